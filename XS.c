@@ -0,0 +1,4835 @@
+/*
+ * This file was generated automatically by ExtUtils::ParseXS version 3.45 from the
+ * contents of XS.xs. Do not edit this file, edit XS.xs instead.
+ *
+ *    ANY CHANGES MADE HERE WILL BE LOST!
+ *
+ */
+
+#line 1 "XS.xs"
+
+#include "EXTERN.h"
+#include "perl.h"
+#include "XSUB.h"
+/* We're not using anything for which we need ppport.h */
+
+#include <string.h>
+#include <gmp.h>
+
+#include "ptypes.h"
+#include "gmp_main.h"
+#include "primality.h"
+#include "lucas_seq.h"
+#include "squfof126.h"
+#include "ecm.h"
+#include "simpqs.h"
+#include "bls75.h"
+#include "ecpp.h"
+#include "aks.h"
+#include "rootmod.h"
+#include "utility.h"
+#include "factor.h"
+#include "isaac.h"
+#include "random_prime.h"
+#include "real.h"
+#include "threadpool.h"
+#include "primegaps.h"
+#include "classpoly.h"
+#include "cert.h"
+#include "prime_iterator.h"
+#define _GMP_ECM_FACTOR(n, f, b1, ncurves) \
+   _GMP_ecm_factor_projective(n, f, b1, 0, ncurves)
+
+
+/* Instead of trying to suck in lots of Math::BigInt::GMP and be terribly
+ * clever (and brittle), just do all C<->Perl bigints via strings.  It's
+ * crude but seems to work pretty well.
+ */
+
+static void validate_string_number(CV* cv, const char* var, const char* s)
+{
+  const char* p;
+  if (s == 0)
+    croak("%s (%s): null string pointer as input", GvNAME(CvGV(cv)),var);
+  if (*s == 0)
+    croak("%s (%s): empty string as input", GvNAME(CvGV(cv)),var);
+  p = s;
+  while (*p != 0) {
+    if (!isdigit(*p))
+      croak("%s (%s): input '%s' must be a positive integer", GvNAME(CvGV(cv)), var, s);
+    p++;
+  }
+}
+
+#define VALIDATE_AND_SET(var, str) \
+  do { \
+    const char* s = str; \
+    if (*s == '+') s++; \
+    validate_string_number(cv,#var,s); \
+    mpz_init_set_str(var, s, 10); \
+  } while (0)
+
+#define VSETNEG_ERR 0
+#define VSETNEG_POS 1
+#define VSETNEG_OK  2
+static int validate_and_set_signed(CV* cv, mpz_t v, const char* vname, const char* s, int negflag) {
+  int neg = (s && *s == '-');
+  if (s && *s == '+') s++;
+  validate_string_number(cv, vname, (neg && negflag != VSETNEG_ERR) ? s+1 : s);
+  mpz_init_set_str(v, (neg && negflag == VSETNEG_POS) ? s+1 : s, 10);
+  return neg;
+}
+
+/* Functions that only need the factorization of n also accept it directly,
+ * as an array reference of primes [2,2,3,...] or of [p,e] pairs.  Each
+ * prime is verified with BPSW before use. */
+static const char* factored_elem(CV* cv, AV* av, int i, int *e)
+{
+  AV *pav;
+  SV **svp, **esvp;
+  const char *s;
+  IV ev;
+
+  /* Arrays may have holes, so every fetch is checked. */
+  svp = av_fetch(av, i, 0);
+  if (svp == 0) croak("%s: undefined factor", GvNAME(CvGV(cv)));
+  *e = 1;
+  if (SvROK(*svp) && SvTYPE(SvRV(*svp)) == SVt_PVAV) {
+    pav = (AV*) SvRV(*svp);
+    if (av_len(pav) != 1)
+      croak("%s: factor pairs must be [p,e]", GvNAME(CvGV(cv)));
+    svp = av_fetch(pav, 0, 0);
+    esvp = av_fetch(pav, 1, 0);
+    if (svp == 0 || esvp == 0)
+      croak("%s: factor pairs must be [p,e]", GvNAME(CvGV(cv)));
+    ev = SvIV(*esvp);
+    if (ev < 0)
+      croak("%s: negative exponent", GvNAME(CvGV(cv)));
+    if (ev > (IV)INT_MAX)
+      croak("%s: exponent too large", GvNAME(CvGV(cv)));
+    *e = (int) ev;
+  }
+  s = SvPV_nolen(*svp);
+  if (*s == '+') s++;
+  return s;
+}
+
+static void factored_from_sv(CV* cv, factored_t* F, SV* sv)
+{
+  AV *av;
+  mpz_t *p;
+  int *e, i, len, ok, ei;
+
+  if (!SvROK(sv) || SvTYPE(SvRV(sv)) != SVt_PVAV)
+    croak("%s: factored input must be an array reference", GvNAME(CvGV(cv)));
+  av = (AV*) SvRV(sv);
+  len = av_len(av) + 1;
+  /* Check everything before allocating, so a croak leaks nothing. */
+  for (i = 0; i < len; i++)
+    validate_string_number(cv, "p", factored_elem(cv, av, i, &ei));
+  New(0, p, (len > 0) ? len : 1, mpz_t);
+  New(0, e, (len > 0) ? len : 1, int);
+  for (i = 0; i < len; i++)
+    mpz_init_set_str(p[i], factored_elem(cv, av, i, &e[i]), 10);
+  ok = factored_init_list(F, len, p, e);
+  for (i = 0; i < len; i++)
+    mpz_clear(p[i]);
+  Safefree(p);
+  Safefree(e);
+  if (!ok) {
+    factored_clear(F);
+    croak("%s: factor is not prime", GvNAME(CvGV(cv)));
+  }
+}
+
+#define IS_FACTORED_SV(sv) (SvROK(sv) && SvTYPE(SvRV(sv)) == SVt_PVAV)
+
+/* The range functions factor their range in blocks of this many values. */
+#define RANGE_BLOCK 32768
+static UV range_block_len(mpz_t lo, mpz_t hi)
+{
+  UV len;
+  mpz_t t;
+  if (mpz_cmp(lo, hi) > 0) return 0;
+  mpz_init(t);
+  mpz_sub(t, hi, lo);
+  len = (mpz_cmp_ui(t, RANGE_BLOCK-1) >= 0) ? RANGE_BLOCK : mpz_get_ui(t)+1;
+  mpz_clear(t);
+  return len;
+}
+
+static char* cert_with_header(char* proof, mpz_t n) {
+  char *str, *strptr;
+  if (proof == 0) {
+    New(0, str, 1, char);
+    str[0] = '\0';
+  } else {
+    New(0, str, strlen(proof) + 100 + mpz_sizeinbase(n,10), char);
+    strptr = str;
+    strptr += gmp_sprintf(strptr, "[MPU - Primality Certificate]\nVersion 1.0\n\nProof for:\nN %Zd\n\n", n);
+    strcat(strptr, proof);
+    Safefree(proof);
+  }
+  return str;
+}
+
+static SV* sv_return_for_mpz(const mpz_t n) {
+  SV* sv = 0;
+  UV v = mpz_get_ui(n);
+  if (!mpz_cmp_ui(n, v)) {  /* Try to use a scalar */
+    sv = newSVuv(v);
+  } else {
+    char* str;
+    int nsize = mpz_sizeinbase(n, 10) + 2;
+    New(0, str, nsize, char);
+    mpz_get_str(str, 10, n);
+    sv = newSVpv(str, 0);
+    Safefree(str);
+  }
+  return sv;
+}
+
+#define XPUSH_MPZ(n) \
+  XPUSHs(sv_2mortal( sv_return_for_mpz(n) ))
+
+static void sv_set_for_mpz(SV* sv, const mpz_t n) {
+  if (mpz_fits_ulong_p(n) && sizeof(unsigned long) <= sizeof(UV)) {
+    sv_setuv(sv, mpz_get_ui(n));
+  } else {
+    char* str;
+    New(0, str, mpz_sizeinbase(n, 10) + 2, char);
+    mpz_get_str(str, 10, n);
+    sv_setpv(sv, str);
+    Safefree(str);
+  }
+}
+
+/* Support for the for... functions taking a block.  $_ is localized and
+ * set to each value in turn.  lastfor() sets a flag that the loops check
+ * after every call.  The flag is saved on the scope stack too, so a nested
+ * loop does not lose a lastfor() from the block around it. */
+static int _for_lastfor = 0;
+
+#define START_FORBLOCK(svarg) \
+  do { \
+    ENTER; \
+    SAVETMPS; \
+    SAVESPTR(GvSV(PL_defgv)); \
+    svarg = newSV(0); \
+    GvSV(PL_defgv) = svarg; \
+    SAVEINT(_for_lastfor); \
+    _for_lastfor = 0; \
+  } while (0)
+
+#define CALL_FORBLOCK(subcv, svarg, v) \
+  do { \
+    dSP; \
+    sv_set_for_mpz(svarg, v); \
+    PUSHMARK(SP); \
+    call_sv((SV*)subcv, G_VOID|G_DISCARD); \
+  } while (0)
+
+#define END_FORBLOCK(svarg) \
+  do { \
+    SvREFCNT_dec(svarg); \
+    FREETMPS; \
+    LEAVE; \
+  } while (0)
+
+/* sieve_stream callback running a block. */
+typedef struct {
+  CV *subcv;
+  SV *svarg;
+} forblock_ctx_t;
+
+static int _forblock_stream(void *vctx, mpz_t v)
+{
+  forblock_ctx_t *ctx = (forblock_ctx_t*) vctx;
+  CALL_FORBLOCK(ctx->subcv, ctx->svarg, v);
+  return _for_lastfor;
+}
+
+/* prime_gap_search callback: $_ is the lower prime, @_ is (gap, merit). */
+static int _forblock_gap(void *vctx, mpz_t p1, UV gap, double merit)
+{
+  forblock_ctx_t *ctx = (forblock_ctx_t*) vctx;
+  dSP;
+  ENTER;         /* Free the arguments after each call, not at the end */
+  SAVETMPS;
+  sv_set_for_mpz(ctx->svarg, p1);
+  PUSHMARK(SP);
+  XPUSHs(sv_2mortal(newSVuv(gap)));
+  XPUSHs(sv_2mortal(newSVnv(merit)));
+  PUTBACK;
+  call_sv((SV*)ctx->subcv, G_VOID|G_DISCARD);
+  FREETMPS;
+  LEAVE;
+  return _for_lastfor;
+}
+
+/* ecpp_prove_batch callback: $_ is N, @_ is (result, proof text).  Other
+ * proofs are still running, so we must not croak here.  A die in the block
+ * stops the batch and is rethrown once it is done. */
+typedef struct {
+  CV    *subcv;
+  SV    *svarg;
+  mpz_t *N;
+  SV   **neg;     /* The input, for negative N (proven as 0) */
+  int    died;
+} forprovable_ctx_t;
+
+static int _forprovable_done(void *vctx, UV i, int result, char *cert)
+{
+  forprovable_ctx_t *ctx = (forprovable_ctx_t*) vctx;
+  dSP;
+  if (ctx->neg[i])  sv_setsv(ctx->svarg, ctx->neg[i]);
+  else              sv_set_for_mpz(ctx->svarg, ctx->N[i]);
+  PUSHMARK(SP);
+  XPUSHs(sv_2mortal(newSViv(result)));
+  XPUSHs(sv_2mortal(newSVpv((cert == 0) ? "" : cert, 0)));
+  PUTBACK;
+  call_sv((SV*)ctx->subcv, G_VOID|G_DISCARD|G_EVAL);
+  if (SvTRUE(ERRSV)) {
+    ctx->died = 1;
+    return 1;
+  }
+  return _for_lastfor;
+}
+
+/* For testing the prime iterators.  Chunk c of [lo,hi] is walked by its own
+ * iterator, placed with setprime, then placed again and walked a second
+ * time.  The chunks run on the thread pool. */
+typedef struct {
+  UV lo, hi, nchunks;
+  UV **list;
+  UV *count;
+  int bad;
+} itertest_ctx_t;
+
+static void _itertest_task(void *vctx, UV c)
+{
+  itertest_ctx_t *ctx = (itertest_ctx_t*) vctx;
+  UV width = (ctx->hi - ctx->lo) / ctx->nchunks + 1;
+  UV clo = ctx->lo + c*width;
+  UV chi = (c == ctx->nchunks-1) ? ctx->hi : clo + width - 1;
+  UV p, n = 0, alloc = 64, pass, k;
+  UV *list;
+  int bad = 0;
+  PRIME_ITERATOR(iter);
+
+  New(0, list, alloc, UV);
+  for (pass = 0; pass < 2; pass++) {
+    prime_iterator_setprime(&iter, clo-1);
+    for (k = 0, p = prime_iterator_next(&iter); p <= chi; p = prime_iterator_next(&iter), k++) {
+      if (pass == 1) {
+        if (k >= n || list[k] != p)  bad = 1;
+        continue;
+      }
+      if (n >= alloc)  Renew(list, alloc *= 2, UV);
+      list[n++] = p;
+    }
+    if (pass == 1 && k != n)  bad = 1;
+  }
+  prime_iterator_destroy(&iter);
+  ctx->list[c] = list;
+  ctx->count[c] = n;
+  if (bad) {
+    parallel_lock();
+    ctx->bad = 1;
+    parallel_unlock();
+  }
+}
+
+
+#line 345 "XS.c"
+#ifndef PERL_UNUSED_VAR
+#  define PERL_UNUSED_VAR(var) if (0) var = var
+#endif
+
+#ifndef dVAR
+#  define dVAR		dNOOP
+#endif
+
+
+/* This stuff is not part of the API! You have been warned. */
+#ifndef PERL_VERSION_DECIMAL
+#  define PERL_VERSION_DECIMAL(r,v,s) (r*1000000 + v*1000 + s)
+#endif
+#ifndef PERL_DECIMAL_VERSION
+#  define PERL_DECIMAL_VERSION \
+	  PERL_VERSION_DECIMAL(PERL_REVISION,PERL_VERSION,PERL_SUBVERSION)
+#endif
+#ifndef PERL_VERSION_GE
+#  define PERL_VERSION_GE(r,v,s) \
+	  (PERL_DECIMAL_VERSION >= PERL_VERSION_DECIMAL(r,v,s))
+#endif
+#ifndef PERL_VERSION_LE
+#  define PERL_VERSION_LE(r,v,s) \
+	  (PERL_DECIMAL_VERSION <= PERL_VERSION_DECIMAL(r,v,s))
+#endif
+
+/* XS_INTERNAL is the explicit static-linkage variant of the default
+ * XS macro.
+ *
+ * XS_EXTERNAL is the same as XS_INTERNAL except it does not include
+ * "STATIC", ie. it exports XSUB symbols. You probably don't want that
+ * for anything but the BOOT XSUB.
+ *
+ * See XSUB.h in core!
+ */
+
+
+/* TODO: This might be compatible further back than 5.10.0. */
+#if PERL_VERSION_GE(5, 10, 0) && PERL_VERSION_LE(5, 15, 1)
+#  undef XS_EXTERNAL
+#  undef XS_INTERNAL
+#  if defined(__CYGWIN__) && defined(USE_DYNAMIC_LOADING)
+#    define XS_EXTERNAL(name) __declspec(dllexport) XSPROTO(name)
+#    define XS_INTERNAL(name) STATIC XSPROTO(name)
+#  endif
+#  if defined(__SYMBIAN32__)
+#    define XS_EXTERNAL(name) EXPORT_C XSPROTO(name)
+#    define XS_INTERNAL(name) EXPORT_C STATIC XSPROTO(name)
+#  endif
+#  ifndef XS_EXTERNAL
+#    if defined(HASATTRIBUTE_UNUSED) && !defined(__cplusplus)
+#      define XS_EXTERNAL(name) void name(pTHX_ CV* cv __attribute__unused__)
+#      define XS_INTERNAL(name) STATIC void name(pTHX_ CV* cv __attribute__unused__)
+#    else
+#      ifdef __cplusplus
+#        define XS_EXTERNAL(name) extern "C" XSPROTO(name)
+#        define XS_INTERNAL(name) static XSPROTO(name)
+#      else
+#        define XS_EXTERNAL(name) XSPROTO(name)
+#        define XS_INTERNAL(name) STATIC XSPROTO(name)
+#      endif
+#    endif
+#  endif
+#endif
+
+/* perl >= 5.10.0 && perl <= 5.15.1 */
+
+
+/* The XS_EXTERNAL macro is used for functions that must not be static
+ * like the boot XSUB of a module. If perl didn't have an XS_EXTERNAL
+ * macro defined, the best we can do is assume XS is the same.
+ * Dito for XS_INTERNAL.
+ */
+#ifndef XS_EXTERNAL
+#  define XS_EXTERNAL(name) XS(name)
+#endif
+#ifndef XS_INTERNAL
+#  define XS_INTERNAL(name) XS(name)
+#endif
+
+/* Now, finally, after all this mess, we want an ExtUtils::ParseXS
+ * internal macro that we're free to redefine for varying linkage due
+ * to the EXPORT_XSUB_SYMBOLS XS keyword. This is internal, use
+ * XS_EXTERNAL(name) or XS_INTERNAL(name) in your code if you need to!
+ */
+
+#undef XS_EUPXS
+#if defined(PERL_EUPXS_ALWAYS_EXPORT)
+#  define XS_EUPXS(name) XS_EXTERNAL(name)
+#else
+   /* default to internal */
+#  define XS_EUPXS(name) XS_INTERNAL(name)
+#endif
+
+#ifndef PERL_ARGS_ASSERT_CROAK_XS_USAGE
+#define PERL_ARGS_ASSERT_CROAK_XS_USAGE assert(cv); assert(params)
+
+/* prototype to pass -Wmissing-prototypes */
+STATIC void
+S_croak_xs_usage(const CV *const cv, const char *const params);
+
+STATIC void
+S_croak_xs_usage(const CV *const cv, const char *const params)
+{
+    const GV *const gv = CvGV(cv);
+
+    PERL_ARGS_ASSERT_CROAK_XS_USAGE;
+
+    if (gv) {
+        const char *const gvname = GvNAME(gv);
+        const HV *const stash = GvSTASH(gv);
+        const char *const hvname = stash ? HvNAME(stash) : NULL;
+
+        if (hvname)
+	    Perl_croak_nocontext("Usage: %s::%s(%s)", hvname, gvname, params);
+        else
+	    Perl_croak_nocontext("Usage: %s(%s)", gvname, params);
+    } else {
+        /* Pants. I don't think that it should be possible to get here. */
+	Perl_croak_nocontext("Usage: CODE(0x%" UVxf ")(%s)", PTR2UV(cv), params);
+    }
+}
+#undef  PERL_ARGS_ASSERT_CROAK_XS_USAGE
+
+#define croak_xs_usage        S_croak_xs_usage
+
+#endif
+
+/* NOTE: the prototype of newXSproto() is different in versions of perls,
+ * so we define a portable version of newXSproto()
+ */
+#ifdef newXS_flags
+#define newXSproto_portable(name, c_impl, file, proto) newXS_flags(name, c_impl, file, proto, 0)
+#else
+#define newXSproto_portable(name, c_impl, file, proto) (PL_Sv=(SV*)newXS(name, c_impl, file), sv_setpv(PL_Sv, proto), (CV*)PL_Sv)
+#endif /* !defined(newXS_flags) */
+
+#if PERL_VERSION_LE(5, 21, 5)
+#  define newXS_deffile(a,b) Perl_newXS(aTHX_ a,b,file)
+#else
+#  define newXS_deffile(a,b) Perl_newXS_deffile(aTHX_ a,b)
+#endif
+
+#line 489 "XS.c"
+
+XS_EUPXS(XS_Math__Prime__Util__GMP__GMP_init); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP__GMP_init)
+{
+    dVAR; dXSARGS;
+    if (items != 0)
+       croak_xs_usage(cv,  "");
+    {
+
+	_GMP_init();
+    }
+    XSRETURN_EMPTY;
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP__GMP_destroy); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP__GMP_destroy)
+{
+    dVAR; dXSARGS;
+    if (items != 0)
+       croak_xs_usage(cv,  "");
+    {
+
+	_GMP_destroy();
+    }
+    XSRETURN_EMPTY;
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP__GMP_memfree); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP__GMP_memfree)
+{
+    dVAR; dXSARGS;
+    if (items != 0)
+       croak_xs_usage(cv,  "");
+    {
+
+	_GMP_memfree();
+    }
+    XSRETURN_EMPTY;
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP__GMP_set_verbose); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP__GMP_set_verbose)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "v");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+	int	v = (int)SvIV(ST(0))
+;
+#line 347 "XS.xs"
+     set_verbose_level(v);
+#line 546 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP__GMP_set_threads); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP__GMP_set_threads)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "n");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+	int	n = (int)SvIV(ST(0))
+;
+#line 351 "XS.xs"
+     set_thread_count(n);
+#line 566 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP__GMP_get_threads); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP__GMP_get_threads)
+{
+    dVAR; dXSARGS;
+    if (items != 0)
+       croak_xs_usage(cv,  "");
+    {
+	int	RETVAL;
+	dXSTARG;
+#line 355 "XS.xs"
+     RETVAL = get_thread_count();
+#line 584 "XS.c"
+	XSprePUSH;
+	PUSHi((IV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP__GMP_set_class_poly_db); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP__GMP_set_class_poly_db)
+{
+    dVAR; dXSARGS;
+    if (items < 0 || items > 1)
+       croak_xs_usage(cv,  "svpath= 0");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+	SV *	svpath;
+
+	if (items < 1)
+	    svpath = 0;
+	else {
+	    svpath = ST(0)
+;
+	}
+#line 361 "XS.xs"
+     if (!class_poly_db_set( (svpath != 0 && SvOK(svpath)) ? SvPV_nolen(svpath) : 0 ))
+       croak("_GMP_set_class_poly_db: cannot change the database while proofs are running");
+     free_class_polys();   /* The computed list depends on the database */
+#line 613 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP__GMP_class_poly); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP__GMP_class_poly)
+{
+    dVAR; dXSARGS;
+    dXSI32;
+    if (items != 1)
+       croak_xs_usage(cv,  "i");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 369 "XS.xs"
+    mpz_t* T = 0;
+    int D, type;
+    UV j, degree;
+#line 634 "XS.c"
+	int	i = (int)SvIV(ST(0))
+;
+#line 373 "XS.xs"
+    /* ix 0:  D, type, and coefficients of the ECPP list entry i (from 1).
+     * ix 1:  coefficients of the Hilbert class polynomial for -i. */
+    if (ix == 0) {
+      degree = poly_class_poly_num(i, &D, &T, &type);
+    } else {
+      degree = (i < 3) ? 0 : hilbert_class_poly(&T, i);
+      D = -i;  type = 1;
+    }
+    if (degree == 0 || T == 0) XSRETURN_EMPTY;
+    if (ix == 0) {
+      XPUSHs(sv_2mortal(newSViv(D)));
+      XPUSHs(sv_2mortal(newSViv(type)));
+    }
+    for (j = 0; j <= degree; j++) {
+      XPUSH_MPZ(T[j]);
+      mpz_clear(T[j]);
+    }
+    Safefree(T);
+#line 656 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP__GMP_prime_iterator_walk); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP__GMP_prime_iterator_walk)
+{
+    dVAR; dXSARGS;
+    if (items < 2 || items > 3)
+       croak_xs_usage(cv,  "lo, hi, nchunks= 1");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 394 "XS.xs"
+    itertest_ctx_t ctx;
+    UV c, i;
+#line 675 "XS.c"
+	UV	lo = (UV)SvUV(ST(0))
+;
+	UV	hi = (UV)SvUV(ST(1))
+;
+	UV	nchunks;
+
+	if (items < 3)
+	    nchunks = 1;
+	else {
+	    nchunks = (UV)SvUV(ST(2))
+;
+	}
+#line 397 "XS.xs"
+    if (lo < 1) lo = 1;
+    if (nchunks < 1) nchunks = 1;
+    if (hi < lo || hi - lo + 1 < nchunks || hi >= UV_MAX - 1000)
+      croak("_GMP_prime_iterator_walk: bad range");
+    ctx.lo = lo;  ctx.hi = hi;  ctx.nchunks = nchunks;  ctx.bad = 0;
+    Newz(0, ctx.list, nchunks, UV*);
+    Newz(0, ctx.count, nchunks, UV);
+    parallel_for(nchunks, _itertest_task, &ctx);
+    for (c = 0; c < nchunks; c++) {
+      if (!ctx.bad)
+        for (i = 0; i < ctx.count[c]; i++)
+          XPUSHs(sv_2mortal(newSVuv(ctx.list[c][i])));
+      Safefree(ctx.list[c]);
+    }
+    Safefree(ctx.list);
+    Safefree(ctx.count);
+    if (ctx.bad) croak("_GMP_prime_iterator_walk: second walk differs");
+#line 706 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP__GMP_polyz_roots_modp); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP__GMP_polyz_roots_modp)
+{
+    dVAR; dXSARGS;
+    if (items < 1)
+       croak_xs_usage(cv,  "strn, ...");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 417 "XS.xs"
+    mpz_t n, *P, *roots;
+    long i, d, nroots;
+#line 725 "XS.c"
+	char *	strn = (char *)SvPV_nolen(ST(0))
+;
+#line 420 "XS.xs"
+    /* Roots mod prime n of the poly with coefficients ST(1) (constant) to
+     * ST(items-1), each 0 <= c < n. */
+    if (items < 2) croak("_GMP_polyz_roots_modp: no coefficients");
+    d = items - 2;
+    for (i = 0; i <= d; i++)
+      validate_string_number(cv, "c", SvPV_nolen(ST(i+1)));
+    VALIDATE_AND_SET(n, strn);
+    New(0, P, d+1, mpz_t);
+    for (i = 0; i <= d; i++)
+      mpz_init_set_str(P[i], SvPV_nolen(ST(i+1)), 10);
+    polyz_roots_modp(&roots, &nroots, 0, P, d, n);
+    for (i = 0; i <= d; i++)
+      mpz_clear(P[i]);
+    Safefree(P);
+    mpz_clear(n);
+    for (i = 0; i < nroots; i++) {
+      XPUSH_MPZ(roots[i]);
+      mpz_clear(roots[i]);
+    }
+    if (roots != 0) Safefree(roots);
+#line 749 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP__GMP_class_numbers); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP__GMP_class_numbers)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "maxd");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 443 "XS.xs"
+    unsigned short* h;
+    UV d;
+#line 768 "XS.c"
+	UV	maxd = (UV)SvUV(ST(0))
+;
+#line 446 "XS.xs"
+    h = class_numbers(maxd);
+    EXTEND(SP, (IV)maxd+1);
+    for (d = 0; d <= maxd; d++)
+      PUSHs(sv_2mortal(newSVuv(h[d])));
+    Safefree(h);
+#line 777 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP__GMP_set_ecpp_checkpoint); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP__GMP_set_ecpp_checkpoint)
+{
+    dVAR; dXSARGS;
+    if (items < 0 || items > 1)
+       croak_xs_usage(cv,  "svpath= 0");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+	SV *	svpath;
+
+	if (items < 1)
+	    svpath = 0;
+	else {
+	    svpath = ST(0)
+;
+	}
+#line 454 "XS.xs"
+     ecpp_set_checkpoint( (svpath != 0 && SvOK(svpath)) ? SvPV_nolen(svpath) : 0 );
+#line 803 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP__GMP_set_ecpp_policy); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP__GMP_set_ecpp_policy)
+{
+    dVAR; dXSARGS;
+    if (items < 1 || items > 3)
+       croak_xs_usage(cv,  "eas, degree_bits= 2.0, step_seconds= 0.0");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+	int	eas = (int)SvIV(ST(0))
+;
+	NV	degree_bits;
+	NV	step_seconds;
+
+	if (items < 2)
+	    degree_bits = 2.0;
+	else {
+	    degree_bits = (NV)SvNV(ST(1))
+;
+	}
+
+	if (items < 3)
+	    step_seconds = 0.0;
+	else {
+	    step_seconds = (NV)SvNV(ST(2))
+;
+	}
+#line 458 "XS.xs"
+     ecpp_set_policy(eas, degree_bits, step_seconds);
+#line 839 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP__GMP_ecpp_stats); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP__GMP_ecpp_stats)
+{
+    dVAR; dXSARGS;
+    if (items != 0)
+       croak_xs_usage(cv,  "");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 462 "XS.xs"
+    ecpp_stats_t st;
+#line 857 "XS.c"
+#line 464 "XS.xs"
+    ecpp_get_stats(&st);
+    EXTEND(SP, 30);
+    PUSHs(sv_2mortal(newSVpv("levels", 0)));         PUSHs(sv_2mortal(newSVuv(st.levels)));
+    PUSHs(sv_2mortal(newSVpv("discriminants", 0)));  PUSHs(sv_2mortal(newSVuv(st.discs)));
+    PUSHs(sv_2mortal(newSVpv("factored", 0)));       PUSHs(sv_2mortal(newSVuv(st.mvalues)));
+    PUSHs(sv_2mortal(newSVpv("candidates", 0)));     PUSHs(sv_2mortal(newSVuv(st.candidates)));
+    PUSHs(sv_2mortal(newSVpv("downs", 0)));          PUSHs(sv_2mortal(newSVuv(st.downs)));
+    PUSHs(sv_2mortal(newSVpv("backtracks", 0)));     PUSHs(sv_2mortal(newSVuv(st.backtracks)));
+    PUSHs(sv_2mortal(newSVpv("eas_reorders", 0)));   PUSHs(sv_2mortal(newSVuv(st.eas_reorders)));
+    PUSHs(sv_2mortal(newSVpv("budget_stops", 0)));   PUSHs(sv_2mortal(newSVuv(st.budget_stops)));
+    PUSHs(sv_2mortal(newSVpv("curve_fails", 0)));    PUSHs(sv_2mortal(newSVuv(st.curve_fails)));
+    PUSHs(sv_2mortal(newSVpv("steps", 0)));          PUSHs(sv_2mortal(newSVuv(st.steps)));
+    PUSHs(sv_2mortal(newSVpv("bls_steps", 0)));      PUSHs(sv_2mortal(newSVuv(st.bls_steps)));
+    PUSHs(sv_2mortal(newSVpv("bits_removed", 0)));   PUSHs(sv_2mortal(newSVuv(st.bits_removed)));
+    PUSHs(sv_2mortal(newSVpv("fstage", 0)));         PUSHs(sv_2mortal(newSViv(st.fstage)));
+    PUSHs(sv_2mortal(newSVpv("factor_seconds", 0))); PUSHs(sv_2mortal(newSVnv(st.factor_seconds)));
+    PUSHs(sv_2mortal(newSVpv("curve_seconds", 0)));  PUSHs(sv_2mortal(newSVnv(st.curve_seconds)));
+    PUSHs(sv_2mortal(newSVpv("total_seconds", 0)));  PUSHs(sv_2mortal(newSVnv(st.total_seconds)));
+#line 877 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_verify_prime_certificate); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_verify_prime_certificate)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "svcert");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 485 "XS.xs"
+    cert_step_t *steps;
+    const char *cert, *error;
+    STRLEN len;
+    UV i, nsteps;
+    int result;
+#line 899 "XS.c"
+	SV *	svcert = ST(0)
+;
+#line 491 "XS.xs"
+    cert = SvPV(svcert, len);
+    result = verify_certificate(cert, len, &steps, &nsteps, &error);
+    if (result < 0) result = 0;
+    if (GIMME_V != G_ARRAY) {
+      cert_steps_free(steps, nsteps);
+      XSRETURN_IV(result);
+    }
+    EXTEND(SP, nsteps+1);
+    PUSHs(sv_2mortal(newSViv(result)));
+    for (i = 0; i < nsteps; i++) {
+      AV* av = newAV();
+      av_push(av, newSVpv(steps[i].name, 0));
+      av_push(av, sv_return_for_mpz(steps[i].n));
+      av_push(av, newSViv(steps[i].result));
+      av_push(av, newSVnv(steps[i].seconds));
+      av_push(av, steps[i].failed ? newSVpv(steps[i].failed, 0) : newSV(0));
+      PUSHs( sv_2mortal(newRV_noinc( (SV*) av )) );
+    }
+    cert_steps_free(steps, nsteps);
+#line 922 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_prime_certificate_to_binary); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_prime_certificate_to_binary)
+{
+    dVAR; dXSARGS;
+    dXSI32;
+    if (items != 1)
+       croak_xs_usage(cv,  "svcert");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 515 "XS.xs"
+    const char *cert, *error = 0;
+    char *out;
+    STRLEN len;
+    size_t outlen = 0;
+#line 944 "XS.c"
+	SV *	svcert = ST(0)
+;
+#line 520 "XS.xs"
+    cert = SvPV(svcert, len);
+    if (ix == 0) {
+      out = cert_to_binary(cert, len, &outlen, &error);
+    } else {
+      out = cert_to_text(cert, len, &error);
+      if (out != 0) outlen = strlen(out);
+    }
+    if (out == 0)
+      croak("%s: %s", GvNAME(CvGV(cv)), error ? error : "invalid certificate");
+    XPUSHs(sv_2mortal(newSVpvn(out, outlen)));
+    Safefree(out);
+#line 959 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_seed_csprng); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_seed_csprng)
+{
+    dVAR; dXSARGS;
+    if (items != 2)
+       croak_xs_usage(cv,  "bytes, seed");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+	UV	bytes = (UV)SvUV(ST(0))
+;
+	unsigned char *	seed = (unsigned char *)SvPV_nolen(ST(1))
+;
+#line 534 "XS.xs"
+    isaac_init(bytes, seed);
+#line 981 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_irand); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_irand)
+{
+    dVAR; dXSARGS;
+    dXSI32;
+    if (items != 0)
+       croak_xs_usage(cv,  "");
+    {
+	UV	RETVAL;
+	dXSTARG;
+#line 541 "XS.xs"
+    switch (ix) {
+#if BITS_PER_WORD >= 64
+      case 0:  RETVAL = isaac_rand32(); break;
+      case 1:  RETVAL = (((UV)isaac_rand32()) << 32) | isaac_rand32();  break;
+#else
+      case 0:
+      case 1:  RETVAL = isaac_rand32(); break;
+#endif
+      case 2:
+      default: RETVAL = isaac_seeded(); break;
+    }
+#line 1010 "XS.c"
+	XSprePUSH;
+	PUSHu((UV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_drand); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_drand)
+{
+    dVAR; dXSARGS;
+    if (items < 0 || items > 1)
+       croak_xs_usage(cv,  "m= 1.0");
+    {
+	NV	RETVAL;
+	dXSTARG;
+	NV	m;
+
+	if (items < 1)
+	    m = 1.0;
+	else {
+	    m = (NV)SvNV(ST(0))
+;
+	}
+#line 557 "XS.xs"
+    RETVAL = m * drand64();
+#line 1037 "XS.c"
+	XSprePUSH;
+	PUSHn((NV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_is_pseudoprime); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_is_pseudoprime)
+{
+    dVAR; dXSARGS;
+    dXSI32;
+    if (items < 1)
+       croak_xs_usage(cv,  "strn, ...");
+    {
+#line 567 "XS.xs"
+    int i;
+    mpz_t n, a;
+#line 1056 "XS.c"
+	int	RETVAL;
+	dXSTARG;
+	char*	strn = (char *)SvPV_nolen(ST(0))
+;
+#line 570 "XS.xs"
+    if (items < 2) croak("%s: no bases", GvNAME(CvGV(cv)));
+    validate_string_number(cv,"n",strn);
+    for (i = 1; i < items; i++) {
+      const char* strbase = SvPV_nolen(ST(i));
+      validate_string_number(cv, "base", strbase);
+      if (strbase[1] == '\0' && (strbase[0] == '0' || strbase[0] == '1'))
+        croak("Base %s is invalid", strbase);
+    }
+    mpz_init_set_str(n, strn, 10);
+    for (i = 1; i < items; i++) {
+      mpz_init_set_str(a, SvPV_nolen(ST(i)), 10);
+      switch (ix) {
+        case 0:  RETVAL = is_pseudoprime(n, a); break;
+        case 1:  RETVAL = is_euler_pseudoprime(n, a); break;
+        case 2:
+        default: RETVAL = miller_rabin(n, a); break;
+      }
+      mpz_clear(a);
+      if (!RETVAL) break;
+    }
+    mpz_clear(n);
+#line 1083 "XS.c"
+	XSprePUSH;
+	PUSHi((IV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_miller_rabin_random); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_miller_rabin_random)
+{
+    dVAR; dXSARGS;
+    if (items < 1 || items > 3)
+       croak_xs_usage(cv,  "strn, nbases= 1, seedstr= 0");
+    {
+#line 596 "XS.xs"
+    mpz_t n;
+#line 1100 "XS.c"
+	int	RETVAL;
+	dXSTARG;
+	char *	strn = (char *)SvPV_nolen(ST(0))
+;
+	IV	nbases;
+	char *	seedstr;
+
+	if (items < 2)
+	    nbases = 1;
+	else {
+	    nbases = (IV)SvIV(ST(1))
+;
+	}
+
+	if (items < 3)
+	    seedstr = 0;
+	else {
+	    seedstr = (char *)SvPV_nolen(ST(2))
+;
+	}
+#line 598 "XS.xs"
+    if (nbases < 0)
+      croak("Parameter '%"IVdf"' must be a positive integer\n", nbases);
+    VALIDATE_AND_SET(n, strn);
+    RETVAL = miller_rabin_random(n, nbases, seedstr);
+    mpz_clear(n);
+#line 1127 "XS.c"
+	XSprePUSH;
+	PUSHi((IV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+#define PRIMALITY_START(name, small_retval, test_small_factors) \
+    /* Negative numbers return 0 */ \
+    if ((strn != 0) && (strn[0] == '-') ) \
+      XSRETURN_IV(0); \
+    validate_string_number(cv, "n", strn); \
+    /* Handle single digit numbers */ \
+    if (strn[1] == 0) { \
+      int q_is_prime = 0; \
+      switch (strn[0]) { \
+        case '2': case '3': case '5': case '7': q_is_prime = (small_retval); \
+                                                break; \
+      } \
+      XSRETURN_IV(q_is_prime); \
+    } \
+    /* Test for small multiples while it is still a string */ \
+    if (test_small_factors) { \
+      UV digsum = 0; \
+      int i, slen = strlen(strn); \
+      /* Multiples of 2 and 5 return 0 */ \
+      switch (strn[slen-1]-'0') { \
+        case 0: case 2: case 4: case 5: case 6: case 8: \
+           XSRETURN_IV(0); break; \
+      } \
+      /* Multiples of 3 return 0 */ \
+      for (i = 0; i < slen; i++)  digsum += strn[i]-'0'; \
+      if (digsum % 3 == 0)  XSRETURN_IV(0); \
+    } \
+    mpz_init_set_str(n, strn, 10);
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_is_lucas_pseudoprime); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_is_lucas_pseudoprime)
+{
+    dVAR; dXSARGS;
+    dXSI32;
+    if (items != 1)
+       croak_xs_usage(cv,  "strn");
+    {
+#line 644 "XS.xs"
+    mpz_t n;
+#line 1173 "XS.c"
+	int	RETVAL;
+	dXSTARG;
+	char*	strn = (char *)SvPV_nolen(ST(0))
+;
+#line 646 "XS.xs"
+    if ((strn != 0) && (strn[0] == '-') )
+      croak("Parameter '%s' must be a positive integer\n", strn);
+    PRIMALITY_START("is_lucas_pseudoprime", 1, 0);
+    switch (ix) {
+      case 0: RETVAL = _GMP_is_lucas_pseudoprime(n, 0); break;
+      case 1: RETVAL = _GMP_is_lucas_pseudoprime(n, 1); break;
+      case 2: RETVAL = _GMP_is_lucas_pseudoprime(n, 2); break;
+      case 3: RETVAL = _GMP_is_frobenius_underwood_pseudoprime(n); break;
+      case 4: RETVAL = _GMP_is_frobenius_khashin_pseudoprime(n); break;
+      case 5:
+      default:RETVAL = is_euler_plumb_pseudoprime(n); break;
+    }
+    mpz_clear(n);
+#line 1192 "XS.c"
+	XSprePUSH;
+	PUSHi((IV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_is_almost_extra_strong_lucas_pseudoprime); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_is_almost_extra_strong_lucas_pseudoprime)
+{
+    dVAR; dXSARGS;
+    if (items < 1 || items > 2)
+       croak_xs_usage(cv,  "strn, increment= 1");
+    {
+#line 665 "XS.xs"
+    mpz_t n;
+#line 1209 "XS.c"
+	int	RETVAL;
+	dXSTARG;
+	char*	strn = (char *)SvPV_nolen(ST(0))
+;
+	UV	increment;
+
+	if (items < 2)
+	    increment = 1;
+	else {
+	    increment = (UV)SvUV(ST(1))
+;
+	}
+#line 667 "XS.xs"
+    if ((strn != 0) && (strn[0] == '-') )
+      croak("Parameter '%s' must be a positive integer\n", strn);
+    if (increment == 0 || increment > 65535)
+      croak("Increment parameter must be >0 and < 65536");
+    PRIMALITY_START("is_almost_extra_strong_lucas_pseudoprime", 1, 0);
+    RETVAL = _GMP_is_almost_extra_strong_lucas_pseudoprime(n, increment);
+    mpz_clear(n);
+#line 1230 "XS.c"
+	XSprePUSH;
+	PUSHi((IV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_is_frobenius_pseudoprime); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_is_frobenius_pseudoprime)
+{
+    dVAR; dXSARGS;
+    if (items < 1 || items > 3)
+       croak_xs_usage(cv,  "strn, P= 0, Q= 0");
+    {
+#line 680 "XS.xs"
+    mpz_t n;
+#line 1247 "XS.c"
+	int	RETVAL;
+	dXSTARG;
+	char*	strn = (char *)SvPV_nolen(ST(0))
+;
+	IV	P;
+	IV	Q;
+
+	if (items < 2)
+	    P = 0;
+	else {
+	    P = (IV)SvIV(ST(1))
+;
+	}
+
+	if (items < 3)
+	    Q = 0;
+	else {
+	    Q = (IV)SvIV(ST(2))
+;
+	}
+#line 682 "XS.xs"
+    if ((strn != 0) && (strn[0] == '-') )
+      croak("Parameter '%s' must be a positive integer\n", strn);
+    PRIMALITY_START("is_frobenius_pseudoprime", 1, 0);
+    RETVAL = is_frobenius_pseudoprime(n, P, Q);
+    mpz_clear(n);
+#line 1274 "XS.c"
+	XSprePUSH;
+	PUSHi((IV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_is_prime); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_is_prime)
+{
+    dVAR; dXSARGS;
+    dXSI32;
+    if (items != 1)
+       croak_xs_usage(cv,  "strn");
+    {
+#line 704 "XS.xs"
+    mpz_t n;
+    int ret;
+#line 1293 "XS.c"
+	int	RETVAL;
+	dXSTARG;
+	char*	strn = (char *)SvPV_nolen(ST(0))
+;
+#line 707 "XS.xs"
+    /* Returns arg for single-dig primes, 0 for multiples of 2, 3, 5, or neg */
+    PRIMALITY_START("is_prime", (ix < 5) ? 2 : 1, 1);
+    switch (ix) {
+      case 0: ret = _GMP_is_prime(n); break;
+      case 1: ret = _GMP_is_prob_prime(n); break;
+      case 2: ret = _GMP_BPSW(n); break;
+      case 3: ret = llr(n); break;
+      case 4: ret = proth(n); break;
+      case 5: ret = is_trial_prime(n); break;
+      case 6: ret = is_aks_prime(n); break;
+      case 7: ret = (BLS_primality_nm1(n, 100, 0) == 2) ? 1 : 0; break;
+      case 8: ret = (BLS_primality_np1(n, 100, 0) == 2) ? 1 : 0; break;
+      case 9: ret = (BLS_primality(n, 100, 0) == 2) ? 1 : 0; break;
+      case 10:
+      default:ret = (_GMP_ecpp(n, 0) == 2) ? 1 : 0; break;
+    }
+    RETVAL = ret;
+    mpz_clear(n);
+#line 1317 "XS.c"
+	XSprePUSH;
+	PUSHi((IV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP__is_provable_prime); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP__is_provable_prime)
+{
+    dVAR; dXSARGS;
+    dXSI32;
+    if (items < 1 || items > 2)
+       croak_xs_usage(cv,  "strn, wantproof= 0");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 735 "XS.xs"
+    int result;
+    mpz_t n;
+#line 1338 "XS.c"
+	char*	strn = (char *)SvPV_nolen(ST(0))
+;
+	int	wantproof;
+
+	if (items < 2)
+	    wantproof = 0;
+	else {
+	    wantproof = (int)SvIV(ST(1))
+;
+	}
+#line 738 "XS.xs"
+    PRIMALITY_START("is_provable_prime", 2, ix != 2);
+    if (ix == 1) {
+      result = is_miller_prime(n, wantproof);  /* Assume GRH or not */
+      mpz_clear(n);
+      XSRETURN_IV(result);
+    }
+    if (ix == 2) {
+      result = is_perrin_pseudoprime(n, wantproof);  /* Restricted or not */
+      mpz_clear(n);
+      XSRETURN_IV(result);
+    }
+    if (wantproof == 0) {
+      result = _GMP_is_provable_prime(n, 0);
+      XPUSHs(sv_2mortal(newSViv( result )));
+    } else {
+      char* prooftext = 0;
+      result = _GMP_is_provable_prime(n, &prooftext);
+      XPUSHs(sv_2mortal(newSViv( result )));
+      if (prooftext) {
+        XPUSHs(sv_2mortal(newSVpv(prooftext, 0)));
+        Safefree(prooftext);
+      } else {
+        XPUSHs(sv_2mortal(newSVpv("", 0)));
+      }
+    }
+    mpz_clear(n);
+#line 1376 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP__validate_ecpp_curve); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP__validate_ecpp_curve)
+{
+    dVAR; dXSARGS;
+    if (items != 7)
+       croak_xs_usage(cv,  "stra, strb, strn, strpx, strpy, strm, strq");
+    {
+#line 768 "XS.xs"
+    mpz_t a, b, n, px, py, m, q, t1, t2;
+#line 1392 "XS.c"
+	int	RETVAL;
+	dXSTARG;
+	char*	stra = (char *)SvPV_nolen(ST(0))
+;
+	char*	strb = (char *)SvPV_nolen(ST(1))
+;
+	char*	strn = (char *)SvPV_nolen(ST(2))
+;
+	char*	strpx = (char *)SvPV_nolen(ST(3))
+;
+	char*	strpy = (char *)SvPV_nolen(ST(4))
+;
+	char*	strm = (char *)SvPV_nolen(ST(5))
+;
+	char*	strq = (char *)SvPV_nolen(ST(6))
+;
+#line 770 "XS.xs"
+    VALIDATE_AND_SET(a, stra);
+    VALIDATE_AND_SET(b, strb);  /* Unused */
+    VALIDATE_AND_SET(n, strn);
+    VALIDATE_AND_SET(px, strpx);
+    VALIDATE_AND_SET(py, strpy);
+    VALIDATE_AND_SET(m, strm);
+    VALIDATE_AND_SET(q, strq);
+    mpz_init(t1);  mpz_init(t2);
+    RETVAL = (ecpp_check_point(px, py, m, q, a, n, t1, t2) == 2) ? 1 : 0;
+    mpz_clear(t1); mpz_clear(t2);
+    mpz_clear(a); mpz_clear(b); mpz_clear(n); mpz_clear(px); mpz_clear(py);
+    mpz_clear(m); mpz_clear(q);
+#line 1422 "XS.c"
+	XSprePUSH;
+	PUSHi((IV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_is_almost_prime); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_is_almost_prime)
+{
+    dVAR; dXSARGS;
+    if (items != 2)
+       croak_xs_usage(cv,  "k, strn");
+    {
+#line 788 "XS.xs"
+    mpz_t n;
+#line 1439 "XS.c"
+	int	RETVAL;
+	dXSTARG;
+	unsigned int	k = (unsigned int)SvUV(ST(0))
+;
+	char*	strn = (char *)SvPV_nolen(ST(1))
+;
+#line 790 "XS.xs"
+    VALIDATE_AND_SET(n, strn);
+    RETVAL = is_almost_prime(k, n);
+    mpz_clear(n);
+#line 1450 "XS.c"
+	XSprePUSH;
+	PUSHi((IV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_is_power); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_is_power)
+{
+    dVAR; dXSARGS;
+    if (items < 1 || items > 2)
+       croak_xs_usage(cv,  "strn, a= 0");
+    {
+#line 798 "XS.xs"
+    mpz_t n;
+    int isneg;
+#line 1468 "XS.c"
+	UV	RETVAL;
+	dXSTARG;
+	char *	strn = (char *)SvPV_nolen(ST(0))
+;
+	UV	a;
+
+	if (items < 2)
+	    a = 0;
+	else {
+	    a = (UV)SvUV(ST(1))
+;
+	}
+#line 801 "XS.xs"
+    isneg = validate_and_set_signed(cv, n, "n", strn, VSETNEG_POS);
+    RETVAL = 0;
+    if (!isneg || (a == 0 || a & 1)) {
+      RETVAL = is_power(n, a);
+    }
+    if (isneg && a == 0 && RETVAL != 0) {
+      UV r = RETVAL;
+      while (!(r & 1)) r >>= 1;
+      RETVAL = (r == 1) ? 0 : r;
+    }
+    mpz_clear(n);
+#line 1493 "XS.c"
+	XSprePUSH;
+	PUSHu((UV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_is_divisible); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_is_divisible)
+{
+    dVAR; dXSARGS;
+    if (items != 2)
+       croak_xs_usage(cv,  "strn, strd");
+    {
+#line 817 "XS.xs"
+    mpz_t n, d;
+#line 1510 "XS.c"
+	int	RETVAL;
+	dXSTARG;
+	char *	strn = (char *)SvPV_nolen(ST(0))
+;
+	char *	strd = (char *)SvPV_nolen(ST(1))
+;
+#line 819 "XS.xs"
+    validate_and_set_signed(cv, n, "n", strn, VSETNEG_OK);
+    validate_and_set_signed(cv, d, "d", strd, VSETNEG_OK);
+    RETVAL = !!mpz_divisible_p(n, d);
+    mpz_clear(d);  mpz_clear(n);
+#line 1522 "XS.c"
+	XSprePUSH;
+	PUSHi((IV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_is_congruent); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_is_congruent)
+{
+    dVAR; dXSARGS;
+    if (items != 3)
+       croak_xs_usage(cv,  "strn, strc, strd");
+    {
+#line 828 "XS.xs"
+    mpz_t n, c, d;
+#line 1539 "XS.c"
+	int	RETVAL;
+	dXSTARG;
+	char *	strn = (char *)SvPV_nolen(ST(0))
+;
+	char *	strc = (char *)SvPV_nolen(ST(1))
+;
+	char *	strd = (char *)SvPV_nolen(ST(2))
+;
+#line 830 "XS.xs"
+    validate_and_set_signed(cv, n, "n", strn, VSETNEG_OK);
+    validate_and_set_signed(cv, c, "c", strc, VSETNEG_OK);
+    validate_and_set_signed(cv, d, "d", strd, VSETNEG_OK);
+    RETVAL = !!mpz_congruent_p(n, c, d);
+    mpz_clear(d);  mpz_clear(c);  mpz_clear(n);
+#line 1554 "XS.c"
+	XSprePUSH;
+	PUSHi((IV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_next_prime); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_next_prime)
+{
+    dVAR; dXSARGS;
+    dXSI32;
+    if (items != 1)
+       croak_xs_usage(cv,  "strn");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 844 "XS.xs"
+    mpz_t n;
+#line 1574 "XS.c"
+	char*	strn = (char *)SvPV_nolen(ST(0))
+;
+#line 846 "XS.xs"
+    VALIDATE_AND_SET(n, strn);
+    if (ix == 1 && mpz_cmp_ui(n,3) < 0) { mpz_clear(n); XSRETURN_UNDEF; }
+    if      (ix == 0) _GMP_next_prime(n);
+    else if (ix == 1) _GMP_prev_prime(n);
+    else              next_twin_prime(n, n);
+    XPUSH_MPZ(n);
+    mpz_clear(n);
+#line 1585 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_random_prime); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_random_prime)
+{
+    dVAR; dXSARGS;
+    dXSI32;
+    if (items < 1 || items > 2)
+       croak_xs_usage(cv,  "strlo, strhi= 0");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 860 "XS.xs"
+    mpz_t lo, hi, res;
+    int retundef;
+#line 1605 "XS.c"
+	char*	strlo = (char *)SvPV_nolen(ST(0))
+;
+	char*	strhi;
+
+	if (items < 2)
+	    strhi = 0;
+	else {
+	    strhi = (char *)SvPV_nolen(ST(1))
+;
+	}
+#line 863 "XS.xs"
+    if (strhi == 0) {
+      mpz_init_set_ui(lo, 0);
+      VALIDATE_AND_SET(hi, strlo);
+    } else {
+      if (*strlo == '+')  strlo++;
+      if (*strhi == '+')  strhi++;
+      validate_string_number(cv, "lo", strlo);
+      validate_string_number(cv, "hi", strhi);
+      mpz_init_set_str(lo, strlo, 10);
+      mpz_init_set_str(hi, strhi, 10);
+    }
+    if (ix == 1 && mpz_sizeinbase(hi,2) <= 32) {
+      uint32_t ulo = mpz_get_ui(lo),  uhi = mpz_get_ui(hi);
+      if (ulo <= uhi) {
+        mpz_clear(lo); mpz_clear(hi);
+        XSRETURN_IV( ulo + isaac_rand(uhi-ulo+1) );
+      }
+    }
+    retundef = 0;
+    mpz_init(res);
+    if (ix == 0) {
+      retundef = !mpz_random_prime(res, lo, hi);
+    } else {
+      if (mpz_cmp(lo,hi) > 0) {
+        retundef = 1;
+      } else {
+        mpz_sub(hi,hi,lo);
+        mpz_add_ui(hi,hi,1);
+        mpz_isaac_urandomm(res, hi);
+        mpz_add(res,res,lo);
+      }
+    }
+    if (!retundef) XPUSH_MPZ(res);
+    mpz_clear(res);
+    mpz_clear(hi);
+    mpz_clear(lo);
+    if (retundef) XSRETURN_UNDEF;
+#line 1654 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_prime_count); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_prime_count)
+{
+    dVAR; dXSARGS;
+    dXSI32;
+    if (items < 1 || items > 2)
+       croak_xs_usage(cv,  "strlo, strhi= 0");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 906 "XS.xs"
+    mpz_t n, lo, hi, res;
+#line 1673 "XS.c"
+	char *	strlo = (char *)SvPV_nolen(ST(0))
+;
+	char *	strhi;
+
+	if (items < 2)
+	    strhi = 0;
+	else {
+	    strhi = (char *)SvPV_nolen(ST(1))
+;
+	}
+#line 908 "XS.xs"
+    mpz_init(res);
+    if (strhi == 0) {
+      VALIDATE_AND_SET(n, strlo);
+      switch (ix) {
+        case  0: prime_count(res, n); break;
+        case  1: prime_power_count(res, n); break;
+        case  2: perfect_power_count(res, n); break;
+        default: break;
+      }
+      mpz_clear(n);
+    } else {
+      VALIDATE_AND_SET(lo, strlo);
+      VALIDATE_AND_SET(hi, strhi);
+      switch (ix) {
+        case  0: prime_count_range(res, lo, hi); break;
+        case  1: prime_power_count_range(res, lo, hi); break;
+        case  2: perfect_power_count_range(res, lo, hi); break;
+        default: break;
+      }
+      mpz_clear(lo);
+      mpz_clear(hi);
+    }
+    XPUSH_MPZ(res);
+#line 1708 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_totient); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_totient)
+{
+    dVAR; dXSARGS;
+    dXSI32;
+    if (items != 1)
+       croak_xs_usage(cv,  "svn");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 950 "XS.xs"
+    mpz_t res, n;
+    const char* strn;
+#line 1728 "XS.c"
+	SV*	svn = ST(0)
+;
+#line 953 "XS.xs"
+    if (IS_FACTORED_SV(svn) && (ix == 0 || ix == 1 || ix == 5)) {
+      factored_t F;
+      factored_from_sv(cv, &F, svn);
+      mpz_init(res);
+      switch (ix) {
+        case 0:  totient_factored(res, &F);  break;
+        case 1:  carmichael_lambda_factored(res, &F);  break;
+        case 5:
+        default: znprimroot_factored(res, &F);  break;
+      }
+      if (ix == 5 && !mpz_sgn(res) && mpz_cmp_ui(F.n,1) != 0) {
+        factored_clear(&F);  mpz_clear(res);
+        XSRETURN_UNDEF;
+      }
+      XPUSH_MPZ(res);
+      factored_clear(&F);
+      mpz_clear(res);
+      XSRETURN(1);
+    }
+    strn = SvPV_nolen(svn);
+    if (strn != 0 && strn[0] == '-') { /* If input is negative... */
+      if (ix == 2)  XSRETURN_IV(1);    /* exp_mangoldt return 1 */
+      if (ix == 5)  strn++;            /* znprimroot flip sign */
+      if (ix == 8)  XSRETURN_IV(0);    /* is_prime_power return 0 */
+    }
+    validate_and_set_signed(cv, n, "n", strn,
+                            (ix==14 || ix==15) ? VSETNEG_OK : VSETNEG_ERR);
+    mpz_init(res);
+    switch (ix) {
+      case 0:  totient(res, n);  break;
+      case 1:  carmichael_lambda(res, n);  break;
+      case 2:  exp_mangoldt(res, n);  break;
+      case 3:  bernfrac(n, res, n);
+               XPUSH_MPZ(n);
+               break;
+      case 4:  harmfrac(n, res, n);
+               XPUSH_MPZ(n);
+               break;
+      case 5:  znprimroot(res, n);
+               if (!mpz_sgn(res) && mpz_cmp_ui(n,1) != 0) {
+                 mpz_clear(n);  mpz_clear(res);
+                 XSRETURN_UNDEF;
+               }
+               break;
+      case 6:  ramanujan_tau(res, n);  break;
+      case 7:  mpz_sqrt(res, n);  break;
+      case 8:  mpz_set_uv(res, prime_power(res, n)); break;
+      case 9:  prime_count_lower(res, n); break;
+      case 10: prime_count_upper(res, n); break;
+      case 11: nth_prime(res, n);
+               if (!mpz_sgn(res)) {
+                 mpz_clear(n);  mpz_clear(res);
+                 XSRETURN_UNDEF;
+               }
+               break;
+      case 13: mpz_isaac_urandomm(res, n); break;
+      case 14: mpz_add_ui(res, n, 1); break;
+      case 15: mpz_sub_ui(res, n, 1); break;
+      default: break;
+    }
+    XPUSH_MPZ(res);
+    mpz_clear(n);
+    mpz_clear(res);
+#line 1795 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_absint); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_absint)
+{
+    dVAR; dXSARGS;
+    dXSI32;
+    if (items != 1)
+       croak_xs_usage(cv,  "strn");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 1021 "XS.xs"
+    mpz_t res;
+#line 1814 "XS.c"
+	char *	strn = (char *)SvPV_nolen(ST(0))
+;
+#line 1023 "XS.xs"
+    if (strn != 0 && strn[0] == '-') {
+      VALIDATE_AND_SET(res, strn+1);
+    } else {
+      VALIDATE_AND_SET(res, strn);
+      if (ix == 1) mpz_neg(res, res);
+    }
+    XPUSH_MPZ(res);
+    mpz_clear(res);
+#line 1826 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_signint); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_signint)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "strn");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 1034 "XS.xs"
+    mpz_t n;
+    int res;
+#line 1845 "XS.c"
+	char *	strn = (char *)SvPV_nolen(ST(0))
+;
+#line 1037 "XS.xs"
+    VALIDATE_AND_SET(n, strn);
+    res = mpz_sgn(n);
+    mpz_clear(n);
+    XSRETURN_IV(res);
+#line 1853 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_cmpint); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_cmpint)
+{
+    dVAR; dXSARGS;
+    dXSI32;
+    if (items != 2)
+       croak_xs_usage(cv,  "stra, strb");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 1046 "XS.xs"
+    mpz_t a, b;
+    int res;
+#line 1873 "XS.c"
+	char *	stra = (char *)SvPV_nolen(ST(0))
+;
+	char *	strb = (char *)SvPV_nolen(ST(1))
+;
+#line 1049 "XS.xs"
+    VALIDATE_AND_SET(a, stra);
+    VALIDATE_AND_SET(b, strb);
+    res = (ix == 0) ? mpz_cmp(a, b) : mpz_cmpabs(a, b);
+    mpz_clear(a);
+    mpz_clear(b);
+    XSRETURN_IV(res);
+#line 1885 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_setbit); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_setbit)
+{
+    dVAR; dXSARGS;
+    dXSI32;
+    if (items != 2)
+       croak_xs_usage(cv,  "strn, k");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 1062 "XS.xs"
+    mpz_t n;
+    int res;
+#line 1905 "XS.c"
+	char *	strn = (char *)SvPV_nolen(ST(0))
+;
+	UV	k = (UV)SvUV(ST(1))
+;
+#line 1065 "XS.xs"
+    VALIDATE_AND_SET(n, strn);
+    switch (ix) {
+      case 0:  mpz_setbit(n, k); break;
+      case 1:  mpz_clrbit(n, k); break;
+      case 2:  mpz_combit(n, k); break;
+      case 3:  res = mpz_tstbit(n, k); break;
+      default: break;
+    }
+    if (ix != 3) XPUSH_MPZ(n);
+    mpz_clear(n);
+    if (ix == 3) XSRETURN_UV(res);
+#line 1922 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_bitand); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_bitand)
+{
+    dVAR; dXSARGS;
+    dXSI32;
+    if (items != 2)
+       croak_xs_usage(cv,  "stra, strb");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 1082 "XS.xs"
+    mpz_t a, b;
+#line 1941 "XS.c"
+	char *	stra = (char *)SvPV_nolen(ST(0))
+;
+	char *	strb = (char *)SvPV_nolen(ST(1))
+;
+#line 1084 "XS.xs"
+    VALIDATE_AND_SET(a, stra);
+    VALIDATE_AND_SET(b, strb);
+    switch (ix) {
+      case 0:  mpz_and(a, a, b); break;
+      case 1:  mpz_ior(a, a, b); break;
+      case 2:  mpz_xor(a, a, b); break;
+      default: break;
+    }
+    XPUSH_MPZ(a);
+    mpz_clear(a);
+    mpz_clear(b);
+#line 1958 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_bitnot); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_bitnot)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "strn");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 1098 "XS.xs"
+    mpz_t n;
+#line 1976 "XS.c"
+	char *	strn = (char *)SvPV_nolen(ST(0))
+;
+#line 1100 "XS.xs"
+    VALIDATE_AND_SET(n, strn);
+    mpz_com(n, n);
+    XPUSH_MPZ(n);
+    mpz_clear(n);
+#line 1984 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_harmreal); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_harmreal)
+{
+    dVAR; dXSARGS;
+    dXSI32;
+    if (items < 1 || items > 2)
+       croak_xs_usage(cv,  "strn, prec= 40");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 1117 "XS.xs"
+    mpz_t n;
+    mpf_t f;
+    char* res;
+#line 2005 "XS.c"
+	char *	strn = (char *)SvPV_nolen(ST(0))
+;
+	UV	prec;
+
+	if (items < 2)
+	    prec = 40;
+	else {
+	    prec = (UV)SvUV(ST(1))
+;
+	}
+#line 1121 "XS.xs"
+    if (ix == 9) {  /* surround_primes */
+      UV prev, next;
+      VALIDATE_AND_SET(n, strn);
+      next = 1 + (mpz_sgn(n)==0);
+      if (mpz_cmp_ui(n,2) > 0) {
+        surround_primes(n, &prev, &next, (items == 1) ? 0 : prec);
+        XPUSHs(sv_2mortal(newSVuv(prev)));
+      } else {
+        XPUSHs(sv_2mortal(newSV(0)));
+      }
+      XPUSHs(sv_2mortal(newSVuv(next)));
+      mpz_clear(n);
+    } else if (ix <= 1) {
+      VALIDATE_AND_SET(n, strn);
+      res = (ix == 0) ? harmreal(n, prec) : bernreal(n, prec);
+      mpz_clear(n);
+      XPUSHs(sv_2mortal(newSVpv(res, 0)));
+      Safefree(res);
+    } else {
+      unsigned long bits  = 64 + (unsigned long)(3.32193 * prec);
+      unsigned long bits2 = 64 + (unsigned long)(3.32193 * strlen(strn));
+      if (bits2 > bits) bits = bits2;
+      mpf_init2(f, bits);
+      if (mpf_set_str(f, strn, 10) != 0)
+        croak("Not valid base-10 floating point input: %s", strn);
+      res = 0;
+      switch (ix) {
+        case 2:  res = logreal(f, prec); break;
+        case 3:  res = expreal(f, prec); break;
+        case 4:  res = zetareal(f, prec); break;
+        case 5:  res = lireal(f, prec); break;
+        case 6:  res = eireal(f, prec); break;
+        case 7:  res = riemannrreal(f, prec); break;
+        case 8:
+        default: res = lambertwreal(f, prec); break;
+      }
+      mpf_clear(f);
+      if (res == 0)
+        XSRETURN_UNDEF;
+      XPUSHs(sv_2mortal(newSVpv(res, 0)));
+      Safefree(res);
+    }
+#line 2059 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_powreal); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_powreal)
+{
+    dVAR; dXSARGS;
+    dXSI32;
+    if (items < 2 || items > 3)
+       croak_xs_usage(cv,  "strn, strx, prec= 40");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 1173 "XS.xs"
+    mpf_t n, x;
+    char* res;
+    unsigned long bits, bits2, bits3;
+#line 2080 "XS.c"
+	char *	strn = (char *)SvPV_nolen(ST(0))
+;
+	char *	strx = (char *)SvPV_nolen(ST(1))
+;
+	UV	prec;
+
+	if (items < 3)
+	    prec = 40;
+	else {
+	    prec = (UV)SvUV(ST(2))
+;
+	}
+#line 1177 "XS.xs"
+    bits  = 64 + (unsigned long)(3.32193 * prec);
+    bits2 = 64 + (unsigned long)(3.32193 * strlen(strn));
+    bits3 = 64 + (unsigned long)(3.32193 * strlen(strx));
+    if (bits2 > bits) bits = bits2;
+    if (bits3 > bits) bits = bits3;
+    mpf_init2(n, bits);
+    if (mpf_set_str(n, strn, 10) != 0)
+      croak("Not valid base-10 floating point input: %s", strn);
+    mpf_init2(x, bits);
+    if (mpf_set_str(x, strx, 10) != 0)
+      croak("Not valid base-10 floating point input: %s", strx);
+    if ( (ix == 0 && mpf_sgn(n) < 0 && !mpf_integer_p(x)) ||
+         (ix == 0 && mpf_sgn(n) == 0 && mpf_sgn(x) < 0) ||
+         (ix == 1 && mpf_sgn(x) == 0) ||
+         (ix == 1 && mpf_sgn(n) < 0 && mpf_cmp_ui(x,1)!=0 && mpf_cmp_si(x,-1)!=0) )
+      XSRETURN_UNDEF;
+    switch (ix) {
+      case 0:  res = powreal(n, x, prec);  break;
+      case 1:  res = rootreal(n, x, prec); break;
+      case 2:  res = agmreal(n, x, prec); break;
+      case 3:  res = addreal(n, x, prec); break;
+      case 4:  res = subreal(n, x, prec); break;
+      case 5:  res = mulreal(n, x, prec); break;
+      case 6:
+      default: res = divreal(n, x, prec);  break;
+    }
+    mpf_clear(n);
+    mpf_clear(x);
+    if (res == 0)
+      XSRETURN_UNDEF;
+    XPUSHs(sv_2mortal(newSVpv(res, 0)));
+    Safefree(res);
+#line 2126 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_bernvec); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_bernvec)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "n");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 1212 "XS.xs"
+    const mpz_t *N, *D;
+    UV i;
+#line 2145 "XS.c"
+	UV	n = (UV)SvUV(ST(0))
+;
+#line 1215 "XS.xs"
+    bernvec(&N, &D, n);  /* Cached array, do not destroy */
+    if (GIMME_V != G_VOID) {
+      EXTEND(SP, n+1);
+      for (i = 0; i <= n; i++) {
+        AV* av = newAV();
+        av_push(av, sv_return_for_mpz(N[i]));
+        av_push(av, sv_return_for_mpz(D[i]));
+        PUSHs( sv_2mortal(newRV_noinc( (SV*) av )) );
+      }
+    }
+#line 2159 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_gcd); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_gcd)
+{
+    dVAR; dXSARGS;
+    dXSI32;
+    PERL_UNUSED_VAR(cv); /* -W */
+    PERL_UNUSED_VAR(items); /* -W */
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 1234 "XS.xs"
+    int i, negflag;
+    mpz_t ret, n;
+#line 2179 "XS.c"
+#line 1237 "XS.xs"
+    if (items == 0) XSRETURN_IV( (ix == 1 || ix == 3) ? 1 : 0);
+    negflag = (ix <= 1) ? VSETNEG_POS : VSETNEG_OK;
+    if (ix == 1 || ix == 3) {
+      mpz_t* list;
+      New(0, list, items, mpz_t);
+      for (i = 0; i < items; i++) {
+        char* strn = SvPV_nolen(ST(i));
+        validate_and_set_signed(cv, list[i], "arg", strn, negflag);
+      }
+      if (ix == 1) mpz_veclcm(list, 0, items-1);
+      else         mpz_product(list, 0, items-1);
+      XPUSH_MPZ(list[0]);
+      for (i = 0; i < items; i++)  mpz_clear(list[i]);
+      Safefree(list);
+      XSRETURN(1);
+    }
+    mpz_init_set_ui(ret, (ix == 1 || ix == 3) ? 1 : 0);
+    for (i = 0; i < items; i++) {
+      char* strn = SvPV_nolen(ST(i));
+      validate_and_set_signed(cv, n, "arg", strn, negflag);
+      switch (ix) {
+        case 0:  mpz_gcd(ret, ret, n); break;
+        case 1:  mpz_lcm(ret, ret, n); break;
+        case 2:  mpz_add(ret, ret, n); break;
+        case 3:
+        default: mpz_mul(ret, ret, n); break;
+      }
+      mpz_clear(n);
+    }
+    XPUSH_MPZ(ret);
+    mpz_clear(ret);
+#line 2212 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_kronecker); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_kronecker)
+{
+    dVAR; dXSARGS;
+    dXSI32;
+    if (items != 2)
+       croak_xs_usage(cv,  "stra, strb");
+    {
+#line 1277 "XS.xs"
+    mpz_t a, b;
+#line 2229 "XS.c"
+	int	RETVAL;
+	dXSTARG;
+	char*	stra = (char *)SvPV_nolen(ST(0))
+;
+	char*	strb = (char *)SvPV_nolen(ST(1))
+;
+#line 1279 "XS.xs"
+    validate_and_set_signed(cv, a, "a", stra, VSETNEG_OK);
+    validate_and_set_signed(cv, b, "b", strb, VSETNEG_OK);
+    if (ix != 0) {
+      mpz_abs(a,a);
+      mpz_abs(b,b);
+    }
+    RETVAL = 0;
+    switch (ix) {
+      case 0: RETVAL = mpz_kronecker(a, b);
+              break;
+      case 1: if (mpz_cmp_ui(b,2) < 0)  croak("valuation: k must be > 1");
+              if (mpz_cmp_ui(a,0) == 0) XSRETURN_UNDEF;
+              RETVAL = (mpz_cmp_ui(b,2) == 0)  ?  mpz_scan1(a, 0)
+                                               :  mpz_remove(a, a, b);
+              break;
+      case 2: if (mpz_sgn(a) == 0) {
+                RETVAL = (mpz_fdiv_ui(b,4) == 3) ? _GMP_is_prime(b) : 0;
+              } else if (mpz_sgn(b) == 0) {
+                RETVAL = (mpz_fdiv_ui(a,4) == 3) ? _GMP_is_prime(a) : 0;
+              } else {
+                mpz_mul(a, a, a);
+                mpz_mul(b, b, b);
+                mpz_add(a, a, b);
+                RETVAL = (!mpz_cmp_ui(a,2))      ?  2
+                       : (mpz_fdiv_ui(a,4) == 1) ?  _GMP_is_prime(a)
+                                                 :  0;
+              }
+              break;
+      case 3: RETVAL = is_smooth(a, b);
+              break;
+      case 4: RETVAL = is_rough(a, b);
+              break;
+      default:break;
+    }
+    mpz_clear(b);
+    mpz_clear(a);
+#line 2273 "XS.c"
+	XSprePUSH;
+	PUSHi((IV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_moebius); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_moebius)
+{
+    dVAR; dXSARGS;
+    if (items < 1 || items > 2)
+       croak_xs_usage(cv,  "svn, stro= 0");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 1321 "XS.xs"
+    mpz_t n;
+#line 2292 "XS.c"
+	SV*	svn = ST(0)
+;
+	char*	stro;
+
+	if (items < 2)
+	    stro = 0;
+	else {
+	    stro = (char *)SvPV_nolen(ST(1))
+;
+	}
+#line 1323 "XS.xs"
+    if (IS_FACTORED_SV(svn) && stro == 0) {
+      factored_t F;
+      int result;
+      factored_from_sv(cv, &F, svn);
+      result = moebius_factored(&F);
+      factored_clear(&F);
+      XSRETURN_IV(result);
+    }
+    validate_and_set_signed(cv, n, "n", SvPV_nolen(svn), VSETNEG_OK);
+    if (stro == 0) {
+      int result = moebius(n);
+      mpz_clear(n);
+      XSRETURN_IV(result);
+    } else {   /* Ranged result */
+      mpz_t nhi;
+      factored_t *F;
+      UV i, len;
+      validate_and_set_signed(cv, nhi, "nhi", stro, VSETNEG_OK);
+      while (mpz_cmp(n, nhi) <= 0 && mpz_sgn(n) <= 0) {
+        XPUSHs(sv_2mortal(newSViv( moebius(n) )));
+        mpz_add_ui(n, n, 1);
+      }
+      while ((len = range_block_len(n, nhi)) > 0) {
+        F = factor_range(n, len);
+        EXTEND(SP, (IV)len);
+        for (i = 0; i < len; i++)
+          PUSHs(sv_2mortal(newSViv( moebius_factored(F+i) )));
+        factor_range_free(F, len);
+        mpz_add_ui(n, n, len);
+      }
+      mpz_clear(n);
+      mpz_clear(nhi);
+    }
+#line 2337 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_totient_range); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_totient_range)
+{
+    dVAR; dXSARGS;
+    dXSI32;
+    if (items != 2)
+       croak_xs_usage(cv,  "strlo, strhi");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 1366 "XS.xs"
+    mpz_t lo, hi, res;
+    factored_t *F;
+    UV i, len;
+#line 2358 "XS.c"
+	char*	strlo = (char *)SvPV_nolen(ST(0))
+;
+	char*	strhi = (char *)SvPV_nolen(ST(1))
+;
+#line 1370 "XS.xs"
+    VALIDATE_AND_SET(lo, strlo);
+    VALIDATE_AND_SET(hi, strhi);
+    mpz_init(res);
+    if (mpz_sgn(lo) == 0 && mpz_cmp(lo, hi) <= 0) {
+      switch (ix) {
+        case 0:  XPUSHs(sv_2mortal(newSVuv(0)));  break;
+        case 1:  XPUSHs(sv_2mortal(newSViv(-1)));  break;
+        case 2:
+        case 3:  XPUSHs(sv_2mortal(newSVuv(1)));  break;
+        case 4:
+        case 5:
+        default: XPUSHs(sv_2mortal(newSVuv(0)));  break;
+      }
+      mpz_add_ui(lo, lo, 1);
+    }
+    while ((len = range_block_len(lo, hi)) > 0) {
+      F = factor_range(lo, len);
+      EXTEND(SP, (IV)len);
+      for (i = 0; i < len; i++) {
+        switch (ix) {
+          case 0:  totient_factored(res, F+i);
+                   PUSHs(sv_2mortal(sv_return_for_mpz(res)));
+                   break;
+          case 1:  PUSHs(sv_2mortal(newSViv(liouville_factored(F+i))));  break;
+          case 2:  PUSHs(sv_2mortal(newSVuv(omega_factored(F+i))));  break;
+          case 3:  PUSHs(sv_2mortal(newSVuv(bigomega_factored(F+i))));  break;
+          case 4:  PUSHs(sv_2mortal(newSVuv(bigomega_factored(F+i) == 2)));  break;
+          case 5:
+          default: carmichael_lambda_factored(res, F+i);
+                   PUSHs(sv_2mortal(sv_return_for_mpz(res)));
+                   break;
+        }
+      }
+      factor_range_free(F, len);
+      mpz_add_ui(lo, lo, len);
+    }
+    mpz_clear(res);
+    mpz_clear(hi);
+    mpz_clear(lo);
+#line 2403 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_sigma_range); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_sigma_range)
+{
+    dVAR; dXSARGS;
+    if (items < 2 || items > 3)
+       croak_xs_usage(cv,  "strlo, strhi, k= 1");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 1413 "XS.xs"
+    mpz_t lo, hi, res;
+    factored_t *F;
+    UV i, len;
+#line 2423 "XS.c"
+	char*	strlo = (char *)SvPV_nolen(ST(0))
+;
+	char*	strhi = (char *)SvPV_nolen(ST(1))
+;
+	UV	k;
+
+	if (items < 3)
+	    k = 1;
+	else {
+	    k = (UV)SvUV(ST(2))
+;
+	}
+#line 1417 "XS.xs"
+    VALIDATE_AND_SET(lo, strlo);
+    VALIDATE_AND_SET(hi, strhi);
+    mpz_init(res);
+    if (mpz_sgn(lo) == 0 && mpz_cmp(lo, hi) <= 0) {
+      sigma(res, lo, k);
+      XPUSH_MPZ(res);
+      mpz_add_ui(lo, lo, 1);
+    }
+    while ((len = range_block_len(lo, hi)) > 0) {
+      F = factor_range(lo, len);
+      EXTEND(SP, (IV)len);
+      for (i = 0; i < len; i++) {
+        sigma_factored(res, F+i, k);
+        PUSHs(sv_2mortal(sv_return_for_mpz(res)));
+      }
+      factor_range_free(F, len);
+      mpz_add_ui(lo, lo, len);
+    }
+    mpz_clear(res);
+    mpz_clear(hi);
+    mpz_clear(lo);
+#line 2458 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_lucasu); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_lucasu)
+{
+    dVAR; dXSARGS;
+    dXSI32;
+    if (items != 3)
+       croak_xs_usage(cv,  "strp, strq, strk");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 1444 "XS.xs"
+    mpz_t u, v, p, q, k;
+#line 2477 "XS.c"
+	char *	strp = (char *)SvPV_nolen(ST(0))
+;
+	char *	strq = (char *)SvPV_nolen(ST(1))
+;
+	char *	strk = (char *)SvPV_nolen(ST(2))
+;
+#line 1446 "XS.xs"
+    validate_and_set_signed(cv, p, "P", strp, VSETNEG_OK);
+    validate_and_set_signed(cv, q, "Q", strq, VSETNEG_OK);
+    VALIDATE_AND_SET(k, strk);
+    mpz_init(u);  mpz_init(v);
+    lucasuv(u, v, p, q, k);
+    switch (ix) {
+      case 0:  XPUSH_MPZ(u);  break;
+      case 1:  XPUSH_MPZ(v);  break;
+      case 2:
+      default: XPUSH_MPZ(u);  XPUSH_MPZ(v); break;
+    }
+    mpz_clear(v); mpz_clear(u);
+    mpz_clear(k); mpz_clear(q); mpz_clear(p);
+#line 2498 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_lucasumod); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_lucasumod)
+{
+    dVAR; dXSARGS;
+    dXSI32;
+    if (items != 4)
+       croak_xs_usage(cv,  "strp, strq, strk, strn");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 1465 "XS.xs"
+    mpz_t u, v, t, p, q, k, n;
+#line 2517 "XS.c"
+	char *	strp = (char *)SvPV_nolen(ST(0))
+;
+	char *	strq = (char *)SvPV_nolen(ST(1))
+;
+	char *	strk = (char *)SvPV_nolen(ST(2))
+;
+	char *	strn = (char *)SvPV_nolen(ST(3))
+;
+#line 1467 "XS.xs"
+    validate_and_set_signed(cv, p, "P", strp, VSETNEG_OK);
+    validate_and_set_signed(cv, q, "Q", strq, VSETNEG_OK);
+    VALIDATE_AND_SET(k, strk);
+    VALIDATE_AND_SET(n, strn);
+    mpz_init(t);
+    if (ix == 0 || ix == 2) mpz_init(u);
+    if (ix == 1 || ix == 2) mpz_init(v);
+    switch (ix) {
+      case 0:  lucasumod(u, p, q, k, n, t);  XPUSH_MPZ(u);  break;
+      case 1:  lucasvmod(v, p, q, k, n, t);  XPUSH_MPZ(v);  break;
+      case 2:
+      default: lucasuvmod(u, v, p, q, k, n, t);
+               XPUSH_MPZ(u);  XPUSH_MPZ(v);
+               break;
+    }
+    if (ix == 0 || ix == 2) mpz_clear(u);
+    if (ix == 1 || ix == 2) mpz_clear(v);
+    mpz_clear(t);
+    mpz_clear(n); mpz_clear(k); mpz_clear(q); mpz_clear(p);
+#line 2546 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_liouville); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_liouville)
+{
+    dVAR; dXSARGS;
+    dXSI32;
+    if (items != 1)
+       croak_xs_usage(cv,  "svn");
+    {
+#line 1500 "XS.xs"
+    mpz_t n;
+    int isneg;
+#line 2564 "XS.c"
+	int	RETVAL;
+	dXSTARG;
+	SV*	svn = ST(0)
+;
+#line 1503 "XS.xs"
+    if (IS_FACTORED_SV(svn) && (ix == 0 || ix == 2 || ix == 4 || ix == 8 || ix == 9)) {
+      factored_t F;
+      factored_from_sv(cv, &F, svn);
+      switch (ix) {
+        case 0:  RETVAL = liouville_factored(&F);  break;
+        case 2:  RETVAL = (bigomega_factored(&F) == 2);  break;
+        case 4:  RETVAL = is_carmichael_factored(&F);  break;
+        case 8:  RETVAL = omega_factored(&F);  break;
+        case 9:
+        default: RETVAL = bigomega_factored(&F);  break;
+      }
+      factored_clear(&F);
+      XSRETURN_IV(RETVAL);
+    }
+    isneg = validate_and_set_signed( cv, n, "n", SvPV_nolen(svn),
+                                     (ix == 0) ? VSETNEG_ERR
+                                   : (ix  < 7) ? VSETNEG_OK
+                                   :             VSETNEG_POS );
+    if (isneg && (ix >= 1 && ix <= 5)) {
+      RETVAL = 0;
+    } else {
+      switch (ix) {
+        case 0:  RETVAL = liouville(n);      break;
+        case 1:  RETVAL = is_power(n,2);     break;
+        case 2:  RETVAL = is_semiprime(n);   break;
+        case 3:  RETVAL = is_totient(n);     break;
+        case 4:  RETVAL = is_carmichael(n);  break;
+        case 5:  RETVAL = is_practical(n);   break;
+        case 6:  RETVAL = is_fundamental(n); break;
+        case 7:  RETVAL = mpz_popcount(n);   break;
+        case 8:  RETVAL = omega(n);          break;
+        case 9:
+        default: RETVAL = bigomega(n);       break;
+      }
+    }
+    mpz_clear(n);
+#line 2606 "XS.c"
+	XSprePUSH;
+	PUSHi((IV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_is_powerful); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_is_powerful)
+{
+    dVAR; dXSARGS;
+    if (items < 1 || items > 2)
+       croak_xs_usage(cv,  "strn, k= 0");
+    {
+#line 1545 "XS.xs"
+    mpz_t n;
+#line 2623 "XS.c"
+	int	RETVAL;
+	dXSTARG;
+	char*	strn = (char *)SvPV_nolen(ST(0))
+;
+	UV	k;
+
+	if (items < 2)
+	    k = 0;
+	else {
+	    k = (UV)SvUV(ST(1))
+;
+	}
+#line 1547 "XS.xs"
+    VALIDATE_AND_SET(n, strn);
+    RETVAL = is_powerful(n, (k == 0) ? 2 : k);
+    mpz_clear(n);
+#line 2640 "XS.c"
+	XSprePUSH;
+	PUSHi((IV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_invmod); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_invmod)
+{
+    dVAR; dXSARGS;
+    dXSI32;
+    if (items != 2)
+       croak_xs_usage(cv,  "stra, svb");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 1580 "XS.xs"
+    mpz_t a, b, t;
+    int retundef;
+#line 2661 "XS.c"
+	char*	stra = (char *)SvPV_nolen(ST(0))
+;
+	SV*	svb = ST(1)
+;
+#line 1583 "XS.xs"
+    if (IS_FACTORED_SV(svb) && (ix == 3 || ix == 4)) {
+      factored_t F;
+      /* Check a before F is made, and set it after, so a croak leaks nothing */
+      validate_string_number(cv, "a", (*stra == '+' || *stra == '-') ? stra+1 : stra);
+      factored_from_sv(cv, &F, svb);
+      validate_and_set_signed(cv, a, "a", stra, VSETNEG_OK);
+      if (ix == 3)  jordan_totient_factored(a, &F, mpz_get_ui(a));
+      else          znorder_factored(a, a, &F);
+      factored_clear(&F);
+      if (ix == 4 && !mpz_sgn(a)) { mpz_clear(a); XSRETURN_UNDEF; }
+      XPUSH_MPZ(a);
+      mpz_clear(a);
+      XSRETURN(1);
+    }
+    validate_and_set_signed(cv, a, "a", stra, VSETNEG_OK);
+    validate_and_set_signed(cv, b, "b", SvPV_nolen(svb), VSETNEG_OK);
+    retundef = 0;
+    switch (ix) {
+               /* undef if a|b = 0, 0 if b is 1, else result of mpz_invert */
+      case 0:{ if (!mpz_sgn(b) || !mpz_sgn(a))  retundef = 1;
+               else if (!mpz_cmp_ui(b,1))       mpz_set_ui(a,0);
+               else                             retundef = !mpz_invert(a,a,b);
+             } break;
+      case 1:{ unsigned long n, k;
+               if (mpz_sgn(b) < 0) {   /* Handle negative k */
+                 if (mpz_sgn(a) >= 0 || mpz_cmp(b,a) > 0)  mpz_set_ui(a, 0);
+                 else                                      mpz_sub(b, a, b);
+               }
+               n = mpz_get_ui(a);
+               k = mpz_get_ui(b);
+               if (k > n || k == 0 || k == n || mpz_sgn(a) < 0) {
+                 mpz_bin_ui(a, a, k);
+               } else {
+                 if (k > n/2) k = n-k;
+                 /* Note: mpz_bin_uiui is *much* faster than mpz_bin_ui.
+                  * It is a bit faster than our code for small values, and
+                  * a tiny bit slower for larger values. */
+                 if (n > 50000 && k > 1000)  binomial(a, n, k);
+                 else                        mpz_bin_uiui(a, n, k);
+               }
+             } break;
+      case 2:{ mpz_init(t);
+               if (mpz_sgn(a) == 0 && mpz_sgn(b) == 0) {
+                 mpz_set_ui(t, 0);  /* This changed in GMP 5.1.2.  Enforce new result. */
+               } else {
+                 gcdext(a, t, b, a, b);
+               }
+               XPUSH_MPZ(t);  XPUSH_MPZ(b);
+               mpz_clear(t);
+             } break;
+      case 3: jordan_totient(a, b, mpz_get_ui(a));
+              break;
+      case 4: znorder(a, a, b);
+              if (!mpz_sgn(a)) retundef = 1;
+              break;
+      case 5: mpz_abs(b, b);
+              retundef = !sqrtmod(a, a, b);
+              break;
+      case 6: mpz_set_si(a, is_primitive_root(a, b, 0) );
+              break;
+      case 7: if (mpz_cmp_ui(b,3) < 0) croak("is_polygonal: k must be >= 3");
+              polygonal_nth(a, a, b);
+              mpz_set_si(a, mpz_sgn(a));
+              break;
+      case 8: if (mpz_cmp_ui(b,3) < 0) croak("polygonal_nth: k must be >= 3");
+              polygonal_nth(a, a, b);
+              break;
+      case 9: if (mpz_sgn(b) <= 0) croak("rootint: k must be > 0");
+              if (mpz_sgn(a) <  0) croak("rootint: n must be >= 0");
+              mpz_root(a, a, mpz_get_ui(b));
+              break;
+      case 10:if (mpz_cmp_ui(b,2) < 0) croak("rootint: base must be > 1");
+              if (mpz_sgn(a) <=  0) croak("rootint: n must be > 0");
+              mpz_set_uv(a, logint(a, mpz_get_uv(b)));
+              break;
+      case 11:if (mpz_sgn(b) < 0) croak("powint: exponent must be >= 0");
+              mpz_pow_ui(a, a, mpz_get_ui(b));
+              break;
+      case 12:mpz_mul(a, a, b);
+              break;
+      case 13:mpz_add(a, a, b);
+              break;
+      case 14:mpz_sub(a, a, b);
+              break;
+      case 15:if (mpz_sgn(b) == 0) croak("divint: divide by zero");
+              mpz_fdiv_q(a, a, b);
+              break;
+      case 16:if (mpz_sgn(b) == 0) croak("modint: divide by zero");
+              mpz_fdiv_r(a, a, b);
+              break;
+      case 17:if (mpz_sgn(b) == 0) croak("cdivint: divide by zero");
+              mpz_cdiv_q(a, a, b);
+              break;
+      case 18:if (mpz_sgn(b) == 0) croak("tdivrem: divide by zero");
+              mpz_tdiv_qr(b, a, a, b);  /* t is t-quotient, a is t-remainder */
+              XPUSH_MPZ(b);
+              break;
+      case 19:if (mpz_sgn(b) == 0) croak("fdivrem: divide by zero");
+              mpz_fdiv_qr(b, a, a, b);  /* t is f-quotient, a is f-remainder */
+              XPUSH_MPZ(b);
+              break;
+      case 20:if (mpz_sgn(b) == 0) croak("cdivrem: divide by zero");
+              mpz_cdiv_qr(b, a, a, b);  /* t is c-quotient, a is c-remainder */
+              XPUSH_MPZ(b);
+              break;
+      case 21:mpz_init_set(t, b);
+              if (mpz_sgn(b) == 0) croak("divrem: divide by zero");
+              mpz_tdiv_qr(t, a, a, b);  /* t is t-quotient, a is t-remainder */
+              if (mpz_sgn(a) < 0) {  /* Change from trunc to Euclidean */
+                if (mpz_sgn(b) > 0) {
+                  mpz_sub_ui(t, t, 1);
+                  mpz_add(a, a, b);
+                } else {
+                  mpz_add_ui(t, t, 1);
+                  mpz_sub(a, a, b);
+                }
+              }
+              XPUSH_MPZ(t);
+              mpz_clear(t);
+              break;
+      case 22:if (mpz_sgn(b) < 0) retundef = 1;
+              else                factorialmod(a, mpz_get_ui(a), b);
+              break;
+      case 23:
+      default:if (mpz_sgn(a) < 0 || mpz_sgn(b) < 0) retundef = 1;
+              else                multifactorial(a, mpz_get_ui(a), mpz_get_ui(b));
+              break;
+
+    }
+    if (!retundef) XPUSH_MPZ(a);
+    mpz_clear(b); mpz_clear(a);
+    if (retundef) XSRETURN_UNDEF;
+#line 2799 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_is_qr); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_is_qr)
+{
+    dVAR; dXSARGS;
+    if (items != 2)
+       croak_xs_usage(cv,  "stra, strn");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 1718 "XS.xs"
+    mpz_t a, n;
+    int retval;
+#line 2818 "XS.c"
+	int	RETVAL;
+	dXSTARG;
+	char *	stra = (char *)SvPV_nolen(ST(0))
+;
+	char *	strn = (char *)SvPV_nolen(ST(1))
+;
+#line 1721 "XS.xs"
+    validate_and_set_signed(cv, a, "a", stra, VSETNEG_OK);
+    validate_and_set_signed(cv, n, "n", strn, VSETNEG_OK);
+    retval = -1;
+    if (mpz_sgn(n) != 0) {
+      mpz_abs(n,n);
+      retval = sqrtmod(a,a,n);
+    }
+    mpz_clear(n); mpz_clear(a);
+    if (retval == -1)
+      XSRETURN_UNDEF;
+    else
+      XSRETURN_IV(retval);
+#line 2838 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_powersum); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_powersum)
+{
+    dVAR; dXSARGS;
+    dXSI32;
+    if (items != 2)
+       croak_xs_usage(cv,  "stra, strb");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 1738 "XS.xs"
+    mpz_t a, b;
+#line 2857 "XS.c"
+	char *	stra = (char *)SvPV_nolen(ST(0))
+;
+	char *	strb = (char *)SvPV_nolen(ST(1))
+;
+#line 1740 "XS.xs"
+    validate_and_set_signed(cv, a, "a", stra, VSETNEG_OK);
+    validate_and_set_signed(cv, b, "b", strb, VSETNEG_OK);
+    if (mpz_sgn(a) < 0 || mpz_sgn(b) < 0) croak("powersum: negative argument");
+    if (ix == 0 || ix == 1)
+      faulhaber_sum(a, a, mpz_get_ui(b));
+    XPUSH_MPZ(a);
+    mpz_clear(b); mpz_clear(a);
+#line 2870 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_lshiftint); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_lshiftint)
+{
+    dVAR; dXSARGS;
+    dXSI32;
+    if (items < 1 || items > 2)
+       croak_xs_usage(cv,  "strn, k= 1");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 1754 "XS.xs"
+    mpz_t n;
+#line 2889 "XS.c"
+	char*	strn = (char *)SvPV_nolen(ST(0))
+;
+	unsigned long	k;
+
+	if (items < 2)
+	    k = 1;
+	else {
+	    k = (unsigned long)SvUV(ST(1))
+;
+	}
+#line 1756 "XS.xs"
+    validate_and_set_signed(cv, n, "n", strn, VSETNEG_OK);
+    switch (ix) {
+      case 0:  mpz_mul_2exp(n, n, k);      break;
+      case 1:  mpz_tdiv_q_2exp(n, n, k);   break;
+      case 2:
+      default: mpz_fdiv_q_2exp(n, n, k);   break;
+    }
+    XPUSH_MPZ(n);
+    mpz_clear(n);
+#line 2910 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_powerful_count); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_powerful_count)
+{
+    dVAR; dXSARGS;
+    if (items < 1 || items > 2)
+       croak_xs_usage(cv,  "strn, k= 2");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 1769 "XS.xs"
+    mpz_t n, r;
+#line 2928 "XS.c"
+	char*	strn = (char *)SvPV_nolen(ST(0))
+;
+	int	k;
+
+	if (items < 2)
+	    k = 2;
+	else {
+	    k = (int)SvIV(ST(1))
+;
+	}
+#line 1771 "XS.xs"
+    validate_and_set_signed(cv, n, "n", strn, VSETNEG_ERR);
+    mpz_init(r);
+    powerful_count(r, n, (unsigned long) k);
+    XPUSH_MPZ(r);
+    mpz_clear(r);
+    mpz_clear(n);
+#line 2946 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_addmod); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_addmod)
+{
+    dVAR; dXSARGS;
+    dXSI32;
+    if (items != 3)
+       croak_xs_usage(cv,  "stra, strb, strn");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 1786 "XS.xs"
+    mpz_t a, b, n;
+    int retundef;
+#line 2966 "XS.c"
+	char*	stra = (char *)SvPV_nolen(ST(0))
+;
+	char*	strb = (char *)SvPV_nolen(ST(1))
+;
+	char*	strn = (char *)SvPV_nolen(ST(2))
+;
+#line 1789 "XS.xs"
+    validate_and_set_signed(cv, a, "a", stra, VSETNEG_OK);
+    validate_and_set_signed(cv, b, "b", strb, VSETNEG_OK);
+    validate_and_set_signed(cv, n, "n", strn, VSETNEG_ERR);
+    retundef = (mpz_sgn(n) <= 0);
+    if (!retundef && ix == 4) {
+      if (mpz_cmp_ui(n,1) > 0) {  /* if n is 1, let the mod turn it into zero */
+        mpz_mod(b, b, n);         /* Get b between 0 and n-1. */
+        if (mpz_sgn(b) == 0)           retundef = 1;
+        else if (mpz_cmp_ui(b,1) > 0)  retundef = !mpz_invert(b,b,n);
+      }
+    }
+    if (!retundef && ix == 3 && mpz_sgn(b) < 0) {
+      if (!mpz_cmp_ui(n,1))       mpz_set_ui(b,0);
+      else                        retundef = !mpz_invert(a,a,n);
+      mpz_abs(b,b);
+    }
+    if (retundef) {
+      mpz_clear(n); mpz_clear(b); mpz_clear(a);
+      XSRETURN_UNDEF;
+    }
+    if (ix == 0) {
+      mpz_add(a,a,b);
+      mpz_mod(a,a,n);
+    } else if (ix == 1) {
+      mpz_sub(a,a,b);
+      mpz_mod(a,a,n);
+    } else if (ix == 2 || ix == 4) {
+      mpz_mul(a,a,b);
+      mpz_mod(a,a,n);
+    } else if (ix == 3) {
+      mpz_powm(a, a, b, n);
+    }
+    XPUSH_MPZ(a);
+    mpz_clear(n); mpz_clear(b); mpz_clear(a);
+#line 3008 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_muladdmod); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_muladdmod)
+{
+    dVAR; dXSARGS;
+    dXSI32;
+    if (items != 4)
+       croak_xs_usage(cv,  "stra, strb, strc, strn");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 1828 "XS.xs"
+    mpz_t a, b, c, n;
+#line 3027 "XS.c"
+	char *	stra = (char *)SvPV_nolen(ST(0))
+;
+	char *	strb = (char *)SvPV_nolen(ST(1))
+;
+	char *	strc = (char *)SvPV_nolen(ST(2))
+;
+	char *	strn = (char *)SvPV_nolen(ST(3))
+;
+#line 1830 "XS.xs"
+    validate_and_set_signed(cv, a, "a", stra, VSETNEG_OK);
+    validate_and_set_signed(cv, b, "b", strb, VSETNEG_OK);
+    validate_and_set_signed(cv, c, "c", strc, VSETNEG_OK);
+    validate_and_set_signed(cv, n, "n", strn, VSETNEG_ERR);
+    if (mpz_sgn(n) <= 0) {
+      mpz_clear(n); mpz_clear(c); mpz_clear(b); mpz_clear(a);
+      XSRETURN_UNDEF;
+    }
+    mpz_mul(a,a,b);
+    if (ix == 0)  mpz_add(a, a, c);
+    else          mpz_sub(a, a, c);
+    mpz_mod(a,a,n);
+    XPUSH_MPZ(a);
+    mpz_clear(n); mpz_clear(c); mpz_clear(b); mpz_clear(a);
+#line 3051 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_is_mersenne_prime); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_is_mersenne_prime)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "n");
+    {
+	int	RETVAL;
+	dXSTARG;
+	UV	n = (UV)SvUV(ST(0))
+;
+#line 1848 "XS.xs"
+    RETVAL = lucas_lehmer(n);
+#line 3071 "XS.c"
+	XSprePUSH;
+	PUSHi((IV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_Pi); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_Pi)
+{
+    dVAR; dXSARGS;
+    dXSI32;
+    if (items != 1)
+       croak_xs_usage(cv,  "n");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 1857 "XS.xs"
+    UV prec;
+#line 3091 "XS.c"
+	UV	n = (UV)SvUV(ST(0))
+;
+#line 1859 "XS.xs"
+    if (ix == 2) {  /* random_bytes */
+      char* sptr;
+      SV* sv = newSV(n == 0 ? 1 : n);
+      SvPOK_only(sv);
+      SvCUR_set(sv, n);
+      sptr = SvPVX(sv);
+      isaac_rand_bytes(n, (unsigned char*)sptr);
+      sptr[n] = '\0';
+      PUSHs(sv_2mortal(sv));
+      XSRETURN(1);
+    }
+    if (ix == 0 && n == 0) XSRETURN(0);
+    if (ix == 0 && n == 1) XSRETURN_IV(3);
+    if (ix == 1 && n == 0) XSRETURN_IV(1);
+    prec = (ix == 0) ? n+1 : n+2;
+    if (GIMME_V == G_VOID) {
+      mpf_t c;
+      mpf_init2(c, 7+prec*3.32193);
+      if (ix == 0)  const_pi(c, prec);
+      else          const_euler(c, prec);
+      mpf_clear(c);
+    } else {
+      char* cstr = (ix == 0) ? piconst(n) : eulerconst(n);
+      XPUSHs(sv_2mortal(newSVpvn(cstr, prec)));
+      Safefree(cstr);
+    }
+#line 3121 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_random_nbit_prime); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_random_nbit_prime)
+{
+    dVAR; dXSARGS;
+    dXSI32;
+    if (items != 1)
+       croak_xs_usage(cv,  "n");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 1904 "XS.xs"
+    mpz_t p;
+    char* proof;
+#line 3141 "XS.c"
+	UV	n = (UV)SvUV(ST(0))
+;
+#line 1907 "XS.xs"
+    if (ix == 8 && n <= BITS_PER_WORD) {
+      UV v = irand64(n);
+      ST(0) = sv_2mortal(newSVuv(v));
+      XSRETURN(1);
+    }
+    mpz_init(p);
+    proof = 0;
+    switch (ix) {
+      case 0:  mpz_random_nbit_prime(p, n); break;
+      case 1:  mpz_random_safe_prime(p, n); break;
+      case 2:  mpz_random_strong_prime(p, n); break;
+      case 3:  mpz_random_maurer_prime(p, n, 0); break;
+      case 4:  mpz_random_maurer_prime(p, n, &proof);
+               proof = cert_with_header(proof, p);
+               break;
+      case 5:  mpz_random_shawe_taylor_prime(p, n, 0); break;
+      case 6:  mpz_random_shawe_taylor_prime(p, n, &proof);
+               proof = cert_with_header(proof, p);
+               break;
+      case 7:  mpz_random_ndigit_prime(p, n); break;
+      case 8:  mpz_isaac_urandomb(p, n); break;
+      case 9:  mpz_fac_ui(p, n); break;   /* swing impl in 5.1+, so fast */
+      case 10: factorial_sum(p, n); break;
+      case 11: subfactorial(p, n); break;
+      case 12: partitions(p, n); break;
+      case 13: _GMP_primorial(p, n);  break;
+      case 14: _GMP_pn_primorial(p, n);  break;
+      case 15:
+      default: consecutive_integer_lcm(p, n);  break;
+    }
+    XPUSH_MPZ(p);
+    mpz_clear(p);
+    if (proof) {
+      XPUSHs(sv_2mortal(newSVpv(proof, 0)));
+      Safefree(proof);
+    }
+#line 3181 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_stirling); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_stirling)
+{
+    dVAR; dXSARGS;
+    if (items < 2 || items > 3)
+       croak_xs_usage(cv,  "n, m, type= 1");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 1947 "XS.xs"
+    mpz_t r;
+#line 3199 "XS.c"
+	UV	n = (UV)SvUV(ST(0))
+;
+	UV	m = (UV)SvUV(ST(1))
+;
+	UV	type;
+
+	if (items < 3)
+	    type = 1;
+	else {
+	    type = (UV)SvUV(ST(2))
+;
+	}
+#line 1949 "XS.xs"
+    mpz_init(r);
+    stirling(r, n, m, type);
+    XPUSH_MPZ( r );
+    mpz_clear(r);
+#line 3217 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_chinese); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_chinese)
+{
+    dVAR; dXSARGS;
+    dXSI32;
+    PERL_UNUSED_VAR(cv); /* -W */
+    PERL_UNUSED_VAR(items); /* -W */
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 1959 "XS.xs"
+    int i, doretval;
+    mpz_t* an;
+    mpz_t ret, lcm;
+#line 3238 "XS.c"
+#line 1963 "XS.xs"
+    if (items == 0) {
+      if (ix == 0)  XSRETURN_UV(0);
+      XPUSHs(sv_2mortal(newSVuv( 0 )));
+      XPUSHs(sv_2mortal(newSVuv( 0 )));
+      XSRETURN(2);
+    }
+    mpz_init_set_ui(ret, 0);
+    New(0, an, 2*items, mpz_t);
+    for (i = 0; i < items; i++) {
+      AV* av;
+      SV** psva;
+      SV** psvn;
+      char* strn;
+      if (!SvROK(ST(i)) || SvTYPE(SvRV(ST(i))) != SVt_PVAV || av_len((AV*)SvRV(ST(i))) != 1)
+        croak("chinese arguments are two-element array references");
+      av = (AV*) SvRV(ST(i));
+      psva = av_fetch(av, 0, 0);
+      psvn = av_fetch(av, 1, 0);
+
+      strn = SvPV_nolen(*psva);
+      validate_and_set_signed(cv, an[i+0], "a", strn, VSETNEG_OK);
+
+      strn = SvPV_nolen(*psvn);
+      validate_and_set_signed(cv, an[i+items], "b", strn, VSETNEG_OK);
+    }
+    mpz_init(lcm);
+    doretval = chinese(ret, lcm, an, an+items, items);
+    if (doretval) {
+      XPUSH_MPZ(ret);
+      if (ix == 1) XPUSH_MPZ(lcm);
+    }
+    for (i = 0; i < items; i++) {
+      mpz_clear(an[i+0]);
+      mpz_clear(an[i+items]);
+    }
+    Safefree(an);
+    mpz_clear(lcm);
+    mpz_clear(ret);
+    if (!doretval) {
+      if (ix == 0) {
+        XSRETURN_UNDEF;
+      } else {
+        XPUSHs(&PL_sv_undef);
+        XPUSHs(&PL_sv_undef);
+        XSRETURN(2);
+      }
+    }
+#line 3287 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_permtonum); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_permtonum)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "svp");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 2014 "XS.xs"
+    AV *av;
+    char* seen;
+    UV val, *V;
+    int plen, n, i, j, k;
+    mpz_t f, t, num;
+#line 3309 "XS.c"
+	SV*	svp = ST(0)
+;
+#line 2020 "XS.xs"
+    if ((!SvROK(svp)) || (SvTYPE(SvRV(svp)) != SVt_PVAV))
+      croak("permtonum argument must be an array reference");
+    av = (AV*) SvRV(svp);
+    plen = av_len(av);
+    if (plen < 0) XSRETURN_IV(0);
+    Newz(0, seen, plen+1, char);
+    New(0, V, plen+1, UV);
+    for (i = 0; i <= plen; i++) {
+      SV **iv = av_fetch(av, i, 0);
+      if (iv == 0) break;
+      val = SvUV(*iv);
+      if (val > (UV)plen || seen[val] != 0) break;
+      seen[val] = 1;
+      V[i] = val;
+    }
+    Safefree(seen);
+    if (i <= plen)
+      croak("permtonum invalid permutation array");
+
+    mpz_init(f);  mpz_init(t);
+    mpz_init_set_ui(num, 0);
+    n = plen+1;
+    mpz_fac_ui(f, n-1);
+    for (i = 0; i < n-1; i++) {
+      for (j = i+1, k = 0; j < n; j++)
+        if (V[j] < V[i])
+          k++;
+      mpz_mul_ui(t, f, k);
+      mpz_add(num, num, t);
+      mpz_divexact_ui(f, f, n-i-1);
+    }
+    Safefree(V);
+    XPUSH_MPZ(num);
+    mpz_clear(num);  mpz_clear(t);  mpz_clear(f);
+#line 3347 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_numtoperm); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_numtoperm)
+{
+    dVAR; dXSARGS;
+    if (items != 2)
+       croak_xs_usage(cv,  "n, strk");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 2057 "XS.xs"
+    mpz_t k, f, p;
+    UV i, j, tv, *perm;
+#line 3366 "XS.c"
+	UV	n = (UV)SvUV(ST(0))
+;
+	char *	strk = (char *)SvPV_nolen(ST(1))
+;
+#line 2060 "XS.xs"
+    if (n == 0)
+      XSRETURN_EMPTY;
+    validate_and_set_signed(cv, k, "k", strk, VSETNEG_OK);
+    mpz_init(f);  mpz_init(p);
+    New(0, perm, n, UV);
+    for (i = 0; i < n; i++)
+      perm[i] = i;
+    mpz_fac_ui(f, n);
+    mpz_mod(k,k,f);
+    for (i = 0; i < n-1; i++) {
+      mpz_divexact_ui(f, f, n-i);
+      mpz_tdiv_qr(p, k, k, f);
+      if (mpz_sgn(p)) {
+        for (j = i + mpz_get_ui(p), tv = perm[j]; j > i; j--)
+          perm[j] = perm[j-1];
+        perm[i] = tv;
+      }
+    }
+    EXTEND(SP, (IV)n);
+    for (i = 0; i < n; i++)
+      PUSHs(sv_2mortal(newSVuv( perm[i] )));
+    Safefree(perm);
+    mpz_clear(p);  mpz_clear(f); mpz_clear(k);
+#line 3395 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_sieve_prime_cluster); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_sieve_prime_cluster)
+{
+    dVAR; dXSARGS;
+    dXSI32;
+    if (items < 2)
+       croak_xs_usage(cv,  "strlow, strhigh, ...");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 2090 "XS.xs"
+    mpz_t low, seghigh, high, t;
+    UV i, nc, nprimes, maxseg, *list;
+#line 3415 "XS.c"
+	char*	strlow = (char *)SvPV_nolen(ST(0))
+;
+	char*	strhigh = (char *)SvPV_nolen(ST(1))
+;
+#line 2093 "XS.xs"
+    VALIDATE_AND_SET(low, strlow);
+    VALIDATE_AND_SET(high, strhigh);
+    mpz_init(seghigh);
+    mpz_init(t);
+
+    nc = items-1;
+    maxseg = ((UV_MAX > ULONG_MAX) ? ULONG_MAX : UV_MAX);
+
+    /* Loop as needed */
+    while (mpz_cmp(low, high) <= 0) {
+      mpz_add_ui(seghigh, low, maxseg - 1);
+      if (mpz_cmp(seghigh, high) > 0)
+        mpz_set(seghigh, high);
+      mpz_set(t, seghigh);  /* Save in case it is modified */
+      if (ix == 1) {
+        UV k = (nc <= 1) ? 0 : SvUV(ST(2));
+        list = sieve_primes(low, seghigh, k, &nprimes);
+      } else if (ix == 2) {
+        list = sieve_twin_primes(low, seghigh, 2, &nprimes);
+      } else {
+        uint32_t *cl;
+        New(0, cl, nc, uint32_t);
+        cl[0] = 0;
+        for (i = 1; i < nc; i++) {
+          UV cval = SvUV(ST(1+i));
+          if (cval & 1) croak("sieve_prime_cluster: values must be even");
+          if (cval > 2147483647UL) croak("sieve_prime_cluster: values must be 31-bit");
+          if (cval <= cl[i-1]) croak("sieve_prime_cluster: values must be increasing");
+          cl[i] = cval;
+        }
+        list = sieve_cluster(low, seghigh, cl, nc, &nprimes);
+        Safefree(cl);
+      }
+      mpz_set(seghigh, t);  /* Restore the value we used */
+
+      if (list != 0) {
+        for (i = 0; i < nprimes; i++) {
+          mpz_add_ui(t, low, list[i]);
+          XPUSH_MPZ( t );
+        }
+        Safefree(list);
+      }
+      mpz_add_ui(low, seghigh, 1);
+    }
+    mpz_clear(t);
+    mpz_clear(seghigh);
+    mpz_clear(high);
+    mpz_clear(low);
+#line 3469 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_cluster_count); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_cluster_count)
+{
+    dVAR; dXSARGS;
+    dXSI32;
+    if (items < 2)
+       croak_xs_usage(cv,  "strlow, strhigh, ...");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 2149 "XS.xs"
+    mpz_t low, high, count;
+    uint32_t *cl;
+    UV i, nc;
+#line 3490 "XS.c"
+	char*	strlow = (char *)SvPV_nolen(ST(0))
+;
+	char*	strhigh = (char *)SvPV_nolen(ST(1))
+;
+#line 2153 "XS.xs"
+    if (ix >= 2 && items != 2)
+      croak("Usage: twin_prime_count(lo,hi)");
+    /* Check all the input before allocating anything */
+    validate_string_number(cv, "low", (*strlow == '+') ? strlow+1 : strlow);
+    validate_string_number(cv, "high", (*strhigh == '+') ? strhigh+1 : strhigh);
+    nc = (ix >= 2) ? 2 : items-1;
+    for (i = 1; ix < 2 && i < nc; i++) {
+      UV cval = SvUV(ST(1+i)), prev = (i == 1) ? 0 : SvUV(ST(i));
+      if (cval & 1) croak("cluster_count: values must be even");
+      if (cval > 2147483647UL) croak("cluster_count: values must be 31-bit");
+      if (cval <= prev) croak("cluster_count: values must be increasing");
+    }
+    VALIDATE_AND_SET(low, strlow);
+    VALIDATE_AND_SET(high, strhigh);
+    New(0, cl, nc, uint32_t);
+    cl[0] = 0;
+    if (ix >= 2) cl[1] = 2;
+    for (i = 1; ix < 2 && i < nc; i++)
+      cl[i] = SvUV(ST(1+i));
+    mpz_init(count);
+    if (ix & 1)  cluster_count_approx(count, low, high, cl, nc);
+    else         cluster_count(count, low, high, cl, nc);
+    Safefree(cl);
+    XPUSH_MPZ(count);
+    mpz_clear(count);
+    mpz_clear(high);
+    mpz_clear(low);
+#line 3523 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_sieve_range); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_sieve_range)
+{
+    dVAR; dXSARGS;
+    if (items != 3)
+       croak_xs_usage(cv,  "strn, width, depth");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 2184 "XS.xs"
+    mpz_t low, seghigh, high, t;
+    UV i, nprimes, maxseg, offset, *list;
+#line 3542 "XS.c"
+	char*	strn = (char *)SvPV_nolen(ST(0))
+;
+	UV	width = (UV)SvUV(ST(1))
+;
+	UV	depth = (UV)SvUV(ST(2))
+;
+#line 2187 "XS.xs"
+    if (width == 0) XSRETURN(0);
+    if (depth == 0) depth = 1;
+
+    VALIDATE_AND_SET(low, strn);
+    mpz_init(high);
+    mpz_add_ui(high, low, width-1);
+    mpz_init(seghigh);
+    mpz_init(t);
+    maxseg = ((UV_MAX > ULONG_MAX) ? ULONG_MAX : UV_MAX);
+    offset = 0;
+
+    /* Deal with 0 and 1 inside range */
+    if (mpz_cmp_ui(low,2) < 0) {
+      offset = 2 - mpz_get_ui(low);
+      width = (width < offset) ? 0 : width - offset;
+      mpz_set_ui(low,2);
+    }
+    /* Deal with depth < 2 (no sieving) */
+    if (depth < 2) {
+      for (i = 0; i < width; i++)
+        XPUSHs(sv_2mortal(newSVuv(offset + i)));
+      mpz_add_ui(low, high, 1);
+    }
+    /* Loop as needed */
+    while (mpz_cmp(low, high) <= 0) {
+      mpz_add_ui(seghigh, low, maxseg - 1);
+      if (mpz_cmp(seghigh, high) > 0)
+        mpz_set(seghigh, high);
+      mpz_set(t, seghigh);  /* Save in case it is modified */
+      list = sieve_primes(low, seghigh, depth, &nprimes);
+      mpz_set(seghigh, t);  /* Restore the value we used */
+
+      if (list != 0) {
+        for (i = 0; i < nprimes; i++) {
+          XPUSHs(sv_2mortal(newSVuv( offset + list[i] )));
+        }
+        Safefree(list);
+      }
+      mpz_add_ui(low, seghigh, 1);
+      offset += maxseg;
+    }
+    mpz_clear(t);
+    mpz_clear(seghigh);
+    mpz_clear(high);
+    mpz_clear(low);
+#line 3595 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_sieve_primes_bitmap); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_sieve_primes_bitmap)
+{
+    dVAR; dXSARGS;
+    dXSI32;
+    if (items < 2 || items > 3)
+       croak_xs_usage(cv,  "strlow, strhigh, k= 0");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 2238 "XS.xs"
+    mpz_t low, high;
+    unsigned char *bytes;
+    UV nbits, nbytes;
+    SV *sv;
+#line 3617 "XS.c"
+	char*	strlow = (char *)SvPV_nolen(ST(0))
+;
+	char*	strhigh = (char *)SvPV_nolen(ST(1))
+;
+	UV	k;
+
+	if (items < 3)
+	    k = 0;
+	else {
+	    k = (UV)SvUV(ST(2))
+;
+	}
+#line 2243 "XS.xs"
+    VALIDATE_AND_SET(low, strlow);
+    VALIDATE_AND_SET(high, strhigh);
+    if (ix == 1) {              /* (n, width, depth) */
+      mpz_add(high, high, low);
+      mpz_sub_ui(high, high, 1);
+      if (k == 0) k = 1;
+    } else if (k < 2) {
+      k = 0;
+    }
+    bytes = sieve_primes_bitmap(low, high, k, &nbits);
+    mpz_clear(high);
+    mpz_clear(low);
+    if (bytes == 0) XSRETURN_PV("");
+    nbytes = (nbits + 7) / 8;
+#ifdef SV_HAS_TRAILING_NUL
+    bytes[nbytes] = 0;          /* Hand the buffer to Perl, no copy */
+    sv = newSV(0);
+    sv_usepvn_flags(sv, (char*)bytes, nbytes, SV_HAS_TRAILING_NUL);
+#else
+    sv = newSVpvn((char*)bytes, nbytes);
+    Safefree(bytes);
+#endif
+    XPUSHs(sv_2mortal(sv));
+#line 3654 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_lucas_sequence); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_lucas_sequence)
+{
+    dVAR; dXSARGS;
+    if (items != 4)
+       croak_xs_usage(cv,  "strn, P, Q, strk");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 2270 "XS.xs"
+    mpz_t U, V, Qk, n, k, t;
+#line 3672 "XS.c"
+	char*	strn = (char *)SvPV_nolen(ST(0))
+;
+	IV	P = (IV)SvIV(ST(1))
+;
+	IV	Q = (IV)SvIV(ST(2))
+;
+	char*	strk = (char *)SvPV_nolen(ST(3))
+;
+#line 2272 "XS.xs"
+    VALIDATE_AND_SET(n, strn);
+    VALIDATE_AND_SET(k, strk);
+    mpz_init(U);  mpz_init(V);  mpz_init(Qk);  mpz_init(t);
+    lucas_seq(U, V, n, P, Q, k, Qk, t);
+    XPUSH_MPZ(U);
+    XPUSH_MPZ(V);
+    XPUSH_MPZ(Qk);
+
+    mpz_clear(n);  mpz_clear(k);
+    mpz_clear(U);  mpz_clear(V);  mpz_clear(Qk);  mpz_clear(t);
+#line 3692 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+#define SET_UV_VIA_MPZ_STRING(uva, sva, name) \
+  { \
+      mpz_t t; \
+      char* stra = SvPV_nolen(sva); \
+      validate_string_number(cv, name, stra); \
+      mpz_init_set_str(t, stra, 10); \
+      uva = mpz_get_ui(t); \
+      mpz_clear(t); \
+  }
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_trial_factor); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_trial_factor)
+{
+    dVAR; dXSARGS;
+    dXSI32;
+    if (items < 1)
+       croak_xs_usage(cv,  "strn, ...");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 2307 "XS.xs"
+    mpz_t n;
+    UV arg1, arg2, uf;
+    static const UV default_arg1[] =
+      {0,   64000000,64000000,5000000,5000000,0,256000000,100000000,0,  0  };
+    /*Trial,Rho,     Brent,   P-1,    P+1,    Cheb, HOLF, SQUFOF,   ECM,QS */
+#line 3724 "XS.c"
+	char*	strn = (char *)SvPV_nolen(ST(0))
+;
+#line 2313 "XS.xs"
+    VALIDATE_AND_SET(n, strn);
+    {
+      int cmpr = mpz_cmp_ui(n,1);
+      if (cmpr <= 0) {
+        mpz_clear(n);
+        XSRETURN_IV( (cmpr < 0)  ?  0  :  1 );
+      }
+    }
+    arg1 = default_arg1[ix];
+    arg2 = 0;
+    if (items >= 2) SET_UV_VIA_MPZ_STRING(arg1, ST(1), "specific factor arg 1");
+    if (items >= 3) SET_UV_VIA_MPZ_STRING(arg2, ST(2), "specific factor arg 2");
+    while (mpz_even_p(n)) {
+      XPUSHs(sv_2mortal(newSVuv(2)));
+      mpz_divexact_ui(n, n, 2);
+    }
+    while (mpz_divisible_ui_p(n, 3)) {
+      XPUSHs(sv_2mortal(newSVuv(3)));
+      mpz_divexact_ui(n, n, 3);
+    }
+    while (mpz_divisible_ui_p(n, 5)) {
+      XPUSHs(sv_2mortal(newSVuv(5)));
+      mpz_divexact_ui(n, n, 5);
+    }
+    if (mpz_cmp_ui(n,1) > 0 && !_GMP_is_prob_prime(n)) {
+      mpz_t f;
+      int success = 0;
+
+      mpz_init(f);
+      switch (ix) {
+        case 0: if (arg1 == 0) arg1 = 2147483647;
+                uf = _GMP_trial_factor(n, 2, arg1);
+                mpz_set_uv(f, uf);
+                success = (uf > 0);
+                break;
+        case 1: success = _GMP_prho_factor(n, f, 3, arg1);        break;
+        case 2: success = _GMP_pbrent_factor(n, f, 3, arg1);      break;
+        case 3: if (arg2 == 0)  arg2 = arg1*10;
+                success = _GMP_pminus1_factor(n, f, arg1,arg2);   break;
+        case 4: if (arg2 == 0)  arg2 = arg1*10;
+                success = _GMP_pplus1_factor(n, f, 0,arg1,arg2);  break;
+        case 5: success = _GMP_cheb_factor(n, f, arg1,arg2);      break;
+        case 6: success = _GMP_holf_factor(n, f, arg1);           break;
+        case 7: success = squfof126(n, f, arg1);                  break;
+        case 8: if (arg2 == 0) arg2 = 100;
+                if (arg1 == 0) {
+                  success =    _GMP_ECM_FACTOR(n, f,     1000, 40)
+                            || _GMP_ECM_FACTOR(n, f,    10000, 40)
+                            || _GMP_ECM_FACTOR(n, f,   100000, 40)
+                            || _GMP_ECM_FACTOR(n, f,  1000000, 40)
+                            || _GMP_ECM_FACTOR(n, f, 10000000,100);
+                } else {
+                  success = _GMP_ECM_FACTOR(n, f, arg1, arg2);
+                }
+                break;
+        case 9:
+        default:{
+                  mpz_t farray[66];
+                  int i, nfactors;
+                  for (i = 0; i < 66; i++)
+                    mpz_init(farray[i]);
+                  nfactors = _GMP_simpqs(n, farray);
+                  for (i = 0; i < nfactors; i++)
+                    XPUSH_MPZ(farray[i]);
+                  for (i = 0; i < 66; i++)
+                    mpz_clear(farray[i]);
+                  if (nfactors > 0)
+                    mpz_set_ui(n, 1);
+                }
+                break;
+      }
+
+      if (success) {
+        mpz_divexact(n, n, f);
+        if (mpz_cmp(f,n) > 0)  /* print smallest first */
+          mpz_swap(n, f);
+        XPUSH_MPZ(f);
+      }
+      mpz_clear(f);
+    }
+    if (mpz_cmp_ui(n,1) > 0)
+      XPUSH_MPZ(n);
+    mpz_clear(n);
+#line 3811 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_factor); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_factor)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "strn");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 2400 "XS.xs"
+    mpz_t n;
+    mpz_t* factors;
+    int* exponents;
+    int nfactors, i, j;
+#line 3832 "XS.c"
+	char*	strn = (char *)SvPV_nolen(ST(0))
+;
+#line 2405 "XS.xs"
+    VALIDATE_AND_SET(n, strn);
+    nfactors = factor(n, &factors, &exponents);
+    if (GIMME_V == G_SCALAR) {
+      for (i = 0, j = 0; i < nfactors; i++)
+        j += exponents[i];
+      PUSHs(sv_2mortal(newSVuv(j)));
+    } else {
+      for (i = 0; i < nfactors; i++) {
+        for (j = 0; j < exponents[i]; j++) {
+          XPUSH_MPZ(factors[i]);
+        }
+      }
+    }
+    clear_factors(nfactors, &factors, &exponents);
+    mpz_clear(n);
+#line 3851 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_divisors); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_divisors)
+{
+    dVAR; dXSARGS;
+    if (items < 1 || items > 2)
+       croak_xs_usage(cv,  "strn, strk= 0");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 2424 "XS.xs"
+    mpz_t n, k;
+    divisor_iterator iter;
+    UV count;
+#line 3871 "XS.c"
+	char*	strn = (char *)SvPV_nolen(ST(0))
+;
+	char*	strk;
+
+	if (items < 2)
+	    strk = 0;
+	else {
+	    strk = (char *)SvPV_nolen(ST(1))
+;
+	}
+#line 2428 "XS.xs"
+    if (strk != 0)   /* Before n is set, so a bad k does not leak it */
+      validate_string_number(cv, "k", (*strk == '+') ? strk+1 : strk);
+    VALIDATE_AND_SET(n, strn);
+    if (strk == 0 && GIMME_V == G_SCALAR) {
+      sigma(n, n, 0);
+      XPUSH_MPZ(n);
+      mpz_clear(n);
+      XSRETURN(1);
+    }
+    if (strk != 0)
+      VALIDATE_AND_SET(k, strk);
+    /* Scalar context only needs a count, so use the unordered walk. */
+    divisor_iterator_init(&iter, n, 0, (strk == 0) ? 0 : k, GIMME_V != G_SCALAR);
+    count = 0;
+    while (divisor_iterator_next(&iter, n)) {
+      if (GIMME_V == G_SCALAR) count++;
+      else                     XPUSH_MPZ(n);
+    }
+    divisor_iterator_destroy(&iter);
+    if (GIMME_V == G_SCALAR)
+      XPUSHs(sv_2mortal(newSVuv(count)));
+    if (strk != 0) mpz_clear(k);
+    mpz_clear(n);
+#line 3906 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_fordivisors); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_fordivisors)
+{
+    dVAR; dXSARGS;
+    if (items < 2 || items > 4)
+       croak_xs_usage(cv,  "block, strn, strlo= 0, strhi= 0");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 2456 "XS.xs"
+    mpz_t n, lo, hi, d;
+    divisor_iterator iter;
+    GV *gv;
+    HV *stash;
+    SV *svarg;
+    CV *subcv;
+#line 3929 "XS.c"
+	SV*	block = ST(0)
+;
+	char*	strn = (char *)SvPV_nolen(ST(1))
+;
+	char*	strlo;
+	char*	strhi;
+
+	if (items < 3)
+	    strlo = 0;
+	else {
+	    strlo = (char *)SvPV_nolen(ST(2))
+;
+	}
+
+	if (items < 4)
+	    strhi = 0;
+	else {
+	    strhi = (char *)SvPV_nolen(ST(3))
+;
+	}
+#line 2463 "XS.xs"
+    subcv = sv_2cv(block, &stash, &gv, 0);
+    if (subcv == Nullcv)
+      croak("Not a subroutine reference");
+    VALIDATE_AND_SET(n, strn);
+    if (strlo != 0)  VALIDATE_AND_SET(lo, strlo);
+    if (strhi != 0)  VALIDATE_AND_SET(hi, strhi);
+    mpz_init(d);
+    divisor_iterator_init(&iter, n, (strlo == 0) ? 0 : lo, (strhi == 0) ? 0 : hi, 1);
+    START_FORBLOCK(svarg);
+    while (divisor_iterator_next(&iter, d)) {
+      CALL_FORBLOCK(subcv, svarg, d);
+      if (_for_lastfor) break;
+    }
+    END_FORBLOCK(svarg);
+    divisor_iterator_destroy(&iter);
+    mpz_clear(d);
+    if (strhi != 0)  mpz_clear(hi);
+    if (strlo != 0)  mpz_clear(lo);
+    mpz_clear(n);
+    XSRETURN_EMPTY;
+#line 3971 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_forprimes); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_forprimes)
+{
+    dVAR; dXSARGS;
+    if (items < 2 || items > 3)
+       croak_xs_usage(cv,  "block, strlo, strhi= 0");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 2488 "XS.xs"
+    mpz_t lo, hi;
+    GV *gv;
+    HV *stash;
+    forblock_ctx_t ctx;
+#line 3992 "XS.c"
+	SV*	block = ST(0)
+;
+	char*	strlo = (char *)SvPV_nolen(ST(1))
+;
+	char*	strhi;
+
+	if (items < 3)
+	    strhi = 0;
+	else {
+	    strhi = (char *)SvPV_nolen(ST(2))
+;
+	}
+#line 2493 "XS.xs"
+    ctx.subcv = sv_2cv(block, &stash, &gv, 0);
+    if (ctx.subcv == Nullcv)
+      croak("Not a subroutine reference");
+    if (strhi == 0) {
+      mpz_init_set_ui(lo, 2);
+      VALIDATE_AND_SET(hi, strlo);
+    } else {
+      VALIDATE_AND_SET(lo, strlo);
+      VALIDATE_AND_SET(hi, strhi);
+    }
+    START_FORBLOCK(ctx.svarg);
+    sieve_stream(lo, hi, 0, 0, 0, _forblock_stream, &ctx);
+    END_FORBLOCK(ctx.svarg);
+    mpz_clear(hi);
+    mpz_clear(lo);
+    XSRETURN_EMPTY;
+#line 4022 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_forclusters); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_forclusters)
+{
+    dVAR; dXSARGS;
+    if (items < 3)
+       croak_xs_usage(cv,  "block, strlo, strhi, ...");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 2514 "XS.xs"
+    mpz_t lo, hi;
+    GV *gv;
+    HV *stash;
+    forblock_ctx_t ctx;
+    uint32_t *cl;
+    UV i, nc;
+#line 4045 "XS.c"
+	SV*	block = ST(0)
+;
+	char*	strlo = (char *)SvPV_nolen(ST(1))
+;
+	char*	strhi = (char *)SvPV_nolen(ST(2))
+;
+#line 2521 "XS.xs"
+    ctx.subcv = sv_2cv(block, &stash, &gv, 0);
+    if (ctx.subcv == Nullcv)
+      croak("Not a subroutine reference");
+    nc = items-2;
+    New(0, cl, nc, uint32_t);
+    cl[0] = 0;
+    for (i = 1; i < nc; i++) {
+      UV cval = SvUV(ST(2+i));
+      if (cval & 1 || cval > 2147483647UL || cval <= cl[i-1]) {
+        Safefree(cl);
+        croak("forclusters: values must be even, 31-bit, and increasing");
+      }
+      cl[i] = cval;
+    }
+    VALIDATE_AND_SET(lo, strlo);
+    VALIDATE_AND_SET(hi, strhi);
+    START_FORBLOCK(ctx.svarg);
+    sieve_stream(lo, hi, 0, cl, nc, _forblock_stream, &ctx);
+    END_FORBLOCK(ctx.svarg);
+    Safefree(cl);
+    mpz_clear(hi);
+    mpz_clear(lo);
+    XSRETURN_EMPTY;
+#line 4076 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_forprimegaps); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_forprimegaps)
+{
+    dVAR; dXSARGS;
+    if (items < 5 || items > 6)
+       croak_xs_usage(cv,  "block, strk, mlo, mhi, minmerit, depth= 0");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 2549 "XS.xs"
+    mpz_t K;
+    GV *gv;
+    HV *stash;
+    forblock_ctx_t ctx;
+    int ok;
+#line 4098 "XS.c"
+	SV*	block = ST(0)
+;
+	char*	strk = (char *)SvPV_nolen(ST(1))
+;
+	UV	mlo = (UV)SvUV(ST(2))
+;
+	UV	mhi = (UV)SvUV(ST(3))
+;
+	NV	minmerit = (NV)SvNV(ST(4))
+;
+	UV	depth;
+
+	if (items < 6)
+	    depth = 0;
+	else {
+	    depth = (UV)SvUV(ST(5))
+;
+	}
+#line 2555 "XS.xs"
+    ctx.subcv = sv_2cv(block, &stash, &gv, 0);
+    if (ctx.subcv == Nullcv)
+      croak("Not a subroutine reference");
+    VALIDATE_AND_SET(K, strk);
+    START_FORBLOCK(ctx.svarg);
+    ok = prime_gap_search(K, mlo, mhi, minmerit, depth, _forblock_gap, &ctx);
+    END_FORBLOCK(ctx.svarg);
+    mpz_clear(K);
+    if (!ok) croak("forprimegaps: centres must be at least 3");
+    XSRETURN_EMPTY;
+#line 4128 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP__forprovable); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP__forprovable)
+{
+    dVAR; dXSARGS;
+    if (items < 1)
+       croak_xs_usage(cv,  "block, ...");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 2570 "XS.xs"
+    GV *gv;
+    HV *stash;
+    forprovable_ctx_t ctx;
+    UV i, n;
+#line 4149 "XS.c"
+	SV*	block = ST(0)
+;
+#line 2575 "XS.xs"
+    ctx.subcv = sv_2cv(block, &stash, &gv, 0);
+    if (ctx.subcv == Nullcv)
+      croak("Not a subroutine reference");
+    n = items-1;
+    if (n == 0)
+      XSRETURN_EMPTY;
+    for (i = 0; i < n; i++) {
+      const char* s = SvPV_nolen(ST(1+i));
+      if (*s == '+') s++;
+      if (*s != '-')
+        validate_string_number(cv, "n", s);
+    }
+    New(0, ctx.N, n, mpz_t);
+    Newz(0, ctx.neg, n, SV*);
+    for (i = 0; i < n; i++) {
+      const char* s = SvPV_nolen(ST(1+i));
+      if (*s == '+') s++;
+      if (*s == '-') {   /* Negative numbers give 0 */
+        mpz_init(ctx.N[i]);
+        ctx.neg[i] = newSVsv(ST(1+i));
+      } else {
+        mpz_init_set_str(ctx.N[i], s, 10);
+      }
+    }
+    ctx.died = 0;
+    START_FORBLOCK(ctx.svarg);
+    ecpp_prove_batch(ctx.N, n, _forprovable_done, &ctx);
+    END_FORBLOCK(ctx.svarg);
+    for (i = 0; i < n; i++) {
+      mpz_clear(ctx.N[i]);
+      if (ctx.neg[i])  SvREFCNT_dec(ctx.neg[i]);
+    }
+    Safefree(ctx.neg);
+    Safefree(ctx.N);
+    if (ctx.died)
+      croak(Nullch);
+    XSRETURN_EMPTY;
+#line 4190 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_lastfor); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_lastfor)
+{
+    dVAR; dXSARGS;
+    if (items != 0)
+       croak_xs_usage(cv,  "");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 2617 "XS.xs"
+    _for_lastfor = 1;
+    XSRETURN_EMPTY;
+#line 4209 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_sigma); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_sigma)
+{
+    dVAR; dXSARGS;
+    if (items < 1 || items > 2)
+       croak_xs_usage(cv,  "svn, k= 1");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 2623 "XS.xs"
+    mpz_t n;
+#line 4227 "XS.c"
+	SV*	svn = ST(0)
+;
+	UV	k;
+
+	if (items < 2)
+	    k = 1;
+	else {
+	    k = (UV)SvUV(ST(1))
+;
+	}
+#line 2625 "XS.xs"
+    if (IS_FACTORED_SV(svn)) {
+      factored_t F;
+      factored_from_sv(cv, &F, svn);
+      mpz_init(n);
+      sigma_factored(n, &F, k);
+      factored_clear(&F);
+    } else {
+      VALIDATE_AND_SET(n, SvPV_nolen(svn));
+      sigma(n, n, k);
+    }
+    XPUSH_MPZ(n);
+    mpz_clear(n);
+#line 4251 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_todigits); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_todigits)
+{
+    dVAR; dXSARGS;
+    if (items < 1 || items > 3)
+       croak_xs_usage(cv,  "strn, base=10, length=-1");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 2641 "XS.xs"
+    mpz_t n;
+    uint32_t d, *digits;
+#line 4270 "XS.c"
+	char*	strn = (char *)SvPV_nolen(ST(0))
+;
+	unsigned int	base;
+	int	length;
+
+	if (items < 2)
+	    base = 10;
+	else {
+	    base = (unsigned int)SvUV(ST(1))
+;
+	}
+
+	if (items < 3)
+	    length = -1;
+	else {
+	    length = (int)SvIV(ST(2))
+;
+	}
+#line 2644 "XS.xs"
+    if (base < 2 || base > 0xFFFFFFFFU) croak("invalid base: %u\n", base);
+    if (strn[0] == '-' || strn[0] == '+')  strn++;
+    validate_string_number(cv, "n", strn);
+    if (base == 10) {
+      uint32_t l = strlen(strn);
+      New(0, digits, l, uint32_t);
+      for (d = 0; d < l; d++)
+        digits[d] = strn[d]-'0';
+    } else {
+      mpz_init_set_str(n, strn, 10);
+      digits = todigits(&d, n, base);
+      mpz_clear(n);
+    }
+    if (length > 0 || d > 1 || digits[0] != 0) {
+      if (length < 0) length = d;
+      EXTEND(SP, length);
+      for (; length > (int)d; length--)
+        PUSHs(sv_2mortal(newSVuv( 0 )));
+      for (; length > 0; length--)
+        PUSHs(sv_2mortal(newSVuv( digits[d-length] )));
+    }
+    Safefree(digits);
+#line 4312 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_Math__Prime__Util__GMP_fromdigits); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_Math__Prime__Util__GMP_fromdigits)
+{
+    dVAR; dXSARGS;
+    if (items < 1 || items > 2)
+       croak_xs_usage(cv,  "svp, base=10");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+#line 2670 "XS.xs"
+    AV *av;
+    int i, plen;
+    uint32_t *digits;
+    mpz_t n;
+#line 4333 "XS.c"
+	SV*	svp = ST(0)
+;
+	unsigned int	base;
+
+	if (items < 2)
+	    base = 10;
+	else {
+	    base = (unsigned int)SvUV(ST(1))
+;
+	}
+#line 2675 "XS.xs"
+    if (base < 2 || base > 0xFFFFFFFFU) croak("invalid base: %u\n", base);
+    mpz_init(n);
+    if (!SvROK(svp)) { /* string */
+      fromdigits_str(n, SvPV_nolen(svp), base);
+    } else {
+      if (SvTYPE(SvRV(svp)) != SVt_PVAV)
+        croak("fromdigits argument must be a string or array reference");
+      av = (AV*) SvRV(svp);
+      plen = av_len(av);
+      if (plen < 0) XSRETURN_IV(0);
+      New(0, digits, plen+1, uint32_t);
+      for (i = 0; i <= plen; i++) {
+        SV **iv = av_fetch(av, i, 0);
+        if (iv == 0) break;
+        digits[plen-i] = SvUV(*iv); /* TODO: anything other than 32-bit */
+      }
+      if (i >= plen)
+        fromdigits(n, digits, plen+1, base);
+      Safefree(digits);
+    }
+    XPUSH_MPZ(n);
+    mpz_clear(n);
+#line 4367 "XS.c"
+	PUTBACK;
+	return;
+    }
+}
+
+#ifdef __cplusplus
+extern "C"
+#endif
+XS_EXTERNAL(boot_Math__Prime__Util__GMP); /* prototype to pass -Wmissing-prototypes */
+XS_EXTERNAL(boot_Math__Prime__Util__GMP)
+{
+#if PERL_VERSION_LE(5, 21, 5)
+    dVAR; dXSARGS;
+#else
+    dVAR; dXSBOOTARGSXSAPIVERCHK;
+#endif
+#if PERL_VERSION_LE(5, 8, 999) /* PERL_VERSION_LT is 5.33+ */
+    char* file = __FILE__;
+#else
+    const char* file = __FILE__;
+#endif
+
+    PERL_UNUSED_VAR(file);
+
+    PERL_UNUSED_VAR(cv); /* -W */
+    PERL_UNUSED_VAR(items); /* -W */
+#if PERL_VERSION_LE(5, 21, 5)
+    XS_VERSION_BOOTCHECK;
+#  ifdef XS_APIVERSION_BOOTCHECK
+    XS_APIVERSION_BOOTCHECK;
+#  endif
+#endif
+
+        (void)newXSproto_portable("Math::Prime::Util::GMP::_GMP_init", XS_Math__Prime__Util__GMP__GMP_init, file, "");
+        (void)newXSproto_portable("Math::Prime::Util::GMP::_GMP_destroy", XS_Math__Prime__Util__GMP__GMP_destroy, file, "");
+        (void)newXSproto_portable("Math::Prime::Util::GMP::_GMP_memfree", XS_Math__Prime__Util__GMP__GMP_memfree, file, "");
+        (void)newXSproto_portable("Math::Prime::Util::GMP::_GMP_set_verbose", XS_Math__Prime__Util__GMP__GMP_set_verbose, file, "$");
+        (void)newXSproto_portable("Math::Prime::Util::GMP::_GMP_set_threads", XS_Math__Prime__Util__GMP__GMP_set_threads, file, "$");
+        (void)newXSproto_portable("Math::Prime::Util::GMP::_GMP_get_threads", XS_Math__Prime__Util__GMP__GMP_get_threads, file, "");
+        (void)newXSproto_portable("Math::Prime::Util::GMP::_GMP_set_class_poly_db", XS_Math__Prime__Util__GMP__GMP_set_class_poly_db, file, ";$");
+        cv = newXSproto_portable("Math::Prime::Util::GMP::_GMP_class_poly", XS_Math__Prime__Util__GMP__GMP_class_poly, file, "$");
+        XSANY.any_i32 = 0;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::_GMP_hilbert_class_poly", XS_Math__Prime__Util__GMP__GMP_class_poly, file, "$");
+        XSANY.any_i32 = 1;
+        (void)newXSproto_portable("Math::Prime::Util::GMP::_GMP_prime_iterator_walk", XS_Math__Prime__Util__GMP__GMP_prime_iterator_walk, file, "$$;$");
+        (void)newXSproto_portable("Math::Prime::Util::GMP::_GMP_polyz_roots_modp", XS_Math__Prime__Util__GMP__GMP_polyz_roots_modp, file, "$;@");
+        (void)newXSproto_portable("Math::Prime::Util::GMP::_GMP_class_numbers", XS_Math__Prime__Util__GMP__GMP_class_numbers, file, "$");
+        (void)newXSproto_portable("Math::Prime::Util::GMP::_GMP_set_ecpp_checkpoint", XS_Math__Prime__Util__GMP__GMP_set_ecpp_checkpoint, file, ";$");
+        (void)newXSproto_portable("Math::Prime::Util::GMP::_GMP_set_ecpp_policy", XS_Math__Prime__Util__GMP__GMP_set_ecpp_policy, file, "$;$$");
+        (void)newXSproto_portable("Math::Prime::Util::GMP::_GMP_ecpp_stats", XS_Math__Prime__Util__GMP__GMP_ecpp_stats, file, "");
+        (void)newXSproto_portable("Math::Prime::Util::GMP::verify_prime_certificate", XS_Math__Prime__Util__GMP_verify_prime_certificate, file, "$");
+        cv = newXSproto_portable("Math::Prime::Util::GMP::prime_certificate_to_binary", XS_Math__Prime__Util__GMP_prime_certificate_to_binary, file, "$");
+        XSANY.any_i32 = 0;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::prime_certificate_to_text", XS_Math__Prime__Util__GMP_prime_certificate_to_binary, file, "$");
+        XSANY.any_i32 = 1;
+        (void)newXSproto_portable("Math::Prime::Util::GMP::seed_csprng", XS_Math__Prime__Util__GMP_seed_csprng, file, "$$");
+        cv = newXSproto_portable("Math::Prime::Util::GMP::irand", XS_Math__Prime__Util__GMP_irand, file, "");
+        XSANY.any_i32 = 0;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::irand64", XS_Math__Prime__Util__GMP_irand, file, "");
+        XSANY.any_i32 = 1;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::is_csprng_well_seeded", XS_Math__Prime__Util__GMP_irand, file, "");
+        XSANY.any_i32 = 2;
+        (void)newXSproto_portable("Math::Prime::Util::GMP::drand", XS_Math__Prime__Util__GMP_drand, file, ";$");
+        cv = newXSproto_portable("Math::Prime::Util::GMP::is_euler_pseudoprime", XS_Math__Prime__Util__GMP_is_pseudoprime, file, "$;@");
+        XSANY.any_i32 = 1;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::is_pseudoprime", XS_Math__Prime__Util__GMP_is_pseudoprime, file, "$;@");
+        XSANY.any_i32 = 0;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::is_strong_pseudoprime", XS_Math__Prime__Util__GMP_is_pseudoprime, file, "$;@");
+        XSANY.any_i32 = 2;
+        (void)newXSproto_portable("Math::Prime::Util::GMP::miller_rabin_random", XS_Math__Prime__Util__GMP_miller_rabin_random, file, "$;$$");
+        cv = newXSproto_portable("Math::Prime::Util::GMP::is_euler_plumb_pseudoprime", XS_Math__Prime__Util__GMP_is_lucas_pseudoprime, file, "$");
+        XSANY.any_i32 = 5;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::is_extra_strong_lucas_pseudoprime", XS_Math__Prime__Util__GMP_is_lucas_pseudoprime, file, "$");
+        XSANY.any_i32 = 2;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::is_frobenius_khashin_pseudoprime", XS_Math__Prime__Util__GMP_is_lucas_pseudoprime, file, "$");
+        XSANY.any_i32 = 4;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::is_frobenius_underwood_pseudoprime", XS_Math__Prime__Util__GMP_is_lucas_pseudoprime, file, "$");
+        XSANY.any_i32 = 3;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::is_lucas_pseudoprime", XS_Math__Prime__Util__GMP_is_lucas_pseudoprime, file, "$");
+        XSANY.any_i32 = 0;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::is_strong_lucas_pseudoprime", XS_Math__Prime__Util__GMP_is_lucas_pseudoprime, file, "$");
+        XSANY.any_i32 = 1;
+        (void)newXSproto_portable("Math::Prime::Util::GMP::is_almost_extra_strong_lucas_pseudoprime", XS_Math__Prime__Util__GMP_is_almost_extra_strong_lucas_pseudoprime, file, "$;$");
+        (void)newXSproto_portable("Math::Prime::Util::GMP::is_frobenius_pseudoprime", XS_Math__Prime__Util__GMP_is_frobenius_pseudoprime, file, "$;$$");
+        cv = newXSproto_portable("Math::Prime::Util::GMP::is_aks_prime", XS_Math__Prime__Util__GMP_is_prime, file, "$");
+        XSANY.any_i32 = 6;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::is_bls75_prime", XS_Math__Prime__Util__GMP_is_prime, file, "$");
+        XSANY.any_i32 = 9;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::is_bpsw_prime", XS_Math__Prime__Util__GMP_is_prime, file, "$");
+        XSANY.any_i32 = 2;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::is_ecpp_prime", XS_Math__Prime__Util__GMP_is_prime, file, "$");
+        XSANY.any_i32 = 10;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::is_llr_prime", XS_Math__Prime__Util__GMP_is_prime, file, "$");
+        XSANY.any_i32 = 3;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::is_nminus1_prime", XS_Math__Prime__Util__GMP_is_prime, file, "$");
+        XSANY.any_i32 = 7;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::is_nplus1_prime", XS_Math__Prime__Util__GMP_is_prime, file, "$");
+        XSANY.any_i32 = 8;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::is_prime", XS_Math__Prime__Util__GMP_is_prime, file, "$");
+        XSANY.any_i32 = 0;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::is_prob_prime", XS_Math__Prime__Util__GMP_is_prime, file, "$");
+        XSANY.any_i32 = 1;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::is_proth_prime", XS_Math__Prime__Util__GMP_is_prime, file, "$");
+        XSANY.any_i32 = 4;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::is_trial_prime", XS_Math__Prime__Util__GMP_is_prime, file, "$");
+        XSANY.any_i32 = 5;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::_is_provable_prime", XS_Math__Prime__Util__GMP__is_provable_prime, file, "$;$");
+        XSANY.any_i32 = 0;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::is_miller_prime", XS_Math__Prime__Util__GMP__is_provable_prime, file, "$;$");
+        XSANY.any_i32 = 1;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::is_perrin_pseudoprime", XS_Math__Prime__Util__GMP__is_provable_prime, file, "$;$");
+        XSANY.any_i32 = 2;
+        (void)newXSproto_portable("Math::Prime::Util::GMP::_validate_ecpp_curve", XS_Math__Prime__Util__GMP__validate_ecpp_curve, file, "$$$$$$$");
+        (void)newXSproto_portable("Math::Prime::Util::GMP::is_almost_prime", XS_Math__Prime__Util__GMP_is_almost_prime, file, "$$");
+        (void)newXSproto_portable("Math::Prime::Util::GMP::is_power", XS_Math__Prime__Util__GMP_is_power, file, "$;$");
+        (void)newXSproto_portable("Math::Prime::Util::GMP::is_divisible", XS_Math__Prime__Util__GMP_is_divisible, file, "$$");
+        (void)newXSproto_portable("Math::Prime::Util::GMP::is_congruent", XS_Math__Prime__Util__GMP_is_congruent, file, "$$$");
+        cv = newXSproto_portable("Math::Prime::Util::GMP::next_prime", XS_Math__Prime__Util__GMP_next_prime, file, "$");
+        XSANY.any_i32 = 0;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::next_twin_prime", XS_Math__Prime__Util__GMP_next_prime, file, "$");
+        XSANY.any_i32 = 2;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::prev_prime", XS_Math__Prime__Util__GMP_next_prime, file, "$");
+        XSANY.any_i32 = 1;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::random_prime", XS_Math__Prime__Util__GMP_random_prime, file, "$;$");
+        XSANY.any_i32 = 0;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::urandomr", XS_Math__Prime__Util__GMP_random_prime, file, "$;$");
+        XSANY.any_i32 = 1;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::perfect_power_count", XS_Math__Prime__Util__GMP_prime_count, file, "$;$");
+        XSANY.any_i32 = 2;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::prime_count", XS_Math__Prime__Util__GMP_prime_count, file, "$;$");
+        XSANY.any_i32 = 0;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::prime_power_count", XS_Math__Prime__Util__GMP_prime_count, file, "$;$");
+        XSANY.any_i32 = 1;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::add1int", XS_Math__Prime__Util__GMP_totient, file, "$");
+        XSANY.any_i32 = 14;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::bernfrac", XS_Math__Prime__Util__GMP_totient, file, "$");
+        XSANY.any_i32 = 3;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::carmichael_lambda", XS_Math__Prime__Util__GMP_totient, file, "$");
+        XSANY.any_i32 = 1;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::exp_mangoldt", XS_Math__Prime__Util__GMP_totient, file, "$");
+        XSANY.any_i32 = 2;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::harmfrac", XS_Math__Prime__Util__GMP_totient, file, "$");
+        XSANY.any_i32 = 4;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::is_prime_power", XS_Math__Prime__Util__GMP_totient, file, "$");
+        XSANY.any_i32 = 8;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::nth_prime", XS_Math__Prime__Util__GMP_totient, file, "$");
+        XSANY.any_i32 = 11;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::prime_count_lower", XS_Math__Prime__Util__GMP_totient, file, "$");
+        XSANY.any_i32 = 9;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::prime_count_upper", XS_Math__Prime__Util__GMP_totient, file, "$");
+        XSANY.any_i32 = 10;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::ramanujan_tau", XS_Math__Prime__Util__GMP_totient, file, "$");
+        XSANY.any_i32 = 6;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::sqrtint", XS_Math__Prime__Util__GMP_totient, file, "$");
+        XSANY.any_i32 = 7;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::sub1int", XS_Math__Prime__Util__GMP_totient, file, "$");
+        XSANY.any_i32 = 15;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::totient", XS_Math__Prime__Util__GMP_totient, file, "$");
+        XSANY.any_i32 = 0;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::urandomm", XS_Math__Prime__Util__GMP_totient, file, "$");
+        XSANY.any_i32 = 13;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::znprimroot", XS_Math__Prime__Util__GMP_totient, file, "$");
+        XSANY.any_i32 = 5;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::absint", XS_Math__Prime__Util__GMP_absint, file, "$");
+        XSANY.any_i32 = 0;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::negint", XS_Math__Prime__Util__GMP_absint, file, "$");
+        XSANY.any_i32 = 1;
+        (void)newXSproto_portable("Math::Prime::Util::GMP::signint", XS_Math__Prime__Util__GMP_signint, file, "$");
+        cv = newXSproto_portable("Math::Prime::Util::GMP::cmpabsint", XS_Math__Prime__Util__GMP_cmpint, file, "$$");
+        XSANY.any_i32 = 1;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::cmpint", XS_Math__Prime__Util__GMP_cmpint, file, "$$");
+        XSANY.any_i32 = 0;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::clrbit", XS_Math__Prime__Util__GMP_setbit, file, "$$");
+        XSANY.any_i32 = 1;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::notbit", XS_Math__Prime__Util__GMP_setbit, file, "$$");
+        XSANY.any_i32 = 2;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::setbit", XS_Math__Prime__Util__GMP_setbit, file, "$$");
+        XSANY.any_i32 = 0;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::tstbit", XS_Math__Prime__Util__GMP_setbit, file, "$$");
+        XSANY.any_i32 = 3;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::bitand", XS_Math__Prime__Util__GMP_bitand, file, "$$");
+        XSANY.any_i32 = 0;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::bitor", XS_Math__Prime__Util__GMP_bitand, file, "$$");
+        XSANY.any_i32 = 1;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::bitxor", XS_Math__Prime__Util__GMP_bitand, file, "$$");
+        XSANY.any_i32 = 2;
+        (void)newXSproto_portable("Math::Prime::Util::GMP::bitnot", XS_Math__Prime__Util__GMP_bitnot, file, "$");
+        cv = newXSproto_portable("Math::Prime::Util::GMP::bernreal", XS_Math__Prime__Util__GMP_harmreal, file, "$;$");
+        XSANY.any_i32 = 1;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::ei", XS_Math__Prime__Util__GMP_harmreal, file, "$;$");
+        XSANY.any_i32 = 6;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::expreal", XS_Math__Prime__Util__GMP_harmreal, file, "$;$");
+        XSANY.any_i32 = 3;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::harmreal", XS_Math__Prime__Util__GMP_harmreal, file, "$;$");
+        XSANY.any_i32 = 0;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::lambertw", XS_Math__Prime__Util__GMP_harmreal, file, "$;$");
+        XSANY.any_i32 = 8;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::li", XS_Math__Prime__Util__GMP_harmreal, file, "$;$");
+        XSANY.any_i32 = 5;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::logreal", XS_Math__Prime__Util__GMP_harmreal, file, "$;$");
+        XSANY.any_i32 = 2;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::riemannr", XS_Math__Prime__Util__GMP_harmreal, file, "$;$");
+        XSANY.any_i32 = 7;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::surround_primes", XS_Math__Prime__Util__GMP_harmreal, file, "$;$");
+        XSANY.any_i32 = 9;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::zeta", XS_Math__Prime__Util__GMP_harmreal, file, "$;$");
+        XSANY.any_i32 = 4;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::addreal", XS_Math__Prime__Util__GMP_powreal, file, "$$;$");
+        XSANY.any_i32 = 3;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::agmreal", XS_Math__Prime__Util__GMP_powreal, file, "$$;$");
+        XSANY.any_i32 = 2;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::divreal", XS_Math__Prime__Util__GMP_powreal, file, "$$;$");
+        XSANY.any_i32 = 6;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::mulreal", XS_Math__Prime__Util__GMP_powreal, file, "$$;$");
+        XSANY.any_i32 = 5;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::powreal", XS_Math__Prime__Util__GMP_powreal, file, "$$;$");
+        XSANY.any_i32 = 0;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::rootreal", XS_Math__Prime__Util__GMP_powreal, file, "$$;$");
+        XSANY.any_i32 = 1;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::subreal", XS_Math__Prime__Util__GMP_powreal, file, "$$;$");
+        XSANY.any_i32 = 4;
+        (void)newXSproto_portable("Math::Prime::Util::GMP::bernvec", XS_Math__Prime__Util__GMP_bernvec, file, "$");
+        cv = newXSproto_portable("Math::Prime::Util::GMP::gcd", XS_Math__Prime__Util__GMP_gcd, file, "@");
+        XSANY.any_i32 = 0;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::lcm", XS_Math__Prime__Util__GMP_gcd, file, "@");
+        XSANY.any_i32 = 1;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::vecprod", XS_Math__Prime__Util__GMP_gcd, file, "@");
+        XSANY.any_i32 = 3;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::vecsum", XS_Math__Prime__Util__GMP_gcd, file, "@");
+        XSANY.any_i32 = 2;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::is_gaussian_prime", XS_Math__Prime__Util__GMP_kronecker, file, "$$");
+        XSANY.any_i32 = 2;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::is_rough", XS_Math__Prime__Util__GMP_kronecker, file, "$$");
+        XSANY.any_i32 = 4;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::is_smooth", XS_Math__Prime__Util__GMP_kronecker, file, "$$");
+        XSANY.any_i32 = 3;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::kronecker", XS_Math__Prime__Util__GMP_kronecker, file, "$$");
+        XSANY.any_i32 = 0;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::valuation", XS_Math__Prime__Util__GMP_kronecker, file, "$$");
+        XSANY.any_i32 = 1;
+        (void)newXSproto_portable("Math::Prime::Util::GMP::moebius", XS_Math__Prime__Util__GMP_moebius, file, "$;$");
+        cv = newXSproto_portable("Math::Prime::Util::GMP::carmichael_lambda_range", XS_Math__Prime__Util__GMP_totient_range, file, "$$");
+        XSANY.any_i32 = 5;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::is_semiprime_range", XS_Math__Prime__Util__GMP_totient_range, file, "$$");
+        XSANY.any_i32 = 4;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::liouville_range", XS_Math__Prime__Util__GMP_totient_range, file, "$$");
+        XSANY.any_i32 = 1;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::prime_bigomega_range", XS_Math__Prime__Util__GMP_totient_range, file, "$$");
+        XSANY.any_i32 = 3;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::prime_omega_range", XS_Math__Prime__Util__GMP_totient_range, file, "$$");
+        XSANY.any_i32 = 2;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::totient_range", XS_Math__Prime__Util__GMP_totient_range, file, "$$");
+        XSANY.any_i32 = 0;
+        (void)newXSproto_portable("Math::Prime::Util::GMP::sigma_range", XS_Math__Prime__Util__GMP_sigma_range, file, "$$;$");
+        cv = newXSproto_portable("Math::Prime::Util::GMP::lucasu", XS_Math__Prime__Util__GMP_lucasu, file, "$$$");
+        XSANY.any_i32 = 0;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::lucasuv", XS_Math__Prime__Util__GMP_lucasu, file, "$$$");
+        XSANY.any_i32 = 2;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::lucasv", XS_Math__Prime__Util__GMP_lucasu, file, "$$$");
+        XSANY.any_i32 = 1;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::lucasumod", XS_Math__Prime__Util__GMP_lucasumod, file, "$$$$");
+        XSANY.any_i32 = 0;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::lucasuvmod", XS_Math__Prime__Util__GMP_lucasumod, file, "$$$$");
+        XSANY.any_i32 = 2;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::lucasvmod", XS_Math__Prime__Util__GMP_lucasumod, file, "$$$$");
+        XSANY.any_i32 = 1;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::hammingweight", XS_Math__Prime__Util__GMP_liouville, file, "$");
+        XSANY.any_i32 = 7;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::is_carmichael", XS_Math__Prime__Util__GMP_liouville, file, "$");
+        XSANY.any_i32 = 4;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::is_fundamental", XS_Math__Prime__Util__GMP_liouville, file, "$");
+        XSANY.any_i32 = 6;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::is_practical", XS_Math__Prime__Util__GMP_liouville, file, "$");
+        XSANY.any_i32 = 5;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::is_semiprime", XS_Math__Prime__Util__GMP_liouville, file, "$");
+        XSANY.any_i32 = 2;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::is_square", XS_Math__Prime__Util__GMP_liouville, file, "$");
+        XSANY.any_i32 = 1;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::is_totient", XS_Math__Prime__Util__GMP_liouville, file, "$");
+        XSANY.any_i32 = 3;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::liouville", XS_Math__Prime__Util__GMP_liouville, file, "$");
+        XSANY.any_i32 = 0;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::prime_bigomega", XS_Math__Prime__Util__GMP_liouville, file, "$");
+        XSANY.any_i32 = 9;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::prime_omega", XS_Math__Prime__Util__GMP_liouville, file, "$");
+        XSANY.any_i32 = 8;
+        (void)newXSproto_portable("Math::Prime::Util::GMP::is_powerful", XS_Math__Prime__Util__GMP_is_powerful, file, "$;$");
+        cv = newXSproto_portable("Math::Prime::Util::GMP::addint", XS_Math__Prime__Util__GMP_invmod, file, "$$");
+        XSANY.any_i32 = 13;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::binomial", XS_Math__Prime__Util__GMP_invmod, file, "$$");
+        XSANY.any_i32 = 1;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::cdivint", XS_Math__Prime__Util__GMP_invmod, file, "$$");
+        XSANY.any_i32 = 17;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::cdivrem", XS_Math__Prime__Util__GMP_invmod, file, "$$");
+        XSANY.any_i32 = 20;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::divint", XS_Math__Prime__Util__GMP_invmod, file, "$$");
+        XSANY.any_i32 = 15;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::divrem", XS_Math__Prime__Util__GMP_invmod, file, "$$");
+        XSANY.any_i32 = 21;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::factorialmod", XS_Math__Prime__Util__GMP_invmod, file, "$$");
+        XSANY.any_i32 = 22;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::fdivrem", XS_Math__Prime__Util__GMP_invmod, file, "$$");
+        XSANY.any_i32 = 19;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::gcdext", XS_Math__Prime__Util__GMP_invmod, file, "$$");
+        XSANY.any_i32 = 2;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::invmod", XS_Math__Prime__Util__GMP_invmod, file, "$$");
+        XSANY.any_i32 = 0;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::is_polygonal", XS_Math__Prime__Util__GMP_invmod, file, "$$");
+        XSANY.any_i32 = 7;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::is_primitive_root", XS_Math__Prime__Util__GMP_invmod, file, "$$");
+        XSANY.any_i32 = 6;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::jordan_totient", XS_Math__Prime__Util__GMP_invmod, file, "$$");
+        XSANY.any_i32 = 3;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::logint", XS_Math__Prime__Util__GMP_invmod, file, "$$");
+        XSANY.any_i32 = 10;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::modint", XS_Math__Prime__Util__GMP_invmod, file, "$$");
+        XSANY.any_i32 = 16;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::mulint", XS_Math__Prime__Util__GMP_invmod, file, "$$");
+        XSANY.any_i32 = 12;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::multifactorial", XS_Math__Prime__Util__GMP_invmod, file, "$$");
+        XSANY.any_i32 = 23;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::polygonal_nth", XS_Math__Prime__Util__GMP_invmod, file, "$$");
+        XSANY.any_i32 = 8;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::powint", XS_Math__Prime__Util__GMP_invmod, file, "$$");
+        XSANY.any_i32 = 11;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::rootint", XS_Math__Prime__Util__GMP_invmod, file, "$$");
+        XSANY.any_i32 = 9;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::sqrtmod", XS_Math__Prime__Util__GMP_invmod, file, "$$");
+        XSANY.any_i32 = 5;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::subint", XS_Math__Prime__Util__GMP_invmod, file, "$$");
+        XSANY.any_i32 = 14;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::tdivrem", XS_Math__Prime__Util__GMP_invmod, file, "$$");
+        XSANY.any_i32 = 18;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::znorder", XS_Math__Prime__Util__GMP_invmod, file, "$$");
+        XSANY.any_i32 = 4;
+        (void)newXSproto_portable("Math::Prime::Util::GMP::is_qr", XS_Math__Prime__Util__GMP_is_qr, file, "$$");
+        cv = newXSproto_portable("Math::Prime::Util::GMP::faulhaber_sum", XS_Math__Prime__Util__GMP_powersum, file, "$$");
+        XSANY.any_i32 = 1;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::powersum", XS_Math__Prime__Util__GMP_powersum, file, "$$");
+        XSANY.any_i32 = 0;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::lshiftint", XS_Math__Prime__Util__GMP_lshiftint, file, "$;$");
+        XSANY.any_i32 = 0;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::rashiftint", XS_Math__Prime__Util__GMP_lshiftint, file, "$;$");
+        XSANY.any_i32 = 2;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::rshiftint", XS_Math__Prime__Util__GMP_lshiftint, file, "$;$");
+        XSANY.any_i32 = 1;
+        (void)newXSproto_portable("Math::Prime::Util::GMP::powerful_count", XS_Math__Prime__Util__GMP_powerful_count, file, "$;$");
+        cv = newXSproto_portable("Math::Prime::Util::GMP::addmod", XS_Math__Prime__Util__GMP_addmod, file, "$$$");
+        XSANY.any_i32 = 0;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::divmod", XS_Math__Prime__Util__GMP_addmod, file, "$$$");
+        XSANY.any_i32 = 4;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::mulmod", XS_Math__Prime__Util__GMP_addmod, file, "$$$");
+        XSANY.any_i32 = 2;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::powmod", XS_Math__Prime__Util__GMP_addmod, file, "$$$");
+        XSANY.any_i32 = 3;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::submod", XS_Math__Prime__Util__GMP_addmod, file, "$$$");
+        XSANY.any_i32 = 1;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::muladdmod", XS_Math__Prime__Util__GMP_muladdmod, file, "$$$$");
+        XSANY.any_i32 = 0;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::mulsubmod", XS_Math__Prime__Util__GMP_muladdmod, file, "$$$$");
+        XSANY.any_i32 = 1;
+        (void)newXSproto_portable("Math::Prime::Util::GMP::is_mersenne_prime", XS_Math__Prime__Util__GMP_is_mersenne_prime, file, "$");
+        cv = newXSproto_portable("Math::Prime::Util::GMP::Euler", XS_Math__Prime__Util__GMP_Pi, file, "$");
+        XSANY.any_i32 = 1;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::Pi", XS_Math__Prime__Util__GMP_Pi, file, "$");
+        XSANY.any_i32 = 0;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::random_bytes", XS_Math__Prime__Util__GMP_Pi, file, "$");
+        XSANY.any_i32 = 2;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::consecutive_integer_lcm", XS_Math__Prime__Util__GMP_random_nbit_prime, file, "$");
+        XSANY.any_i32 = 15;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::factorial", XS_Math__Prime__Util__GMP_random_nbit_prime, file, "$");
+        XSANY.any_i32 = 9;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::factorial_sum", XS_Math__Prime__Util__GMP_random_nbit_prime, file, "$");
+        XSANY.any_i32 = 10;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::partitions", XS_Math__Prime__Util__GMP_random_nbit_prime, file, "$");
+        XSANY.any_i32 = 12;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::pn_primorial", XS_Math__Prime__Util__GMP_random_nbit_prime, file, "$");
+        XSANY.any_i32 = 14;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::primorial", XS_Math__Prime__Util__GMP_random_nbit_prime, file, "$");
+        XSANY.any_i32 = 13;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::random_maurer_prime", XS_Math__Prime__Util__GMP_random_nbit_prime, file, "$");
+        XSANY.any_i32 = 3;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::random_maurer_prime_with_cert", XS_Math__Prime__Util__GMP_random_nbit_prime, file, "$");
+        XSANY.any_i32 = 4;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::random_nbit_prime", XS_Math__Prime__Util__GMP_random_nbit_prime, file, "$");
+        XSANY.any_i32 = 0;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::random_ndigit_prime", XS_Math__Prime__Util__GMP_random_nbit_prime, file, "$");
+        XSANY.any_i32 = 7;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::random_safe_prime", XS_Math__Prime__Util__GMP_random_nbit_prime, file, "$");
+        XSANY.any_i32 = 1;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::random_shawe_taylor_prime", XS_Math__Prime__Util__GMP_random_nbit_prime, file, "$");
+        XSANY.any_i32 = 5;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::random_shawe_taylor_prime_with_cert", XS_Math__Prime__Util__GMP_random_nbit_prime, file, "$");
+        XSANY.any_i32 = 6;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::random_strong_prime", XS_Math__Prime__Util__GMP_random_nbit_prime, file, "$");
+        XSANY.any_i32 = 2;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::subfactorial", XS_Math__Prime__Util__GMP_random_nbit_prime, file, "$");
+        XSANY.any_i32 = 11;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::urandomb", XS_Math__Prime__Util__GMP_random_nbit_prime, file, "$");
+        XSANY.any_i32 = 8;
+        (void)newXSproto_portable("Math::Prime::Util::GMP::stirling", XS_Math__Prime__Util__GMP_stirling, file, "$$;$");
+        cv = newXSproto_portable("Math::Prime::Util::GMP::chinese", XS_Math__Prime__Util__GMP_chinese, file, "@");
+        XSANY.any_i32 = 0;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::chinese2", XS_Math__Prime__Util__GMP_chinese, file, "@");
+        XSANY.any_i32 = 1;
+        (void)newXSproto_portable("Math::Prime::Util::GMP::permtonum", XS_Math__Prime__Util__GMP_permtonum, file, "$");
+        (void)newXSproto_portable("Math::Prime::Util::GMP::numtoperm", XS_Math__Prime__Util__GMP_numtoperm, file, "$$");
+        cv = newXSproto_portable("Math::Prime::Util::GMP::sieve_prime_cluster", XS_Math__Prime__Util__GMP_sieve_prime_cluster, file, "$$;@");
+        XSANY.any_i32 = 0;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::sieve_primes", XS_Math__Prime__Util__GMP_sieve_prime_cluster, file, "$$;@");
+        XSANY.any_i32 = 1;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::sieve_twin_primes", XS_Math__Prime__Util__GMP_sieve_prime_cluster, file, "$$;@");
+        XSANY.any_i32 = 2;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::cluster_count", XS_Math__Prime__Util__GMP_cluster_count, file, "$$;@");
+        XSANY.any_i32 = 0;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::cluster_count_approx", XS_Math__Prime__Util__GMP_cluster_count, file, "$$;@");
+        XSANY.any_i32 = 1;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::twin_prime_count", XS_Math__Prime__Util__GMP_cluster_count, file, "$$;@");
+        XSANY.any_i32 = 2;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::twin_prime_count_approx", XS_Math__Prime__Util__GMP_cluster_count, file, "$$;@");
+        XSANY.any_i32 = 3;
+        (void)newXSproto_portable("Math::Prime::Util::GMP::sieve_range", XS_Math__Prime__Util__GMP_sieve_range, file, "$$$");
+        cv = newXSproto_portable("Math::Prime::Util::GMP::sieve_primes_bitmap", XS_Math__Prime__Util__GMP_sieve_primes_bitmap, file, "$$;$");
+        XSANY.any_i32 = 0;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::sieve_range_bitmap", XS_Math__Prime__Util__GMP_sieve_primes_bitmap, file, "$$;$");
+        XSANY.any_i32 = 1;
+        (void)newXSproto_portable("Math::Prime::Util::GMP::lucas_sequence", XS_Math__Prime__Util__GMP_lucas_sequence, file, "$$$$");
+        cv = newXSproto_portable("Math::Prime::Util::GMP::cheb_factor", XS_Math__Prime__Util__GMP_trial_factor, file, "$;@");
+        XSANY.any_i32 = 5;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::ecm_factor", XS_Math__Prime__Util__GMP_trial_factor, file, "$;@");
+        XSANY.any_i32 = 8;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::holf_factor", XS_Math__Prime__Util__GMP_trial_factor, file, "$;@");
+        XSANY.any_i32 = 6;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::pbrent_factor", XS_Math__Prime__Util__GMP_trial_factor, file, "$;@");
+        XSANY.any_i32 = 2;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::pminus1_factor", XS_Math__Prime__Util__GMP_trial_factor, file, "$;@");
+        XSANY.any_i32 = 3;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::pplus1_factor", XS_Math__Prime__Util__GMP_trial_factor, file, "$;@");
+        XSANY.any_i32 = 4;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::prho_factor", XS_Math__Prime__Util__GMP_trial_factor, file, "$;@");
+        XSANY.any_i32 = 1;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::qs_factor", XS_Math__Prime__Util__GMP_trial_factor, file, "$;@");
+        XSANY.any_i32 = 9;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::squfof_factor", XS_Math__Prime__Util__GMP_trial_factor, file, "$;@");
+        XSANY.any_i32 = 7;
+        cv = newXSproto_portable("Math::Prime::Util::GMP::trial_factor", XS_Math__Prime__Util__GMP_trial_factor, file, "$;@");
+        XSANY.any_i32 = 0;
+        (void)newXSproto_portable("Math::Prime::Util::GMP::factor", XS_Math__Prime__Util__GMP_factor, file, "$");
+        (void)newXSproto_portable("Math::Prime::Util::GMP::divisors", XS_Math__Prime__Util__GMP_divisors, file, "$;$");
+        (void)newXSproto_portable("Math::Prime::Util::GMP::fordivisors", XS_Math__Prime__Util__GMP_fordivisors, file, "&$;$$");
+        (void)newXSproto_portable("Math::Prime::Util::GMP::forprimes", XS_Math__Prime__Util__GMP_forprimes, file, "&$;$");
+        (void)newXSproto_portable("Math::Prime::Util::GMP::forclusters", XS_Math__Prime__Util__GMP_forclusters, file, "&$$@");
+        (void)newXSproto_portable("Math::Prime::Util::GMP::forprimegaps", XS_Math__Prime__Util__GMP_forprimegaps, file, "&$$$$;$");
+        (void)newXSproto_portable("Math::Prime::Util::GMP::_forprovable", XS_Math__Prime__Util__GMP__forprovable, file, "&@");
+        (void)newXSproto_portable("Math::Prime::Util::GMP::lastfor", XS_Math__Prime__Util__GMP_lastfor, file, "");
+        (void)newXSproto_portable("Math::Prime::Util::GMP::sigma", XS_Math__Prime__Util__GMP_sigma, file, "$;$");
+        (void)newXSproto_portable("Math::Prime::Util::GMP::todigits", XS_Math__Prime__Util__GMP_todigits, file, "$;$$");
+        (void)newXSproto_portable("Math::Prime::Util::GMP::fromdigits", XS_Math__Prime__Util__GMP_fromdigits, file, "$;$");
+#if PERL_VERSION_LE(5, 21, 5)
+#  if PERL_VERSION_GE(5, 9, 0)
+    if (PL_unitcheckav)
+        call_list(PL_scopestack_ix, PL_unitcheckav);
+#  endif
+    XSRETURN_YES;
+#else
+    Perl_xs_boot_epilog(aTHX_ ax);
+#endif
+}
+
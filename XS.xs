@@ -23,6 +23,11 @@
 #include "isaac.h"
 #include "random_prime.h"
 #include "real.h"
+#include "threadpool.h"
+#include "primegaps.h"
+#include "classpoly.h"
+#include "cert.h"
+#include "prime_iterator.h"
 #define _GMP_ECM_FACTOR(n, f, b1, ncurves) \
    _GMP_ecm_factor_projective(n, f, b1, 0, ncurves)
 
@@ -66,6 +71,84 @@ static int validate_and_set_signed(CV* cv, mpz_t v, const char* vname, const cha
   return neg;
 }
 
+/* Functions that only need the factorization of n also accept it directly,
+ * as an array reference of primes [2,2,3,...] or of [p,e] pairs.  Each
+ * prime is verified with BPSW before use. */
+static const char* factored_elem(CV* cv, AV* av, int i, int *e)
+{
+  AV *pav;
+  SV **svp, **esvp;
+  const char *s;
+  IV ev;
+
+  /* Arrays may have holes, so every fetch is checked. */
+  svp = av_fetch(av, i, 0);
+  if (svp == 0) croak("%s: undefined factor", GvNAME(CvGV(cv)));
+  *e = 1;
+  if (SvROK(*svp) && SvTYPE(SvRV(*svp)) == SVt_PVAV) {
+    pav = (AV*) SvRV(*svp);
+    if (av_len(pav) != 1)
+      croak("%s: factor pairs must be [p,e]", GvNAME(CvGV(cv)));
+    svp = av_fetch(pav, 0, 0);
+    esvp = av_fetch(pav, 1, 0);
+    if (svp == 0 || esvp == 0)
+      croak("%s: factor pairs must be [p,e]", GvNAME(CvGV(cv)));
+    ev = SvIV(*esvp);
+    if (ev < 0)
+      croak("%s: negative exponent", GvNAME(CvGV(cv)));
+    if (ev > (IV)INT_MAX)
+      croak("%s: exponent too large", GvNAME(CvGV(cv)));
+    *e = (int) ev;
+  }
+  s = SvPV_nolen(*svp);
+  if (*s == '+') s++;
+  return s;
+}
+
+static void factored_from_sv(CV* cv, factored_t* F, SV* sv)
+{
+  AV *av;
+  mpz_t *p;
+  int *e, i, len, ok, ei;
+
+  if (!SvROK(sv) || SvTYPE(SvRV(sv)) != SVt_PVAV)
+    croak("%s: factored input must be an array reference", GvNAME(CvGV(cv)));
+  av = (AV*) SvRV(sv);
+  len = av_len(av) + 1;
+  /* Check everything before allocating, so a croak leaks nothing. */
+  for (i = 0; i < len; i++)
+    validate_string_number(cv, "p", factored_elem(cv, av, i, &ei));
+  New(0, p, (len > 0) ? len : 1, mpz_t);
+  New(0, e, (len > 0) ? len : 1, int);
+  for (i = 0; i < len; i++)
+    mpz_init_set_str(p[i], factored_elem(cv, av, i, &e[i]), 10);
+  ok = factored_init_list(F, len, p, e);
+  for (i = 0; i < len; i++)
+    mpz_clear(p[i]);
+  Safefree(p);
+  Safefree(e);
+  if (!ok) {
+    factored_clear(F);
+    croak("%s: factor is not prime", GvNAME(CvGV(cv)));
+  }
+}
+
+#define IS_FACTORED_SV(sv) (SvROK(sv) && SvTYPE(SvRV(sv)) == SVt_PVAV)
+
+/* The range functions factor their range in blocks of this many values. */
+#define RANGE_BLOCK 32768
+static UV range_block_len(mpz_t lo, mpz_t hi)
+{
+  UV len;
+  mpz_t t;
+  if (mpz_cmp(lo, hi) > 0) return 0;
+  mpz_init(t);
+  mpz_sub(t, hi, lo);
+  len = (mpz_cmp_ui(t, RANGE_BLOCK-1) >= 0) ? RANGE_BLOCK : mpz_get_ui(t)+1;
+  mpz_clear(t);
+  return len;
+}
+
 static char* cert_with_header(char* proof, mpz_t n) {
   char *str, *strptr;
   if (proof == 0) {
@@ -100,6 +183,154 @@ static SV* sv_return_for_mpz(const mpz_t n) {
 #define XPUSH_MPZ(n) \
   XPUSHs(sv_2mortal( sv_return_for_mpz(n) ))
 
+static void sv_set_for_mpz(SV* sv, const mpz_t n) {
+  if (mpz_fits_ulong_p(n) && sizeof(unsigned long) <= sizeof(UV)) {
+    sv_setuv(sv, mpz_get_ui(n));
+  } else {
+    char* str;
+    New(0, str, mpz_sizeinbase(n, 10) + 2, char);
+    mpz_get_str(str, 10, n);
+    sv_setpv(sv, str);
+    Safefree(str);
+  }
+}
+
+/* Support for the for... functions taking a block.  $_ is localized and
+ * set to each value in turn.  lastfor() sets a flag that the loops check
+ * after every call.  The flag is saved on the scope stack too, so a nested
+ * loop does not lose a lastfor() from the block around it. */
+static int _for_lastfor = 0;
+
+#define START_FORBLOCK(svarg) \
+  do { \
+    ENTER; \
+    SAVETMPS; \
+    SAVESPTR(GvSV(PL_defgv)); \
+    svarg = newSV(0); \
+    GvSV(PL_defgv) = svarg; \
+    SAVEINT(_for_lastfor); \
+    _for_lastfor = 0; \
+  } while (0)
+
+#define CALL_FORBLOCK(subcv, svarg, v) \
+  do { \
+    dSP; \
+    sv_set_for_mpz(svarg, v); \
+    PUSHMARK(SP); \
+    call_sv((SV*)subcv, G_VOID|G_DISCARD); \
+  } while (0)
+
+#define END_FORBLOCK(svarg) \
+  do { \
+    SvREFCNT_dec(svarg); \
+    FREETMPS; \
+    LEAVE; \
+  } while (0)
+
+/* sieve_stream callback running a block. */
+typedef struct {
+  CV *subcv;
+  SV *svarg;
+} forblock_ctx_t;
+
+static int _forblock_stream(void *vctx, mpz_t v)
+{
+  forblock_ctx_t *ctx = (forblock_ctx_t*) vctx;
+  CALL_FORBLOCK(ctx->subcv, ctx->svarg, v);
+  return _for_lastfor;
+}
+
+/* prime_gap_search callback: $_ is the lower prime, @_ is (gap, merit). */
+static int _forblock_gap(void *vctx, mpz_t p1, UV gap, double merit)
+{
+  forblock_ctx_t *ctx = (forblock_ctx_t*) vctx;
+  dSP;
+  ENTER;         /* Free the arguments after each call, not at the end */
+  SAVETMPS;
+  sv_set_for_mpz(ctx->svarg, p1);
+  PUSHMARK(SP);
+  XPUSHs(sv_2mortal(newSVuv(gap)));
+  XPUSHs(sv_2mortal(newSVnv(merit)));
+  PUTBACK;
+  call_sv((SV*)ctx->subcv, G_VOID|G_DISCARD);
+  FREETMPS;
+  LEAVE;
+  return _for_lastfor;
+}
+
+/* ecpp_prove_batch callback: $_ is N, @_ is (result, proof text).  Other
+ * proofs are still running, so we must not croak here.  A die in the block
+ * stops the batch and is rethrown once it is done. */
+typedef struct {
+  CV    *subcv;
+  SV    *svarg;
+  mpz_t *N;
+  SV   **neg;     /* The input, for negative N (proven as 0) */
+  int    died;
+} forprovable_ctx_t;
+
+static int _forprovable_done(void *vctx, UV i, int result, char *cert)
+{
+  forprovable_ctx_t *ctx = (forprovable_ctx_t*) vctx;
+  dSP;
+  if (ctx->neg[i])  sv_setsv(ctx->svarg, ctx->neg[i]);
+  else              sv_set_for_mpz(ctx->svarg, ctx->N[i]);
+  PUSHMARK(SP);
+  XPUSHs(sv_2mortal(newSViv(result)));
+  XPUSHs(sv_2mortal(newSVpv((cert == 0) ? "" : cert, 0)));
+  PUTBACK;
+  call_sv((SV*)ctx->subcv, G_VOID|G_DISCARD|G_EVAL);
+  if (SvTRUE(ERRSV)) {
+    ctx->died = 1;
+    return 1;
+  }
+  return _for_lastfor;
+}
+
+/* For testing the prime iterators.  Chunk c of [lo,hi] is walked by its own
+ * iterator, placed with setprime, then placed again and walked a second
+ * time.  The chunks run on the thread pool. */
+typedef struct {
+  UV lo, hi, nchunks;
+  UV **list;
+  UV *count;
+  int bad;
+} itertest_ctx_t;
+
+static void _itertest_task(void *vctx, UV c)
+{
+  itertest_ctx_t *ctx = (itertest_ctx_t*) vctx;
+  UV width = (ctx->hi - ctx->lo) / ctx->nchunks + 1;
+  UV clo = ctx->lo + c*width;
+  UV chi = (c == ctx->nchunks-1) ? ctx->hi : clo + width - 1;
+  UV p, n = 0, alloc = 64, pass, k;
+  UV *list;
+  int bad = 0;
+  PRIME_ITERATOR(iter);
+
+  New(0, list, alloc, UV);
+  for (pass = 0; pass < 2; pass++) {
+    prime_iterator_setprime(&iter, clo-1);
+    for (k = 0, p = prime_iterator_next(&iter); p <= chi; p = prime_iterator_next(&iter), k++) {
+      if (pass == 1) {
+        if (k >= n || list[k] != p)  bad = 1;
+        continue;
+      }
+      if (n >= alloc)  Renew(list, alloc *= 2, UV);
+      list[n++] = p;
+    }
+    if (pass == 1 && k != n)  bad = 1;
+  }
+  prime_iterator_destroy(&iter);
+  ctx->list[c] = list;
+  ctx->count[c] = n;
+  if (bad) {
+    parallel_lock();
+    ctx->bad = 1;
+    parallel_unlock();
+  }
+}
+
 
 MODULE = Math::Prime::Util::GMP		PACKAGE = Math::Prime::Util::GMP
 
@@ -115,6 +346,189 @@ void _GMP_set_verbose(IN int v)
   PPCODE:
      set_verbose_level(v);
 
+void _GMP_set_threads(IN int n)
+  PPCODE:
+     set_thread_count(n);
+
+int _GMP_get_threads()
+  CODE:
+     RETVAL = get_thread_count();
+  OUTPUT:
+     RETVAL
+
+void _GMP_set_class_poly_db(IN SV* svpath = 0)
+  PPCODE:
+     if (!class_poly_db_set( (svpath != 0 && SvOK(svpath)) ? SvPV_nolen(svpath) : 0 ))
+       croak("_GMP_set_class_poly_db: cannot change the database while proofs are running");
+     free_class_polys();   /* The computed list depends on the database */
+
+void _GMP_class_poly(IN int i)
+  ALIAS:
+    _GMP_hilbert_class_poly = 1
+  PREINIT:
+    mpz_t* T = 0;
+    int D, type;
+    UV j, degree;
+  PPCODE:
+    /* ix 0:  D, type, and coefficients of the ECPP list entry i (from 1).
+     * ix 1:  coefficients of the Hilbert class polynomial for -i. */
+    if (ix == 0) {
+      degree = poly_class_poly_num(i, &D, &T, &type);
+    } else {
+      degree = (i < 3) ? 0 : hilbert_class_poly(&T, i);
+      D = -i;  type = 1;
+    }
+    if (degree == 0 || T == 0) XSRETURN_EMPTY;
+    if (ix == 0) {
+      XPUSHs(sv_2mortal(newSViv(D)));
+      XPUSHs(sv_2mortal(newSViv(type)));
+    }
+    for (j = 0; j <= degree; j++) {
+      XPUSH_MPZ(T[j]);
+      mpz_clear(T[j]);
+    }
+    Safefree(T);
+
+void _GMP_prime_iterator_walk(IN UV lo, IN UV hi, IN UV nchunks = 1)
+  PREINIT:
+    itertest_ctx_t ctx;
+    UV c, i;
+  PPCODE:
+    if (lo < 1) lo = 1;
+    if (nchunks < 1) nchunks = 1;
+    if (hi < lo || hi - lo + 1 < nchunks || hi >= UV_MAX - 1000)
+      croak("_GMP_prime_iterator_walk: bad range");
+    ctx.lo = lo;  ctx.hi = hi;  ctx.nchunks = nchunks;  ctx.bad = 0;
+    Newz(0, ctx.list, nchunks, UV*);
+    Newz(0, ctx.count, nchunks, UV);
+    parallel_for(nchunks, _itertest_task, &ctx);
+    for (c = 0; c < nchunks; c++) {
+      if (!ctx.bad)
+        for (i = 0; i < ctx.count[c]; i++)
+          XPUSHs(sv_2mortal(newSVuv(ctx.list[c][i])));
+      Safefree(ctx.list[c]);
+    }
+    Safefree(ctx.list);
+    Safefree(ctx.count);
+    if (ctx.bad) croak("_GMP_prime_iterator_walk: second walk differs");
+
+void _GMP_polyz_roots_modp(IN char* strn, ...)
+  PREINIT:
+    mpz_t n, *P, *roots;
+    long i, d, nroots;
+  PPCODE:
+    /* Roots mod prime n of the poly with coefficients ST(1) (constant) to
+     * ST(items-1), each 0 <= c < n. */
+    if (items < 2) croak("_GMP_polyz_roots_modp: no coefficients");
+    d = items - 2;
+    for (i = 0; i <= d; i++)
+      validate_string_number(cv, "c", SvPV_nolen(ST(i+1)));
+    VALIDATE_AND_SET(n, strn);
+    New(0, P, d+1, mpz_t);
+    for (i = 0; i <= d; i++)
+      mpz_init_set_str(P[i], SvPV_nolen(ST(i+1)), 10);
+    polyz_roots_modp(&roots, &nroots, 0, P, d, n);
+    for (i = 0; i <= d; i++)
+      mpz_clear(P[i]);
+    Safefree(P);
+    mpz_clear(n);
+    for (i = 0; i < nroots; i++) {
+      XPUSH_MPZ(roots[i]);
+      mpz_clear(roots[i]);
+    }
+    if (roots != 0) Safefree(roots);
+
+void _GMP_class_numbers(IN UV maxd)
+  PREINIT:
+    unsigned short* h;
+    UV d;
+  PPCODE:
+    h = class_numbers(maxd);
+    EXTEND(SP, (IV)maxd+1);
+    for (d = 0; d <= maxd; d++)
+      PUSHs(sv_2mortal(newSVuv(h[d])));
+    Safefree(h);
+
+void _GMP_set_ecpp_checkpoint(IN SV* svpath = 0)
+  PPCODE:
+     ecpp_set_checkpoint( (svpath != 0 && SvOK(svpath)) ? SvPV_nolen(svpath) : 0 );
+
+void _GMP_set_ecpp_policy(IN int eas, IN NV degree_bits = 2.0, IN NV step_seconds = 0.0)
+  PPCODE:
+     ecpp_set_policy(eas, degree_bits, step_seconds);
+
+void _GMP_ecpp_stats()
+  PREINIT:
+    ecpp_stats_t st;
+  PPCODE:
+    ecpp_get_stats(&st);
+    EXTEND(SP, 30);
+    PUSHs(sv_2mortal(newSVpv("levels", 0)));         PUSHs(sv_2mortal(newSVuv(st.levels)));
+    PUSHs(sv_2mortal(newSVpv("discriminants", 0)));  PUSHs(sv_2mortal(newSVuv(st.discs)));
+    PUSHs(sv_2mortal(newSVpv("factored", 0)));       PUSHs(sv_2mortal(newSVuv(st.mvalues)));
+    PUSHs(sv_2mortal(newSVpv("candidates", 0)));     PUSHs(sv_2mortal(newSVuv(st.candidates)));
+    PUSHs(sv_2mortal(newSVpv("downs", 0)));          PUSHs(sv_2mortal(newSVuv(st.downs)));
+    PUSHs(sv_2mortal(newSVpv("backtracks", 0)));     PUSHs(sv_2mortal(newSVuv(st.backtracks)));
+    PUSHs(sv_2mortal(newSVpv("eas_reorders", 0)));   PUSHs(sv_2mortal(newSVuv(st.eas_reorders)));
+    PUSHs(sv_2mortal(newSVpv("budget_stops", 0)));   PUSHs(sv_2mortal(newSVuv(st.budget_stops)));
+    PUSHs(sv_2mortal(newSVpv("curve_fails", 0)));    PUSHs(sv_2mortal(newSVuv(st.curve_fails)));
+    PUSHs(sv_2mortal(newSVpv("steps", 0)));          PUSHs(sv_2mortal(newSVuv(st.steps)));
+    PUSHs(sv_2mortal(newSVpv("bls_steps", 0)));      PUSHs(sv_2mortal(newSVuv(st.bls_steps)));
+    PUSHs(sv_2mortal(newSVpv("bits_removed", 0)));   PUSHs(sv_2mortal(newSVuv(st.bits_removed)));
+    PUSHs(sv_2mortal(newSVpv("fstage", 0)));         PUSHs(sv_2mortal(newSViv(st.fstage)));
+    PUSHs(sv_2mortal(newSVpv("factor_seconds", 0))); PUSHs(sv_2mortal(newSVnv(st.factor_seconds)));
+    PUSHs(sv_2mortal(newSVpv("curve_seconds", 0)));  PUSHs(sv_2mortal(newSVnv(st.curve_seconds)));
+    PUSHs(sv_2mortal(newSVpv("total_seconds", 0)));  PUSHs(sv_2mortal(newSVnv(st.total_seconds)));
+
+void verify_prime_certificate(IN SV* svcert)
+  PREINIT:
+    cert_step_t *steps;
+    const char *cert, *error;
+    STRLEN len;
+    UV i, nsteps;
+    int result;
+  PPCODE:
+    cert = SvPV(svcert, len);
+    result = verify_certificate(cert, len, &steps, &nsteps, &error);
+    if (result < 0) result = 0;
+    if (GIMME_V != G_ARRAY) {
+      cert_steps_free(steps, nsteps);
+      XSRETURN_IV(result);
+    }
+    EXTEND(SP, nsteps+1);
+    PUSHs(sv_2mortal(newSViv(result)));
+    for (i = 0; i < nsteps; i++) {
+      AV* av = newAV();
+      av_push(av, newSVpv(steps[i].name, 0));
+      av_push(av, sv_return_for_mpz(steps[i].n));
+      av_push(av, newSViv(steps[i].result));
+      av_push(av, newSVnv(steps[i].seconds));
+      av_push(av, steps[i].failed ? newSVpv(steps[i].failed, 0) : newSV(0));
+      PUSHs( sv_2mortal(newRV_noinc( (SV*) av )) );
+    }
+    cert_steps_free(steps, nsteps);
+
+void prime_certificate_to_binary(IN SV* svcert)
+  ALIAS:
+    prime_certificate_to_text = 1
+  PREINIT:
+    const char *cert, *error = 0;
+    char *out;
+    STRLEN len;
+    size_t outlen = 0;
+  PPCODE:
+    cert = SvPV(svcert, len);
+    if (ix == 0) {
+      out = cert_to_binary(cert, len, &outlen, &error);
+    } else {
+      out = cert_to_text(cert, len, &error);
+      if (out != 0) outlen = strlen(out);
+    }
+    if (out == 0)
+      croak("%s: %s", GvNAME(CvGV(cv)), error ? error : "invalid certificate");
+    XPUSHs(sv_2mortal(newSVpvn(out, outlen)));
+    Safefree(out);
+
 void seed_csprng(IN UV bytes, IN unsigned char* seed)
   PPCODE:
     isaac_init(bytes, seed);
@@ -516,7 +930,7 @@ void prime_count(IN char* strlo, IN char* strhi = 0)
     XPUSH_MPZ(res);
 
 void
-totient(IN char* strn)
+totient(IN SV* svn)
   ALIAS:
     carmichael_lambda = 1
     exp_mangoldt = 2
@@ -528,12 +942,34 @@ totient(IN char* strn)
     is_prime_power = 8
     prime_count_lower = 9
     prime_count_upper = 10
+    nth_prime = 11
     urandomm = 13
     add1int = 14
     sub1int = 15
   PREINIT:
     mpz_t res, n;
+    const char* strn;
   PPCODE:
+    if (IS_FACTORED_SV(svn) && (ix == 0 || ix == 1 || ix == 5)) {
+      factored_t F;
+      factored_from_sv(cv, &F, svn);
+      mpz_init(res);
+      switch (ix) {
+        case 0:  totient_factored(res, &F);  break;
+        case 1:  carmichael_lambda_factored(res, &F);  break;
+        case 5:
+        default: znprimroot_factored(res, &F);  break;
+      }
+      if (ix == 5 && !mpz_sgn(res) && mpz_cmp_ui(F.n,1) != 0) {
+        factored_clear(&F);  mpz_clear(res);
+        XSRETURN_UNDEF;
+      }
+      XPUSH_MPZ(res);
+      factored_clear(&F);
+      mpz_clear(res);
+      XSRETURN(1);
+    }
+    strn = SvPV_nolen(svn);
     if (strn != 0 && strn[0] == '-') { /* If input is negative... */
       if (ix == 2)  XSRETURN_IV(1);    /* exp_mangoldt return 1 */
       if (ix == 5)  strn++;            /* znprimroot flip sign */
@@ -563,6 +999,12 @@ totient(IN char* strn)
       case 8:  mpz_set_uv(res, prime_power(res, n)); break;
       case 9:  prime_count_lower(res, n); break;
       case 10: prime_count_upper(res, n); break;
+      case 11: nth_prime(res, n);
+               if (!mpz_sgn(res)) {
+                 mpz_clear(n);  mpz_clear(res);
+                 XSRETURN_UNDEF;
+               }
+               break;
       case 13: mpz_isaac_urandomm(res, n); break;
       case 14: mpz_add_ui(res, n, 1); break;
       case 15: mpz_sub_ui(res, n, 1); break;
@@ -874,26 +1316,126 @@ kronecker(IN char* stra, IN char* strb)
     RETVAL
 
 void
-moebius(IN char* strn, IN char* stro = 0)
+moebius(IN SV* svn, IN char* stro = 0)
   PREINIT:
     mpz_t n;
   PPCODE:
-    validate_and_set_signed(cv, n, "n", strn, VSETNEG_OK);
+    if (IS_FACTORED_SV(svn) && stro == 0) {
+      factored_t F;
+      int result;
+      factored_from_sv(cv, &F, svn);
+      result = moebius_factored(&F);
+      factored_clear(&F);
+      XSRETURN_IV(result);
+    }
+    validate_and_set_signed(cv, n, "n", SvPV_nolen(svn), VSETNEG_OK);
     if (stro == 0) {
       int result = moebius(n);
       mpz_clear(n);
       XSRETURN_IV(result);
     } else {   /* Ranged result */
       mpz_t nhi;
+      factored_t *F;
+      UV i, len;
       validate_and_set_signed(cv, nhi, "nhi", stro, VSETNEG_OK);
-      while (mpz_cmp(n, nhi) <= 0) {
+      while (mpz_cmp(n, nhi) <= 0 && mpz_sgn(n) <= 0) {
         XPUSHs(sv_2mortal(newSViv( moebius(n) )));
         mpz_add_ui(n, n, 1);
       }
+      while ((len = range_block_len(n, nhi)) > 0) {
+        F = factor_range(n, len);
+        EXTEND(SP, (IV)len);
+        for (i = 0; i < len; i++)
+          PUSHs(sv_2mortal(newSViv( moebius_factored(F+i) )));
+        factor_range_free(F, len);
+        mpz_add_ui(n, n, len);
+      }
       mpz_clear(n);
       mpz_clear(nhi);
     }
 
+void
+totient_range(IN char* strlo, IN char* strhi)
+  ALIAS:
+    liouville_range = 1
+    prime_omega_range = 2
+    prime_bigomega_range = 3
+    is_semiprime_range = 4
+    carmichael_lambda_range = 5
+  PREINIT:
+    mpz_t lo, hi, res;
+    factored_t *F;
+    UV i, len;
+  PPCODE:
+    VALIDATE_AND_SET(lo, strlo);
+    VALIDATE_AND_SET(hi, strhi);
+    mpz_init(res);
+    if (mpz_sgn(lo) == 0 && mpz_cmp(lo, hi) <= 0) {
+      switch (ix) {
+        case 0:  XPUSHs(sv_2mortal(newSVuv(0)));  break;
+        case 1:  XPUSHs(sv_2mortal(newSViv(-1)));  break;
+        case 2:
+        case 3:  XPUSHs(sv_2mortal(newSVuv(1)));  break;
+        case 4:
+        case 5:
+        default: XPUSHs(sv_2mortal(newSVuv(0)));  break;
+      }
+      mpz_add_ui(lo, lo, 1);
+    }
+    while ((len = range_block_len(lo, hi)) > 0) {
+      F = factor_range(lo, len);
+      EXTEND(SP, (IV)len);
+      for (i = 0; i < len; i++) {
+        switch (ix) {
+          case 0:  totient_factored(res, F+i);
+                   PUSHs(sv_2mortal(sv_return_for_mpz(res)));
+                   break;
+          case 1:  PUSHs(sv_2mortal(newSViv(liouville_factored(F+i))));  break;
+          case 2:  PUSHs(sv_2mortal(newSVuv(omega_factored(F+i))));  break;
+          case 3:  PUSHs(sv_2mortal(newSVuv(bigomega_factored(F+i))));  break;
+          case 4:  PUSHs(sv_2mortal(newSVuv(bigomega_factored(F+i) == 2)));  break;
+          case 5:
+          default: carmichael_lambda_factored(res, F+i);
+                   PUSHs(sv_2mortal(sv_return_for_mpz(res)));
+                   break;
+        }
+      }
+      factor_range_free(F, len);
+      mpz_add_ui(lo, lo, len);
+    }
+    mpz_clear(res);
+    mpz_clear(hi);
+    mpz_clear(lo);
+
+void
+sigma_range(IN char* strlo, IN char* strhi, IN UV k = 1)
+  PREINIT:
+    mpz_t lo, hi, res;
+    factored_t *F;
+    UV i, len;
+  PPCODE:
+    VALIDATE_AND_SET(lo, strlo);
+    VALIDATE_AND_SET(hi, strhi);
+    mpz_init(res);
+    if (mpz_sgn(lo) == 0 && mpz_cmp(lo, hi) <= 0) {
+      sigma(res, lo, k);
+      XPUSH_MPZ(res);
+      mpz_add_ui(lo, lo, 1);
+    }
+    while ((len = range_block_len(lo, hi)) > 0) {
+      F = factor_range(lo, len);
+      EXTEND(SP, (IV)len);
+      for (i = 0; i < len; i++) {
+        sigma_factored(res, F+i, k);
+        PUSHs(sv_2mortal(sv_return_for_mpz(res)));
+      }
+      factor_range_free(F, len);
+      mpz_add_ui(lo, lo, len);
+    }
+    mpz_clear(res);
+    mpz_clear(hi);
+    mpz_clear(lo);
+
 void lucasu(IN char* strp, IN char* strq, IN char* strk)
   ALIAS:
     lucasv = 1
@@ -943,7 +1485,7 @@ void lucasumod(IN char* strp, IN char* strq, IN char* strk, IN char* strn)
     mpz_clear(n); mpz_clear(k); mpz_clear(q); mpz_clear(p);
 
 int
-liouville(IN char* strn)
+liouville(IN SV* svn)
   ALIAS:
     is_square = 1
     is_semiprime = 2
@@ -958,7 +1500,21 @@ liouville(IN char* strn)
     mpz_t n;
     int isneg;
   CODE:
-    isneg = validate_and_set_signed( cv, n, "n", strn,
+    if (IS_FACTORED_SV(svn) && (ix == 0 || ix == 2 || ix == 4 || ix == 8 || ix == 9)) {
+      factored_t F;
+      factored_from_sv(cv, &F, svn);
+      switch (ix) {
+        case 0:  RETVAL = liouville_factored(&F);  break;
+        case 2:  RETVAL = (bigomega_factored(&F) == 2);  break;
+        case 4:  RETVAL = is_carmichael_factored(&F);  break;
+        case 8:  RETVAL = omega_factored(&F);  break;
+        case 9:
+        default: RETVAL = bigomega_factored(&F);  break;
+      }
+      factored_clear(&F);
+      XSRETURN_IV(RETVAL);
+    }
+    isneg = validate_and_set_signed( cv, n, "n", SvPV_nolen(svn),
                                      (ix == 0) ? VSETNEG_ERR
                                    : (ix  < 7) ? VSETNEG_OK
                                    :             VSETNEG_POS );
@@ -995,7 +1551,7 @@ is_powerful(IN char* strn, IN UV k = 0)
     RETVAL
 
 void
-invmod(IN char* stra, IN char* strb)
+invmod(IN char* stra, IN SV* svb)
   ALIAS:
     binomial = 1
     gcdext = 2
@@ -1024,8 +1580,22 @@ invmod(IN char* stra, IN char* strb)
     mpz_t a, b, t;
     int retundef;
   PPCODE:
+    if (IS_FACTORED_SV(svb) && (ix == 3 || ix == 4)) {
+      factored_t F;
+      /* Check a before F is made, and set it after, so a croak leaks nothing */
+      validate_string_number(cv, "a", (*stra == '+' || *stra == '-') ? stra+1 : stra);
+      factored_from_sv(cv, &F, svb);
+      validate_and_set_signed(cv, a, "a", stra, VSETNEG_OK);
+      if (ix == 3)  jordan_totient_factored(a, &F, mpz_get_ui(a));
+      else          znorder_factored(a, a, &F);
+      factored_clear(&F);
+      if (ix == 4 && !mpz_sgn(a)) { mpz_clear(a); XSRETURN_UNDEF; }
+      XPUSH_MPZ(a);
+      mpz_clear(a);
+      XSRETURN(1);
+    }
     validate_and_set_signed(cv, a, "a", stra, VSETNEG_OK);
-    validate_and_set_signed(cv, b, "b", strb, VSETNEG_OK);
+    validate_and_set_signed(cv, b, "b", SvPV_nolen(svb), VSETNEG_OK);
     retundef = 0;
     switch (ix) {
                /* undef if a|b = 0, 0 if b is 1, else result of mpz_invert */
@@ -1569,6 +2139,45 @@ sieve_prime_cluster(IN char* strlow, IN char* strhigh, ...)
     mpz_clear(high);
     mpz_clear(low);
 
+void
+cluster_count(IN char* strlow, IN char* strhigh, ...)
+  ALIAS:
+    cluster_count_approx = 1
+    twin_prime_count = 2
+    twin_prime_count_approx = 3
+  PREINIT:
+    mpz_t low, high, count;
+    uint32_t *cl;
+    UV i, nc;
+  PPCODE:
+    if (ix >= 2 && items != 2)
+      croak("Usage: twin_prime_count(lo,hi)");
+    /* Check all the input before allocating anything */
+    validate_string_number(cv, "low", (*strlow == '+') ? strlow+1 : strlow);
+    validate_string_number(cv, "high", (*strhigh == '+') ? strhigh+1 : strhigh);
+    nc = (ix >= 2) ? 2 : items-1;
+    for (i = 1; ix < 2 && i < nc; i++) {
+      UV cval = SvUV(ST(1+i)), prev = (i == 1) ? 0 : SvUV(ST(i));
+      if (cval & 1) croak("cluster_count: values must be even");
+      if (cval > 2147483647UL) croak("cluster_count: values must be 31-bit");
+      if (cval <= prev) croak("cluster_count: values must be increasing");
+    }
+    VALIDATE_AND_SET(low, strlow);
+    VALIDATE_AND_SET(high, strhigh);
+    New(0, cl, nc, uint32_t);
+    cl[0] = 0;
+    if (ix >= 2) cl[1] = 2;
+    for (i = 1; ix < 2 && i < nc; i++)
+      cl[i] = SvUV(ST(1+i));
+    mpz_init(count);
+    if (ix & 1)  cluster_count_approx(count, low, high, cl, nc);
+    else         cluster_count(count, low, high, cl, nc);
+    Safefree(cl);
+    XPUSH_MPZ(count);
+    mpz_clear(count);
+    mpz_clear(high);
+    mpz_clear(low);
+
 void
 sieve_range(IN char* strn, IN UV width, IN UV depth)
   PREINIT:
@@ -1621,6 +2230,40 @@ sieve_range(IN char* strn, IN UV width, IN UV depth)
     mpz_clear(high);
     mpz_clear(low);
 
+void
+sieve_primes_bitmap(IN char* strlow, IN char* strhigh, IN UV k = 0)
+  ALIAS:
+    sieve_range_bitmap = 1
+  PREINIT:
+    mpz_t low, high;
+    unsigned char *bytes;
+    UV nbits, nbytes;
+    SV *sv;
+  PPCODE:
+    VALIDATE_AND_SET(low, strlow);
+    VALIDATE_AND_SET(high, strhigh);
+    if (ix == 1) {              /* (n, width, depth) */
+      mpz_add(high, high, low);
+      mpz_sub_ui(high, high, 1);
+      if (k == 0) k = 1;
+    } else if (k < 2) {
+      k = 0;
+    }
+    bytes = sieve_primes_bitmap(low, high, k, &nbits);
+    mpz_clear(high);
+    mpz_clear(low);
+    if (bytes == 0) XSRETURN_PV("");
+    nbytes = (nbits + 7) / 8;
+#ifdef SV_HAS_TRAILING_NUL
+    bytes[nbytes] = 0;          /* Hand the buffer to Perl, no copy */
+    sv = newSV(0);
+    sv_usepvn_flags(sv, (char*)bytes, nbytes, SV_HAS_TRAILING_NUL);
+#else
+    sv = newSVpvn((char*)bytes, nbytes);
+    Safefree(bytes);
+#endif
+    XPUSHs(sv_2mortal(sv));
+
 void
 lucas_sequence(IN char* strn, IN IV P, IN IV Q, IN char* strk)
   PREINIT:
@@ -1753,8 +2396,6 @@ trial_factor(IN char* strn, ...)
 
 void
 factor(IN char* strn)
-  ALIAS:
-    divisors = 1
   PREINIT:
     mpz_t n;
     mpz_t* factors;
@@ -1762,43 +2403,235 @@ factor(IN char* strn)
     int nfactors, i, j;
   PPCODE:
     VALIDATE_AND_SET(n, strn);
-    if (ix == 0) {
-      nfactors = factor(n, &factors, &exponents);
-      if (GIMME_V == G_SCALAR) {
-        for (i = 0, j = 0; i < nfactors; i++)
-          j += exponents[i];
-        PUSHs(sv_2mortal(newSVuv(j)));
-      } else {
-        for (i = 0; i < nfactors; i++) {
-          for (j = 0; j < exponents[i]; j++) {
-            XPUSH_MPZ(factors[i]);
-          }
-        }
-      }
-      clear_factors(nfactors, &factors, &exponents);
+    nfactors = factor(n, &factors, &exponents);
+    if (GIMME_V == G_SCALAR) {
+      for (i = 0, j = 0; i < nfactors; i++)
+        j += exponents[i];
+      PUSHs(sv_2mortal(newSVuv(j)));
     } else {
-      if (GIMME_V == G_SCALAR) {
-        sigma(n, n, 0);
-        XPUSH_MPZ(n);
-      } else {
-        factors = divisor_list(&nfactors, n);
-        EXTEND(SP, nfactors);
-        for (i = 0; i < nfactors; i++) {
+      for (i = 0; i < nfactors; i++) {
+        for (j = 0; j < exponents[i]; j++) {
           XPUSH_MPZ(factors[i]);
-          mpz_clear(factors[i]);
         }
-        Safefree(factors);
       }
     }
+    clear_factors(nfactors, &factors, &exponents);
     mpz_clear(n);
 
 void
-sigma(IN char* strn, IN UV k = 1)
+divisors(IN char* strn, IN char* strk = 0)
   PREINIT:
-    mpz_t n;
+    mpz_t n, k;
+    divisor_iterator iter;
+    UV count;
+  PPCODE:
+    if (strk != 0)   /* Before n is set, so a bad k does not leak it */
+      validate_string_number(cv, "k", (*strk == '+') ? strk+1 : strk);
+    VALIDATE_AND_SET(n, strn);
+    if (strk == 0 && GIMME_V == G_SCALAR) {
+      sigma(n, n, 0);
+      XPUSH_MPZ(n);
+      mpz_clear(n);
+      XSRETURN(1);
+    }
+    if (strk != 0)
+      VALIDATE_AND_SET(k, strk);
+    /* Scalar context only needs a count, so use the unordered walk. */
+    divisor_iterator_init(&iter, n, 0, (strk == 0) ? 0 : k, GIMME_V != G_SCALAR);
+    count = 0;
+    while (divisor_iterator_next(&iter, n)) {
+      if (GIMME_V == G_SCALAR) count++;
+      else                     XPUSH_MPZ(n);
+    }
+    divisor_iterator_destroy(&iter);
+    if (GIMME_V == G_SCALAR)
+      XPUSHs(sv_2mortal(newSVuv(count)));
+    if (strk != 0) mpz_clear(k);
+    mpz_clear(n);
+
+void
+fordivisors(SV* block, IN char* strn, IN char* strlo = 0, IN char* strhi = 0)
+  PROTOTYPE: &$;$$
+  PREINIT:
+    mpz_t n, lo, hi, d;
+    divisor_iterator iter;
+    GV *gv;
+    HV *stash;
+    SV *svarg;
+    CV *subcv;
   PPCODE:
+    subcv = sv_2cv(block, &stash, &gv, 0);
+    if (subcv == Nullcv)
+      croak("Not a subroutine reference");
     VALIDATE_AND_SET(n, strn);
-    sigma(n, n, k);
+    if (strlo != 0)  VALIDATE_AND_SET(lo, strlo);
+    if (strhi != 0)  VALIDATE_AND_SET(hi, strhi);
+    mpz_init(d);
+    divisor_iterator_init(&iter, n, (strlo == 0) ? 0 : lo, (strhi == 0) ? 0 : hi, 1);
+    START_FORBLOCK(svarg);
+    while (divisor_iterator_next(&iter, d)) {
+      CALL_FORBLOCK(subcv, svarg, d);
+      if (_for_lastfor) break;
+    }
+    END_FORBLOCK(svarg);
+    divisor_iterator_destroy(&iter);
+    mpz_clear(d);
+    if (strhi != 0)  mpz_clear(hi);
+    if (strlo != 0)  mpz_clear(lo);
+    mpz_clear(n);
+    XSRETURN_EMPTY;
+
+void
+forprimes(SV* block, IN char* strlo, IN char* strhi = 0)
+  PROTOTYPE: &$;$
+  PREINIT:
+    mpz_t lo, hi;
+    GV *gv;
+    HV *stash;
+    forblock_ctx_t ctx;
+  PPCODE:
+    ctx.subcv = sv_2cv(block, &stash, &gv, 0);
+    if (ctx.subcv == Nullcv)
+      croak("Not a subroutine reference");
+    if (strhi == 0) {
+      mpz_init_set_ui(lo, 2);
+      VALIDATE_AND_SET(hi, strlo);
+    } else {
+      VALIDATE_AND_SET(lo, strlo);
+      VALIDATE_AND_SET(hi, strhi);
+    }
+    START_FORBLOCK(ctx.svarg);
+    sieve_stream(lo, hi, 0, 0, 0, _forblock_stream, &ctx);
+    END_FORBLOCK(ctx.svarg);
+    mpz_clear(hi);
+    mpz_clear(lo);
+    XSRETURN_EMPTY;
+
+void
+forclusters(SV* block, IN char* strlo, IN char* strhi, ...)
+  PROTOTYPE: &$$@
+  PREINIT:
+    mpz_t lo, hi;
+    GV *gv;
+    HV *stash;
+    forblock_ctx_t ctx;
+    uint32_t *cl;
+    UV i, nc;
+  PPCODE:
+    ctx.subcv = sv_2cv(block, &stash, &gv, 0);
+    if (ctx.subcv == Nullcv)
+      croak("Not a subroutine reference");
+    nc = items-2;
+    New(0, cl, nc, uint32_t);
+    cl[0] = 0;
+    for (i = 1; i < nc; i++) {
+      UV cval = SvUV(ST(2+i));
+      if (cval & 1 || cval > 2147483647UL || cval <= cl[i-1]) {
+        Safefree(cl);
+        croak("forclusters: values must be even, 31-bit, and increasing");
+      }
+      cl[i] = cval;
+    }
+    VALIDATE_AND_SET(lo, strlo);
+    VALIDATE_AND_SET(hi, strhi);
+    START_FORBLOCK(ctx.svarg);
+    sieve_stream(lo, hi, 0, cl, nc, _forblock_stream, &ctx);
+    END_FORBLOCK(ctx.svarg);
+    Safefree(cl);
+    mpz_clear(hi);
+    mpz_clear(lo);
+    XSRETURN_EMPTY;
+
+void
+forprimegaps(SV* block, IN char* strk, IN UV mlo, IN UV mhi, IN NV minmerit, IN UV depth = 0)
+  PROTOTYPE: &$$$$;$
+  PREINIT:
+    mpz_t K;
+    GV *gv;
+    HV *stash;
+    forblock_ctx_t ctx;
+    int ok;
+  PPCODE:
+    ctx.subcv = sv_2cv(block, &stash, &gv, 0);
+    if (ctx.subcv == Nullcv)
+      croak("Not a subroutine reference");
+    VALIDATE_AND_SET(K, strk);
+    START_FORBLOCK(ctx.svarg);
+    ok = prime_gap_search(K, mlo, mhi, minmerit, depth, _forblock_gap, &ctx);
+    END_FORBLOCK(ctx.svarg);
+    mpz_clear(K);
+    if (!ok) croak("forprimegaps: centres must be at least 3");
+    XSRETURN_EMPTY;
+
+void
+_forprovable(SV* block, ...)
+  PROTOTYPE: &@
+  PREINIT:
+    GV *gv;
+    HV *stash;
+    forprovable_ctx_t ctx;
+    UV i, n;
+  PPCODE:
+    ctx.subcv = sv_2cv(block, &stash, &gv, 0);
+    if (ctx.subcv == Nullcv)
+      croak("Not a subroutine reference");
+    n = items-1;
+    if (n == 0)
+      XSRETURN_EMPTY;
+    for (i = 0; i < n; i++) {
+      const char* s = SvPV_nolen(ST(1+i));
+      if (*s == '+') s++;
+      if (*s != '-')
+        validate_string_number(cv, "n", s);
+    }
+    New(0, ctx.N, n, mpz_t);
+    Newz(0, ctx.neg, n, SV*);
+    for (i = 0; i < n; i++) {
+      const char* s = SvPV_nolen(ST(1+i));
+      if (*s == '+') s++;
+      if (*s == '-') {   /* Negative numbers give 0 */
+        mpz_init(ctx.N[i]);
+        ctx.neg[i] = newSVsv(ST(1+i));
+      } else {
+        mpz_init_set_str(ctx.N[i], s, 10);
+      }
+    }
+    ctx.died = 0;
+    START_FORBLOCK(ctx.svarg);
+    ecpp_prove_batch(ctx.N, n, _forprovable_done, &ctx);
+    END_FORBLOCK(ctx.svarg);
+    for (i = 0; i < n; i++) {
+      mpz_clear(ctx.N[i]);
+      if (ctx.neg[i])  SvREFCNT_dec(ctx.neg[i]);
+    }
+    Safefree(ctx.neg);
+    Safefree(ctx.N);
+    if (ctx.died)
+      croak(Nullch);
+    XSRETURN_EMPTY;
+
+void
+lastfor()
+  PROTOTYPE:
+  PPCODE:
+    _for_lastfor = 1;
+    XSRETURN_EMPTY;
+
+void
+sigma(IN SV* svn, IN UV k = 1)
+  PREINIT:
+    mpz_t n;
+  PPCODE:
+    if (IS_FACTORED_SV(svn)) {
+      factored_t F;
+      factored_from_sv(cv, &F, svn);
+      mpz_init(n);
+      sigma_factored(n, &F, k);
+      factored_clear(&F);
+    } else {
+      VALIDATE_AND_SET(n, SvPV_nolen(svn));
+      sigma(n, n, k);
+    }
     XPUSH_MPZ(n);
     mpz_clear(n);
 
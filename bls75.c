@@ -318,11 +318,13 @@ static void handle_factor2(mpz_t f, mpz_t R, mpz_t F,
   }
 }
 
-static void trim_factors(mpz_t F, mpz_t R, mpz_t n, mpz_t n_pm_one, UV B, fstack_t* fs, limit_func_t func, mpz_t t, mpz_t m, mpz_t r, mpz_t s) {
+/* Returns 0 if the stack is inconsistent (no croak, as ECPP batch proofs
+ * call us from worker threads), 1 otherwise. */
+static int trim_factors(mpz_t F, mpz_t R, mpz_t n, mpz_t n_pm_one, UV B, fstack_t* fs, limit_func_t func, mpz_t t, mpz_t m, mpz_t r, mpz_t s) {
   int i;
   if (ev > 1) gmp_printf("Starting trim with F %Zd R %Zd\n", F, R);
   if (fs->cur > 1) {
-    if (mpz_odd_p(n_pm_one)) croak("n-1 / n+1 isn't even in trim_factors");
+    if (mpz_odd_p(n_pm_one)) return 0;   /* n-1 / n+1 isn't even */
     mpz_set_ui(F, 1);
     mpz_set(R, n_pm_one);
     for (i = 0; i < fs->cur; i++) {
@@ -338,9 +340,10 @@ static void trim_factors(mpz_t F, mpz_t R, mpz_t n, mpz_t n_pm_one, UV B, fstack
       pop_fstack(t, fs);
   }
   /* Verify Q[0] = 2 */
-  if (mpz_cmp_ui(fs->stack[0], 2) != 0)
-    croak("BLS75 internal error: 2 not at start of fstack");
+  if (fs->cur == 0 || mpz_cmp_ui(fs->stack[0], 2) != 0)
+    return 0;
   /* r and s have been set by func */
+  return 1;
 }
 
 static int numcmp(const void *av, const void *bv)
@@ -387,7 +390,7 @@ static int bls_theorem5_limit(mpz_t n, mpz_t A, mpz_t B, UV dummy,
 {
   mpz_mul(t, A, B);
   mpz_add_ui(t, t, 1);
-  if (mpz_cmp(t, n) != 0) croak("BLS75 internal error: A*B != n-1\n");
+  if (mpz_cmp(t, n) != 0) return 0;   /* A*B != n-1 */
 
   mpz_mul_ui(t, A, 2);
   mpz_tdiv_qr(s, r, B, t);
@@ -407,7 +410,7 @@ static int bls_theorem7_limit(mpz_t n, mpz_t F1, mpz_t R1, UV B1,
 {
   mpz_mul(t, F1, R1);
   mpz_add_ui(t, t, 1);
-  if (mpz_cmp(t, n) != 0) croak("BLS75 internal error: F1*R1 != n-1\n");
+  if (mpz_cmp(t, n) != 0) return 0;   /* F1*R1 != n-1 */
 
   mpz_mul_ui(t, F1, 2);
   mpz_tdiv_qr(s, r, R1, t);
@@ -437,7 +440,7 @@ static int bls_theorem17_limit(mpz_t n, mpz_t F2, mpz_t R2, UV dummy,
 {
   mpz_mul(t, F2, R2);
   mpz_sub_ui(t, t, 1);
-  if (mpz_cmp(t, n) != 0) croak("BLS75 internal error: F2*R2 != n+1\n");
+  if (mpz_cmp(t, n) != 0) return 0;   /* F2*R2 != n+1 */
 
   mpz_mul_ui(t, F2, 2);
   mpz_tdiv_qr(s, r, R2, t);
@@ -462,7 +465,7 @@ static int bls_theorem19_limit(mpz_t n, mpz_t F2, mpz_t R2, UV B2,
 {
   mpz_mul(t, F2, R2);
   mpz_sub_ui(t, t, 1);
-  if (mpz_cmp(t, n) != 0) croak("BLS75 internal error: F2*R2 != n+1\n");
+  if (mpz_cmp(t, n) != 0) return 0;   /* F2*R2 != n+1 */
 
   mpz_mul_ui(t, F2, 2);
   mpz_tdiv_qr(s, r, R2, t);
@@ -634,7 +637,7 @@ static int _test_III_D(mpz_t n, mpz_t np1, IV D, IV P, IV Q, fstack_t* qi, mpz_t
   for (ipq = 0; nqileft > 0 && ipq < 12; ipq++) {
     if (ipq > 0) {  Q += P+1;  P += 2;  }
     if (ev > 1) gmp_printf("   n %Zd   III start  D %ld  P %ld Q %ld\n", n, D, P, Q);
-    if ((P*P-4*Q) != D) croak("test_III_D bad D construction");
+    if ((P*P-4*Q) != D) break;   /* bad D construction: not sure */
     mpz_set_iv(t1,P);
     mpz_set_iv(t2,Q);
     mpz_gcd(t, n, t2);
@@ -726,7 +729,8 @@ static int _test_III_IV(mpz_t n, mpz_t np1, mpz_t R2, fstack_t* fstack,
 static int _prove_T19(mpz_t n, mpz_t np1, mpz_t F2, mpz_t R2, UV B2,
                       fstack_t* fstack, mpz_t t, mpz_t m, mpz_t r, mpz_t s)
 {
-  trim_factors(F2, R2, n, np1, B2, fstack, &bls_theorem19_limit, t, m, r, s);
+  if (!trim_factors(F2, R2, n, np1, B2, fstack, &bls_theorem19_limit, t, m, r, s))
+    return 0;
   if (!bls_theorem19_limit(n, F2, R2, B2, t,m,r,s))
     return 0;
    mpz_mul(t, r, r);
@@ -745,7 +749,23 @@ static int _prove_T19(mpz_t n, mpz_t np1, mpz_t F2, mpz_t R2, UV B2,
 
 
 
+void bls_partial_init(bls_partial_t* part) {
+  mpz_init(part->n);
+  mpz_init(part->r1);
+  mpz_init(part->r2);
+}
+void bls_partial_clear(bls_partial_t* part) {
+  mpz_clear(part->n);
+  mpz_clear(part->r1);
+  mpz_clear(part->r2);
+}
+
 int BLS_primality_nm1(mpz_t n, int effort, char** prooftextptr)
+{
+  return BLS_primality_nm1_partial(n, effort, prooftextptr, 0);
+}
+
+int BLS_primality_nm1_partial(mpz_t n, int effort, char** prooftextptr, bls_partial_t* part)
 {
   mpz_t nm1, F1, R1, t, m, f, r, s;
   FACTOR_STACK(fstack);
@@ -827,6 +847,12 @@ start_nm1_proof:
 
   if (ev) gmp_printf("n-1 start proof  %d n %Zd  nm1 %Zd  F1 %Zd R1 %Zd B1 %lu\n",success,n,nm1,F1,R1,B1);
 
+  if (part) {   /* F1 holds only proven factors */
+    mpz_set(part->n, n);
+    mpz_set(part->r1, R1);
+    mpz_set_ui(part->r2, 0);
+  }
+
   /* clear mstack since we don't care about it.  Use to hold a values. */
   clear_fstack(&mstack);
 
@@ -834,10 +860,10 @@ start_nm1_proof:
 
   /* Shrink to smallest set and verify conditions. */
   if (success > 0) {
-    trim_factors(F1, R1, n, nm1, B1, &fstack, limitfunc, t, m, r, s);
     /* Verify conditions */
     success = 0;
-    if (limitfunc(n, F1, R1, B1, t, m, r, s)) {
+    if (trim_factors(F1, R1, n, nm1, B1, &fstack, limitfunc, t, m, r, s)
+        && limitfunc(n, F1, R1, B1, t, m, r, s)) {
       mpz_mul(t, r, r);
       mpz_submul_ui(t, s, 8);   /* t = r^2 - 8s */
       /* N is prime if and only if s=0 OR t not a perfect square */
@@ -879,6 +905,8 @@ start_nm1_proof:
     mpz_clear(ap);
   }
 
+  if (success > 0 && prooftextptr != 0 && nstack(&fstack) != nstack(&mstack))
+    success = 0;   /* Different f and a counts, so no certificate */
   if (success > 0 && prooftextptr != 0) {
     int i;
     char *proofstr, *proofptr;
@@ -887,7 +915,6 @@ start_nm1_proof:
     int msp = nstack(&mstack);
     int myprooflen = (5 + mpz_sizeinbase(n, 10)) * (2 + fsp + msp) + 200;
 
-    if (fsp != msp) croak("Different f and a counts\n");
     New(0, proofstr, myprooflen + curprooflen + 1, char);
     proofptr = proofstr;
     proofptr += gmp_sprintf(proofptr, "Type BLS5\nN  %Zd\n", n);
@@ -1046,6 +1073,11 @@ start_np1_proof:
  *    Comb  Corollary 11
  */
 int BLS_primality(mpz_t n, int effort, char** prooftextptr)
+{
+  return BLS_primality_partial(n, effort, prooftextptr, 0);
+}
+
+int BLS_primality_partial(mpz_t n, int effort, char** prooftextptr, bls_partial_t* part)
 {
   mpz_t nm1, np1, F1, F2, R1, R2;
   mpz_t r, s, t, u, f, c1, c2;
@@ -1176,12 +1208,23 @@ int BLS_primality(mpz_t n, int effort, char** prooftextptr)
   }
 
 start_hybrid_proof:
-  mpz_mul(t, F1, R1); if (mpz_cmp(nm1, t) != 0) croak("Bad n-1 factor");
-  mpz_mul(t, F2, R2); if (mpz_cmp(np1, t) != 0) croak("Bad n+1 factor");
+  mpz_mul(t, F1, R1); if (mpz_cmp(nm1, t) != 0) { success = 0; goto end_hybrid; }
+  mpz_mul(t, F2, R2); if (mpz_cmp(np1, t) != 0) { success = 0; goto end_hybrid; }
 
   /* We've done all the factoring we need or can. */
   if (ev) gmp_printf("start hybrid:  N %Zd  F2 %Zd  R2 %Zd  B1 %lu\n", n, F2, R2, B1);
 
+  if (part) {   /* F1 and F2 also hold the probable primes, so start over */
+    int i;
+    mpz_set(part->n, n);
+    mpz_set(part->r1, nm1);
+    for (i = 0; i < f1stack.cur; i++)
+      mpz_remove(part->r1, part->r1, f1stack.stack[i]);
+    mpz_set(part->r2, np1);
+    for (i = 0; i < f2stack.cur; i++)
+      mpz_remove(part->r2, part->r2, f2stack.stack[i]);
+  }
+
   /* Finish proofs for p{1,2}stack as needed. */
   /* TODO: optimize for cases of both n-1 and n+1 working */
   if (nstack(&p1stack) > 0) {
@@ -1190,9 +1233,10 @@ start_hybrid_proof:
       pop_fstack(f, &p1stack);
       if (effort > low_effort)
         pr = BLS_primality(f, effort, prooftextptr);
-      if      (pr == 0) croak("probable prime factor proved composite");
-      else if (pr == 2) push_fstack(&f1stack, f); /* Proved, put on F stack */
-      else              factor_out(F1, R1, f);    /* No proof.  Move to R */
+      /* pr == 0 would be a BPSW counterexample.  It can't be used, but
+       * n-1 / n+1 is still right with it in R, so no need to croak. */
+      if (pr == 2) push_fstack(&f1stack, f); /* Proved, put on F stack */
+      else         factor_out(F1, R1, f);    /* No proof.  Move to R */
     }
   }
   if (nstack(&p2stack) > 0) {
@@ -1201,9 +1245,8 @@ start_hybrid_proof:
       pop_fstack(f, &p2stack);
       if (effort > low_effort)
         pr = BLS_primality(f, effort, prooftextptr);
-      if      (pr == 0) croak("probable prime factor proved composite");
-      else if (pr == 2) push_fstack(&f2stack, f); /* Proved, put on F stack */
-      else              factor_out(F2, R2, f);    /* No proof.  Move to R */
+      if (pr == 2) push_fstack(&f2stack, f); /* Proved, put on F stack */
+      else         factor_out(F2, R2, f);    /* No proof.  Move to R */
     }
   }
 
@@ -1225,7 +1268,8 @@ start_hybrid_proof:
   if (bls_theorem7_limit(n, F1, R1, B1, t, u, r, s)) {
     if (get_verbose_level() > 0) printf("BLS75 proof using N-1\n");
     if (ev) gmp_printf("N %Zd  F1 %Zd  R1 %Zd  B1 %lu\n", n, F1, R1, B1);
-    trim_factors(F1, R1, n, nm1, B1, &f1stack, &bls_theorem7_limit, t, u, r, s);
+    if (!trim_factors(F1, R1, n, nm1, B1, &f1stack, &bls_theorem7_limit, t, u, r, s))
+      { success = 0;  goto end_hybrid; }
     if (ev) gmp_printf("N %Zd  F1 %Zd  R1 %Zd  B1 %lu\n", n, F1, R1, B1);
     for (pcount = 0; success > 0 && pcount < f1stack.cur; pcount++)
       success = _verify_cond_I_p(n, f1stack.stack[pcount], u, t, 1000, 0);
@@ -1265,7 +1309,7 @@ start_hybrid_proof:
       pop_fstack(t, &f2stack);
     /* Verify Q[0] = 2 */
     if (mpz_cmp_ui(f2stack.stack[0], 2) != 0)
-      croak("BLS75 internal error: 2 not at start of fstack");
+      success = 0;
   }
 
   /* Check lambda divisibility if needed */
@@ -1445,7 +1489,7 @@ int BLS_check_T15(mpz_t n, mpz_t f, IV* lp, IV* lq)
 
 end_bls15:
   /* Somehow there is a tester getting 0 for LQ */
-  if (rval && lq && *lq < 2) croak("Internal error in BLS15\n");
+  if (rval && lq && *lq < 2) rval = 0;
   mpz_clear(np1);  mpz_clear(m);  mpz_clear(t);  mpz_clear(t2);
   return rval;
 }
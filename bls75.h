@@ -27,4 +27,19 @@ extern int BLS_primality_np1(mpz_t n, int effort, char** prooftextptr);
 /* BLS75 theorem 20 complete proof (N-1 and N+1) */
 extern int BLS_primality(mpz_t n, int effort, char** prooftextptr);
 
+
+/* What the factoring in a proof learned, so ECPP can carry on from it.
+ * r1 and r2 are n-1 and n+1 with the proven prime factors taken out, or 0
+ * where that side was not looked at. */
+typedef struct {
+  mpz_t n, r1, r2;
+} bls_partial_t;
+
+extern void bls_partial_init(bls_partial_t* part);
+extern void bls_partial_clear(bls_partial_t* part);
+
+/* As BLS_primality_nm1 and BLS_primality, also filling in part. */
+extern int BLS_primality_nm1_partial(mpz_t n, int effort, char** prooftextptr, bls_partial_t* part);
+extern int BLS_primality_partial(mpz_t n, int effort, char** prooftextptr, bls_partial_t* part);
+
 #endif
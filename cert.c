@@ -0,0 +1,1318 @@
+/*
+ * Primality certificate verification.
+ *
+ * This is the verifier of examples/vcert.c made into a library routine.
+ * The certificate is parsed once into an array of steps, each saying "if
+ * these Q values are prime then N is prime".  Primo steps are converted to
+ * the equivalent MPU step as they are read, since their conditions depend
+ * on the N of the previous step.
+ *
+ * The steps are independent of each other, so they are checked in parallel,
+ * largest first so the long ECPP steps at the top of the chain do not end
+ * up last.  What is left to do serially is cheap: checking that every Q
+ * value used has a step of its own or is small enough to be proven by BPSW.
+ *
+ * MPU certificates also have a compact binary form, converted to and from
+ * the text by the same parser, which the verifier reads directly.
+ *
+ * Nothing run by the workers may croak, so the conditions of each step are
+ * returned as the text of the first one to fail.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <gmp.h>
+#include "ptypes.h"
+
+#include "cert.h"
+#include "primality.h"
+#include "lucas_seq.h"
+#include "ecpp.h"
+#include "threadpool.h"
+#include "utility.h"
+
+/*****************************************************************************/
+/* Steps                                                                     */
+/*****************************************************************************/
+
+static void _step_init(cert_step_t *s, int type, const char *name)
+{
+  s->type = type;
+  s->result = 0;
+  s->name = name;
+  s->failed = 0;
+  s->seconds = 0.0;
+  mpz_init(s->n);  mpz_init(s->a);  mpz_init(s->b);
+  mpz_init(s->m);  mpz_init(s->q);  mpz_init(s->x);
+  mpz_init(s->y);  mpz_init(s->lp); mpz_init(s->lq);
+  s->nq = 0;
+  s->qs = s->as = 0;
+}
+
+static void _step_clear(cert_step_t *s)
+{
+  int j;
+  mpz_clear(s->n);  mpz_clear(s->a);  mpz_clear(s->b);
+  mpz_clear(s->m);  mpz_clear(s->q);  mpz_clear(s->x);
+  mpz_clear(s->y);  mpz_clear(s->lp); mpz_clear(s->lq);
+  for (j = 0; j < s->nq; j++) {
+    mpz_clear(s->qs[j]);
+    mpz_clear(s->as[j]);
+  }
+  if (s->qs != 0) Safefree(s->qs);
+  if (s->as != 0) Safefree(s->as);
+}
+
+void cert_steps_free(cert_step_t *steps, UV nsteps)
+{
+  UV i;
+  for (i = 0; i < nsteps; i++)
+    _step_clear(steps + i);
+  if (steps != 0) Safefree(steps);
+}
+
+/* Make room for factor index i of a BLS5 or Lucas step. */
+static void _step_grow_qs(cert_step_t *s, int i)
+{
+  if (i < s->nq) return;
+  if (s->qs == 0) { New(0, s->qs, i+1, mpz_t);  New(0, s->as, i+1, mpz_t); }
+  else            { Renew(s->qs, i+1, mpz_t);  Renew(s->as, i+1, mpz_t); }
+  while (s->nq <= i) {
+    mpz_init_set_ui(s->qs[s->nq], 0);
+    mpz_init_set_ui(s->as[s->nq], 2);
+    s->nq++;
+  }
+}
+
+/*****************************************************************************/
+/* Step conditions                                                           */
+/*****************************************************************************/
+
+/* Each of these checks that N is prime assuming its Q values are, returning
+ * the condition that failed or 0.  See examples/vcert.c for the theorems. */
+
+/* N <= 2^64 passes BPSW, which has no counterexamples in that range. */
+static const char* _check_small(mpz_t n)
+{
+  if (mpz_sizeinbase(n, 2) > 64)     return "N <= 2^64";
+  if (mpz_cmp_ui(n, 2) < 0)          return "N does not pass BPSW";
+  if (mpz_perfect_square_p(n))       return "N does not pass BPSW";
+  if (_GMP_is_prob_prime(n) != 2)    return "N does not pass BPSW";
+  return 0;
+}
+
+/* Atkin and Morain, Theorem 5.2 / Corollary 5.1, with s = q prime. */
+static const char* _check_ecpp(cert_step_t *s, mpz_t t1, mpz_t t2)
+{
+  mpz_ptr N = s->n;
+  int r;
+
+  mpz_mod(s->a, s->a, N);
+  mpz_mod(s->b, s->b, N);
+  if (mpz_cmp_ui(N, 0) <= 0)         return "N > 0";
+  if (mpz_gcd_ui(NULL, N, 6) != 1)   return "gcd(N, 6) = 1";
+  mpz_mul(t1, s->a, s->a);
+  mpz_mul(t1, t1, s->a);
+  mpz_mul_ui(t1, t1, 4);
+  mpz_mul(t2, s->b, s->b);
+  mpz_mul_ui(t2, t2, 27);
+  mpz_add(t1, t1, t2);
+  mpz_gcd(t1, t1, N);
+  if (mpz_cmp_ui(t1, 1) != 0)        return "gcd(4*a^3 + 27*b^2, N) = 1";
+  mpz_mul(t1, s->x, s->x);
+  mpz_add(t1, t1, s->a);
+  mpz_mul(t1, t1, s->x);
+  mpz_add(t1, t1, s->b);
+  mpz_mod(t1, t1, N);
+  mpz_mul(t2, s->y, s->y);
+  mpz_mod(t2, t2, N);
+  if (mpz_cmp(t1, t2) != 0)          return "Y^2 = X^3 + A*X + B mod N";
+  mpz_mul_ui(t2, N, 4);
+  mpz_sqrt(t2, t2);
+  mpz_add_ui(t1, N, 1);
+  mpz_sub(t1, t1, t2);
+  if (mpz_cmp(s->m, t1) < 0)         return "M >= N + 1 - 2*sqrt(N)";
+  mpz_add_ui(t1, N, 1);
+  mpz_add(t1, t1, t2);
+  if (mpz_cmp(s->m, t1) > 0)         return "M <= N + 1 + 2*sqrt(N)";
+  mpz_root(t1, N, 4);
+  mpz_add_ui(t1, t1, 1);
+  mpz_mul(t1, t1, t1);
+  if (mpz_cmp(s->q, t1) <= 0)        return "Q > (N^(1/4)+1)^2";
+  if (mpz_cmp(s->q, N) >= 0)         return "Q < N";
+  if (!mpz_divisible_p(s->m, s->q))  return "Q divides M";
+
+  mpz_mod(s->x, s->x, N);
+  mpz_mod(s->y, s->y, N);
+  r = ecpp_check_point(s->x, s->y, s->m, s->q, s->a, N, t1, t2);
+  if (r == 0)                        return "Factor found for N";
+  if (r != 2)                        return "(M/Q)P != O and MP = O";
+  return 0;
+}
+
+/* BLS75 Theorem 15. */
+static const char* _check_bls15(cert_step_t *s, mpz_t t1, mpz_t t2)
+{
+  mpz_ptr N = s->n, Q = s->q, M = s->m, k = s->x;
+
+  if (mpz_even_p(Q))                 return "Q odd";
+  if (mpz_cmp_ui(Q, 2) <= 0)         return "Q > 2";
+  if (mpz_cmp_ui(N, 2) <= 0)         return "N > 2";
+  if (mpz_even_p(N))                 return "N odd";
+  mpz_add_ui(t2, N, 1);
+  if (!mpz_divisible_p(t2, Q))       return "Q divides N+1";
+  mpz_divexact(M, t2, Q);
+  mpz_mul_ui(t1, Q, 2);
+  mpz_sub_ui(t1, t1, 1);
+  mpz_sqrt(t2, N);
+  if (mpz_cmp(t1, t2) <= 0)          return "2Q-1 > sqrt(N)";
+  mpz_mul(t1, s->lp, s->lp);
+  mpz_mul_ui(t2, s->lq, 4);
+  mpz_sub(t1, t1, t2);
+  if (mpz_sgn(t1) == 0)              return "D != 0";
+  if (mpz_jacobi(t1, N) != -1)       return "jacobi(D,N) = -1";
+  mpz_tdiv_q_2exp(k, M, 1);
+  lucasvmod(t1, s->lp, s->lq, k, N, t2);
+  if (mpz_sgn(t1) == 0)              return "V_{m/2} mod N != 0";
+  mpz_add_ui(k, N, 1);
+  mpz_tdiv_q_2exp(k, k, 1);
+  lucasvmod(t1, s->lp, s->lq, k, N, t2);
+  if (mpz_sgn(t1) != 0)              return "V_{(N+1)/2} mod N == 0";
+  return 0;
+}
+
+/* Pocklington with a single prime factor q > sqrt(N)-1 of N-1. */
+static const char* _check_pocklington(cert_step_t *s, mpz_t t1, mpz_t t2)
+{
+  mpz_ptr N = s->n, Q = s->q, M = s->m, A = s->a;
+
+  if (mpz_cmp_ui(N, 2) <= 0)         return "N > 2";
+  if (mpz_cmp_ui(Q, 0) <= 0)         return "Q > 0";
+  mpz_sub_ui(t2, N, 1);
+  if (!mpz_divisible_p(t2, Q))       return "Q divides N-1";
+  mpz_divexact(M, t2, Q);
+  if (mpz_odd_p(M))                  return "M is even";
+  if (mpz_cmp_ui(M, 0) <= 0)         return "M > 0";
+  if (mpz_cmp(M, Q) >= 0)            return "M < Q";
+  if (mpz_cmp_ui(A, 1) <= 0)         return "A > 1";
+  if (mpz_cmp(A, N) >= 0)            return "A < N";
+  mpz_powm(t1, A, t2, N);
+  if (mpz_cmp_ui(t1, 1) != 0)        return "A^(N-1) mod N = 1";
+  mpz_powm(t1, A, M, N);
+  if (mpz_sgn(t1)) mpz_sub_ui(t1, t1, 1);
+  else             mpz_set(t1, t2);
+  mpz_gcd(t1, t1, N);
+  if (mpz_cmp_ui(t1, 1) != 0)        return "gcd(A^M - 1, N) = 1";
+  return 0;
+}
+
+/* BLS75 Theorem 3. */
+static const char* _check_bls3(cert_step_t *s, mpz_t t1, mpz_t t2)
+{
+  mpz_ptr N = s->n, Q = s->q, M = s->m, A = s->a;
+
+  if (mpz_even_p(Q))                 return "Q odd";
+  if (mpz_cmp_ui(Q, 2) <= 0)         return "Q > 2";
+  if (mpz_cmp_ui(N, 2) <= 0)         return "N > 2";
+  mpz_sub_ui(t2, N, 1);
+  if (!mpz_divisible_p(t2, Q))       return "Q divides N-1";
+  mpz_divexact(M, t2, Q);
+  if (mpz_cmp_ui(M, 0) <= 0)         return "M > 0";
+  mpz_mul_ui(t1, Q, 2);
+  mpz_add_ui(t1, t1, 1);
+  mpz_sqrt(t2, N);
+  if (mpz_cmp(t1, t2) <= 0)          return "2Q+1 > sqrt(N)";
+  mpz_sub_ui(t2, N, 1);
+  mpz_divexact_ui(t1, t2, 2);
+  mpz_powm(t1, A, t1, N);
+  if (mpz_cmp(t1, t2) != 0)          return "A^((N-1)/2) = N-1 mod N";
+  mpz_divexact_ui(t1, M, 2);
+  mpz_powm(t1, A, t1, N);
+  if (mpz_cmp(t1, t2) == 0)          return "A^(M/2) != N-1 mod N";
+  return 0;
+}
+
+/* BLS75 Theorem 5 with m = 1.  qs[0] = 2. */
+static const char* _check_bls5(cert_step_t *s, mpz_t t1, mpz_t t2)
+{
+  mpz_ptr N = s->n;
+  const char *fail = 0;
+  mpz_t F, R, sq, r;
+  int i;
+
+  if (mpz_cmp_ui(N, 2) <= 0)         return "N > 2";
+  if (mpz_even_p(N))                 return "N odd";
+  mpz_sub_ui(t2, N, 1);
+  for (i = 0; i < s->nq; i++) {
+    if (mpz_cmp_ui(s->qs[i], 1) <= 0)   return "Q > 1";
+    if (mpz_cmp(s->qs[i], t2) >= 0)     return "Q < N-1";
+    if (mpz_cmp_ui(s->as[i], 1) <= 0)   return "A > 1";
+    if (mpz_cmp(s->as[i], t2) >= 0)     return "A < N-1";
+    if (!mpz_divisible_p(t2, s->qs[i])) return "Q divides N-1";
+  }
+  mpz_init_set_ui(F, 1);
+  mpz_init_set(R, t2);
+  mpz_init(sq);  mpz_init(r);
+  for (i = 0; i < s->nq; i++) {
+    while (mpz_divisible_p(R, s->qs[i])) {
+      mpz_mul(F, F, s->qs[i]);
+      mpz_divexact(R, R, s->qs[i]);
+    }
+  }
+  mpz_gcd(t1, F, R);
+  if      (mpz_odd_p(F))             fail = "F is even";
+  else if (mpz_cmp_ui(t1, 1) != 0)   fail = "gcd(F, R) = 1";
+  if (!fail) {
+    mpz_mul_ui(t1, F, 2);
+    mpz_tdiv_qr(sq, r, R, t1);
+    mpz_sub_ui(t2, r, 1);
+    mpz_add(t1, t1, t2);
+    mpz_mul(t1, t1, F);
+    mpz_add_ui(t1, t1, 1);           /* 2F^2 + (r-1)F + 1 */
+    mpz_add_ui(t2, F, 1);
+    mpz_mul(t1, t1, t2);
+    if (mpz_cmp(N, t1) >= 0)         fail = "N < (F+1)(2F^2+(r-1)F+1)";
+    else if (mpz_sgn(sq) != 0) {
+      mpz_mul(t2, r, r);
+      mpz_submul_ui(t2, sq, 8);
+      if (mpz_perfect_square_p(t2))  fail = "S=0 OR R^2-8S not a perfect square";
+    }
+  }
+  mpz_clear(F);  mpz_clear(R);  mpz_clear(sq);  mpz_clear(r);
+  if (fail) return fail;
+
+  mpz_sub_ui(t2, N, 1);
+  for (i = 0; i < s->nq; i++) {
+    mpz_powm(t1, s->as[i], t2, N);
+    if (mpz_cmp_ui(t1, 1) != 0)      return "A[i]^(N-1) mod N = 1";
+    mpz_divexact(t1, t2, s->qs[i]);
+    mpz_powm(t1, s->as[i], t1, N);
+    if (mpz_sgn(t1)) mpz_sub_ui(t1, t1, 1);
+    else             mpz_set(t1, t2);
+    mpz_gcd(t1, t1, N);
+    if (mpz_cmp_ui(t1, 1) != 0)      return "gcd(A[i]^((N-1)/Q[i]) - 1, N) = 1";
+  }
+  return 0;
+}
+
+/* Lehmer 1927, Theorem 2: N-1 completely factored. */
+static const char* _check_lucas(cert_step_t *s, mpz_t t1, mpz_t t2)
+{
+  mpz_ptr N = s->n, A = s->a, R = s->m;
+  int i;
+
+  if (mpz_cmp_ui(N, 2) <= 0)         return "N > 2";
+  if (mpz_cmp_ui(A, 1) <= 0)         return "A > 1";
+  if (mpz_cmp(A, N) >= 0)            return "A < N";
+  mpz_sub_ui(t2, N, 1);
+  mpz_powm(t1, A, t2, N);
+  if (mpz_cmp_ui(t1, 1) != 0)        return "A^(N-1) mod N = 1";
+  mpz_set(R, t2);
+  for (i = 0; i < s->nq; i++) {
+    if (mpz_cmp_ui(s->qs[i], 1) <= 0)   return "Q > 1";
+    if (mpz_cmp(s->qs[i], t2) >= 0)     return "Q < N-1";
+    if (!mpz_divisible_p(t2, s->qs[i])) return "Q divides N-1";
+    mpz_divexact(t1, t2, s->qs[i]);
+    mpz_powm(t1, A, t1, N);
+    if (mpz_cmp_ui(t1, 1) == 0)      return "A^((N-1)/Q[i]) mod N != 1";
+    while (mpz_divisible_p(R, s->qs[i]))
+      mpz_divexact(R, R, s->qs[i]);
+  }
+  if (mpz_cmp_ui(R, 1) != 0)         return "N-1 has only factors Q[i]";
+  return 0;
+}
+
+/*****************************************************************************/
+/* Parsing                                                                   */
+/*****************************************************************************/
+
+#define CERT_BAD_LINES_ALLOWED  5    /* For Primo, as vcert */
+
+typedef struct {
+  char        *s;
+  size_t       len, size;
+} cert_buf_t;
+
+typedef struct {
+  const char  *p;           /* Rest of the text */
+  const unsigned char *b, *bend;  /* Rest of a binary certificate */
+  cert_buf_t  *out;         /* The other form, if converting */
+  char        *line;        /* Current line, trimmed */
+  size_t       size;
+  int          base;
+  const char  *error;
+  cert_step_t *steps;
+  UV           nsteps, maxsteps;
+  mpz_t        proofn, S, R, T, J, W, t1, t2;
+} cert_parse_t;
+
+static int _next_line(cert_parse_t *P)
+{
+  const char *s = P->p, *e;
+  size_t len;
+
+  if (*s == '\0') return 0;
+  e = strchr(s, '\n');
+  if (e == 0) e = s + strlen(s);
+  P->p = (*e == '\0') ? e : e+1;
+  while (s < e && isspace((unsigned char)*s))     s++;
+  while (e > s && isspace((unsigned char)e[-1]))  e--;
+  len = e - s;
+  if (len+1 > P->size) {
+    P->size = 2*len + 64;
+    Renew(P->line, P->size, char);
+  }
+  memcpy(P->line, s, len);
+  P->line[len] = '\0';
+  return 1;
+}
+
+static int _need_line(cert_parse_t *P)
+{
+  if (_next_line(P)) return 1;
+  P->error = "unexpected end of certificate";
+  return 0;
+}
+
+static cert_step_t* _new_step(cert_parse_t *P, int type, const char *name)
+{
+  if (P->nsteps >= P->maxsteps) {
+    P->maxsteps = (P->maxsteps == 0) ? 32 : 2*P->maxsteps;
+    if (P->steps == 0) New(0, P->steps, P->maxsteps, cert_step_t);
+    else               Renew(P->steps, P->maxsteps, cert_step_t);
+  }
+  _step_init(P->steps + P->nsteps, type, name);
+  return P->steps + P->nsteps++;
+}
+
+/* Split "NAME value" in place. */
+static int _mpu_split(char *line, char **name, char **value)
+{
+  char *v = line;
+  while (*v != '\0' && !isspace((unsigned char)*v))  v++;
+  if (*v == '\0' || v == line) return 0;
+  *v++ = '\0';
+  while (isspace((unsigned char)*v))  v++;
+  *name = line;
+  *value = v;
+  return *v != '\0';
+}
+
+static mpz_ptr _mpu_slot(cert_parse_t *P, cert_step_t *s, const char *name)
+{
+  if (!strcmp(name, "N"))   return s->n;
+  if (!strcmp(name, "A"))   return s->a;
+  if (!strcmp(name, "B"))   return s->b;
+  if (!strcmp(name, "M"))   return s->m;
+  if (!strcmp(name, "Q"))   return s->q;
+  if (!strcmp(name, "X"))   return s->x;
+  if (!strcmp(name, "Y"))   return s->y;
+  if (!strcmp(name, "LP"))  return s->lp;
+  if (!strcmp(name, "LQ"))  return s->lq;
+  if (!strcmp(name, "S"))   return P->S;
+  if (!strcmp(name, "R"))   return P->R;
+  if (!strcmp(name, "T"))   return P->T;
+  if (!strcmp(name, "J"))   return P->J;
+  return 0;
+}
+
+/* Read the space separated variables in vars, each once, in any order. */
+static int _mpu_vars(cert_parse_t *P, cert_step_t *s, const char *vars)
+{
+  char want[32], *list[8], *name, *value, *w;
+  int i, nvars = 0, nfound = 0;
+
+  strcpy(want, vars);
+  for (w = strtok(want, " "); w != 0 && nvars < 8; w = strtok(NULL, " "))
+    list[nvars++] = w;
+  while (nfound < nvars) {
+    if (!_need_line(P)) return 0;
+    if (P->line[0] == '\0' || P->line[0] == '#') continue;
+    if (!_mpu_split(P->line, &name, &value))
+      { P->error = "bad variable line";  return 0; }
+    for (i = 0; i < nvars; i++)
+      if (list[i] != 0 && !strcmp(list[i], name))
+        break;
+    if (i >= nvars)
+      { P->error = "unknown or repeated variable";  return 0; }
+    list[i] = 0;
+    if (mpz_set_str(_mpu_slot(P, s, name), value, P->base) != 0)
+      { P->error = "bad number";  return 0; }
+    nfound++;
+  }
+  return 1;
+}
+
+/* A Primo variable line "V$=hex" (format 3), or "V=$hex", "V=0xhex", or
+ * "V=dec" (format 4), with an optional '-' before the value.  Returns the
+ * variable letter, or 0 if this is not such a line. */
+static int _primo_var(const char *line, mpz_t v)
+{
+  int name = line[0], neg = 0, base = 10;
+  const char *p = line+1;
+
+  if (!isupper(name)) return 0;
+  if (*p == '$') { p++; base = 16; }
+  if (*p++ != '=') return 0;
+  if (*p == '-') { p++; neg = 1; }
+  if (*p == '$')                                 { p++;   base = 16; }
+  else if (p[0] == '0' && (p[1] == 'x' || p[1] == 'X')) { p += 2; base = 16; }
+  if (*p == '\0' || mpz_set_str(v, p, base) != 0) return 0;
+  if (neg) mpz_neg(v, v);
+  return name;
+}
+
+static mpz_ptr _primo_slot(cert_parse_t *P, cert_step_t *s, int name)
+{
+  switch (name) {
+    case 'S': return P->S;
+    case 'R': return P->R;
+    case 'T': return P->T;
+    case 'J': return P->J;
+    case 'W': return P->W;
+    case 'A': return s->a;
+    case 'B': return s->b;
+    case 'Q': return s->lq;
+    default:  return 0;
+  }
+}
+
+/* Read Primo variables into the step until vars (format 3), or one of the
+ * format 4 sets, have been seen.  Returns the format 4 step type. */
+static int _primo_vars(cert_parse_t *P, cert_step_t *s, const char *vars)
+{
+  char seen[128];
+  int c, bad_lines = 0;
+
+  memset(seen, 0, sizeof(seen));
+  while (1) {
+    if (!_need_line(P)) return 0;
+    if (P->line[0] == '\0') continue;
+    if (P->line[0] == '[')
+      { P->error = "variables missing from proof step";  return 0; }
+    c = _primo_var(P->line, P->t1);
+    if (c != 0 && _primo_slot(P, s, c) != 0 &&
+        (vars == 0 || strchr(vars, c) != 0)) {
+      mpz_set(_primo_slot(P, s, c), P->t1);
+      seen[c] = 1;
+      bad_lines = 0;
+    } else if (bad_lines++ >= CERT_BAD_LINES_ALLOWED) {
+      P->error = "too many bad lines reading variables";
+      return 0;
+    }
+    if (vars != 0) {
+      const char *v = vars;
+      while (*v != '\0' && (*v == ' ' || seen[(int)*v]))  v++;
+      if (*v == '\0') return 1;
+    } else if (seen['S']) {
+      if ( seen['W'] && seen['T'] && seen['J'])                return 4;
+      if ( seen['W'] && seen['T'] && seen['A'] && seen['B'])   return 3;
+      if (!seen['W'] && seen['Q'])                             return 2;
+      if (!seen['W'] && seen['B'])                             return 1;
+    }
+  }
+}
+
+/* Primo steps are turned into MPU steps here, as the conversions need the
+ * N of the step.  A failed precondition marks the step as failed. */
+
+/* Format 4 gives W and S, with R = (N+1-W)/S. */
+static const char* _primo_r_from_w(cert_parse_t *P, mpz_t N)
+{
+  if (mpz_cmp_ui(P->S, 0) <= 0)      return "S > 0";
+  mpz_mul(P->t1, P->W, P->W);
+  mpz_mul_ui(P->t2, N, 4);
+  if (mpz_cmp(P->t1, P->t2) >= 0)    return "W^2 < 4*N";
+  mpz_add_ui(P->R, N, 1);
+  mpz_sub(P->R, P->R, P->W);
+  if (!mpz_divisible_p(P->R, P->S))  return "(N+1-W) mod S = 0";
+  mpz_divexact(P->R, P->R, P->S);
+  return 0;
+}
+
+/* The curve is given by A and B, or by J for A = 3J(1728-J) and
+ * B = 2J(1728-J)^2, with a point of abscissa T.  With L = T^3+AT+B the
+ * MPU curve is (AL^2, BL^3) with point (TL, L^2), M = RS and Q = R. */
+static const char* _primo_ecpp(cert_parse_t *P, cert_step_t *s, int type)
+{
+  mpz_ptr N = s->n, t1 = P->t1, t2 = P->t2;
+
+  if (mpz_sgn(N) <= 0)               return "N > 0";
+  if (type == 4) {
+    mpz_mul_ui(t1, P->J, 2);
+    if (mpz_cmpabs(t1, N) > 0)       return "|J| <= N/2";
+    mpz_set_ui(t2, 1728);
+    mpz_sub(t2, t2, P->J);
+    mpz_mul(s->a, t2, P->J);
+    mpz_mul_ui(s->a, s->a, 3);
+    mpz_mul(t2, t2, t2);
+    mpz_mul(s->b, t2, P->J);
+    mpz_mul_ui(s->b, s->b, 2);
+  } else {
+    mpz_mul_ui(t1, s->a, 2);
+    mpz_mul_ui(t2, s->b, 2);
+    if (mpz_cmpabs(t1, N) > 0)       return "|A| <= N/2";
+    if (mpz_cmpabs(t2, N) > 0)       return "|B| <= N/2";
+  }
+  if (mpz_sgn(P->T) < 0)             return "T >= 0";
+  if (mpz_cmp(P->T, N) >= 0)         return "T < N";
+
+  mpz_mul(t1, P->T, P->T);
+  mpz_add(t1, t1, s->a);
+  mpz_mul(t1, t1, P->T);
+  mpz_add(t1, t1, s->b);
+  mpz_mod(t1, t1, N);
+  if (mpz_sgn(t1) <= 0)              return "L > 0";
+  mpz_mul(t2, t1, t1);
+  mpz_mul(s->a, s->a, t2);
+  mpz_mod(s->a, s->a, N);
+  mpz_mul(t2, t2, t1);
+  mpz_mul(s->b, s->b, t2);
+  mpz_mod(s->b, s->b, N);
+  mpz_mul(s->x, P->T, t1);
+  mpz_mod(s->x, s->x, N);
+  mpz_mul(s->y, t1, t1);
+  mpz_mod(s->y, s->y, N);
+  mpz_mul(s->m, P->R, P->S);
+  mpz_set(s->q, P->R);
+  return 0;
+}
+
+/* N+1 with Lucas Q, P = 1 or 2. */
+static void _primo_np1(cert_parse_t *P, cert_step_t *s)
+{
+  s->type = CERT_STEP_BLS15;
+  mpz_set_ui(s->lp, mpz_odd_p(s->lq) ? 2 : 1);
+  mpz_set(s->q, P->R);
+}
+
+/* N-1 with base B. */
+static void _primo_nm1(cert_parse_t *P, cert_step_t *s)
+{
+  s->type = CERT_STEP_POCKLINGTON;
+  mpz_set(s->a, s->b);
+  mpz_set(s->q, P->R);
+}
+
+/* Format 4 N+1 and N-1 steps give S, with R = (N+1)/S or (N-1)/S. */
+static const char* _primo_r_from_s(cert_parse_t *P, cert_step_t *s, int plus)
+{
+  mpz_ptr N = s->n;
+  if (plus) mpz_add_ui(P->R, N, 1);
+  else      mpz_sub_ui(P->R, N, 1);
+  if (!mpz_even_p(P->S))             return "S is even";
+  if (mpz_cmp_ui(P->S, 1) <= 0)      return "S > 1";
+  if (!mpz_divisible_p(P->R, P->S))  return plus ? "(N+1) mod S = 0" : "(N-1) mod S = 0";
+  mpz_divexact(P->R, P->R, P->S);
+  if (plus) {
+    if (mpz_even_p(N))               return "N odd";
+    if (mpz_sgn(s->lq) <= 0)         return "Q > 0";
+    if (mpz_cmp(s->lq, N) >= 0)      return "Q < N";
+    if (mpz_jacobi(s->lq, N) != -1)  return "jacobi(Q,N) = -1";
+  } else {
+    if (mpz_cmp_ui(s->b, 1) <= 0)    return "B > 1";
+    if (mpz_cmp(s->b, N) >= 0)       return "B < N";
+  }
+  return 0;
+}
+
+static const struct {
+  const char *name, *vars;
+  int type, primo, code;    /* code is the type in the binary form */
+} _mpu_types[] = {
+  { "ECPP",        "N A B M Q X Y", CERT_STEP_ECPP,        0, 1 },
+  { "ECPP3",       "N S R A B T",   CERT_STEP_ECPP,        3, 2 },
+  { "ECPP4",       "N S R J T",     CERT_STEP_ECPP,        4, 3 },
+  { "BLS15",       "N Q LP LQ",     CERT_STEP_BLS15,       0, 4 },
+  { "BLS3",        "N Q A",         CERT_STEP_BLS3,        0, 5 },
+  { "POCKLINGTON", "N Q A",         CERT_STEP_POCKLINGTON, 0, 6 },
+  { "SMALL",       "N",             CERT_STEP_SMALL,       0, 7 },
+  { "BLS5",        0,               CERT_STEP_BLS5,        0, 8 },
+  { "LUCAS",       0,               CERT_STEP_LUCAS,       0, 9 },
+};
+#define NUM_MPU_TYPES (sizeof(_mpu_types)/sizeof(_mpu_types[0]))
+
+/* The binary form of an MPU certificate is CERT_MAGIC, the N being proven,
+ * then the steps to the end of the data.  Each step is its type code then
+ * its numbers in the order of vars above, or for BLS5 the count k, Q[1..k-1]
+ * and A[0..k-1], and for Lucas k, Q[1..k] and A.  Counts are varints (7 bits
+ * a byte, low first), and a number is the varint 2*bytes+sign followed by
+ * its magnitude in little-endian bytes.  Converting between the two forms
+ * loses only comments, the base, and the layout of the text. */
+#define CERT_MAGIC      "MPUCERT\001"
+#define CERT_MAGIC_LEN  8
+
+static int _is_binary(const char *cert, size_t len)
+{
+  return len >= CERT_MAGIC_LEN && memcmp(cert, CERT_MAGIC, CERT_MAGIC_LEN) == 0;
+}
+
+static void _buf_need(cert_buf_t *B, size_t n)
+{
+  if (B->len + n + 1 > B->size) {
+    B->size = 2*(B->len + n) + 256;
+    if (B->s == 0) New(0, B->s, B->size, char);
+    else           Renew(B->s, B->size, char);
+  }
+}
+
+static void _buf_put(cert_buf_t *B, const void *p, size_t n)
+{
+  _buf_need(B, n);
+  memcpy(B->s + B->len, p, n);
+  B->len += n;
+}
+
+/* The next name in a vars list, or "" at the end. */
+static const char* _next_var(const char *vars, char name[4])
+{
+  int i = 0;
+  while (*vars == ' ')  vars++;
+  while (*vars != '\0' && *vars != ' ' && i < 3)  name[i++] = *vars++;
+  name[i] = '\0';
+  return vars;
+}
+
+static void _bin_uint(cert_buf_t *B, size_t v)
+{
+  unsigned char c[2*sizeof(size_t)];
+  int i = 0;
+  do {
+    c[i] = v & 0x7F;
+    v >>= 7;
+    if (v != 0) c[i] |= 0x80;
+    i++;
+  } while (v != 0);
+  _buf_put(B, c, i);
+}
+
+static void _bin_mpz(cert_buf_t *B, mpz_srcptr v)
+{
+  size_t n = (mpz_sgn(v) == 0) ? 0 : (mpz_sizeinbase(v, 2) + 7) / 8;
+  _bin_uint(B, 2*n + (mpz_sgn(v) < 0));
+  _buf_need(B, n);
+  mpz_export(B->s + B->len, &n, -1, 1, 0, 0, v);
+  B->len += n;
+}
+
+static int _bin_get_uint(cert_parse_t *P, size_t *v)
+{
+  int shift = 0;
+  *v = 0;
+  while (P->b < P->bend && shift < 8*(int)sizeof(size_t)) {
+    unsigned char c = *P->b++;
+    *v |= (size_t)(c & 0x7F) << shift;
+    if (!(c & 0x80)) return 1;
+    shift += 7;
+  }
+  P->error = "bad binary certificate";
+  return 0;
+}
+
+static int _bin_get_mpz(cert_parse_t *P, mpz_ptr v)
+{
+  size_t n;
+  if (!_bin_get_uint(P, &n)) return 0;
+  if (n/2 > (size_t)(P->bend - P->b))
+    { P->error = "bad binary certificate";  return 0; }
+  mpz_import(v, n/2, -1, 1, 0, 0, P->b);
+  P->b += n/2;
+  if (n & 1) mpz_neg(v, v);
+  return 1;
+}
+
+/* Step s of type t, as read before any Primo conversion. */
+static void _bin_step(cert_parse_t *P, cert_step_t *s, UV t)
+{
+  cert_buf_t *B = P->out;
+  unsigned char code = _mpu_types[t].code;
+  const char *v;
+  char name[4];
+  int i;
+
+  _buf_put(B, &code, 1);
+  if (_mpu_types[t].vars != 0) {
+    for (v = _next_var(_mpu_types[t].vars, name); name[0] != '\0'; v = _next_var(v, name))
+      _bin_mpz(B, _mpu_slot(P, s, name));
+  } else if (s->type == CERT_STEP_BLS5) {
+    _bin_mpz(B, s->n);
+    _bin_uint(B, s->nq);
+    for (i = 1; i < s->nq; i++)  _bin_mpz(B, s->qs[i]);
+    for (i = 0; i < s->nq; i++)  _bin_mpz(B, s->as[i]);
+  } else {
+    _bin_mpz(B, s->n);
+    _bin_uint(B, s->nq);
+    for (i = 0; i < s->nq; i++)  _bin_mpz(B, s->qs[i]);
+    _bin_mpz(B, s->a);
+  }
+}
+
+/* Text as the provers write it: "N  v", "LP v", "Q[1]  v". */
+static void _text_var(cert_buf_t *B, const char *name, mpz_srcptr v)
+{
+  _buf_need(B, strlen(name) + mpz_sizeinbase(v, 10) + 5);
+  B->len += gmp_sprintf(B->s + B->len, "%s%s%Zd\n", name,
+                        (name[1] == '\0' || name[1] == '[') ? "  " : " ", v);
+}
+
+static void _text_step(cert_parse_t *P, cert_step_t *s, UV t)
+{
+  cert_buf_t *B = P->out;
+  const char *type = (s->type == CERT_STEP_SMALL) ? "Small" : _mpu_types[t].name;
+  const char *v;
+  char name[16];
+  int i;
+
+  _buf_need(B, strlen(type) + 8);
+  B->len += sprintf(B->s + B->len, "\nType %s\n", type);
+  if (_mpu_types[t].vars != 0) {
+    for (v = _next_var(_mpu_types[t].vars, name); name[0] != '\0'; v = _next_var(v, name))
+      _text_var(B, name, _mpu_slot(P, s, name));
+  } else if (s->type == CERT_STEP_BLS5) {
+    _text_var(B, "N", s->n);
+    for (i = 1; i < s->nq; i++) {
+      sprintf(name, "Q[%d]", i);
+      _text_var(B, name, s->qs[i]);
+    }
+    for (i = 0; i < s->nq; i++) {
+      if (mpz_cmp_ui(s->as[i], 2) == 0) continue;
+      sprintf(name, "A[%d]", i);
+      _text_var(B, name, s->as[i]);
+    }
+    _buf_put(B, "----\n", 5);
+  } else {
+    _text_var(B, "N", s->n);
+    for (i = 0; i < s->nq; i++) {
+      sprintf(name, "Q[%d]", i+1);
+      _text_var(B, name, s->qs[i]);
+    }
+    _text_var(B, "A", s->a);
+  }
+}
+
+static int _parse_bin(cert_parse_t *P)
+{
+  cert_step_t *s;
+  size_t nq;
+  UV t;
+  int i;
+
+  if (!_bin_get_mpz(P, P->proofn)) return 0;
+  if (P->out != 0) {
+    _buf_need(P->out, mpz_sizeinbase(P->proofn, 10) + 64);
+    P->out->len += gmp_sprintf(P->out->s + P->out->len,
+      "[MPU - Primality Certificate]\nVersion 1.0\n\nProof for:\nN %Zd\n",
+      P->proofn);
+  }
+  while (P->b < P->bend) {
+    unsigned char code = *P->b++;
+    for (t = 0; t < NUM_MPU_TYPES; t++)
+      if (_mpu_types[t].code == code)
+        break;
+    if (t >= NUM_MPU_TYPES)
+      { P->error = "unknown step type";  return 0; }
+    s = _new_step(P, _mpu_types[t].type, _mpu_types[t].name);
+    if (_mpu_types[t].vars != 0) {
+      const char *v;
+      char name[4];
+      for (v = _next_var(_mpu_types[t].vars, name); name[0] != '\0'; v = _next_var(v, name))
+        if (!_bin_get_mpz(P, _mpu_slot(P, s, name))) return 0;
+    } else {
+      int bls5 = (s->type == CERT_STEP_BLS5);
+      if (!_bin_get_mpz(P, s->n) || !_bin_get_uint(P, &nq)) return 0;
+      /* Every number takes at least a byte */
+      if (nq > (size_t)(P->bend - P->b) || (bls5 && nq == 0))
+        { P->error = "bad binary certificate";  return 0; }
+      if (nq > 0) _step_grow_qs(s, nq-1);
+      if (bls5) mpz_set_ui(s->qs[0], 2);
+      for (i = bls5; i < s->nq; i++)
+        if (!_bin_get_mpz(P, s->qs[i])) return 0;
+      if (bls5) {
+        for (i = 0; i < s->nq; i++)
+          if (!_bin_get_mpz(P, s->as[i])) return 0;
+      } else {
+        if (!_bin_get_mpz(P, s->a)) return 0;
+      }
+    }
+    if (P->out != 0)
+      _text_step(P, s, t);
+    if (_mpu_types[t].primo)
+      s->failed = _primo_ecpp(P, s, _mpu_types[t].primo);
+  }
+  return 1;
+}
+
+/* BLS5 has Q[1..] (Q[0] = 2) and A[0..] with A defaulting to 2, ending at
+ * a line of dashes.  Lucas has Q[1..] and ends at A. */
+static int _mpu_factor_list(cert_parse_t *P, cert_step_t *s)
+{
+  char *name, *value;
+  int i, index = 1, bls5 = (s->type == CERT_STEP_BLS5);
+
+  if (bls5) {
+    _step_grow_qs(s, 0);
+    mpz_set_ui(s->qs[0], 2);
+  }
+  while (1) {
+    mpz_ptr v;
+    if (!_need_line(P)) return 0;
+    if (bls5 && P->line[0] == '-') break;
+    if (!_mpu_split(P->line, &name, &value)) continue;
+    if (!strcmp(name, "N")) {
+      v = s->n;
+    } else if (sscanf(name, "Q[%d]", &i) == 1) {
+      if (i != index)
+        { P->error = "invalid Q index";  return 0; }
+      if (!bls5) i--;
+      _step_grow_qs(s, i);
+      v = s->qs[i];
+      index++;
+    } else if (bls5 && sscanf(name, "A[%d]", &i) == 1) {
+      if (i < 0 || i > index)
+        { P->error = "invalid A index";  return 0; }
+      _step_grow_qs(s, i);
+      v = s->as[i];
+    } else if (!bls5 && !strcmp(name, "A")) {
+      v = s->a;
+    } else {
+      continue;
+    }
+    if (mpz_set_str(v, value, P->base) != 0)
+      { P->error = "bad number";  return 0; }
+    if (v == s->a) break;
+  }
+  if (s->nq > (bls5 ? index : index-1))
+    { P->error = "invalid A index";  return 0; }
+  return 1;
+}
+
+static int _parse_mpu(cert_parse_t *P)
+{
+  cert_step_t top, *s;
+  char type[16];
+  UV t;
+  int i, ok;
+
+  while (1) {
+    if (!_need_line(P)) return 0;
+    if (P->line[0] == '#') continue;
+    if (sscanf(P->line, "Base %d", &P->base) == 1) {
+      if (P->base < 2 || P->base > 62)
+        { P->error = "invalid base";  return 0; }
+      continue;
+    }
+    if (!strcmp(P->line, "Proof for:")) break;
+  }
+  _step_init(&top, CERT_STEP_SMALL, "");
+  ok = _mpu_vars(P, &top, "N");
+  mpz_set(P->proofn, top.n);
+  _step_clear(&top);
+  if (!ok) return 0;
+  if (P->out != 0) {
+    _buf_put(P->out, CERT_MAGIC, CERT_MAGIC_LEN);
+    _bin_mpz(P->out, P->proofn);
+  }
+
+  while (_next_line(P)) {
+    if (strncmp(P->line, "Type ", 5) != 0) continue;
+    for (i = 0; i < 15 && P->line[5+i] != '\0'; i++)
+      type[i] = toupper((unsigned char)P->line[5+i]);
+    type[i] = '\0';
+    for (t = 0; t < NUM_MPU_TYPES; t++)
+      if (!strcmp(type, _mpu_types[t].name))
+        break;
+    if (t >= NUM_MPU_TYPES)
+      { P->error = "unknown step type";  return 0; }
+    s = _new_step(P, _mpu_types[t].type, _mpu_types[t].name);
+    if (_mpu_types[t].vars == 0) {
+      if (!_mpu_factor_list(P, s)) return 0;
+    } else {
+      if (!_mpu_vars(P, s, _mpu_types[t].vars)) return 0;
+    }
+    if (P->out != 0)
+      _bin_step(P, s, t);
+    if (_mpu_types[t].primo)
+      s->failed = _primo_ecpp(P, s, _mpu_types[t].primo);
+  }
+  return 1;
+}
+
+static int _parse_primo(cert_parse_t *P)
+{
+  cert_step_t *s = 0;
+  int format = 3, have_candidate = 0, have_n = 0, step = 0, r, type;
+  long testcount = -1;
+  mpz_t n;
+
+  while (!have_n || testcount < 0) {
+    if (!_need_line(P)) return 0;
+    if (sscanf(P->line, "Format=%d", &format) == 1) {
+      if (format != 3 && format != 4)
+        { P->error = "unknown Primo format";  return 0; }
+    } else if (sscanf(P->line, "TestCount=%ld", &testcount) == 1) {
+      if (testcount < 0)
+        { P->error = "bad TestCount";  return 0; }
+    } else if (!strcmp(P->line, "[Candidate]")) {
+      have_candidate = 1;
+    } else if (have_candidate && _primo_var(P->line, P->proofn) == 'N') {
+      have_n = 1;
+    }
+  }
+
+  mpz_init_set(n, P->proofn);
+  while (format == 3 || step < testcount) {
+    const char *fail = 0;
+    if (!_need_line(P)) break;
+    if (sscanf(P->line, "[%d]", &r) == 1) {
+      if (r != step+1)
+        { P->error = "wrong step number";  break; }
+      step++;
+      if (format == 3) continue;
+      s = _new_step(P, CERT_STEP_ECPP, "");
+      mpz_set(s->n, n);
+      type = _primo_vars(P, s, 0);
+      switch (type) {
+        case 4:
+        case 3:  s->name = (type == 4) ? "Primo Type 4" : "Primo Type 3";
+                 fail = _primo_r_from_w(P, s->n);
+                 if (!fail) fail = _primo_ecpp(P, s, type);
+                 break;
+        case 2:  s->name = "Primo N+1";
+                 fail = _primo_r_from_s(P, s, 1);
+                 _primo_np1(P, s);
+                 break;
+        case 1:  s->name = "Primo N-1";
+                 fail = _primo_r_from_s(P, s, 0);
+                 _primo_nm1(P, s);
+                 break;
+        default: break;
+      }
+    } else if (format == 3 && sscanf(P->line, "Type=%d", &type) == 1) {
+      if (type == 0) break;
+      s = _new_step(P, CERT_STEP_ECPP, "");
+      mpz_set(s->n, n);
+      switch (type) {
+        case 4:  s->name = "Primo Type 4";
+                 if (_primo_vars(P, s, "SRJT"))
+                   fail = _primo_ecpp(P, s, 4);
+                 break;
+        case 3:  s->name = "Primo Type 3";
+                 if (_primo_vars(P, s, "SRABT"))
+                   fail = _primo_ecpp(P, s, 3);
+                 break;
+        case 2:  s->name = "Primo Type 2";
+                 if (_primo_vars(P, s, "SRQ"))
+                   _primo_np1(P, s);
+                 break;
+        case 1:  s->name = "Primo Type 1";
+                 if (_primo_vars(P, s, "SRB")) {
+                   mpz_mul(P->t1, P->S, P->R);
+                   mpz_add_ui(P->t1, P->t1, 1);
+                   if (mpz_cmp(P->t1, n) != 0) fail = "SR+1 = N";
+                   _primo_nm1(P, s);
+                 }
+                 break;
+        default: P->error = "unknown step type";
+                 break;
+      }
+    } else {
+      continue;
+    }
+    if (P->error != 0) break;
+    s->failed = fail;
+    mpz_set(n, P->R);
+  }
+  /* The last R is small enough to prove directly. */
+  if (P->error == 0) {
+    s = _new_step(P, CERT_STEP_SMALL, "Small");
+    mpz_set(s->n, n);
+  }
+  mpz_clear(n);
+  return P->error == 0;
+}
+
+/*****************************************************************************/
+/* Verification                                                              */
+/*****************************************************************************/
+
+typedef struct {
+  mpz_srcptr n;
+  UV         i;
+} cert_order_t;
+
+typedef struct {
+  cert_step_t  *steps;
+  cert_order_t *order;
+} cert_ctx_t;
+
+static void _check_step(void *vctx, UV i)
+{
+  const cert_ctx_t *ctx = (const cert_ctx_t*) vctx;
+  cert_step_t *s = ctx->steps + ctx->order[i].i;
+  double t0 = wall_seconds();
+
+  if (s->failed == 0) {
+    mpz_t t1, t2;
+    mpz_init(t1);  mpz_init(t2);
+    switch (s->type) {
+      case CERT_STEP_SMALL:       s->failed = _check_small(s->n);             break;
+      case CERT_STEP_ECPP:        s->failed = _check_ecpp(s, t1, t2);         break;
+      case CERT_STEP_BLS15:       s->failed = _check_bls15(s, t1, t2);        break;
+      case CERT_STEP_BLS3:        s->failed = _check_bls3(s, t1, t2);         break;
+      case CERT_STEP_POCKLINGTON: s->failed = _check_pocklington(s, t1, t2);  break;
+      case CERT_STEP_BLS5:        s->failed = _check_bls5(s, t1, t2);         break;
+      case CERT_STEP_LUCAS:       s->failed = _check_lucas(s, t1, t2);        break;
+      default:                    s->failed = "unknown step type";            break;
+    }
+    mpz_clear(t1);  mpz_clear(t2);
+  }
+  s->result = (s->failed == 0);
+  s->seconds = wall_seconds() - t0;
+}
+
+static int _cmp_size_desc(const void *a, const void *b)
+{
+  size_t sa = mpz_size(((const cert_order_t*)a)->n);
+  size_t sb = mpz_size(((const cert_order_t*)b)->n);
+  return (sa > sb) ? -1 : (sa < sb) ? 1 : 0;
+}
+static int _cmp_n(const void *a, const void *b)
+{
+  return mpz_cmp(((const cert_order_t*)a)->n, ((const cert_order_t*)b)->n);
+}
+
+/* The chain check: n is proven if it is small or some step for n holds and
+ * all its Q values are proven.  Steps are memoized, and a step depending on
+ * itself is not proven. */
+#define CHAIN_UNKNOWN 0
+#define CHAIN_ACTIVE  1
+#define CHAIN_PROVEN  2
+#define CHAIN_FAILED  3
+
+typedef struct {
+  cert_step_t  *steps;
+  cert_order_t *byn;      /* Steps sorted by n */
+  UV           nsteps;
+  char        *state;
+} cert_chain_t;
+
+static int _chain_proven(cert_chain_t *C, mpz_t n)
+{
+  UV lo = 0, hi = C->nsteps;
+
+  if (mpz_sizeinbase(n, 2) <= 64)
+    return _check_small(n) == 0;
+
+  while (lo < hi) {                   /* First step with steps[].n >= n */
+    UV mid = lo + (hi-lo)/2;
+    if (mpz_cmp(C->byn[mid].n, n) < 0)  lo = mid+1;
+    else                                          hi = mid;
+  }
+  for ( ; lo < C->nsteps && mpz_cmp(C->byn[lo].n, n) == 0; lo++) {
+    UV i = C->byn[lo].i;
+    cert_step_t *s = C->steps + i;
+    int j, ok = 1;
+    if (C->state[i] == CHAIN_PROVEN) return 1;
+    if (C->state[i] != CHAIN_UNKNOWN || !s->result) continue;
+    C->state[i] = CHAIN_ACTIVE;
+    switch (s->type) {
+      case CERT_STEP_SMALL:  break;
+      case CERT_STEP_BLS5:
+      case CERT_STEP_LUCAS:  for (j = 0; ok && j < s->nq; j++)
+                               ok = _chain_proven(C, s->qs[j]);
+                             break;
+      default:               ok = _chain_proven(C, s->q);
+                             break;
+    }
+    C->state[i] = ok ? CHAIN_PROVEN : CHAIN_FAILED;
+    if (ok) return 1;
+  }
+  return 0;
+}
+
+static const char* _step_type_name(int type)
+{
+  switch (type) {
+    case CERT_STEP_SMALL:       return "Small";
+    case CERT_STEP_ECPP:        return "ECPP";
+    case CERT_STEP_BLS15:       return "BLS15";
+    case CERT_STEP_BLS3:        return "BLS3";
+    case CERT_STEP_POCKLINGTON: return "Pocklington";
+    case CERT_STEP_BLS5:        return "BLS5";
+    case CERT_STEP_LUCAS:       return "Lucas";
+    default:                    return "?";
+  }
+}
+
+static void _parse_init(cert_parse_t *P, const char *cert, size_t len,
+                        cert_buf_t *out)
+{
+  memset(P, 0, sizeof(*P));
+  P->p = cert;
+  P->b = (const unsigned char*) cert + CERT_MAGIC_LEN;
+  P->bend = (const unsigned char*) cert + len;
+  P->out = out;
+  P->base = 10;
+  mpz_init(P->proofn);  mpz_init(P->S);  mpz_init(P->R);  mpz_init(P->T);
+  mpz_init(P->J);  mpz_init(P->W);  mpz_init(P->t1);  mpz_init(P->t2);
+}
+
+static void _parse_clear(cert_parse_t *P)
+{
+  if (P->line != 0) Safefree(P->line);
+  mpz_clear(P->proofn);  mpz_clear(P->S);  mpz_clear(P->R);  mpz_clear(P->T);
+  mpz_clear(P->J);  mpz_clear(P->W);  mpz_clear(P->t1);  mpz_clear(P->t2);
+}
+
+/* Parse a binary, MPU, or Primo certificate.  Only the first two can be
+ * converted to the other form. */
+static int _parse(cert_parse_t *P, size_t len)
+{
+  if (_is_binary(P->p, len))
+    return _parse_bin(P);
+  while (_next_line(P) && strstr(P->line, "Primality Certificate") == 0)
+    ;
+  if (P->line == 0 || strstr(P->line, "Primality Certificate") == 0)
+    P->error = "no primality certificate found";
+  else if (!strcmp(P->line, "[MPU - Primality Certificate]"))
+    return _parse_mpu(P);
+  else if (P->out != 0)
+    P->error = "only MPU certificates have a binary form";
+  else if (!strcmp(P->line, "[PRIMO - Primality Certificate]"))
+    return _parse_primo(P);
+  else
+    P->error = "unknown certificate type";
+  return 0;
+}
+
+int verify_certificate(const char *cert, size_t len, cert_step_t **steps,
+                       UV *nsteps, const char **error)
+{
+  cert_parse_t P;
+  cert_ctx_t ctx;
+  cert_chain_t C;
+  UV i;
+  int result = -1, ok;
+  double t0 = wall_seconds();
+
+  _parse_init(&P, cert, len, 0);
+  ok = _parse(&P, len);
+
+  if (ok) {
+    if (get_verbose_level() > 0)
+      printf("cert: N has %lu digits, %lu steps\n",
+             (unsigned long)mpz_sizeinbase(P.proofn, 10), (unsigned long)P.nsteps);
+    result = 0;
+    if (_GMP_is_prob_prime(P.proofn) == 0) {
+      P.error = "N is composite";
+    } else {
+      New(0, ctx.order, P.nsteps+1, cert_order_t);
+      for (i = 0; i < P.nsteps; i++) {
+        ctx.order[i].n = P.steps[i].n;
+        ctx.order[i].i = i;
+      }
+      qsort(ctx.order, P.nsteps, sizeof(cert_order_t), _cmp_size_desc);
+      ctx.steps = P.steps;
+      parallel_for(P.nsteps, _check_step, &ctx);
+
+      for (i = 0; i < P.nsteps; i++)
+        if (!P.steps[i].result)
+          break;
+      if (i < P.nsteps) {
+        P.error = "a step failed its conditions";
+      } else {
+        C.steps = P.steps;
+        C.nsteps = P.nsteps;
+        C.byn = ctx.order;
+        qsort(C.byn, P.nsteps, sizeof(cert_order_t), _cmp_n);
+        Newz(0, C.state, P.nsteps+1, char);
+        result = _chain_proven(&C, P.proofn);
+        if (!result) P.error = "a Q value has no proof";
+        Safefree(C.state);
+      }
+      Safefree(ctx.order);
+    }
+    if (get_verbose_level() > 0) {
+      for (i = 0; i < P.nsteps; i++) {
+        cert_step_t *s = P.steps + i;
+        printf("cert: step %4lu  %-12s %-11s %6lu digits %9.3fs  %s%s\n",
+               (unsigned long)i+1, s->name, _step_type_name(s->type),
+               (unsigned long)mpz_sizeinbase(s->n, 10), s->seconds,
+               s->result ? "ok" : s->failed ? "FAILED " : "not checked",
+               s->failed ? s->failed : "");
+      }
+      printf("cert: %s in %.3fs\n", result ? "PRIME" : "NOT PROVEN",
+             wall_seconds() - t0);
+    }
+  }
+
+  if (result != 1 && get_verbose_level() > 0)
+    printf("cert: %s\n", P.error ? P.error : "not proven");
+  if (error != 0) *error = P.error;
+  if (steps != 0 && result >= 0) {
+    *steps = P.steps;
+    *nsteps = P.nsteps;
+  } else {
+    cert_steps_free(P.steps, P.nsteps);
+    if (steps != 0) { *steps = 0;  *nsteps = 0; }
+  }
+  _parse_clear(&P);
+  return result;
+}
+
+/* Parse the certificate writing the other form, returning it with room
+ * for a trailing NUL. */
+static char* _convert(const char *cert, size_t len, size_t *outlen,
+                      const char **error)
+{
+  cert_parse_t P;
+  cert_buf_t B;
+  int ok;
+
+  B.s = 0;  B.len = B.size = 0;
+  _parse_init(&P, cert, len, &B);
+  ok = _parse(&P, len);
+  cert_steps_free(P.steps, P.nsteps);
+  if (error != 0) *error = P.error;
+  _parse_clear(&P);
+  if (!ok) {
+    if (B.s != 0) Safefree(B.s);
+    return 0;
+  }
+  *outlen = B.len;
+  return B.s;
+}
+
+char* cert_to_binary(const char *cert, size_t len, size_t *outlen,
+                     const char **error)
+{
+  char *out;
+  if (_is_binary(cert, len)) {
+    New(0, out, len+1, char);
+    memcpy(out, cert, len);
+    *outlen = len;
+    return out;
+  }
+  return _convert(cert, len, outlen, error);
+}
+
+char* cert_to_text(const char *cert, size_t len, const char **error)
+{
+  char *out;
+  size_t outlen;
+  if (!_is_binary(cert, len)) {
+    New(0, out, len+1, char);
+    memcpy(out, cert, len);
+    out[len] = '\0';
+    return out;
+  }
+  out = _convert(cert, len, &outlen, error);
+  if (out != 0) {
+    /* As is_provable_prime_with_cert, without a final newline */
+    if (outlen > 0 && out[outlen-1] == '\n') outlen--;
+    out[outlen] = '\0';
+  }
+  return out;
+}
@@ -0,0 +1,54 @@
+#ifndef MPU_CERT_H
+#define MPU_CERT_H
+
+#include <gmp.h>
+#include "ptypes.h"
+
+/* One step of a parsed primality certificate.  Primo steps are converted
+ * to the equivalent MPU step (ECPP, BLS15, or Pocklington) when parsed. */
+typedef struct {
+  int         type;       /* CERT_STEP_* */
+  int         result;     /* 1 if the step holds given its Q values */
+  const char *name;       /* As in the certificate, e.g. "ECPP3" */
+  const char *failed;     /* The condition that failed, or 0 */
+  double      seconds;    /* Time taken to check it */
+  mpz_t       n, a, b, m, q, x, y, lp, lq;
+  int         nq;         /* BLS5 and Lucas: factors q[0..nq-1] */
+  mpz_t      *qs, *as;
+} cert_step_t;
+
+#define CERT_STEP_SMALL        0
+#define CERT_STEP_ECPP         1
+#define CERT_STEP_BLS15        2
+#define CERT_STEP_BLS3         3
+#define CERT_STEP_POCKLINGTON  4
+#define CERT_STEP_BLS5         5
+#define CERT_STEP_LUCAS        6
+
+/* Verify an MPU or Primo (format 3 or 4) certificate given as text, or an
+ * MPU certificate in binary form, of len bytes.  It is parsed once, then
+ * the steps are checked in parallel, largest first, with get_thread_count()
+ * threads.  Finally the chain of Q values is checked to lead from N down to
+ * numbers proven directly.
+ *
+ * Returns 1 if the certificate proves its N prime, 0 if it does not, and
+ * -1 if it could not be parsed.  Unless the result is 1, *error is set to
+ * the reason.  If steps is non-null it is set to the steps in certificate
+ * order, to be freed with cert_steps_free.  With verbose output each step
+ * is shown with its time. */
+extern int verify_certificate(const char *cert, size_t len,
+                              cert_step_t **steps, UV *nsteps,
+                              const char **error);
+
+extern void cert_steps_free(cert_step_t *steps, UV nsteps);
+
+/* Convert an MPU certificate between text and the compact binary form (see
+ * cert.c), returning a new string to be freed with Safefree, or 0 with
+ * *error set if it could not be parsed.  A certificate already in the
+ * requested form is copied.  The text is NUL terminated and laid out as
+ * is_provable_prime_with_cert gives it. */
+extern char* cert_to_binary(const char *cert, size_t len, size_t *outlen,
+                            const char **error);
+extern char* cert_to_text(const char *cert, size_t len, const char **error);
+
+#endif
@@ -0,0 +1,485 @@
+/*
+ * Hilbert class polynomials, computed as needed for ECPP.
+ *
+ * The roots of H_D are j((-b+sqrt(D))/2a) for the reduced primitive forms
+ * (a,b,c) of discriminant D.  We evaluate j with complex floating point at
+ * a precision large enough for the coefficients, multiply out the linear
+ * factors, and round to integers.  See Cohen, "A Course in Computational
+ * Algebraic Number Theory", section 7.6.
+ *
+ * j is found from f = Delta(2t)/Delta(t) as (256f+1)^3/f.  The eta products
+ * in Delta use Euler's pentagonal number series, so with |q| <= e^(-pi*sqrt3)
+ * only a few dozen terms are needed even at thousands of bits.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <gmp.h>
+#include "ptypes.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+ #define CLASS_DB_MMAP 1
+ #include <sys/types.h>
+ #include <sys/mman.h>
+ #include <sys/stat.h>
+ #include <fcntl.h>
+ #include <unistd.h>
+#endif
+
+#include "classpoly.h"
+#include "real.h"
+#define FUNC_gcd_ui 1
+#include "utility.h"
+#include "threadpool.h"
+
+/* Reduced forms have |b| <= a <= c, and b >= 0 if |b| = a or a = c. */
+unsigned short* class_numbers(UV maxd)
+{
+  unsigned short *h;
+  UV a, c;
+  IV b;
+
+  Newz(0, h, maxd+1, unsigned short);
+  for (a = 1; 3*a*a <= maxd; a++) {
+    for (b = 1-(IV)a; b <= (IV)a; b++) {
+      UV ab = (b < 0) ? -b : b,  b2 = ab*ab;
+      for (c = (b < 0) ? a+1 : a; 4*a*c - b2 <= maxd; c++)
+        if (gcd_ui(gcd_ui(a, ab), c) == 1)
+          h[4*a*c - b2]++;
+    }
+  }
+  return h;
+}
+
+static int _squarefree(UV n)
+{
+  UV p;
+  if ((n % 4) == 0) return 0;
+  for (p = 3; p*p <= n; p += 2)
+    if ((n % (p*p)) == 0)
+      return 0;
+  return 1;
+}
+
+int is_fundamental_disc(UV d)
+{
+  if ((d % 4) == 3)  return _squarefree(d);
+  if ((d % 16) == 4 || (d % 16) == 8)  return _squarefree(d/4);
+  return 0;
+}
+
+/******************************************************************************/
+
+typedef struct { mpf_t re, im; } cmpf_t;
+
+static void cmpf_init(cmpf_t *z, UV bits)
+  { mpf_init2(z->re, bits);  mpf_init2(z->im, bits); }
+static void cmpf_clear(cmpf_t *z)
+  { mpf_clear(z->re);  mpf_clear(z->im); }
+static void cmpf_set(cmpf_t *z, cmpf_t *x)
+  { mpf_set(z->re, x->re);  mpf_set(z->im, x->im); }
+
+/* z = x*y.  z may be x or y. */
+static void cmpf_mul(cmpf_t *z, cmpf_t *x, cmpf_t *y, mpf_t t1, mpf_t t2)
+{
+  mpf_mul(t1, x->re, y->re);
+  mpf_mul(t2, x->im, y->im);
+  mpf_sub(t1, t1, t2);
+  mpf_mul(t2, x->re, y->im);
+  mpf_mul(z->im, x->im, y->re);
+  mpf_add(z->im, z->im, t2);
+  mpf_set(z->re, t1);
+}
+
+/* z = 1/x.  z may be x. */
+static void cmpf_inv(cmpf_t *z, cmpf_t *x, mpf_t t1, mpf_t t2)
+{
+  mpf_mul(t1, x->re, x->re);
+  mpf_mul(t2, x->im, x->im);
+  mpf_add(t1, t1, t2);
+  mpf_div(z->re, x->re, t1);
+  mpf_div(z->im, x->im, t1);
+  mpf_neg(z->im, z->im);
+}
+
+static int _tiny(mpf_t x, UV bits)
+{
+  long e;
+  if (mpf_sgn(x) == 0) return 1;
+  mpf_get_d_2exp(&e, x);
+  return (e < -(long)bits);
+}
+
+/* c = cos(x), s = sin(x), for |x| <= pi.  Taylor series at x/2^16, then
+ * sixteen doublings. */
+static void _cos_sin(mpf_t c, mpf_t s, mpf_t x, UV bits)
+{
+  mpf_t y2, term, t;
+  UV k;
+
+  mpf_init2(y2, bits);  mpf_init2(term, bits);  mpf_init2(t, bits);
+  mpf_div_2exp(s, x, 16);
+  mpf_mul(y2, s, s);
+  mpf_set(term, s);
+  for (k = 1; ; k++) {
+    mpf_mul(term, term, y2);
+    mpf_div_ui(term, term, (2*k)*(2*k+1));
+    if (_tiny(term, bits)) break;
+    if (k & 1) mpf_sub(s, s, term);
+    else       mpf_add(s, s, term);
+  }
+  mpf_set_ui(c, 1);
+  mpf_set_ui(term, 1);
+  for (k = 1; ; k++) {
+    mpf_mul(term, term, y2);
+    mpf_div_ui(term, term, (2*k-1)*(2*k));
+    if (_tiny(term, bits)) break;
+    if (k & 1) mpf_sub(c, c, term);
+    else       mpf_add(c, c, term);
+  }
+  for (k = 0; k < 16; k++) {
+    mpf_mul(t, s, c);
+    mpf_mul_2exp(s, t, 1);              /* sin 2y = 2 sin y cos y */
+    mpf_mul(t, c, c);
+    mpf_mul_2exp(t, t, 1);
+    mpf_sub_ui(c, t, 1);                /* cos 2y = 2 cos^2 y - 1 */
+  }
+  mpf_clear(t);  mpf_clear(term);  mpf_clear(y2);
+}
+
+/* E = prod(1-q^n) = 1 + sum_k>=1 (-1)^k (q^(k(3k-1)/2) + q^(k(3k+1)/2)).
+ * log2q is log2|q|. */
+static void _eta_prod(cmpf_t *E, cmpf_t *q, double log2q, UV bits,
+                      cmpf_t *w, mpf_t t1, mpf_t t2)
+{
+  cmpf_t *q3 = w, *step = w+1, *qk = w+2, *qe = w+3, *term = w+4;
+  UV k;
+
+  cmpf_mul(q3, q, q, t1, t2);
+  cmpf_mul(q3, q3, q, t1, t2);
+  cmpf_set(step, q);
+  cmpf_set(qk, q);
+  mpf_set_ui(qe->re, 1);  mpf_set_ui(qe->im, 0);
+  mpf_set_ui(E->re, 1);   mpf_set_ui(E->im, 0);
+  for (k = 1; (double)(k*(3*k-1)/2) * log2q > -(double)(bits+8); k++) {
+    cmpf_mul(qe, qe, step, t1, t2);     /* q^(k(3k-1)/2) */
+    cmpf_mul(step, step, q3, t1, t2);
+    if (k > 1) cmpf_mul(qk, qk, q, t1, t2);
+    cmpf_mul(term, qe, qk, t1, t2);     /* q^(k(3k+1)/2) */
+    mpf_add(term->re, term->re, qe->re);
+    mpf_add(term->im, term->im, qe->im);
+    if (k & 1) { mpf_sub(E->re, E->re, term->re); mpf_sub(E->im, E->im, term->im); }
+    else       { mpf_add(E->re, E->re, term->re); mpf_add(E->im, E->im, term->im); }
+  }
+}
+
+UV hilbert_class_poly(mpz_t** T, UV d)
+{
+  UV h, i, k, a, c, ab, nforms, bits;
+  IV b, *fa, *fb;
+  double sqrtd = sqrt((double)d), log2j;
+  mpf_t pi, sd, r, t1, t2;
+  cmpf_t q, q2, e1, e2, j, *C, w[5];
+  int ok = 1;
+
+  if (d < 3 || ((d % 4) != 0 && (d % 4) != 3)) return 0;
+
+  /* The reduced forms of discriminant -d */
+  nforms = 0;
+  for (a = 1; 3*a*a <= d; a++)
+    nforms += 2*a;
+  New(0, fa, nforms, IV);
+  New(0, fb, nforms, IV);
+  h = 0;
+  log2j = 0;
+  for (a = 1; 3*a*a <= d; a++) {
+    for (b = 1-(IV)a; b <= (IV)a; b++) {
+      ab = (b < 0) ? -b : b;
+      if (((ab*ab + d) % (4*a)) != 0) continue;
+      c = (ab*ab + d) / (4*a);
+      if (c < a || (b < 0 && c == a)) continue;
+      if (gcd_ui(gcd_ui(a, ab), c) != 1) continue;
+      fa[h] = a;  fb[h] = b;  h++;
+      /* |j| is about exp(pi sqrt(d)/a) + 744 */
+      log2j += 3.0 + M_PI * sqrtd / (a * M_LN2);
+    }
+  }
+  if (h == 0) { Safefree(fa);  Safefree(fb);  return 0; }
+
+  /* The coefficients are at most prod(1+|j_i|), plus a guard. */
+  bits = (UV)log2j + h + 64;
+
+  mpf_init2(pi, bits);  mpf_init2(sd, bits);  mpf_init2(r, bits);
+  mpf_init2(t1, bits);  mpf_init2(t2, bits);
+  cmpf_init(&q, bits);  cmpf_init(&q2, bits);
+  cmpf_init(&e1, bits); cmpf_init(&e2, bits);  cmpf_init(&j, bits);
+  for (i = 0; i < 5; i++)
+    cmpf_init(w+i, bits);
+  New(0, C, h+1, cmpf_t);
+  for (i = 0; i <= h; i++) {
+    cmpf_init(C+i, bits);
+    mpf_set_ui(C[i].re, (i == 0));
+    mpf_set_ui(C[i].im, 0);
+  }
+
+  const_pi(pi, BITS2DIGS(bits) + 2);
+  mpf_sqrt_ui(sd, d);
+
+  for (i = 0; i < h; i++) {
+    double log2q = -M_PI * sqrtd / (fa[i] * M_LN2);
+    /* q = exp(2 pi i tau) = exp(-pi sqrt(d)/a) * exp(-pi i b/a) */
+    mpf_mul(r, pi, sd);
+    mpf_div_ui(r, r, fa[i]);
+    mpf_neg(r, r);
+    mpf_exp(r, r);
+    mpf_mul_ui(t1, pi, (fb[i] < 0) ? -fb[i] : fb[i]);
+    mpf_div_ui(t1, t1, fa[i]);
+    _cos_sin(q.re, q.im, t1, bits + 32);
+    if (fb[i] > 0) mpf_neg(q.im, q.im);
+    mpf_mul(q.re, q.re, r);
+    mpf_mul(q.im, q.im, r);
+
+    /* f = q * (E(q^2)/E(q))^24,  j = (256f+1)^3 / f */
+    cmpf_mul(&q2, &q, &q, t1, t2);
+    _eta_prod(&e1, &q, log2q, bits, w, t1, t2);
+    _eta_prod(&e2, &q2, 2*log2q, bits, w, t1, t2);
+    cmpf_inv(&e1, &e1, t1, t2);
+    cmpf_mul(&e2, &e2, &e1, t1, t2);
+    cmpf_mul(&e2, &e2, &e2, t1, t2);    /* ^2 */
+    cmpf_mul(&e1, &e2, &e2, t1, t2);    /* ^4 */
+    cmpf_mul(&e2, &e1, &e2, t1, t2);    /* ^6 */
+    cmpf_mul(&e2, &e2, &e2, t1, t2);    /* ^12 */
+    cmpf_mul(&e2, &e2, &e2, t1, t2);    /* ^24 */
+    cmpf_mul(&e2, &e2, &q, t1, t2);     /* f */
+    mpf_mul_ui(j.re, e2.re, 256);
+    mpf_add_ui(j.re, j.re, 1);
+    mpf_mul_ui(j.im, e2.im, 256);
+    cmpf_mul(&e1, &j, &j, t1, t2);
+    cmpf_mul(&e1, &e1, &j, t1, t2);
+    cmpf_inv(&e2, &e2, t1, t2);
+    cmpf_mul(&j, &e1, &e2, t1, t2);
+
+    /* C = C * (X - j) */
+    for (k = i+1; k > 0; k--) {
+      cmpf_mul(&e1, &j, C+k, t1, t2);
+      mpf_sub(C[k].re, C[k-1].re, e1.re);
+      mpf_sub(C[k].im, C[k-1].im, e1.im);
+    }
+    cmpf_mul(C, &j, C, t1, t2);
+    mpf_neg(C[0].re, C[0].re);
+    mpf_neg(C[0].im, C[0].im);
+  }
+
+  /* Round, making sure each coefficient really is close to an integer */
+  New(0, *T, h+1, mpz_t);
+  for (i = 0; i <= h; i++) {
+    mpz_init((*T)[i]);
+    mpf_set_d(t2, (mpf_sgn(C[i].re) >= 0) ? 0.5 : -0.5);
+    mpf_add(t1, C[i].re, t2);
+    mpz_set_f((*T)[i], t1);             /* truncates toward zero */
+    mpf_set_z(t2, (*T)[i]);
+    mpf_sub(t2, C[i].re, t2);
+    mpf_abs(t2, t2);
+    mpf_abs(t1, C[i].im);
+    if (mpf_cmp_d(t2, 0.25) > 0 || mpf_cmp_d(t1, 0.25) > 0)
+      ok = 0;
+  }
+  for (i = 0; i <= h; i++)
+    cmpf_clear(C+i);
+  Safefree(C);
+  if (!ok) {
+    for (i = 0; i <= h; i++)
+      mpz_clear((*T)[i]);
+    Safefree(*T);
+    *T = 0;
+    h = 0;
+  }
+
+  Safefree(fa);  Safefree(fb);
+  mpf_clear(pi);  mpf_clear(sd);  mpf_clear(r);  mpf_clear(t1);  mpf_clear(t2);
+  cmpf_clear(&q);  cmpf_clear(&q2);  cmpf_clear(&e1);  cmpf_clear(&e2);
+  cmpf_clear(&j);
+  for (i = 0; i < 5; i++)
+    cmpf_clear(w+i);
+  return h;
+}
+
+
+/*
+ * External class polynomial database.
+ *
+ * Layout, all integers little-endian:
+ *   header   "MPUCPDB1", uint32 count, uint32 reserved (0)
+ *   index    count entries of 16 bytes, sorted by D:
+ *              uint32 D, uint8 type, uint8 reserved, uint16 degree,
+ *              uint32 offset, uint32 length
+ *   data     coefficient strings, encoded as in class_poly_data.h
+ *
+ * The file is mapped read-only (or read in whole where there is no mmap)
+ * the first time the count is asked for, and checked before use.  Anything
+ * wrong with it and we act as if there were no file.
+ */
+
+#define CLASS_DB_MAGIC  "MPUCPDB1"
+#define CLASS_DB_HEADER 16
+#define CLASS_DB_ENTRY  16
+
+static char* _db_path = 0;
+static int _db_tried = 0;
+static const unsigned char* _db_data = 0;
+static UV _db_size = 0;
+static UV _db_count = 0;
+static int _db_mapped = 0;
+static int _db_holds = 0;
+
+static uint32_t _get_u32(const unsigned char* p)
+{ return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24); }
+static uint32_t _get_u16(const unsigned char* p)
+{ return (uint32_t)p[0] | ((uint32_t)p[1] << 8); }
+
+static int _db_load(const char* path)
+{
+#ifdef CLASS_DB_MMAP
+  struct stat st;
+  void *map;
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) return 0;
+  if (fstat(fd, &st) != 0 || st.st_size < CLASS_DB_HEADER) { close(fd); return 0; }
+  map = mmap(0, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) return 0;
+  _db_data = (const unsigned char*) map;
+  _db_size = (UV) st.st_size;
+  _db_mapped = 1;
+#else
+  unsigned char *buf;
+  long size;
+  FILE *fp = fopen(path, "rb");
+  if (fp == 0) return 0;
+  if (fseek(fp, 0, SEEK_END) != 0 || (size = ftell(fp)) < CLASS_DB_HEADER ||
+      fseek(fp, 0, SEEK_SET) != 0) { fclose(fp); return 0; }
+  New(0, buf, size, unsigned char);
+  if (fread(buf, 1, size, fp) != (size_t)size) { Safefree(buf); fclose(fp); return 0; }
+  fclose(fp);
+  _db_data = buf;
+  _db_size = (UV) size;
+  _db_mapped = 0;
+#endif
+  return 1;
+}
+
+static int _db_check(void)
+{
+  UV i, count, lastD = 0;
+  if (memcmp(_db_data, CLASS_DB_MAGIC, 8) != 0) return 0;
+  count = _get_u32(_db_data+8);
+  if (count > (_db_size - CLASS_DB_HEADER) / CLASS_DB_ENTRY) return 0;
+  for (i = 0; i < count; i++) {
+    const unsigned char *e = _db_data + CLASS_DB_HEADER + i*CLASS_DB_ENTRY;
+    UV D = _get_u32(e), degree = _get_u16(e+6);
+    UV offset = _get_u32(e+8), length = _get_u32(e+12);
+    if (D <= lastD || e[4] < 1 || e[4] > 3 || degree < 1 || degree > 255)
+      return 0;
+    if (offset > _db_size || length > _db_size - offset)
+      return 0;
+    lastD = D;
+  }
+  _db_count = count;
+  return 1;
+}
+
+void class_poly_db_close(void)
+{
+  if (_db_data != 0) {
+#ifdef CLASS_DB_MMAP
+    if (_db_mapped)  munmap((void*)_db_data, (size_t)_db_size);
+    else
+#endif
+    Safefree((void*)_db_data);
+  }
+  _db_data = 0;
+  _db_size = 0;
+  _db_count = 0;
+  _db_tried = 0;
+}
+
+void class_poly_db_hold(int hold)
+{
+  parallel_lock();
+  _db_holds += (hold) ? 1 : -1;
+  parallel_unlock();
+}
+
+int class_poly_db_set(const char* path)
+{
+  int busy;
+  parallel_lock();
+  busy = (_db_holds > 0);
+  parallel_unlock();
+  if (busy) return 0;
+  class_poly_db_close();
+  if (_db_path != 0) Safefree(_db_path);
+  _db_path = 0;
+  if (path != 0) {
+    New(0, _db_path, strlen(path)+1, char);
+    strcpy(_db_path, path);
+  }
+  return 1;
+}
+
+/* Load the file named by the path or environment, if any. */
+static void _db_open(void)
+{
+  const char *path = (_db_path != 0) ? _db_path : getenv("MPU_CLASS_POLY_DB");
+  if (path == 0 || *path == '\0') return;
+  if (!_db_load(path)) {
+    if (get_verbose_level()) printf("class poly db: cannot read %s\n", path);
+    return;
+  }
+  if (!_db_check()) {
+    if (get_verbose_level()) printf("class poly db: %s is not valid, ignored\n", path);
+    class_poly_db_close();
+    return;
+  }
+  if (get_verbose_level()) printf("class poly db: %lu polys from %s\n", (unsigned long)_db_count, path);
+}
+
+/* The first caller loads the file under the lock, so any thread asking
+ * sees either nothing loaded yet or the whole database. */
+UV class_poly_db_count(void)
+{
+  UV count;
+  parallel_lock();
+  if (!_db_tried) {
+    _db_open();
+    _db_tried = 1;
+  }
+  count = _db_count;
+  parallel_unlock();
+  return count;
+}
+
+UV class_poly_db_entry(UV i, UV *D, int *type, const unsigned char **coefs, UV *length)
+{
+  const unsigned char *e;
+  if (i >= _db_count) return 0;
+  e = _db_data + CLASS_DB_HEADER + i*CLASS_DB_ENTRY;
+  if (D != 0)       *D = _get_u32(e);
+  if (type != 0)    *type = e[4];
+  if (coefs != 0)   *coefs = _db_data + _get_u32(e+8);
+  if (length != 0)  *length = _get_u32(e+12);
+  return _get_u16(e+6);
+}
+
+int class_poly_db_find(UV D)
+{
+  UV lo = 0, hi = _db_count;
+  while (lo < hi) {
+    UV mid = lo + (hi-lo)/2;
+    if (_get_u32(_db_data + CLASS_DB_HEADER + mid*CLASS_DB_ENTRY) < D)  lo = mid+1;
+    else                                                                hi = mid;
+  }
+  return (lo < _db_count && _get_u32(_db_data + CLASS_DB_HEADER + lo*CLASS_DB_ENTRY) == D);
+}
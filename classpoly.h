@@ -0,0 +1,36 @@
+#ifndef MPU_CLASSPOLY_H
+#define MPU_CLASSPOLY_H
+
+#include <gmp.h>
+#include "ptypes.h"
+
+/* Fill in the class numbers of all discriminants -d with d <= maxd, as an
+ * array indexed by d (0 where -d is not a discriminant).  Free with Safefree. */
+extern unsigned short* class_numbers(UV maxd);
+
+/* Is -d a fundamental discriminant */
+extern int is_fundamental_disc(UV d);
+
+/* Compute the Hilbert class polynomial of the discriminant -d.  Returns the
+ * degree h, with T set to a new array of the h+1 coefficients (T[h] = 1), or
+ * 0 if it could not be computed. */
+extern UV hilbert_class_poly(mpz_t** T, UV d);
+
+/* An external class polynomial database, see classpoly.c for the format.
+ * The path is from class_poly_db_set, or else MPU_CLASS_POLY_DB in the
+ * environment.  It is loaded at the first class_poly_db_count; a missing or
+ * bad file gives a count of 0. */
+extern int  class_poly_db_set(const char* path);
+extern UV   class_poly_db_count(void);
+/* Batch proofs hold the database while they run (hold 1, then 0).  While
+ * it is held class_poly_db_set changes nothing and returns 0. */
+extern void class_poly_db_hold(int hold);
+extern void class_poly_db_close(void);
+/* Is D in the database */
+extern int  class_poly_db_find(UV D);
+/* Entry i (from 0): returns the degree and fills in D, the type, and the
+ * encoded coefficients with their length in bytes. */
+extern UV   class_poly_db_entry(UV i, UV *D, int *type,
+                                const unsigned char **coefs, UV *length);
+
+#endif
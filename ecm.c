@@ -219,77 +219,81 @@ int _GMP_ecm_factor_affine(mpz_t n, mpz_t f, UV B1, UV ncurves)
  * other articles.
  */
 
-static mpz_t b, ecn;          /* used throughout ec mult */
-static mpz_t u, v, w;         /* temporaries */
-static mpz_t x1, z1, x2, z2;  /* used by ec_mult and stage2 */
+/* The state of one ECM run, so separate threads can each have their own. */
+typedef struct {
+  mpz_t b, n;                 /* used throughout ec mult */
+  mpz_t u, v, w;              /* temporaries */
+  mpz_t x1, z1, x2, z2;       /* used by ec_mult and stage2 */
+  mpz_t x3, z3, x4, z4;       /* used by prac */
+} ecm_state_t;
 
 #define mpz_mulmod(r, a, b, n, t)  \
   do { mpz_mul(t, a, b); mpz_mod(r, t, n); } while (0)
 
 /* (x2:z2) = (x1:z1) + (x2:z2) */
-static void ec_add(mpz_t x2, mpz_t z2, mpz_t x1, mpz_t z1, mpz_t xinit)
+static void ec_add(ecm_state_t *s, mpz_t x2, mpz_t z2, mpz_t x1, mpz_t z1, mpz_t xinit)
 {
-  mpz_sub(u, x2, z2);
-  mpz_add(v, x1, z1);
-  mpz_mulmod(u, u, v, ecn, w);   /* u = (x2 - z2) * (x1 + z1) % n */
+  mpz_sub(s->u, x2, z2);
+  mpz_add(s->v, x1, z1);
+  mpz_mulmod(s->u, s->u, s->v, s->n, s->w);   /* u = (x2 - z2) * (x1 + z1) % n */
 
-  mpz_add(v, x2, z2);
-  mpz_sub(w, x1, z1);
-  mpz_mulmod(v, v, w, ecn, x2);  /* v = (x2 + z2) * (x1 - z1) % n */
+  mpz_add(s->v, x2, z2);
+  mpz_sub(s->w, x1, z1);
+  mpz_mulmod(s->v, s->v, s->w, s->n, x2);  /* v = (x2 + z2) * (x1 - z1) % n */
 
-  mpz_add(w, u, v);
-  mpz_mulmod(x2, w, w, ecn, z2); /* x2 = (u+v)^2 % n */
+  mpz_add(s->w, s->u, s->v);
+  mpz_mulmod(x2, s->w, s->w, s->n, z2); /* x2 = (u+v)^2 % n */
 
-  mpz_sub(w, u, v);
-  mpz_mulmod(z2, w, w, ecn, v);  /* z2 = (u-v)^2 % n */
+  mpz_sub(s->w, s->u, s->v);
+  mpz_mulmod(z2, s->w, s->w, s->n, s->v);  /* z2 = (u-v)^2 % n */
 
-  mpz_mulmod(z2, xinit, z2, ecn, v); /* z2 *= X1. */
+  mpz_mulmod(z2, xinit, z2, s->n, s->v); /* z2 *= X1. */
   /* Per Montgomery 1987, we set Z1 to 1, so no need for x2 *= Z1 */
   /* 5 mulmods, 6 adds */
 }
 
 /* This version assumes no normalization, so uses an extra mulmod. */
 /* (xout:zout) = (x1:z1) + (x2:z2) */
-static void ec_add3(mpz_t xout, mpz_t zout,
+static void ec_add3(ecm_state_t *s, mpz_t xout, mpz_t zout,
                     mpz_t x1, mpz_t z1,
                     mpz_t x2, mpz_t z2,
                     mpz_t xin, mpz_t zin)
 {
-  mpz_sub(u, x2, z2);
-  mpz_add(v, x1, z1);
-  mpz_mulmod(u, u, v, ecn, w);   /* u = (x2 - z2) * (x1 + z1) % n */
+  mpz_sub(s->u, x2, z2);
+  mpz_add(s->v, x1, z1);
+  mpz_mulmod(s->u, s->u, s->v, s->n, s->w);   /* u = (x2 - z2) * (x1 + z1) % n */
 
-  mpz_add(v, x2, z2);
-  mpz_sub(w, x1, z1);
-  mpz_mulmod(v, v, w, ecn, v);   /* v = (x2 + z2) * (x1 - z1) % n */
+  mpz_add(s->v, x2, z2);
+  mpz_sub(s->w, x1, z1);
+  mpz_mulmod(s->v, s->v, s->w, s->n, s->v);   /* v = (x2 + z2) * (x1 - z1) % n */
 
-  mpz_add(w, u, v);              /* w = u+v */
-  mpz_sub(v, u, v);              /* v = u-v */
+  mpz_add(s->w, s->u, s->v);              /* w = u+v */
+  mpz_sub(s->v, s->u, s->v);              /* v = u-v */
 
-  mpz_mulmod(w, w, w, ecn, u);   /* w = (u+v)^2 % n */
-  mpz_mulmod(v, v, v, ecn, u);   /* v = (u-v)^2 % n */
+  mpz_mulmod(s->w, s->w, s->w, s->n, s->u);   /* w = (u+v)^2 % n */
+  mpz_mulmod(s->v, s->v, s->v, s->n, s->u);   /* v = (u-v)^2 % n */
 
-  mpz_set(u, xin);
-  mpz_mulmod(xout, w, zin, ecn, w);
-  mpz_mulmod(zout, v, u,   ecn, w);
+  mpz_set(s->u, xin);
+  mpz_mulmod(xout, s->w, zin, s->n, s->w);
+  mpz_mulmod(zout, s->v, s->u,   s->n, s->w);
   /* 6 mulmods, 6 adds */
 }
 
 /* (x2:z2) = 2(x1:z1) */
-static void ec_double(mpz_t x2, mpz_t z2, mpz_t x1, mpz_t z1)
+static void ec_double(ecm_state_t *s, mpz_t x2, mpz_t z2, mpz_t x1, mpz_t z1)
 {
-  mpz_add(u, x1, z1);
-  mpz_mulmod(u, u, u, ecn, w);   /* u = (x1+z1)^2 % n */
+  mpz_add(s->u, x1, z1);
+  mpz_mulmod(s->u, s->u, s->u, s->n, s->w);   /* u = (x1+z1)^2 % n */
 
-  mpz_sub(v, x1, z1);
-  mpz_mulmod(v, v, v, ecn, w);   /* v = (x1-z1)^2 % n */
+  mpz_sub(s->v, x1, z1);
+  mpz_mulmod(s->v, s->v, s->v, s->n, s->w);   /* v = (x1-z1)^2 % n */
 
-  mpz_mulmod(x2, u, v, ecn, w);  /* x2 = uv % n */
+  mpz_mulmod(x2, s->u, s->v, s->n, s->w);  /* x2 = uv % n */
 
-  mpz_sub(w, u, v);              /* w = u-v = 4(x1 * z1) */
-  mpz_mulmod(u, b, w, ecn, z2);
-  mpz_add(u, u, v);              /* u = (v+b*w) mod n */
-  mpz_mulmod(z2, w, u, ecn, v);  /* z2 = (w*u) mod n */
+  mpz_sub(s->w, s->u, s->v);              /* w = u-v = 4(x1 * z1) */
+  mpz_mulmod(s->u, s->b, s->w, s->n, z2);
+  mpz_add(s->u, s->u, s->v);              /* u = (v+b*w) mod n */
+  mpz_mulmod(z2, s->w, s->u, s->n, s->v);  /* z2 = (w*u) mod n */
   /* 5 mulmods, 4 adds */
 }
 
@@ -299,34 +303,34 @@ static void ec_double(mpz_t x2, mpz_t z2, mpz_t x1, mpz_t z1)
 
 #ifndef USE_PRAC
 
-static void ec_mult(UV k, mpz_t x, mpz_t z)
+static void ec_mult(ecm_state_t *s, UV k, mpz_t x, mpz_t z)
 {
   int l, r;
 
   r = --k; l = -1; while (r != 1) { r >>= 1; l++; }
   if (k & ( UVCONST(1)<<l)) {
-    ec_double(x2, z2, x, z);
-    ec_add3(x1, z1, x2, z2, x, z, x, z);
-    ec_double(x2, z2, x2, z2);
+    ec_double(s, s->x2, s->z2, x, z);
+    ec_add3(s, s->x1, s->z1, s->x2, s->z2, x, z, x, z);
+    ec_double(s, s->x2, s->z2, s->x2, s->z2);
   } else {
-    ec_double(x1, z1, x, z);
-    ec_add3(x2, z2, x, z, x1, z1, x, z);
+    ec_double(s, s->x1, s->z1, x, z);
+    ec_add3(s, s->x2, s->z2, x, z, s->x1, s->z1, x, z);
   }
   l--;
   while (l >= 1) {
     if (k & ( UVCONST(1)<<l)) {
-      ec_add3(x1, z1, x1, z1, x2, z2, x, z);
-      ec_double(x2, z2, x2, z2);
+      ec_add3(s, s->x1, s->z1, s->x1, s->z1, s->x2, s->z2, x, z);
+      ec_double(s, s->x2, s->z2, s->x2, s->z2);
     } else {
-      ec_add3(x2, z2, x2, z2, x1, z1, x, z);
-      ec_double(x1, z1, x1, z1);
+      ec_add3(s, s->x2, s->z2, s->x2, s->z2, s->x1, s->z1, x, z);
+      ec_double(s, s->x1, s->z1, s->x1, s->z1);
     }
     l--;
   }
   if (k & 1) {
-    ec_double(x, z, x2, z2);
+    ec_double(s, x, z, s->x2, s->z2);
   } else {
-    ec_add3(x, z, x2, z2, x1, z1, x, z);
+    ec_add3(s, x, z, s->x2, s->z2, s->x1, s->z1, x, z);
   }
 }
 
@@ -346,7 +350,6 @@ static void ec_mult(UV k, mpz_t x, mpz_t z)
 
 /* PRAC, details from GMP-ECM, algorithm from Montgomery */
 /* See "20 years of ECM" by Paul Zimmermann for more info */
-static mpz_t x3, z3, x4, z4;  /* used by prac */
 #define ADD 6 /* number of multiplications in an addition */
 #define DUP 5 /* number of multiplications in a double */
 
@@ -391,7 +394,7 @@ static UV lucas_cost(UV n, double val)
   t = x##a; x##a = x##b; x##b = t;  t = z##a; z##a = z##b; z##b = t;
 
 /* PRAC: computes kP from P=(x:z) and puts the result in (x:z). Assumes k>2.*/
-static void ec_mult(UV k, mpz_t x, mpz_t z)
+static void ec_mult(ecm_state_t *s, UV k, mpz_t x, mpz_t z)
 {
    unsigned int  d, e, r, i;
    __mpz_struct *xA, *zA, *xB, *zB, *xC, *zC, *xT, *zT, *xT2, *zT2, *t;
@@ -409,13 +412,13 @@ static void ec_mult(UV k, mpz_t x, mpz_t z)
    }
    r = (unsigned int)((double)k / val[i] + 0.5);
    /* A=(x:z) B=(x1:z1) C=(x2:z2) T=T1=(x3:z3) T2=(x4:z4) */
-   xA=x; zA=z; xB=x1; zB=z1; xC=x2; zC=z2; xT=x3; zT=z3; xT2=x4; zT2=z4;
+   xA=x; zA=z; xB=s->x1; zB=s->z1; xC=s->x2; zC=s->z2; xT=s->x3; zT=s->z3; xT2=s->x4; zT2=s->z4;
    /* first iteration always begins by Condition 3, then a swap */
    d = k - r;
    e = 2 * r - k;
    mpz_set(xB,xA); mpz_set(zB,zA); /* B=A */
    mpz_set(xC,xA); mpz_set(zC,zA); /* C=A */
-   ec_double(xA,zA,xA,zA);         /* A=2*A */
+   ec_double(s, xA,zA,xA,zA);         /* A=2*A */
    while (d != e) {
       if (d < e) {
          r = d;  d = e;  e = r;
@@ -425,53 +428,53 @@ static void ec_mult(UV k, mpz_t x, mpz_t z)
       if (4 * d <= 5 * e && ((d + e) % 3) == 0) { /* condition 1 */
          d = (2 * d - e) / 3;
          e = (e - d) / 2;
-         ec_add3(xT,zT,xA,zA,xB,zB,xC,zC);   /* T = f(A,B,C) */
-         ec_add3(xT2,zT2,xT,zT,xA,zA,xB,zB); /* T2= f(T,A,B) */
-         ec_add3(xB,zB,xB,zB,xT,zT,xA,zA);   /* B = f(B,T,A) */
+         ec_add3(s, xT,zT,xA,zA,xB,zB,xC,zC);   /* T = f(A,B,C) */
+         ec_add3(s, xT2,zT2,xT,zT,xA,zA,xB,zB); /* T2= f(T,A,B) */
+         ec_add3(s, xB,zB,xB,zB,xT,zT,xA,zA);   /* B = f(B,T,A) */
          SWAP(A,T2);
       } else if (4 * d <= 5 * e && (d - e) % 6 == 0) { /* condition 2 */
          d = (d - e) / 2;
-         ec_add3(xB,zB,xA,zA,xB,zB,xC,zC);   /* B = f(A,B,C) */
-         ec_double(xA,zA,xA,zA);             /* A = 2*A */
+         ec_add3(s, xB,zB,xA,zA,xB,zB,xC,zC);   /* B = f(A,B,C) */
+         ec_double(s, xA,zA,xA,zA);             /* A = 2*A */
       } else if (d <= (4 * e)) { /* condition 3 */
          d -= e;
-         ec_add3(xC,zC,xB,zB,xA,zA,xC,zC);   /* C = f(B,A,C) */
+         ec_add3(s, xC,zC,xB,zB,xA,zA,xC,zC);   /* C = f(B,A,C) */
          SWAP(B,C);
       } else if ((d + e) % 2 == 0) { /* condition 4 */
          d = (d - e) / 2;
-         ec_add3(xB,zB,xB,zB,xA,zA,xC,zC);   /* B = f(B,A,C) */
-         ec_double(xA,zA,xA,zA);             /* A = 2*A */
+         ec_add3(s, xB,zB,xB,zB,xA,zA,xC,zC);   /* B = f(B,A,C) */
+         ec_double(s, xA,zA,xA,zA);             /* A = 2*A */
       } else if (d % 2 == 0) { /* condition 5 */
          d /= 2;
-         ec_add3(xC,zC,xC,zC,xA,zA,xB,zB);   /* C = f(C,A,B) */
-         ec_double(xA,zA,xA,zA);             /* A = 2*A */
+         ec_add3(s, xC,zC,xC,zC,xA,zA,xB,zB);   /* C = f(C,A,B) */
+         ec_double(s, xA,zA,xA,zA);             /* A = 2*A */
       } else if (d % 3 == 0) { /* condition 6 */
          d = d / 3 - e;
-         ec_double(xT,zT,xA,zA);             /* T = 2*A */
-         ec_add3(xT2,zT2,xA,zA,xB,zB,xC,zC); /* T2= f(A,B,C) */
-         ec_add3(xA,zA,xT,zT,xA,zA,xA,zA);   /* A = f(T,A,A) */
-         ec_add3(xC,zC,xT,zT,xT2,zT2,xC,zC); /* C = f(T,T2,C) */
+         ec_double(s, xT,zT,xA,zA);             /* T = 2*A */
+         ec_add3(s, xT2,zT2,xA,zA,xB,zB,xC,zC); /* T2= f(A,B,C) */
+         ec_add3(s, xA,zA,xT,zT,xA,zA,xA,zA);   /* A = f(T,A,A) */
+         ec_add3(s, xC,zC,xT,zT,xT2,zT2,xC,zC); /* C = f(T,T2,C) */
          SWAP(B,C);
       } else if ((d + e) % 3 == 0) { /* condition 7 */
          d = (d - 2 * e) / 3;
-         ec_add3(xT,zT,xA,zA,xB,zB,xC,zC);   /* T = f(A,B,C) */
-         ec_add3(xB,zB,xT,zT,xA,zA,xB,zB);   /* B = f(T1,A,B) */
-         ec_double(xT,zT,xA,zA);
-         ec_add3(xA,zA,xA,zA,xT,zT,xA,zA);   /* A = 3*A */
+         ec_add3(s, xT,zT,xA,zA,xB,zB,xC,zC);   /* T = f(A,B,C) */
+         ec_add3(s, xB,zB,xT,zT,xA,zA,xB,zB);   /* B = f(T1,A,B) */
+         ec_double(s, xT,zT,xA,zA);
+         ec_add3(s, xA,zA,xA,zA,xT,zT,xA,zA);   /* A = 3*A */
       } else if ((d - e) % 3 == 0) { /* condition 8 */
          d = (d - e) / 3;
-         ec_add3(xT,zT,xA,zA,xB,zB,xC,zC);   /* T = f(A,B,C) */
-         ec_add3(xC,zC,xC,zC,xA,zA,xB,zB);   /* C = f(A,C,B) */
+         ec_add3(s, xT,zT,xA,zA,xB,zB,xC,zC);   /* T = f(A,B,C) */
+         ec_add3(s, xC,zC,xC,zC,xA,zA,xB,zB);   /* C = f(A,C,B) */
          SWAP(B,T);
-         ec_double(xT,zT,xA,zA);
-         ec_add3(xA,zA,xA,zA,xT,zT,xA,zA);   /* A = 3*A */
+         ec_double(s, xT,zT,xA,zA);
+         ec_add3(s, xA,zA,xA,zA,xT,zT,xA,zA);   /* A = 3*A */
       } else { /* condition 9 */
          e /= 2;
-         ec_add3(xC,zC,xC,zC,xB,zB,xA,zA);   /* C = f(C,B,A) */
-         ec_double(xB,zB,xB,zB);             /* B = 2*B */
+         ec_add3(s, xC,zC,xC,zC,xB,zB,xA,zA);   /* C = f(C,B,A) */
+         ec_double(s, xB,zB,xB,zB);             /* B = 2*B */
       }
    }
-   ec_add3(xA,zA,xA,zA,xB,zB,xC,zC);
+   ec_add3(s, xA,zA,xA,zA,xB,zB,xC,zC);
    if (x!=xA) { mpz_set(x,xA); mpz_set(z,zA); }
 }
 
@@ -484,7 +487,7 @@ static void ec_mult(UV k, mpz_t x, mpz_t z)
     mpz_mulmod(x, x, u, n, v); \
     mpz_set_ui(z, 1);
 
-static int ec_stage2(UV B1, UV B2, mpz_t x, mpz_t z, mpz_t f)
+static int ec_stage2(ecm_state_t *s, UV B1, UV B2, mpz_t x, mpz_t z, mpz_t f)
 {
   UV D, i, m;
   mpz_t* nqx = 0;
@@ -493,7 +496,7 @@ static int ec_stage2(UV B1, UV B2, mpz_t x, mpz_t z, mpz_t f)
   PRIME_ITERATOR(iter);
 
   do {
-    NORMALIZE(f, u, v, x, z, ecn);
+    NORMALIZE(f, s->u, s->v, x, z, s->n);
 
     D = sqrt( (double)B2 / 2.0 );
     if (D%2) D++;
@@ -506,45 +509,45 @@ static int ec_stage2(UV B1, UV B2, mpz_t x, mpz_t z, mpz_t f)
 
     for (i = 2; i <= 2*D; i++) {
       if (i % 2) {
-        mpz_set(x2, nqx[(i+1)/2]);  mpz_set_ui(z2, 1);
-        ec_add(x2, z2, nqx[(i-1)/2], one, x);
+        mpz_set(s->x2, nqx[(i+1)/2]);  mpz_set_ui(s->z2, 1);
+        ec_add(s, s->x2, s->z2, nqx[(i-1)/2], one, x);
       } else {
-        ec_double(x2, z2, nqx[i/2], one);
+        ec_double(s, s->x2, s->z2, nqx[i/2], one);
       }
-      mpz_init_set(nqx[i], x2);
-      NORMALIZE(f, u, v, nqx[i], z2, ecn);
+      mpz_init_set(nqx[i], s->x2);
+      NORMALIZE(f, s->u, s->v, nqx[i], s->z2, s->n);
     }
     if (found) break;
 
-    mpz_set(x1, x);
-    mpz_set(z1, z);
+    mpz_set(s->x1, x);
+    mpz_set(s->z1, z);
     mpz_set(x, nqx[2*D-1]);
     mpz_set_ui(z, 1);
 
     /* See Zimmermann, "20 Years of ECM" slides, 2006, page 11-12 */
     for (m = 1; m < B2+D; m += 2*D) {
       if (m != 1) {
-        mpz_set(x2, x1);
-        mpz_set(z2, z1);
-        ec_add(x1, z1, nqx[2*D], one, x);
-        NORMALIZE(f, u, v, x1, z1, ecn);
-        mpz_set(x, x2);  mpz_set(z, z2);
+        mpz_set(s->x2, s->x1);
+        mpz_set(s->z2, s->z1);
+        ec_add(s, s->x1, s->z1, nqx[2*D], one, x);
+        NORMALIZE(f, s->u, s->v, s->x1, s->z1, s->n);
+        mpz_set(x, s->x2);  mpz_set(z, s->z2);
       }
       if (m+D > B1 && m >= D) {
         prime_iterator_setprime(&iter, m-D-1);
         for (i = prime_iterator_next(&iter); i < m; i = prime_iterator_next(&iter)) {
           /* if (m+D-i<1 || m+D-i>2*D) croak("index %lu range\n",i-(m-D)); */
-          mpz_sub(w, x1, nqx[m+D-i]);
-          mpz_mulmod(g, g, w, ecn, u);
+          mpz_sub(s->w, s->x1, nqx[m+D-i]);
+          mpz_mulmod(g, g, s->w, s->n, s->u);
         }
         for ( ; i <= m+D; i = prime_iterator_next(&iter)) {
           if (i > m && !prime_iterator_isprime(&iter, m+m-i)) {
             /* if (i-m<1 || i-m>2*D) croak("index %lu range\n",i-(m-D)); */
-            mpz_sub(w, x1, nqx[i-m]);
-            mpz_mulmod(g, g, w, ecn, u);
+            mpz_sub(s->w, s->x1, nqx[i-m]);
+            mpz_mulmod(g, g, s->w, s->n, s->u);
           }
         }
-        mpz_gcd(f, g, ecn);
+        mpz_gcd(f, g, s->n);
         found = mpz_cmp_ui(f, 1);
         if (found) break;
       }
@@ -561,12 +564,13 @@ static int ec_stage2(UV B1, UV B2, mpz_t x, mpz_t z, mpz_t f)
     mpz_clear(g);
     mpz_clear(one);
   }
-  if (found && !mpz_cmp(f, ecn)) found = 0;
+  if (found && !mpz_cmp(f, s->n)) found = 0;
   return (found) ? 2 : 0;
 }
 
 int _GMP_ecm_factor_projective(mpz_t n, mpz_t f, UV B1, UV B2, UV ncurves)
 {
+  ecm_state_t state, *s = &state;
   mpz_t sigma, a, x, z;
   UV i, curve, q, k;
   int found = 0;
@@ -576,12 +580,12 @@ int _GMP_ecm_factor_projective(mpz_t n, mpz_t f, UV B1, UV B2, UV ncurves)
 
   if (B2 < B1)  B2 = 100*B1;  /* time(S1) == time(S2) ~ 125 */
 
-  mpz_init_set(ecn, n);
-  mpz_init(x);   mpz_init(z);   mpz_init(a);   mpz_init(b);
-  mpz_init(u);   mpz_init(v);   mpz_init(w);   mpz_init(sigma);
-  mpz_init(x1);  mpz_init(z1);  mpz_init(x2);  mpz_init(z2);
+  mpz_init_set(s->n, n);
+  mpz_init(x);   mpz_init(z);   mpz_init(a);   mpz_init(s->b);
+  mpz_init(s->u);   mpz_init(s->v);   mpz_init(s->w);   mpz_init(sigma);
+  mpz_init(s->x1);  mpz_init(s->z1);  mpz_init(s->x2);  mpz_init(s->z2);
 #ifdef USE_PRAC
-  mpz_init(x3);  mpz_init(z3);  mpz_init(x4);  mpz_init(z4);
+  mpz_init(s->x3);  mpz_init(s->z3);  mpz_init(s->x4);  mpz_init(s->z4);
 #endif
 
   if (_verbose>2) gmp_printf("# ecm trying %Zd (B1=%lu B2=%lu ncurves=%lu)\n", n, (unsigned long)B1, (unsigned long)B2, (unsigned long)ncurves);
@@ -591,80 +595,80 @@ int _GMP_ecm_factor_projective(mpz_t n, mpz_t f, UV B1, UV B2, UV ncurves)
     do {
       mpz_isaac_urandomm(sigma, n);
     } while (mpz_cmp_ui(sigma, 5) <= 0);
-    mpz_mul_ui(w, sigma, 4);
-    mpz_mod(v, w, n);             /* v = 4σ */
+    mpz_mul_ui(s->w, sigma, 4);
+    mpz_mod(s->v, s->w, n);             /* v = 4σ */
 
     mpz_mul(x, sigma, sigma);
-    mpz_sub_ui(w, x, 5);
-    mpz_mod(u, w, n);             /* u = σ^2-5 */
+    mpz_sub_ui(s->w, x, 5);
+    mpz_mod(s->u, s->w, n);             /* u = σ^2-5 */
 
-    mpz_mul(x, u, u);
-    mpz_mulmod(x, x, u, n, w);    /* x = u^3 */
+    mpz_mul(x, s->u, s->u);
+    mpz_mulmod(x, x, s->u, n, s->w);    /* x = u^3 */
 
-    mpz_mul(z, v, v);
-    mpz_mulmod(z, z, v, n, w);    /* z = v^3 */
+    mpz_mul(z, s->v, s->v);
+    mpz_mulmod(z, z, s->v, n, s->w);    /* z = v^3 */
 
-    mpz_mul(b, x, v);
-    mpz_mul_ui(w, b, 4);
-    mpz_mod(b, w, n);             /* b = 4 u^3 v */
+    mpz_mul(s->b, x, s->v);
+    mpz_mul_ui(s->w, s->b, 4);
+    mpz_mod(s->b, s->w, n);             /* b = 4 u^3 v */
 
-    mpz_sub(a, v, u);
-    mpz_mul(w, a, a);
-    mpz_mulmod(w, w, a, n, w);
+    mpz_sub(a, s->v, s->u);
+    mpz_mul(s->w, a, a);
+    mpz_mulmod(s->w, s->w, a, n, s->w);
 
-    mpz_mul_ui(a, u, 3);
-    mpz_add(a, a, v);
-    mpz_mul(w, w, a);
-    mpz_mod(a, w, n);             /* a = ((v-u)^3 * (3*u + v)) % n */
+    mpz_mul_ui(a, s->u, 3);
+    mpz_add(a, a, s->v);
+    mpz_mul(s->w, s->w, a);
+    mpz_mod(a, s->w, n);             /* a = ((v-u)^3 * (3*u + v)) % n */
 
-    mpz_gcdext(f, u, NULL, b, n);
+    mpz_gcdext(f, s->u, NULL, s->b, n);
     found = mpz_cmp_ui(f, 1);
     if (found) { if (!mpz_cmp(f, n)) { found = 0; continue; } break; }
-    mpz_mul(a, a, u);
+    mpz_mul(a, a, s->u);
 
     mpz_sub_ui(a, a, 2);
     mpz_mod(a, a, n);
 
-    mpz_add_ui(b, a, 2);
-    if (mpz_mod_ui(w, b, 2)) mpz_add(b, b, n);
-    mpz_tdiv_q_2exp(b, b, 1);
-    if (mpz_mod_ui(w, b, 2)) mpz_add(b, b, n);
-    mpz_tdiv_q_2exp(b, b, 1);
+    mpz_add_ui(s->b, a, 2);
+    if (mpz_mod_ui(s->w, s->b, 2)) mpz_add(s->b, s->b, n);
+    mpz_tdiv_q_2exp(s->b, s->b, 1);
+    if (mpz_mod_ui(s->w, s->b, 2)) mpz_add(s->b, s->b, n);
+    mpz_tdiv_q_2exp(s->b, s->b, 1);
 
     /* Use sigma to collect possible factors */
     mpz_set_ui(sigma, 1);
 
     /* Stage 1 */
     for (q = 2; q < B1; q *= 2)
-      ec_double(x, z, x, z);
-    mpz_mulmod(sigma, sigma, x, ecn, w);
+      ec_double(s, x, z, x, z);
+    mpz_mulmod(sigma, sigma, x, s->n, s->w);
     i = 15;
     for (q = prime_iterator_next(&iter); q < B1; q = prime_iterator_next(&iter)) {
       /* PRAC is a little faster with:
        *     for (k = 1; k <= B1/q; k *= q)
-       *       ec_mult(q, x, z);
+       *       ec_mult(s, q, x, z);
        * but binary multiplication is much slower that way. */
       for (k = q; k <= B1/q; k *= q) ;
-      ec_mult(k, x, z);
-      mpz_mulmod(sigma, sigma, x, ecn, w);
+      ec_mult(s, k, x, z);
+      mpz_mulmod(sigma, sigma, x, s->n, s->w);
       if (i++ % 32 == 0) {
-        mpz_gcd(f, sigma, ecn);
+        mpz_gcd(f, sigma, s->n);
         if (mpz_cmp_ui(f, 1))  break;
       }
     }
     prime_iterator_destroy(&iter);
 
     /* Find factor in S1 */
-    do { NORMALIZE(f, u, v, x, z, n); } while (0);
+    do { NORMALIZE(f, s->u, s->v, x, z, n); } while (0);
     if (!found) {
-      mpz_gcd(f, sigma, ecn);
+      mpz_gcd(f, sigma, s->n);
       found = mpz_cmp_ui(f, 1);
     }
     if (found) { if (!mpz_cmp(f, n)) { found = 0; continue; } break; }
 
     /* Stage 2 */
     if (!found && B2 > B1)
-      found = ec_stage2(B1, B2, x, z, f);
+      found = ec_stage2(s, B1, B2, x, z, f);
 
     if (found) { if (!mpz_cmp(f, n)) { found = 0; continue; } break; }
   }
@@ -673,12 +677,12 @@ int _GMP_ecm_factor_projective(mpz_t n, mpz_t f, UV B1, UV B2, UV ncurves)
     else       gmp_printf("# ecm: no factor\n");
   }
 
-  mpz_clear(ecn);
-  mpz_clear(x);   mpz_clear(z);   mpz_clear(a);   mpz_clear(b);
-  mpz_clear(u);   mpz_clear(v);   mpz_clear(w);   mpz_clear(sigma);
-  mpz_clear(x1);  mpz_clear(z1);  mpz_clear(x2);  mpz_clear(z2);
+  mpz_clear(s->n);
+  mpz_clear(x);   mpz_clear(z);   mpz_clear(a);   mpz_clear(s->b);
+  mpz_clear(s->u);   mpz_clear(s->v);   mpz_clear(s->w);   mpz_clear(sigma);
+  mpz_clear(s->x1);  mpz_clear(s->z1);  mpz_clear(s->x2);  mpz_clear(s->z2);
 #ifdef USE_PRAC
-  mpz_clear(x3);  mpz_clear(z3);  mpz_clear(x4);  mpz_clear(z4);
+  mpz_clear(s->x3);  mpz_clear(s->z3);  mpz_clear(s->x4);  mpz_clear(s->z4);
 #endif
 
   return found;
@@ -21,8 +21,9 @@
  *     present here, but his (very old!) binaries run slower than this code at
  *     all sizes.  Not open source.
  *
- * A set of fixed discriminants are used, rather than calculating them as
- * needed.  Having a way to calculate values as needed would be a big help.
+ * A set of fixed discriminants are used first.  For inputs over about 450
+ * digits we add several thousand more whose Hilbert polynomials are computed
+ * as needed (see classpoly.c).
  * In the interests of space for the MPU package, I've chosen ~600 values which
  * compile into about 35k of data.  This is about 1/5 of the entire code size
  * for the MPU package.  The github repository includes an expanded set of 5271
@@ -72,9 +73,75 @@
 #include "bls75.h"
 #include "factor.h"
 #include "primality.h"
+#include "cert.h"
+#include "threadpool.h"
+#include "classpoly.h"
+
+#ifdef USE_PTHREADS
+ #include <pthread.h>
+#endif
 
 #define MAX_SFACS 1000
 
+static void ckpt_write_factor(mpz_t f);
+
+/* EAS (see ecpp_set_policy) is only used for N with at least this many
+ * digits.  Below this a level takes little time whatever q we go down with. */
+#define ECPP_EAS_DIGITS 100
+
+static struct {
+  int    eas;            /* Candidates to compare at each level, 0 = off */
+  double degree_bits;    /* Bits of reduction worth one more in the degree */
+  double step_seconds;   /* Factoring time at a level per stage, 0 = none */
+} _policy = {0, 2.0, 0.0};
+
+/* The state of one proof.  A batch runs several at once, each on a worker
+ * thread with its own one of these.  Otherwise it is _run. */
+typedef struct {
+  ecpp_stats_t   stats;
+  bls_partial_t *part;      /* From a BLS75 proof of the top N, or 0 */
+  int           *dilist;    /* In a batch, the discriminants to start with */
+  mpz_t         *sfacs;     /* ... and the saved factors it shares */
+  int           *nsfacs;
+} ecpp_run_t;
+
+static ecpp_run_t _run;
+
+#ifdef USE_PTHREADS
+static pthread_key_t _runkey;
+static int _runkey_ok = 0;
+static ecpp_run_t* ecpp_run(void)
+{
+  ecpp_run_t *run = _runkey_ok ? (ecpp_run_t*) pthread_getspecific(_runkey) : 0;
+  return (run != 0) ? run : &_run;
+}
+#else
+#define ecpp_run()  (&_run)
+#endif
+
+/* A proof in a batch leaves the threads to the batch, and has no checkpoint */
+#define IN_BATCH(run)  ((run)->dilist != 0)
+
+#define FACTOR_TIME(run, t0, spent) \
+  do { double _dt = wall_seconds() - t0; \
+       spent += _dt;  (run)->stats.factor_seconds += _dt; } while (0)
+
+void ecpp_set_policy(int eas, double degree_bits, double step_seconds)
+{
+  _policy.eas = (eas < 0) ? 0 : eas;
+  _policy.degree_bits = (degree_bits < 0) ? 0 : degree_bits;
+  _policy.step_seconds = (step_seconds < 0) ? 0 : step_seconds;
+}
+
+void ecpp_get_stats(ecpp_stats_t* stats)
+{
+  *stats = _run.stats;
+}
+
+/* Inputs larger than this also try the discriminants whose Hilbert class
+ * polynomials are computed as needed, beyond the compiled in set. */
+#define ECPP_GEN_POLY_BITS 1500
+
 #ifdef USE_LIBECM
  #include <ecm.h>
 #endif
@@ -117,6 +184,17 @@ void destroy_ecpp_gcds(void) {
  * straight to the base-2 Miller-Rabin test we use in BPSW. */
 #define is_bpsw_prime(n) _GMP_BPSW(n)
 
+/* The proofs in a batch share their saved factors, adding to them as they
+ * go, so the count is read under the lock. */
+static int sfacs_count(int* nsfacs)
+{
+  int n;
+  parallel_lock();
+  n = *nsfacs;
+  parallel_unlock();
+  return n;
+}
+
 static int check_for_factor(mpz_t f, mpz_t inputn, mpz_t fmin, mpz_t n, int stage, mpz_t* sfacs, int* nsfacs, int degree)
 {
   int success, sfaci;
@@ -210,7 +288,7 @@ static int check_for_factor(mpz_t f, mpz_t inputn, mpz_t fmin, mpz_t n, int stag
 #endif
     }
     /* Try any factors found in previous stage 2+ calls */
-    while (!success && sfaci < *nsfacs) {
+    while (!success && sfaci < sfacs_count(nsfacs)) {
       if (mpz_divisible_p(n, sfacs[sfaci])) {
         mpz_set(f, sfacs[sfaci]);
         success = 1;
@@ -240,14 +318,24 @@ static int check_for_factor(mpz_t f, mpz_t inputn, mpz_t fmin, mpz_t n, int stag
     }
     if (success) {
       if (mpz_cmp_ui(f, 1) == 0 || mpz_cmp(f, n) == 0) {
-        gmp_printf("factoring %Zd resulted in factor %Zd\n", n, f);
-        croak("internal error in ECPP factoring");
+        /* A trivial factor is a bug in the factoring code.  Give up on this
+         * n rather than croak, since we may be on a worker thread. */
+        if (get_verbose_level())
+          gmp_printf("factoring %Zd resulted in factor %Zd\n", n, f);
+        break;
       }
       /* Add the factor to the saved factors list */
-      if (stage > 1 && *nsfacs < MAX_SFACS) {
+      if (stage > 1) {
+        int added = 0;
         /* gmp_printf(" ***** adding factor %Zd ****\n", f); */
-        mpz_init_set(sfacs[*nsfacs], f);
-        nsfacs[0]++;
+        parallel_lock();
+        if (*nsfacs < MAX_SFACS) {
+          mpz_init_set(sfacs[*nsfacs], f);
+          nsfacs[0]++;
+          added = 1;
+        }
+        parallel_unlock();
+        if (added) ckpt_write_factor(f);
       }
       /* Is the factor f what we want? */
       if ( mpz_cmp(f, fmin) > 0 && is_bpsw_prime(f) )  return 1;
@@ -365,13 +453,18 @@ static int find_roots(long D, int poly_index, mpz_t N, mpz_t** roots, int maxroo
   polyz_mod(T, T, &dT, N);
 
   polyz_roots_modp(roots, &nroots, maxroots, T, dT, N);
-  if (nroots == 0) {
-    gmp_printf("N = %Zd\n", N);
-    croak("Failed to find roots for D = %ld\n", D);
-  }
   for (i = 0; i <= dT; i++)
     mpz_clear(T[i]);
   Safefree(T);
+  /* Either N is composite or the class poly is bad.  The caller gives up on
+   * this D, which is safe either way and lets us run on worker threads. */
+  if (nroots == 0) {
+    if (get_verbose_level())
+      gmp_printf("\n  Failed to find roots for D = %ld with N = %Zd\n", D, N);
+    if (*roots != 0) Safefree(*roots);
+    *roots = 0;
+    return 0;
+  }
 #if 0
   if (nroots != dT && get_verbose_level())
     printf("  found %ld roots of the %ld degree poly\n", nroots, dT);
@@ -432,10 +525,12 @@ static void select_curve_params(mpz_t a, mpz_t b, mpz_t g,
     mpz_set_ui(g, 0);
 }
 
-static void select_point(mpz_t x, mpz_t y, mpz_t a, mpz_t b, mpz_t N,
-                         mpz_t t, mpz_t t2)
+/* Returns 0 if N was found to be composite, 1 otherwise */
+static int select_point(mpz_t x, mpz_t y, mpz_t a, mpz_t b, mpz_t N,
+                        mpz_t t, mpz_t t2)
 {
   mpz_t Q, t3, t4;
+  int result = 1;
 
   mpz_init(Q); mpz_init(t3); mpz_init(t4);
   mpz_set_ui(y, 0);
@@ -454,12 +549,15 @@ static void select_point(mpz_t x, mpz_t y, mpz_t a, mpz_t b, mpz_t N,
       mpz_add(t, t, b);
       mpz_mod(Q, t, N);
     } while (mpz_jacobi(Q, N) == -1);
-    /* Select Y */
-    sqrtmodp_t(y, Q, N, t, t2, t3, t4);
-    /* TODO: if y^2 mod Ni != t, return composite */
-    if (mpz_sgn(y) == 0) croak("y == 0 in point selection\n");
+    /* Select Y.  Q = 0 gives y = 0, so we pick another x. */
+    if (!sqrtmodp_t(y, Q, N, t, t2, t3, t4)) {
+      mpz_set_ui(y, 0);
+      result = 0;
+      break;
+    }
   }
   mpz_clear(Q); mpz_clear(t3); mpz_clear(t4);
+  return result;
 }
 
 /* Returns 0 (composite), 1 (didn't find a point), 2 (found point) */
@@ -549,7 +647,8 @@ static int find_curve(mpz_t a, mpz_t b, mpz_t x, mpz_t y,
       if (i > 0)
         update_ab(a, b, D, g, N);
       npoints++;
-      select_point(x, y,  a, b, N, t, t2);
+      if (!select_point(x, y,  a, b, N, t, t2))
+        { result = 0; break; }
       result = ecpp_check_point(x, y, m, q, a, N, t, t2);
     }
   }
@@ -607,8 +706,507 @@ static void choose_m(mpz_t* mlist, long D, mpz_t u, mpz_t v, mpz_t N,
           mpz_swap( mlist[i], mlist[j] );
 }
 
+/* The proof text for one step. */
+static char* proof_step_text(int D, mpz_t Ni,
+                             mpz_t a, mpz_t b, mpz_t m, mpz_t q, mpz_t x, mpz_t y,
+                             UV nm1a, IV np1lp, IV np1lq, mpz_t t)
+{
+  char *proofstr;
+
+  if (D == 1) {
+    int myprooflen = 20 + 2*(4 + mpz_sizeinbase(Ni, 10)) + 1*21;
+    New(0, proofstr, myprooflen + 1, char);
+    sprintf(proofstr + gmp_sprintf(proofstr, "Type BLS3\nN  %Zd\nQ  %Zd\n", Ni,q),
+            "A  %"UVuf"\n", nm1a);
+  } else if (D == -1) {
+    int myprooflen = 20 + 2*(4 + mpz_sizeinbase(Ni, 10)) + 2*21;
+    New(0, proofstr, myprooflen + 1, char);
+    /* It seems some testers have a sprintf bug with IVs.  Try to handle. */
+    sprintf(proofstr + gmp_sprintf(proofstr, "Type BLS15\nN  %Zd\nQ  %Zd\n", Ni,q),
+            "LP %d\nLQ %d\n", (int)np1lp, (int)np1lq);
+  } else {
+    int myprooflen = 20 + 7*(4 + mpz_sizeinbase(Ni, 10)) + 0;
+    New(0, proofstr, myprooflen + 1, char);
+    mpz_sub_ui(t, Ni, 1);
+    if (mpz_cmp(a, t) == 0)  mpz_set_si(a, -1);
+    if (mpz_cmp(b, t) == 0)  mpz_set_si(b, -1);
+    gmp_sprintf(proofstr, "Type ECPP\nN  %Zd\nA  %Zd\nB  %Zd\nM  %Zd\nQ  %Zd\nX  %Zd\nY  %Zd\n", Ni, a, b, m, q, x, y);
+  }
+  return proofstr;
+}
+
+/* Prepend the text for one step (which is taken over) to anything that exists. */
+static void prepend_text(char** prooftextptr, char* steptext)
+{
+  char *proofstr;
+
+  if (*prooftextptr == 0) {
+    *prooftextptr = steptext;
+    return;
+  }
+  New(0, proofstr, strlen(steptext) + 1 + strlen(*prooftextptr) + 1, char);
+  strcpy(proofstr, steptext);
+  strcat(proofstr, "\n");
+  strcat(proofstr, *prooftextptr);
+  Safefree(steptext);
+  Safefree(*prooftextptr);
+  *prooftextptr = proofstr;
+}
+
+/*********************  Checkpoints  *********************
+ *
+ * A long proof can be saved as it goes, so it can be stopped and picked up
+ * again later.  The checkpoint file is an MPU certificate for N, with the
+ * search state in comment lines, all appended (and flushed) as we go:
+ *
+ *   # Factor f          a factor saved in sfacs
+ *   # Down D N M Q      the step from N to Q about to be tried (D is 1 for
+ *                       n-1, -1 for n+1, else the discriminant)
+ *   Type ...            a step that has been proven, once everything below
+ *                       it is.  These come out bottom up.
+ *
+ * When the proof is done the file is a complete certificate.
+ *
+ * On a restart with the same N, the steps in the file are checked and any
+ * N with a proof is not searched again.  Otherwise the last Down seen for
+ * an N is tried first, which skips the factoring that found it.  The file
+ * is then rewritten with only the good parts (dropping a partly written
+ * end), and we carry on appending to it.
+ */
+
+typedef struct {
+  int    D;
+  mpz_t  N, m, q;
+} ckpt_down_t;
+
+static char*         _ckpt_path = 0;
+static FILE*         _ckpt_fh = 0;
+static ckpt_down_t*  _ckpt_downs = 0;
+static int           _ckpt_ndowns = 0;
+static cert_step_t*  _ckpt_steps = 0;
+static UV            _ckpt_nsteps = 0;
+static char*         _ckpt_state = 0;   /* 0 unknown, 1 proven, 2 not */
+
+void ecpp_set_checkpoint(const char* path)
+{
+  if (_ckpt_path != 0) Safefree(_ckpt_path);
+  _ckpt_path = 0;
+  if (path != 0) {
+    New(0, _ckpt_path, strlen(path)+1, char);
+    strcpy(_ckpt_path, path);
+  }
+}
+
+static void ckpt_write_factor(mpz_t f)
+{
+  if (_ckpt_fh == 0) return;
+  gmp_fprintf(_ckpt_fh, "# Factor %Zd\n", f);
+  fflush(_ckpt_fh);
+}
+
+static void ckpt_write_down(int D, mpz_t N, mpz_t m, mpz_t q)
+{
+  if (_ckpt_fh == 0) return;
+  gmp_fprintf(_ckpt_fh, "# Down %d %Zd %Zd %Zd\n", D, N, m, q);
+  fflush(_ckpt_fh);
+}
+
+static void ckpt_write_step(const char* text)
+{
+  if (_ckpt_fh == 0) return;
+  fprintf(_ckpt_fh, "%s\n", text);
+  fflush(_ckpt_fh);
+}
+
+/* The proof text for a step read back from the checkpoint. */
+static char* ckpt_step_text(cert_step_t* s, mpz_t t)
+{
+  int D = (s->type == CERT_STEP_BLS3) ? 1 : (s->type == CERT_STEP_BLS15) ? -1 : 0;
+  return proof_step_text(D, s->n, s->a, s->b, s->m, s->q, s->x, s->y,
+                         mpz_get_ui(s->a), mpz_get_si(s->lp), mpz_get_si(s->lq), t);
+}
+
+static char* ckpt_read_file(const char* path)
+{
+  FILE *fh;
+  char *text;
+  size_t len = 0, size = 65536, got;
+
+  fh = fopen(path, "r");
+  if (fh == NULL) return 0;
+  New(0, text, size, char);
+  while ((got = fread(text + len, 1, size - len - 1, fh)) > 0) {
+    len += got;
+    if (len + 1 >= size)  Renew(text, size *= 2, char);
+  }
+  text[len] = '\0';
+  fclose(fh);
+  return text;
+}
+
+/* Cut off anything written after the last complete line or step. */
+static void ckpt_trim(char* text)
+{
+  char *end = strrchr(text, '\n'), *blank = 0, *p;
+
+  if (end == 0) { text[0] = '\0';  return; }
+  end[1] = '\0';
+  for (p = strstr(text, "\n\n"); p != 0; p = strstr(p+1, "\n\n"))
+    blank = p+2;
+  if (blank == 0) return;
+  for (p = blank; *p != '\0'; p = strchr(p, '\n') + 1)
+    if (*p != '#')
+      { *blank = '\0';  return; }
+}
+
+static void ckpt_close(void)
+{
+  int j;
+  if (_ckpt_fh != 0) fclose(_ckpt_fh);
+  _ckpt_fh = 0;
+  for (j = 0; j < _ckpt_ndowns; j++) {
+    mpz_clear(_ckpt_downs[j].N);
+    mpz_clear(_ckpt_downs[j].m);
+    mpz_clear(_ckpt_downs[j].q);
+  }
+  if (_ckpt_downs != 0) Safefree(_ckpt_downs);
+  _ckpt_downs = 0;
+  _ckpt_ndowns = 0;
+  if (_ckpt_steps != 0) cert_steps_free(_ckpt_steps, _ckpt_nsteps);
+  if (_ckpt_state != 0) Safefree(_ckpt_state);
+  _ckpt_steps = 0;
+  _ckpt_nsteps = 0;
+  _ckpt_state = 0;
+}
+
+/* Load what we can from the checkpoint for N, rewrite it cleanly, and open
+ * it for adding to.  Saved factors are added to sfacs.  Returns 0, or the
+ * path if it could not be written (the caller croaks, after freeing). */
+static const char* ckpt_open(mpz_t N, mpz_t* sfacs, int* nsfacs)
+{
+  const char *path, *error;
+  char *text, *header, *line, *tmppath;
+  FILE *fh;
+  mpz_t t;
+  UV i;
+  int j, ok, verbose = get_verbose_level();
+
+  ckpt_close();
+  path = (_ckpt_path != 0) ? _ckpt_path : getenv("MPU_ECPP_CHECKPOINT");
+  if (path == 0 || *path == '\0') return 0;
+
+  New(0, header, 80 + mpz_sizeinbase(N, 10), char);
+  gmp_sprintf(header, "[MPU - Primality Certificate]\nVersion 1.0\n\nProof for:\nN %Zd\n\n", N);
+  text = ckpt_read_file(path);
+  if (text != 0 && strncmp(text, header, strlen(header)) == 0) {
+    ckpt_trim(text);
+    for (line = text; *line != '\0'; line = strchr(line, '\n') + 1) {
+      if (strncmp(line, "# Factor ", 9) == 0 && *nsfacs < MAX_SFACS) {
+        mpz_init(sfacs[*nsfacs]);
+        if (gmp_sscanf(line, "# Factor %Zd", sfacs[*nsfacs]) == 1)
+          nsfacs[0]++;
+        else
+          mpz_clear(sfacs[*nsfacs]);
+      } else if (strncmp(line, "# Down ", 7) == 0) {
+        ckpt_down_t *d;
+        if (_ckpt_ndowns % 64 == 0)
+          Renew(_ckpt_downs, _ckpt_ndowns + 64, ckpt_down_t);
+        d = _ckpt_downs + _ckpt_ndowns;
+        mpz_init(d->N);  mpz_init(d->m);  mpz_init(d->q);
+        if (gmp_sscanf(line, "# Down %d %Zd %Zd %Zd", &d->D, d->N, d->m, d->q) == 4)
+          _ckpt_ndowns++;
+        else
+          { mpz_clear(d->N);  mpz_clear(d->m);  mpz_clear(d->q); }
+      }
+    }
+    /* Only keep the steps that check out. */
+    set_verbose_level(0);
+    verify_certificate(text, strlen(text), &_ckpt_steps, &_ckpt_nsteps, &error);
+    set_verbose_level(verbose);
+    for (i = 0; i < _ckpt_nsteps; i++) {
+      cert_step_t *s = _ckpt_steps + i;
+      if (s->type != CERT_STEP_ECPP && s->type != CERT_STEP_BLS3 && s->type != CERT_STEP_BLS15)
+        s->result = 0;
+    }
+    Newz(0, _ckpt_state, _ckpt_nsteps+1, char);
+    if (verbose)
+      printf("ECPP checkpoint: resuming with %lu steps, %d choices, %d factors\n",
+             (unsigned long)_ckpt_nsteps, _ckpt_ndowns, *nsfacs);
+  }
+  if (text != 0) Safefree(text);
+
+  /* Write it again with what we kept, then append to it. */
+  New(0, tmppath, strlen(path) + 5, char);
+  sprintf(tmppath, "%s.tmp", path);
+  fh = fopen(tmppath, "w");
+  if (fh == NULL) {
+    Safefree(tmppath);  Safefree(header);
+    ckpt_close();
+    return path;
+  }
+  fputs(header, fh);
+  for (j = 0; j < *nsfacs; j++)
+    gmp_fprintf(fh, "# Factor %Zd\n", sfacs[j]);
+  for (j = 0; j < _ckpt_ndowns; j++)
+    gmp_fprintf(fh, "# Down %d %Zd %Zd %Zd\n", _ckpt_downs[j].D, _ckpt_downs[j].N, _ckpt_downs[j].m, _ckpt_downs[j].q);
+  mpz_init(t);
+  for (i = 0; i < _ckpt_nsteps; i++) {
+    if (_ckpt_steps[i].result) {
+      char *steptext = ckpt_step_text(_ckpt_steps + i, t);
+      fprintf(fh, "%s\n", steptext);
+      Safefree(steptext);
+    }
+  }
+  mpz_clear(t);
+  ok = (fclose(fh) == 0 && (rename(tmppath, path) == 0 ||
+                             (remove(path), rename(tmppath, path) == 0)));
+  Safefree(tmppath);
+  Safefree(header);
+  if (ok)
+    _ckpt_fh = fopen(path, "a");
+  if (_ckpt_fh == NULL) {
+    ckpt_close();
+    return path;
+  }
+  return 0;
+}
+
+/* The index of a good saved step for N whose Q values are all proven, or -1. */
+static IV ckpt_proven_step(mpz_t N)
+{
+  UV i;
+  for (i = 0; i < _ckpt_nsteps; i++) {
+    cert_step_t *s = _ckpt_steps + i;
+    if (!s->result || _ckpt_state[i] == 2 || mpz_cmp(s->n, N) != 0)
+      continue;
+    if (_ckpt_state[i] == 0) {
+      _ckpt_state[i] = 2;
+      if (mpz_sizeinbase(s->q, 2) <= 64 ? _GMP_is_prob_prime(s->q) == 2
+                                        : ckpt_proven_step(s->q) >= 0)
+        _ckpt_state[i] = 1;
+    }
+    if (_ckpt_state[i] == 1)
+      return i;
+  }
+  return -1;
+}
+
+/* If the checkpoint has a proof for N, add it to the proof text. */
+static int ckpt_restore(mpz_t N, char** prooftextptr)
+{
+  IV i;
+  int n = 0, j;
+  IV *chain;
+  mpz_t t;
+
+  if (_ckpt_nsteps == 0 || ckpt_proven_step(N) < 0)
+    return 0;
+  if (prooftextptr == 0)
+    return 1;
+  New(0, chain, _ckpt_nsteps, IV);
+  for (i = ckpt_proven_step(N); i >= 0; i = ckpt_proven_step(_ckpt_steps[i].q))
+    chain[n++] = i;
+  mpz_init(t);
+  for (j = n-1; j >= 0; j--)
+    prepend_text(prooftextptr, ckpt_step_text(_ckpt_steps + chain[j], t));
+  mpz_clear(t);
+  Safefree(chain);
+  return 1;
+}
+
+/* The last saved choice for N, or -1. */
+static int ckpt_find_down(mpz_t N)
+{
+  int j;
+  for (j = _ckpt_ndowns-1; j >= 0; j--)
+    if (mpz_cmp(_ckpt_downs[j].N, N) == 0)
+      return j;
+  return -1;
+}
+
+/* A step of the proof is done: add it to the proof text and checkpoint. */
+static void record_step(char** prooftextptr, int D, mpz_t Ni,
+                        mpz_t a, mpz_t b, mpz_t m, mpz_t q, mpz_t x, mpz_t y,
+                        UV nm1a, IV np1lp, IV np1lq, mpz_t t)
+{
+  ecpp_run_t *run = ecpp_run();
+  char *steptext;
+
+  run->stats.steps++;
+  run->stats.bits_removed += mpz_sizeinbase(Ni, 2) - mpz_sizeinbase(q, 2);
+  if (prooftextptr == 0 && _ckpt_fh == 0) return;
+  steptext = proof_step_text(D, Ni, a, b, m, q, x, y, nm1a, np1lp, np1lq, t);
+  ckpt_write_step(steptext);
+  if (prooftextptr != 0)  prepend_text(prooftextptr, steptext);
+  else                    Safefree(steptext);
+}
+
+/*********************  Threaded ECPP  *********************
+ *
+ * With more than one thread we do two things differently:
+ *
+ *  - In factoring stages 0 and 1, the m values for a run of discriminants
+ *    are factored at once on the worker pool.  The discriminants are still
+ *    walked in the usual order, so the chain is the same one the single
+ *    threaded code builds.  Those stages never add to sfacs, which keeps
+ *    the workers independent.  Later stages use ECM, whose state is global,
+ *    so they stay serial.
+ *
+ *  - The down-run records each step instead of finding its curve.  Once the
+ *    chain reaches the bottom, the curves for every step are found in
+ *    parallel and the proof text is put together.  If a curve can't be
+ *    found (a bad class poly, or a composite) the stage is run again with
+ *    the serial code, which knows how to back up.
+ */
+
+typedef struct {
+  int    dindex, degree;
+  mpz_t  m[6], q[6];
+} ecpp_cand_t;
+
+typedef struct {
+  ecpp_cand_t *cand;
+  int         *task;
+  mpz_ptr      minfactor;
+  mpz_t       *sfacs;
+  int          nsfacs, stage;
+} ecpp_batch_t;
+
+static void _factor_task(void *vctx, UV i)
+{
+  const ecpp_batch_t *b = (const ecpp_batch_t*) vctx;
+  ecpp_cand_t *c = b->cand + b->task[i] / 6;
+  int k = b->task[i] % 6, nsfacs = b->nsfacs;
+  mpz_t t;
+
+  mpz_init(t);
+  if (check_for_factor(c->q[k], c->m[k], b->minfactor, t, b->stage, b->sfacs, &nsfacs, c->degree) <= 0)
+    mpz_set_ui(c->q[k], 0);
+  mpz_clear(t);
+}
+
+/* Starting at dilist[dindex], walk the discriminants as ecpp_down would
+ * until there is enough factoring to keep the threads busy, then factor all
+ * the m values at once.  Returns the dilist position after the last one
+ * looked at. */
+static int fill_batch(ecpp_cand_t* cand, int* ncand, int maxcand, int* task,
+                      int* dilist, int dindex, mpz_t Ni, int stage, int maxH,
+                      mpz_t minfactor, mpz_t* sfacs, int nsfacs,
+                      mpz_t u, mpz_t v, mpz_t mD, mpz_t t, mpz_t t2)
+{
+  ecpp_batch_t b;
+  int k, ntasks = 0, nthreads = get_thread_count();
+
+  *ncand = 0;
+  for ( ; dilist[dindex] != 0 && *ncand < maxcand && ntasks < 2*nthreads; dindex++) {
+    int D, degree, pindex = dilist[dindex];
+    ecpp_cand_t *c;
+    if (pindex < 0) continue;
+    degree = poly_class_poly_num(pindex, &D, NULL, NULL);
+    if (degree == 0 || (degree > 16 && stage == 0) || (maxH > 0 && degree > maxH))
+      break;
+    mpz_set_si(mD, D);
+    if (mpz_jacobi(mD, Ni) != 1 || !modified_cornacchia(u, v, mD, Ni))
+      continue;
+    c = cand + (*ncand)++;
+    c->dindex = dindex;
+    c->degree = degree;
+    choose_m(c->m, D, u, v, Ni, t, t2);
+    for (k = 0; k < 6; k++) {
+      mpz_set_ui(c->q[k], 0);
+      if (mpz_sgn(c->m[k]))
+        task[ntasks++] = 6*(c - cand) + k;
+    }
+  }
+  b.cand = cand;  b.task = task;  b.minfactor = minfactor;
+  b.sfacs = sfacs;  b.nsfacs = nsfacs;  b.stage = stage;
+  parallel_for(ntasks, _factor_task, &b);
+  return dindex;
+}
 
+typedef struct {
+  int    D, pindex, dindex, result;
+  UV     nm1a;
+  IV     np1lp, np1lq;
+  mpz_t  N, a, b, m, q, x, y;
+} ecpp_step_t;
 
+typedef struct {
+  ecpp_step_t *steps;
+  int          n, nmax;
+} ecpp_chain_t;
+
+static ecpp_step_t* chain_push(ecpp_chain_t* chain, int D, mpz_t N, mpz_t q)
+{
+  ecpp_step_t *s;
+  if (chain->n >= chain->nmax) {
+    chain->nmax = (chain->nmax == 0) ? 64 : 2 * chain->nmax;
+    Renew(chain->steps, chain->nmax, ecpp_step_t);
+  }
+  s = chain->steps + chain->n++;
+  s->D = D;
+  s->result = 2;
+  mpz_init_set(s->N, N);  mpz_init_set(s->q, q);
+  mpz_init(s->a);  mpz_init(s->b);  mpz_init(s->m);
+  mpz_init(s->x);  mpz_init(s->y);
+  return s;
+}
+
+static void chain_truncate(ecpp_chain_t* chain, int n)
+{
+  while (chain->n > n) {
+    ecpp_step_t *s = chain->steps + --chain->n;
+    mpz_clear(s->N);  mpz_clear(s->q);
+    mpz_clear(s->a);  mpz_clear(s->b);  mpz_clear(s->m);
+    mpz_clear(s->x);  mpz_clear(s->y);
+  }
+}
+
+static void _curve_task(void *vctx, UV i)
+{
+  ecpp_step_t *s = ((ecpp_chain_t*) vctx)->steps + i;
+  if (s->D == 1 || s->D == -1)   /* BLS steps were done on the way down */
+    return;
+  /* Try with only one root, then 8 if that didn't work. */
+  s->result = find_curve(s->a, s->b, s->x, s->y, s->D, s->pindex, s->m, s->q, s->N, 1);
+  if (s->result == 1)
+    s->result = find_curve(s->a, s->b, s->x, s->y, s->D, s->pindex, s->m, s->q, s->N, 8);
+}
+
+/* Find the curves for a finished chain.  Returns 2 with the proof made, or
+ * -1 if some step failed and the stage has to be redone. */
+static int chain_curves(ecpp_chain_t* chain, int* dilist, char** prooftextptr)
+{
+  ecpp_run_t *run = ecpp_run();
+  int i, verbose = get_verbose_level();
+  mpz_t t;
+
+  double t0 = wall_seconds();
+
+  if (verbose) { printf("  finding curves for %d steps\n", chain->n); fflush(stdout); }
+  parallel_for(chain->n, _curve_task, chain);
+  run->stats.curve_seconds += wall_seconds() - t0;
+  for (i = 0; i < chain->n; i++) {
+    ecpp_step_t *s = chain->steps + i;
+    if (s->result != 2) {
+      if (s->result == 1) {
+        dilist[s->dindex] = -2;   /* skip this D value from now on */
+        run->stats.curve_fails++;
+      }
+      if (verbose)
+        gmp_printf("\n  Curve finding failed (%d) for D = %d with N = %Zd\n", s->result, s->D, s->N);
+      return -1;
+    }
+  }
+  /* The chain was recorded bottom up, the same order the text is built. */
+  mpz_init(t);
+  for (i = 0; i < chain->n; i++) {
+    ecpp_step_t *s = chain->steps + i;
+    record_step(prooftextptr, s->D, s->N, s->a, s->b, s->m, s->q, s->x, s->y, s->nm1a, s->np1lp, s->np1lq, t);
+  }
+  mpz_clear(t);
+  return 2;
+}
 
 
 /* This is the "factor all strategy" FAS version, which ends up being a lot
@@ -627,9 +1225,172 @@ static void choose_m(mpz_t* mlist, long D, mpz_t u, mpz_t v, mpz_t N,
     fflush(stdout); \
   }
 
+static int ecpp_down(int i, mpz_t Ni, int facstage, int *pmaxH, int* dilist, mpz_t* sfacs, int* nsfacs, char** prooftextptr, ecpp_chain_t* chain);
+
+/* The q values found at a level, waiting to be gone down with.  Without
+ * EAS each is tried as soon as it is found, smallest first for each D.
+ * With EAS they are collected over several discriminants and tried best
+ * score first. */
+typedef struct {
+  int    D, pindex, dindex, type, degree, order;
+  double score;
+  mpz_t  m, q;
+} ecpp_pick_t;
+
+typedef struct {
+  ecpp_pick_t *p;
+  int          n, nmax;
+} ecpp_picks_t;
+
+static void picks_add(ecpp_picks_t* pl, int D, int pindex, int dindex, int type, int degree, mpz_t Ni, mpz_t m, mpz_t q)
+{
+  ecpp_pick_t *p;
+  if (pl->n >= pl->nmax) {
+    int j, nmax = (pl->nmax == 0) ? 8 : 2 * pl->nmax;
+    Renew(pl->p, nmax, ecpp_pick_t);
+    for (j = pl->nmax; j < nmax; j++)
+      { mpz_init(pl->p[j].m);  mpz_init(pl->p[j].q); }
+    pl->nmax = nmax;
+  }
+  p = pl->p + pl->n;
+  p->D = D;  p->pindex = pindex;  p->dindex = dindex;
+  p->type = type;  p->degree = degree;  p->order = pl->n++;
+  p->score = (double)(mpz_sizeinbase(Ni, 2) - mpz_sizeinbase(q, 2))
+           - _policy.degree_bits * degree;
+  mpz_set(p->m, m);
+  mpz_set(p->q, q);
+}
+
+static void picks_free(ecpp_picks_t* pl)
+{
+  int j;
+  for (j = 0; j < pl->nmax; j++)
+    { mpz_clear(pl->p[j].m);  mpz_clear(pl->p[j].q); }
+  if (pl->p != 0) Safefree(pl->p);
+}
+
+/* Go down with each pick in turn until one works.  Returns 0 (composite),
+ * 2 (proven, with the curve in a,b,x,y and the pick in D,m,q, or pushed on
+ * the chain), or 1 with the picks all used up. */
+static int try_picks(ecpp_picks_t* pl, int i, mpz_t Ni, int facstage, int next_stage, int *pmaxH, int* dilist, mpz_t* sfacs, int* nsfacs, char** prooftextptr, ecpp_chain_t* chain,
+                     mpz_t a, mpz_t b, mpz_t x, mpz_t y, int* pD, mpz_t m, mpz_t q)
+{
+  ecpp_run_t *run = ecpp_run();
+  int j, k, downresult = 1, curveresult;
+  int verbose = get_verbose_level();
+  int nidigits = mpz_sizeinbase(Ni, 10);
+  double t0;
+
+  /* Best score first, keeping the order found for ties */
+  for (j = 1; j < pl->n; j++)
+    for (k = j; k > 0 && (pl->p[k].score > pl->p[k-1].score ||
+                          (pl->p[k].score == pl->p[k-1].score && pl->p[k].order < pl->p[k-1].order)); k--) {
+      ecpp_pick_t tp = pl->p[k];
+      pl->p[k] = pl->p[k-1];
+      pl->p[k-1] = tp;
+    }
+  if (pl->n > 1 && pl->p[0].order != 0)
+    run->stats.eas_reorders++;
+
+  for (j = 0; j < pl->n; j++) {
+    ecpp_pick_t *p = pl->p + j;
+    int maxH = *pmaxH;
+    int minH = (nidigits <= 240) ? 7 : (nidigits+39)/40;
+
+    *pD = p->D;
+    mpz_set(m, p->m);
+    mpz_set(q, p->q);
+    if (verbose)
+      { printf(" %d (%s %d)\n", p->D, poly_class_type_name(p->type), p->degree); fflush(stdout); }
+    if (maxH == 0) {
+      maxH = minH-1 + p->degree;
+      if (facstage > 1)              /* We worked hard to get here, */
+        maxH = 2*maxH + 10;          /* try hard to make use of it. */
+    } else if (maxH > minH && maxH > (p->degree+2)) {
+      maxH--;
+    }
+    /* Great, now go down. */
+    ckpt_write_down(p->D, Ni, m, q);
+    run->stats.downs++;
+    downresult = ecpp_down(i+1, q, next_stage, &maxH, dilist, sfacs, nsfacs, prooftextptr, chain);
+    /* Nothing found, look at more polys in the future */
+    if (downresult == 1 && *pmaxH > 0)  *pmaxH = maxH;
+
+    if (downresult == 0) break;   /* composite */
+    if (downresult == 1) {   /* nothing found at this stage */
+      run->stats.backtracks++;
+      VERBOSE_PRINT_N(i, nidigits, *pmaxH, facstage);
+      continue;
+    }
+
+    /* Awesome, we found the q chain and are in STAGE 2 */
+    if (verbose)
+      { printf("%*sN[%d] (%d dig) %d (%s %d)", i, "", i, nidigits, p->D, poly_class_type_name(p->type), p->degree); fflush(stdout); }
+
+    if (chain != 0) {   /* The curve is found later with the others */
+      ecpp_step_t *s = chain_push(chain, p->D, Ni, q);
+      s->pindex = p->pindex;  s->dindex = p->dindex;
+      mpz_set(s->m, m);
+      if (verbose) { printf("\n"); fflush(stdout); }
+      break;
+    }
+
+    /* Try with only one or two roots, then 8 if that didn't work. */
+    /* TODO: This should be done using a root iterator in find_curve() */
+    t0 = wall_seconds();
+    curveresult = find_curve(a, b, x, y, p->D, p->pindex, m, q, Ni, 1);
+    if (curveresult == 1) {
+      if (verbose) { printf(" [redo roots]"); fflush(stdout); }
+      curveresult = find_curve(a, b, x, y, p->D, p->pindex, m, q, Ni, 8);
+    }
+    run->stats.curve_seconds += wall_seconds() - t0;
+    if (verbose) { printf("  %d\n", curveresult); fflush(stdout); }
+    if (curveresult == 1) {
+      /* Something is wrong.  Very likely the class poly coefficients are
+         incorrect.  We've wasted lots of time, and need to try again. */
+      dilist[p->dindex] = -2; /* skip this D value from now on */
+      if (verbose) gmp_printf("\n  Invalidated D = %d with N = %Zd\n", p->D, Ni);
+      run->stats.curve_fails++;
+      downresult = 1;
+      continue;
+    }
+    /* We found it was composite or proved it */
+    downresult = curveresult;
+    break;
+  }
+  pl->n = 0;
+  return downresult;
+}
+
 /* Recursive routine to prove via ECPP */
-static int ecpp_down(int i, mpz_t Ni, int facstage, int *pmaxH, int* dilist, mpz_t* sfacs, int* nsfacs, char** prooftextptr)
+/* Most of N-1 (or N+1, if we need no certificate) is factored, so see if
+ * BLS75 can finish N here rather than going down another level.  Its steps
+ * go in the proof text and checkpoint like ours. */
+static int bls_step(mpz_t Ni, int nm1, char** prooftextptr)
+{
+  ecpp_run_t *run = ecpp_run();
+  char *text = 0;
+  int result, cert = (prooftextptr != 0 || _ckpt_fh != 0);
+
+  if (cert && !nm1) return 1;   /* No N+1 certificates */
+  result = cert ? BLS_primality_nm1(Ni, 1, &text) : BLS_primality(Ni, 1, 0);
+  if (result == 2) {
+    run->stats.steps++;
+    run->stats.bls_steps++;
+    if (text != 0) {
+      ckpt_write_step(text);
+      if (prooftextptr != 0)  prepend_text(prooftextptr, text);
+      else                    Safefree(text);
+    }
+  } else if (text != 0) {
+    Safefree(text);
+  }
+  return result;
+}
+
+static int ecpp_down(int i, mpz_t Ni, int facstage, int *pmaxH, int* dilist, mpz_t* sfacs, int* nsfacs, char** prooftextptr, ecpp_chain_t* chain)
 {
+  ecpp_run_t *run = ecpp_run();
   mpz_t a, b, u, v, m, q, minfactor, sqrtn, mD, t, t2;
   mpz_t mlist[6];
   mpz_t qlist[6];
@@ -638,6 +1399,12 @@ static int ecpp_down(int i, mpz_t Ni, int facstage, int *pmaxH, int* dilist, mpz
   struct ec_affine_point P;
   int k, dindex, pindex, nidigits, facresult, curveresult, downresult, stage, D;
   int verbose = get_verbose_level();
+  ecpp_cand_t* cand = 0;
+  int* task = 0;
+  int ncand = 0, maxcand = 0, ci = 0, bend = 0, clen = 0;
+  int ri = -1, rdindex = -1, eas, bls_tried = 0, bls_done = 0;
+  ecpp_picks_t picks = {0, 0, 0};
+  double t0, spent, budget;
 
   nidigits = mpz_sizeinbase(Ni, 10);
 
@@ -655,8 +1422,17 @@ static int ecpp_down(int i, mpz_t Ni, int facstage, int *pmaxH, int* dilist, mpz
     gmp_printf("\n\n**** BPSW counter-example found?  ****\n**** N = %Zd ****\n\n", Ni);
     return 0;
   }
+  if (_ckpt_fh != 0 && ckpt_restore(Ni, prooftextptr)) {
+    if (verbose) printf("%*sN[%d] (%d dig)  PRIME (checkpoint)\n", i, "", i, nidigits);
+    return 2;
+  }
 
   VERBOSE_PRINT_N(i, nidigits, *pmaxH, facstage);
+  run->stats.levels++;
+  /* Look at several discriminants before going down while N is large */
+  eas = (nidigits >= ECPP_EAS_DIGITS) ? _policy.eas : 0;
+  /* Only the first pass is limited, the later ones are the fallback */
+  budget = (facstage == 1) ? _policy.step_seconds : 0;
 
   mpz_init(a);  mpz_init(b);
   mpz_init(u);  mpz_init(v);
@@ -676,28 +1452,70 @@ static int ecpp_down(int i, mpz_t Ni, int facstage, int *pmaxH, int* dilist, mpz
   mpz_mul(minfactor, minfactor, minfactor);
   mpz_sqrt(sqrtn, Ni);
 
+  /* Resuming from a checkpoint: go straight to the choice made last time. */
+  if (_ckpt_fh != 0 && (ri = ckpt_find_down(Ni)) >= 0) {
+    int rD = _ckpt_downs[ri].D;
+    if (rD != 1 && rD != -1) {
+      for (rdindex = 0; dilist[rdindex] != 0; rdindex++)
+        if (dilist[rdindex] > 0 && poly_class_poly_num(dilist[rdindex], &D, NULL, NULL) > 0 && D == rD)
+          break;
+      if (dilist[rdindex] == 0)  ri = -1;
+    }
+  }
+
   stage = 0;
   if (nidigits > 700) stage = 1;  /* Too rare to find them */
   if (i == 0 && facstage > 1)  stage = facstage;
   for ( ; stage <= facstage; stage++) {
     int next_stage = (stage > 1) ? stage : 1;
+    int pstage = (stage <= 1 && get_thread_count() > 1 && !IN_BATCH(run));
+    bend = ncand = 0;
+    spent = 0;
     for (dindex = -1; dindex < 0 || dilist[dindex] != 0; dindex++) {
       int poly_type;  /* just for debugging/verbose */
       int poly_degree;
       int allq = (nidigits < 400);  /* Do all q values together, or not */
+      int resume = -1;              /* Index of the saved choice to use */
 
       if (dindex == -1) {   /* n-1 and n+1 tests */
         int nm1_success = 0;
         int np1_success = 0;
         const char* ptype = "";
-        mpz_sub_ui(m, Ni, 1);
-        mpz_sub_ui(t2, sqrtn, 1);
-        mpz_tdiv_q_2exp(t2, t2, 1);    /* t2 = minfactor */
-        nm1_success = check_for_factor(u, m, t2, t, stage, sfacs, nsfacs, 0);
-        mpz_add_ui(m, Ni, 1);
-        mpz_add_ui(t2, sqrtn, 1);
-        mpz_tdiv_q_2exp(t2, t2, 1);    /* t2 = minfactor */
-        np1_success = check_for_factor(v, m, t2, t, stage, sfacs, nsfacs, 0);
+        if (ri >= 0) {   /* The BLS checks below make sure this Q is good */
+          if (rdindex >= 0)  continue;
+          D = _ckpt_downs[ri].D;
+          mpz_set(u, _ckpt_downs[ri].q);
+          mpz_set(v, _ckpt_downs[ri].q);
+          nm1_success = (D == 1);
+          np1_success = (D == -1);
+          ri = -1;
+        } else {
+          /* BLS75 already took out what it could of the top N-1 and N+1 */
+          int top = (i == 0 && run->part != 0);
+          t0 = wall_seconds();
+          mpz_sub_ui(m, Ni, 1);
+          if (top)  mpz_set(m, run->part->r1);
+          mpz_sub_ui(t2, sqrtn, 1);
+          mpz_tdiv_q_2exp(t2, t2, 1);    /* t2 = minfactor */
+          nm1_success = check_for_factor(u, m, t2, t, stage, sfacs, nsfacs, 0);
+          mpz_add_ui(m, Ni, 1);
+          if (top && mpz_sgn(run->part->r2) > 0)  mpz_set(m, run->part->r2);
+          mpz_add_ui(t2, sqrtn, 1);
+          mpz_tdiv_q_2exp(t2, t2, 1);    /* t2 = minfactor */
+          np1_success = check_for_factor(v, m, t2, t, stage, sfacs, nsfacs, 0);
+          FACTOR_TIME(run, t0, spent);
+          run->stats.mvalues += 2;
+          /* A 0 means all but a small part was factored.  Try BLS75 once. */
+          if (!top && !bls_tried && (nm1_success == 0 || np1_success == 0)) {
+            bls_tried = 1;
+            downresult = bls_step(Ni, nm1_success == 0, prooftextptr);
+            if (downresult != 1) {
+              bls_done = (downresult == 2);
+              if (verbose && bls_done) { printf(" BLS75\n"); fflush(stdout); }
+              goto end_down;
+            }
+          }
+        }
         /* If both successful, pick smallest */
         if (nm1_success > 0 && np1_success > 0) {
           if (mpz_cmp(u, v) <= 0) np1_success = 0;
@@ -707,9 +1525,16 @@ static int ecpp_down(int i, mpz_t Ni, int facstage, int *pmaxH, int* dilist, mpz
         else if (np1_success > 0) {  ptype = "n+1";  mpz_set(q, v);  D = -1; }
         else                      continue;
         if (verbose) { printf(" %s\n", ptype); fflush(stdout); }
-        downresult = ecpp_down(i+1, q, next_stage, pmaxH, dilist, sfacs, nsfacs, prooftextptr);
+        if (chain != 0) clen = chain->n;
+        if (_ckpt_fh != 0) {
+          if (D == 1) mpz_sub_ui(m, Ni, 1);  else  mpz_add_ui(m, Ni, 1);
+          ckpt_write_down(D, Ni, m, q);
+        }
+        run->stats.downs++;
+        downresult = ecpp_down(i+1, q, next_stage, pmaxH, dilist, sfacs, nsfacs, prooftextptr, chain);
         if (downresult == 0) goto end_down;   /* composite */
         if (downresult == 1) {   /* nothing found at this stage */
+          run->stats.backtracks++;
           VERBOSE_PRINT_N(i, nidigits, *pmaxH, facstage);
           continue;
         }
@@ -722,56 +1547,128 @@ static int ecpp_down(int i, mpz_t Ni, int facstage, int *pmaxH, int* dilist, mpz
         if ( ! curveresult ) { /* This ought not happen */
           if (verbose)
             gmp_printf("\n  Could not prove %s with N = %Zd\n", ptype, Ni);
+          if (chain != 0) chain_truncate(chain, clen);
           downresult = 1;
           continue;
         }
+        if (chain != 0) {
+          ecpp_step_t *s = chain_push(chain, D, Ni, q);
+          s->nm1a = nm1a;  s->np1lp = np1lp;  s->np1lq = np1lq;
+        }
         goto end_down;
       }
 
       pindex = dilist[dindex];
       if (pindex < 0) continue;  /* We marked this for skip */
+      if (ri >= 0) {
+        if (dindex != rdindex) continue;
+        resume = ri;
+        ri = -1;
+      }
       /* Get the values for D, degree, and poly type */
       poly_degree = poly_class_poly_num(pindex, &D, NULL, &poly_type);
-      if (poly_degree == 0)
-        croak("Unknown value in dilist[%d]: %d\n", dindex, pindex);
-
-      if ( (-D % 4) != 3 && (-D % 16) != 4 && (-D % 16) != 8 )
-        croak("Invalid discriminant '%d' in list\n", D);
+      /* A bad entry means a bad table or database.  Skip it rather than
+       * croak, as this may be on a worker thread; if nothing else works
+       * the caller sees 1 (probable prime). */
+      if (poly_degree == 0) {
+        if (verbose) printf(" [bad dilist[%d]: %d]", dindex, pindex);
+        continue;
+      }
+      if ( (-D % 4) != 3 && (-D % 16) != 4 && (-D % 16) != 8 ) {
+        if (verbose) printf(" [invalid D %d]", D);
+        continue;
+      }
       /* D must also be squarefree in odd divisors, but assume it. */
       /* Make sure we can get a class polynomial for this D. */
-      if (poly_degree > 16 && stage == 0) {
+      if (poly_degree > 16 && stage == 0 && resume < 0) {
         if (verbose) printf(" [1]");
         break;
       }
       /* Make the continue-search vs. backtrack decision */
-      if (*pmaxH > 0 && poly_degree > *pmaxH)  break;
-      mpz_set_si(mD, D);
-      /* (D/N) must be 1, and we have to have a u,v solution */
-      if (mpz_jacobi(mD, Ni) != 1)
-        continue;
-      if ( ! modified_cornacchia(u, v, mD, Ni) )
-        continue;
-
-      if (verbose > 1)
-        { printf(" %d", D); fflush(stdout); }
-
+      if (*pmaxH > 0 && poly_degree > *pmaxH && resume < 0)  break;
+      /* Out of time for this level at this stage: back up and let the level
+       * above try another q.  The top level has nothing to back up to. */
+      if (i > 0 && budget > 0 && spent > budget && resume < 0) {
+        if (verbose) printf(" [time]");
+        run->stats.budget_stops++;
+        break;
+      }
       /* We're going to factor all the values for this discriminant then pick
        * the smallest.  This adds a little time, but it means we go down
        * faster.  This makes smaller proofs, and might even save time. */
 
-      choose_m(mlist, D, u, v, Ni, t, t2);
-      if (allq) {
-        int x, y;
-        /* We have 0 to 6 m values.  Try to factor them, put in qlist. */
+      if (pstage && resume < 0) {
+        /* Take this D from the batch, factoring the next batch if needed */
+        if (dindex >= bend) {
+          if (cand == 0) {
+            maxcand = 2*get_thread_count() + 8;
+            New(0, cand, maxcand, ecpp_cand_t);
+            New(0, task, 6*maxcand, int);
+            for (ci = 0; ci < maxcand; ci++)
+              for (k = 0; k < 6; k++)
+                { mpz_init(cand[ci].m[k]);  mpz_init(cand[ci].q[k]); }
+          }
+          t0 = wall_seconds();
+          bend = fill_batch(cand, &ncand, maxcand, task, dilist, dindex, Ni, stage, *pmaxH, minfactor, sfacs, *nsfacs, u, v, mD, t, t2);
+          FACTOR_TIME(run, t0, spent);
+          for (ci = 0; ci < ncand; ci++)
+            for (k = 0; k < 6; k++)
+              if (mpz_sgn(cand[ci].m[k]))
+                run->stats.mvalues++;
+          run->stats.discs += ncand;
+          ci = 0;
+        }
+        while (ci < ncand && cand[ci].dindex < dindex)  ci++;
+        if (ci >= ncand || cand[ci].dindex != dindex)
+          continue;
         for (k = 0; k < 6; k++) {
-          mpz_set_ui(qlist[k], 0);
-          if (mpz_sgn(mlist[k])) {
-            facresult = check_for_factor(qlist[k], mlist[k], minfactor, t, stage, sfacs, nsfacs, poly_degree);
-            /* -1 = couldn't find, 0 = no big factors, 1 = found */
-            if (facresult <= 0)
-              mpz_set_ui(qlist[k], 0);
+          mpz_swap(mlist[k], cand[ci].m[k]);
+          mpz_swap(qlist[k], cand[ci].q[k]);
+        }
+        allq = 1;
+      } else {
+        mpz_set_si(mD, D);
+        /* (D/N) must be 1, and we have to have a u,v solution */
+        if (mpz_jacobi(mD, Ni) != 1)
+          continue;
+        if ( ! modified_cornacchia(u, v, mD, Ni) )
+          continue;
+
+        choose_m(mlist, D, u, v, Ni, t, t2);
+        run->stats.discs++;
+        if (eas > 1)  allq = 1;
+        if (resume >= 0) {
+          /* Use the saved q, if it still looks right for one of the m */
+          ckpt_down_t *d = _ckpt_downs + resume;
+          for (k = 0; k < 6; k++) {
+            mpz_set_ui(qlist[k], 0);
+            if (mpz_sgn(mlist[k]) && mpz_cmp(mlist[k], d->m) == 0 &&
+                mpz_cmp(d->q, minfactor) > 0 && mpz_divisible_p(d->m, d->q))
+              mpz_set(qlist[k], d->q);
+          }
+          allq = 1;
+        } else if (allq) {
+          /* We have 0 to 6 m values.  Try to factor them, put in qlist. */
+          t0 = wall_seconds();
+          for (k = 0; k < 6; k++) {
+            mpz_set_ui(qlist[k], 0);
+            if (mpz_sgn(mlist[k])) {
+              facresult = check_for_factor(qlist[k], mlist[k], minfactor, t, stage, sfacs, nsfacs, poly_degree);
+              run->stats.mvalues++;
+              /* -1 = couldn't find, 0 = no big factors, 1 = found */
+              if (facresult <= 0)
+                mpz_set_ui(qlist[k], 0);
+            }
           }
+          FACTOR_TIME(run, t0, spent);
         }
+      }
+
+      if (verbose > 1)
+        { printf(" %d", D); fflush(stdout); }
+
+      if (allq) {
+        int x, y;
         /* Sort any q values by size, so we work on the smallest first */
         for (x = 0; x < 5; x++)
           if (mpz_sgn(qlist[x]))
@@ -782,11 +1679,9 @@ static int ecpp_down(int i, mpz_t Ni, int facstage, int *pmaxH, int* dilist, mpz
               }
       }
       /* Try to make a proof with the first (smallest) q value.
-       * Repeat for others if we have to. */
+       * Repeat for others if we have to.  With EAS, hold on to them until
+       * we have enough to choose from. */
       for (k = 0; k < 6; k++) {
-        int maxH = *pmaxH;
-        int minH = (nidigits <= 240) ? 7 : (nidigits+39)/40;
-
         if (allq) {
           if (mpz_sgn(qlist[k]) == 0) continue;
           mpz_set(m, mlist[k]);
@@ -794,57 +1689,32 @@ static int ecpp_down(int i, mpz_t Ni, int facstage, int *pmaxH, int* dilist, mpz
         } else {
           if (mpz_sgn(mlist[k]) == 0) continue;
           mpz_set(m, mlist[k]);
+          t0 = wall_seconds();
           facresult = check_for_factor(q, m, minfactor, t, stage, sfacs, nsfacs, poly_degree);
+          FACTOR_TIME(run, t0, spent);
+          run->stats.mvalues++;
           if (facresult <= 0) continue;
         }
-
-        if (verbose)
-          { printf(" %d (%s %d)\n", D, poly_class_type_name(poly_type), poly_degree); fflush(stdout); }
-        if (maxH == 0) {
-          maxH = minH-1 + poly_degree;
-          if (facstage > 1)              /* We worked hard to get here, */
-            maxH = 2*maxH + 10;          /* try hard to make use of it. */
-        } else if (maxH > minH && maxH > (poly_degree+2)) {
-          maxH--;
-        }
-        /* Great, now go down. */
-        downresult = ecpp_down(i+1, q, next_stage, &maxH, dilist, sfacs, nsfacs, prooftextptr);
-        /* Nothing found, look at more polys in the future */
-        if (downresult == 1 && *pmaxH > 0)  *pmaxH = maxH;
-
-        if (downresult == 0) goto end_down;   /* composite */
-        if (downresult == 1) {   /* nothing found at this stage */
-          VERBOSE_PRINT_N(i, nidigits, *pmaxH, facstage);
+        run->stats.candidates++;
+        picks_add(&picks, D, pindex, dindex, poly_type, poly_degree, Ni, m, q);
+        if (eas > 1 && resume < 0 && picks.n < eas)
           continue;
-        }
-
-        /* Awesome, we found the q chain and are in STAGE 2 */
-        if (verbose)
-          { printf("%*sN[%d] (%d dig) %d (%s %d)", i, "", i, nidigits, D, poly_class_type_name(poly_type), poly_degree); fflush(stdout); }
-
-        /* Try with only one or two roots, then 8 if that didn't work. */
-        /* TODO: This should be done using a root iterator in find_curve() */
-        curveresult = find_curve(a, b, P.x, P.y, D, pindex, m, q, Ni, 1);
-        if (curveresult == 1) {
-          if (verbose) { printf(" [redo roots]"); fflush(stdout); }
-          curveresult = find_curve(a, b, P.x, P.y, D, pindex, m, q, Ni, 8);
-        }
-        if (verbose) { printf("  %d\n", curveresult); fflush(stdout); }
-        if (curveresult == 1) {
-          /* Something is wrong.  Very likely the class poly coefficients are
-             incorrect.  We've wasted lots of time, and need to try again. */
-          dilist[dindex] = -2; /* skip this D value from now on */
-          if (verbose) gmp_printf("\n  Invalidated D = %d with N = %Zd\n", D, Ni);
-          downresult = 1;
-          continue;
-        }
-        /* We found it was composite or proved it */
-        goto end_down;
+        downresult = try_picks(&picks, i, Ni, facstage, next_stage, pmaxH, dilist, sfacs, nsfacs, prooftextptr, chain, a, b, P.x, P.y, &D, m, q);
+        if (downresult != 1) goto end_down;
       } /* k loop for D */
     } /* D */
+    /* Go down with any EAS picks left when we ran out of discriminants */
+    if (picks.n > 0) {
+      downresult = try_picks(&picks, i, Ni, facstage, next_stage, pmaxH, dilist, sfacs, nsfacs, prooftextptr, chain, a, b, P.x, P.y, &D, m, q);
+      if (downresult != 1) goto end_down;
+    }
   } /* fac stage */
-  /* Nothing at this level */
-  if (downresult != 1) croak("ECPP internal error: downresult is %d at end\n", downresult);
+  /* Nothing at this level.  Every other result jumps to end_down, so
+   * anything else is a bug; report it as unproven. */
+  if (downresult != 1) {
+    if (verbose) printf(" [downresult %d at end]", downresult);
+    downresult = 1;
+  }
   if (verbose) {
     if (*pmaxH > 0) printf(" (max %d)", *pmaxH);
     printf(" ---\n");
@@ -868,39 +1738,8 @@ end_down:
       fflush(stdout);
     }
     /* Prepend our proof to anything that exists. */
-    if (prooftextptr != 0) {
-      char *proofstr, *proofptr;
-      int curprooflen = (*prooftextptr == 0) ? 0 : strlen(*prooftextptr);
-
-      if (D == 1) {
-        int myprooflen = 20 + 2*(4 + mpz_sizeinbase(Ni, 10)) + 1*21;
-        New(0, proofstr, myprooflen + curprooflen + 1, char);
-        proofptr = proofstr;
-        proofptr += gmp_sprintf(proofptr, "Type BLS3\nN  %Zd\nQ  %Zd\n", Ni,q);
-        proofptr += sprintf(proofptr, "A  %"UVuf"\n", nm1a);
-      } else if (D == -1) {
-        int myprooflen = 20 + 2*(4 + mpz_sizeinbase(Ni, 10)) + 2*21;
-        New(0, proofstr, myprooflen + curprooflen + 1, char);
-        proofptr = proofstr;
-        /* It seems some testers have a sprintf bug with IVs.  Try to handle. */
-        proofptr += gmp_sprintf(proofptr, "Type BLS15\nN  %Zd\nQ  %Zd\n", Ni,q);
-        proofptr += sprintf(proofptr, "LP %d\nLQ %d\n", (int)np1lp, (int)np1lq);
-      } else {
-        int myprooflen = 20 + 7*(4 + mpz_sizeinbase(Ni, 10)) + 0;
-        New(0, proofstr, myprooflen + curprooflen + 1, char);
-        proofptr = proofstr;
-        mpz_sub_ui(t, Ni, 1);
-        if (mpz_cmp(a, t) == 0)  mpz_set_si(a, -1);
-        if (mpz_cmp(b, t) == 0)  mpz_set_si(b, -1);
-        proofptr += gmp_sprintf(proofptr, "Type ECPP\nN  %Zd\nA  %Zd\nB  %Zd\nM  %Zd\nQ  %Zd\nX  %Zd\nY  %Zd\n", Ni, a, b, m, q, P.x, P.y);
-      }
-      if (*prooftextptr) {
-        proofptr += gmp_sprintf(proofptr, "\n");
-        strcat(proofptr, *prooftextptr);
-        Safefree(*prooftextptr);
-      }
-      *prooftextptr = proofstr;
-    }
+    if (chain == 0 && !bls_done)
+      record_step(prooftextptr, D, Ni, a, b, m, q, P.x, P.y, nm1a, np1lp, np1lq, t);
   }
 
   /* Ni passed BPSW, so it's highly unlikely to be composite */
@@ -923,6 +1762,14 @@ end_down:
     mpz_clear(mlist[k]);
     mpz_clear(qlist[k]);
   }
+  picks_free(&picks);
+  if (cand != 0) {
+    for (ci = 0; ci < maxcand; ci++)
+      for (k = 0; k < 6; k++)
+        { mpz_clear(cand[ci].m[k]);  mpz_clear(cand[ci].q[k]); }
+    Safefree(cand);
+    Safefree(task);
+  }
 
   return downresult;
 }
@@ -930,10 +1777,19 @@ end_down:
 /* returns 2 if N is proven prime, 1 if probably prime, 0 if composite */
 int _GMP_ecpp(mpz_t N, char** prooftextptr)
 {
+  return _GMP_ecpp_partial(N, prooftextptr, 0);
+}
+
+int _GMP_ecpp_partial(mpz_t N, char** prooftextptr, bls_partial_t* part)
+{
+  ecpp_run_t *run = ecpp_run();
   int* dilist;
   mpz_t* sfacs;
-  int i, fstage, result, nsfacs;
+  int i, fstage, result, nsfacs, *pnsfacs;
+  ecpp_chain_t chain = {0, 0, 0};
+  const char* ckpath;
   UV nsize = mpz_sizeinbase(N,2);
+  double t0;
 
   /* We must check gcd(N,6), let's check 2*3*5*7*11*13*17*19*23. */
   if (nsize <= 64 || mpz_gcd_ui(NULL, N, 223092870UL) != 1) {
@@ -942,31 +1798,206 @@ int _GMP_ecpp(mpz_t N, char** prooftextptr)
   }
 
   init_ecpp_gcds( nsize );
+  memset(&run->stats, 0, sizeof(run->stats));
+  t0 = wall_seconds();
 
   if (prooftextptr)
     *prooftextptr = 0;
 
-  New(0, sfacs, MAX_SFACS, mpz_t);
-  dilist = poly_class_nums();
-  nsfacs = 0;
+  if (IN_BATCH(run)) {   /* Our own copy, as we mark bad ones */
+    for (i = 0; run->dilist[i] != 0; i++)
+      ;
+    New(0, dilist, i+1, int);
+    memcpy(dilist, run->dilist, (i+1) * sizeof(int));
+    sfacs = run->sfacs;
+    pnsfacs = run->nsfacs;
+  } else {
+    New(0, sfacs, MAX_SFACS, mpz_t);
+    dilist = poly_class_nums(nsize > ECPP_GEN_POLY_BITS);
+    nsfacs = 0;
+    pnsfacs = &nsfacs;
+    if ((ckpath = ckpt_open(N, sfacs, pnsfacs)) != 0) {
+      for (i = 0; i < nsfacs; i++)
+        mpz_clear(sfacs[i]);
+      Safefree(sfacs);
+      Safefree(dilist);
+      croak("ECPP: cannot write checkpoint %s", ckpath);
+    }
+  }
+  run->part = (part != 0 && mpz_cmp(part->n, N) == 0) ? part : 0;
   result = 1;
   for (fstage = 1; fstage < 20; fstage++) {
     int maxH = 0;
     if (fstage == 3 && get_verbose_level())
       gmp_printf("Working hard on: %Zd\n", N);
-    result = ecpp_down(0, N, fstage, &maxH, dilist, sfacs, &nsfacs, prooftextptr);
+    if (get_thread_count() > 1 && !IN_BATCH(run)) {
+      result = ecpp_down(0, N, fstage, &maxH, dilist, sfacs, pnsfacs, prooftextptr, &chain);
+      if (result == 2)
+        result = chain_curves(&chain, dilist, prooftextptr);
+      chain_truncate(&chain, 0);
+      if (result == -1) {   /* Redo this stage the careful way */
+        if (prooftextptr != 0 && *prooftextptr != 0) {  /* From a checkpoint */
+          Safefree(*prooftextptr);
+          *prooftextptr = 0;
+        }
+        maxH = 0;
+        result = ecpp_down(0, N, fstage, &maxH, dilist, sfacs, pnsfacs, prooftextptr, 0);
+      }
+    } else {
+      result = ecpp_down(0, N, fstage, &maxH, dilist, sfacs, pnsfacs, prooftextptr, 0);
+    }
     if (result != 1)
       break;
   }
+  run->stats.fstage = (fstage < 20) ? fstage : 19;
+  run->stats.total_seconds = wall_seconds() - t0;
+  if (get_verbose_level()) {
+    printf("ECPP: %lu steps removing %lu bits, %lu levels searched, factor stage %d\n",
+           (unsigned long)run->stats.steps, (unsigned long)run->stats.bits_removed,
+           (unsigned long)run->stats.levels, run->stats.fstage);
+    if (run->stats.bls_steps > 0)
+      printf("ECPP: %lu steps finished with BLS75\n", (unsigned long)run->stats.bls_steps);
+    printf("ECPP: %lu discriminants, %lu m values factored, %lu q found, %lu downs, %lu backtracks\n",
+           (unsigned long)run->stats.discs, (unsigned long)run->stats.mvalues,
+           (unsigned long)run->stats.candidates, (unsigned long)run->stats.downs,
+           (unsigned long)run->stats.backtracks);
+    printf("ECPP: %lu EAS reorders, %lu out of time, %lu curve failures\n",
+           (unsigned long)run->stats.eas_reorders, (unsigned long)run->stats.budget_stops,
+           (unsigned long)run->stats.curve_fails);
+    printf("ECPP: %.3fs factoring, %.3fs curves, %.3fs total\n",
+           run->stats.factor_seconds, run->stats.curve_seconds, run->stats.total_seconds);
+  }
+  if (chain.steps != 0) Safefree(chain.steps);
+  run->part = 0;
   Safefree(dilist);
-  for (i = 0; i < nsfacs; i++)
-    mpz_clear(sfacs[i]);
-  Safefree(sfacs);
+  if (!IN_BATCH(run)) {
+    ckpt_close();
+    for (i = 0; i < nsfacs; i++)
+      mpz_clear(sfacs[i]);
+    Safefree(sfacs);
+  }
 
   return result;
 }
 
 
+/* A batch of proofs, run by parallel_queue. */
+typedef struct {
+  mpz_t          *N;
+  int            *results;
+  char          **certs;
+  int            *dilist[2];   /* The discriminants for small and large N */
+  mpz_t          *sfacs;
+  int             nsfacs;
+  ecpp_stats_t    totals;
+  ecpp_batch_fn_t done;
+  void           *ctx;
+} ecpp_prove_batch_t;
+
+static void stats_add(ecpp_stats_t* t, const ecpp_stats_t* s)
+{
+  t->levels += s->levels;            t->discs += s->discs;
+  t->mvalues += s->mvalues;          t->candidates += s->candidates;
+  t->downs += s->downs;              t->backtracks += s->backtracks;
+  t->eas_reorders += s->eas_reorders;
+  t->budget_stops += s->budget_stops;
+  t->curve_fails += s->curve_fails;  t->steps += s->steps;
+  t->bls_steps += s->bls_steps;      t->bits_removed += s->bits_removed;
+  if (s->fstage > t->fstage)  t->fstage = s->fstage;
+  t->factor_seconds += s->factor_seconds;
+  t->curve_seconds += s->curve_seconds;
+  t->total_seconds += s->total_seconds;
+}
+
+static void _prove_task(void *vctx, UV i)
+{
+  ecpp_prove_batch_t *b = (ecpp_prove_batch_t*) vctx;
+  ecpp_run_t run;
+  int big = (mpz_sizeinbase(b->N[i], 2) > ECPP_GEN_POLY_BITS);
+
+  memset(&run, 0, sizeof(run));
+  run.dilist = b->dilist[big];
+  run.sfacs = b->sfacs;
+  run.nsfacs = &b->nsfacs;
+#ifdef USE_PTHREADS
+  if (_runkey_ok && pthread_setspecific(_runkey, &run) == 0) {
+    b->results[i] = _GMP_is_provable_prime(b->N[i], &b->certs[i]);
+    pthread_setspecific(_runkey, 0);
+  } else
+#endif
+  {   /* Without the key the batch is run serially, so _run is ours */
+    _run.dilist = run.dilist;
+    _run.sfacs = run.sfacs;
+    _run.nsfacs = run.nsfacs;
+    b->results[i] = _GMP_is_provable_prime(b->N[i], &b->certs[i]);
+    run.stats = _run.stats;
+    _run.dilist = 0;
+  }
+  parallel_lock();
+  stats_add(&b->totals, &run.stats);
+  parallel_unlock();
+}
+
+static int _prove_done(void *vctx, UV i)
+{
+  ecpp_prove_batch_t *b = (ecpp_prove_batch_t*) vctx;
+  int stop = b->done(b->ctx, i, b->results[i], b->certs[i]);
+  if (b->certs[i] != 0) { Safefree(b->certs[i]); b->certs[i] = 0; }
+  return stop;
+}
+
+void ecpp_prove_batch(mpz_t* N, UV n, ecpp_batch_fn_t done, void* ctx)
+{
+  ecpp_prove_batch_t b;
+  UV i, nsize = 0;
+  int big = 0;
+
+  if (n == 0) return;
+  for (i = 0; i < n; i++)
+    if (mpz_sizeinbase(N[i], 2) > nsize)
+      nsize = mpz_sizeinbase(N[i], 2);
+  big = (nsize > ECPP_GEN_POLY_BITS);
+
+  /* Everything the proofs share is set up here, before any workers start. */
+  init_ecpp_gcds(nsize);
+  b.N = N;
+  b.done = done;
+  b.ctx = ctx;
+  Newz(0, b.results, n, int);
+  Newz(0, b.certs, n, char*);
+  class_poly_db_hold(1);   /* Callbacks must not swap it from under us */
+  b.dilist[0] = poly_class_nums(0);
+  b.dilist[1] = big ? poly_class_nums(1) : b.dilist[0];
+  New(0, b.sfacs, MAX_SFACS, mpz_t);
+  b.nsfacs = 0;
+  memset(&b.totals, 0, sizeof(b.totals));
+#ifdef USE_PTHREADS
+  if (!_runkey_ok)
+    _runkey_ok = (pthread_key_create(&_runkey, 0) == 0);
+  if (!_runkey_ok) {   /* The proofs would share _run, so one at a time */
+    for (i = 0; i < n; i++) {
+      _prove_task(&b, i);
+      if (_prove_done(&b, i)) break;
+    }
+  } else
+#endif
+  parallel_queue(n, _prove_task, _prove_done, &b);
+  class_poly_db_hold(0);
+
+  _run.stats = b.totals;
+  for (i = 0; i < n; i++)   /* Any not passed on, if stopped early */
+    if (b.certs[i] != 0)
+      Safefree(b.certs[i]);
+  for (i = 0; i < (UV)b.nsfacs; i++)
+    mpz_clear(b.sfacs[i]);
+  Safefree(b.sfacs);
+  if (big) Safefree(b.dilist[1]);
+  Safefree(b.dilist[0]);
+  Safefree(b.certs);
+  Safefree(b.results);
+}
+
+
 #ifdef STANDALONE_ECPP
 static void dieusage(char* prog) {
   printf("ECPP-DJ version 1.04.  Dana Jacobsen, 2014.\n\n");
@@ -976,12 +2007,18 @@ static void dieusage(char* prog) {
   printf("   -V     set extra verbose\n");
   printf("   -q     no output other than return code\n");
   printf("   -c     print certificate to stdout (redirect to save to a file)\n");
+  printf("   -cb    print certificate in compact binary form to stdout\n");
+  printf("   -t <n> use n threads (0 for one per processor)\n");
   printf("   -bpsw  use the extra strong BPSW test (probable prime test)\n");
   printf("   -nm1   use n-1 proof only (BLS75 theorem 5/7)\n");
   printf("   -np1   use n+1 proof only (BLS75 theorem 19)\n");
   printf("   -bls   use n-1 / n+1 proof (various BLS75 theorems)\n");
   printf("   -ecpp  use ECPP proof only\n");
   printf("   -aks   use AKS for proof\n");
+  printf("   -checkpoint <file>  save ECPP progress to file, resuming from it\n");
+  printf("   -eas <n>  compare n candidate q values at each ECPP step\n");
+  printf("   -budget <s>  ECPP factoring time per step per stage, in seconds\n");
+  printf("   -verify <file>  verify a certificate (MPU, binary, or Primo), - for stdin\n");
 #ifdef USE_APRCL
   printf("   -aprcl use APR-CL for proof\n");
 #endif
@@ -994,6 +2031,34 @@ static void dieusage(char* prog) {
 #include "expr.h"
 #include "aks.h"
 #include "bls75.h"
+#include "cert.h"
+
+static int verify_cert_file(const char* filename, int be_quiet)
+{
+  FILE *fh;
+  char *text;
+  size_t len = 0, size = 65536, got;
+  const char *error;
+  int res;
+
+  fh = (strcmp(filename, "-") == 0) ? stdin : fopen(filename, "rb");
+  if (fh == NULL) croak("Unable to open file: %s\n", filename);
+  New(0, text, size, char);
+  while ((got = fread(text + len, 1, size - len - 1, fh)) > 0) {
+    len += got;
+    if (len + 1 >= size)  Renew(text, size *= 2, char);
+  }
+  text[len] = '\0';
+  if (fh != stdin) fclose(fh);
+
+  res = verify_certificate(text, len, 0, 0, &error);
+  Safefree(text);
+  if (!be_quiet) {
+    if (res == 1) printf("PRIME\n");
+    else          printf("NOT PROVEN: %s\n", error);
+  }
+  return (res == 1) ? 0 : (res == 0) ? 2 : 3;
+}
 
 int main(int argc, char **argv)
 {
@@ -1008,6 +2073,8 @@ int main(int argc, char **argv)
   int do_bpsw = 0;
   int be_quiet = 0;
   int retcode = 3;
+  int eas = 0;
+  double budget = 0;
   char* cert = 0;
 
   if (argc < 2) dieusage(argv[0]);
@@ -1029,6 +2096,10 @@ int main(int argc, char **argv)
         do_printcert = 0;
       } else if (strcmp(argv[i], "-c") == 0) {
         do_printcert = 1;
+      } else if (strcmp(argv[i], "-cb") == 0) {
+        do_printcert = 2;
+      } else if (strcmp(argv[i], "-t") == 0 && i+1 < argc) {
+        set_thread_count(atoi(argv[++i]));
       } else if (strcmp(argv[i], "-nm1") == 0) {
         do_nminus1 = 1;
       } else if (strcmp(argv[i], "-np1") == 0) {
@@ -1043,6 +2114,16 @@ int main(int argc, char **argv)
         do_aprcl = 1;
       } else if (strcmp(argv[i], "-bpsw") == 0) {
         do_bpsw = 1;
+      } else if (strcmp(argv[i], "-eas") == 0 && i+1 < argc) {
+        eas = atoi(argv[++i]);
+        ecpp_set_policy(eas, 2.0, budget);
+      } else if (strcmp(argv[i], "-budget") == 0 && i+1 < argc) {
+        budget = atof(argv[++i]);
+        ecpp_set_policy(eas, 2.0, budget);
+      } else if (strcmp(argv[i], "-checkpoint") == 0 && i+1 < argc) {
+        ecpp_set_checkpoint(argv[++i]);
+      } else if (strcmp(argv[i], "-verify") == 0 && i+1 < argc) {
+        retcode = verify_cert_file(argv[++i], be_quiet);
       } else if (strcmp(argv[i], "-help") == 0 || strcmp(argv[i], "--help") == 0) {
         dieusage(argv[0]);
       } else {
@@ -1085,12 +2166,16 @@ int main(int argc, char **argv)
         croak("Compiled without USE_APRCL.  Sorry.");
 #endif
       } else {
+        bls_partial_t part;
+        bls_partial_init(&part);
         if (!do_ecpp) {
           /* Quick n-1 test */
-          isprime = BLS_primality_nm1(n, 1, &cert);
+          isprime = BLS_primality_nm1_partial(n, 1, &cert, &part);
+          if (isprime == 1 && cert != 0) { Safefree(cert); cert = 0; }
         }
         if (isprime == 1)
-          isprime = _GMP_ecpp(n, &cert);
+          isprime = _GMP_ecpp_partial(n, &cert, &part);
+        bls_partial_clear(&part);
       }
     }
 
@@ -1103,7 +2188,19 @@ int main(int argc, char **argv)
       if (!be_quiet) printf("PROBABLY PRIME\n");
       retcode = 2;
     } else if (isprime == 2) {
-      if (do_printcert) {
+      if (do_printcert == 2) {
+        char *text, *bin;
+        const char *error;
+        size_t len;
+        New(0, text, strlen(cert) + mpz_sizeinbase(n, 10) + 80, char);
+        gmp_sprintf(text, "[MPU - Primality Certificate]\nVersion 1.0\n\n"
+                          "Proof for:\nN %Zd\n\n%s", n, cert);
+        bin = cert_to_binary(text, strlen(text), &len, &error);
+        if (bin == 0) croak("cert: %s\n", error);
+        fwrite(bin, 1, len, stdout);
+        Safefree(bin);
+        Safefree(text);
+      } else if (do_printcert) {
         gmp_printf("[MPU - Primality Certificate]\n");
         gmp_printf("Version 1.0\n");
         gmp_printf("\n");
@@ -3,13 +3,61 @@
 
 #include <gmp.h>
 #include "ptypes.h"
+#include "bls75.h"
 
 extern void init_ecpp_gcds(UV nsize);
 extern void destroy_ecpp_gcds(void);
 
 extern int _GMP_ecpp(mpz_t N, char** prooftextptr);
+/* As _GMP_ecpp, after a BLS75 proof that did not succeed.  The first step
+ * only factors what it left of N-1 and N+1. */
+extern int _GMP_ecpp_partial(mpz_t N, char** prooftextptr, bls_partial_t* part);
 extern int _GMP_ecpp_fps(mpz_t N, char** prooftextptr);
 
+/* Save the proof state to this file as we go, and resume from it if it is
+ * for the same N.  0 turns it off, unless MPU_ECPP_CHECKPOINT is set. */
+extern void ecpp_set_checkpoint(const char* path);
+
+/* How each step picks its q.  With eas > 1, while N has 100 or more digits
+ * the q values found are collected until there are eas of them, then tried
+ * best first, scoring the bits removed less degree_bits for each unit of
+ * class polynomial degree.  With step_seconds > 0, in the first pass of the
+ * proof a level below the top stops looking at more discriminants once it
+ * has spent that long factoring in a stage, so the level above tries
+ * another q.  Later passes, if needed, are not limited.  The default is
+ * (0, 2.0, 0): take the first q found. */
+extern void ecpp_set_policy(int eas, double degree_bits, double step_seconds);
+
+/* Counts and times for the last _GMP_ecpp, also shown with verbose on. */
+typedef struct {
+  UV     levels;          /* numbers searched for a step */
+  UV     discs;           /* discriminants with curve orders to factor */
+  UV     mvalues;         /* curve orders, N-1, and N+1 factored */
+  UV     candidates;      /* q values found */
+  UV     downs;           /* times we went down with a q */
+  UV     backtracks;      /* ... and came back with nothing */
+  UV     eas_reorders;    /* EAS went first with other than the first q */
+  UV     budget_stops;    /* levels that ran out of time in a stage */
+  UV     curve_fails;     /* discriminants dropped with no curve found */
+  UV     steps;           /* steps proven */
+  UV     bls_steps;       /* ... of which finished with a BLS75 proof */
+  UV     bits_removed;    /* total size reduction over those steps */
+  int    fstage;          /* the last factoring stage */
+  double factor_seconds, curve_seconds, total_seconds;
+} ecpp_stats_t;
+extern void ecpp_get_stats(ecpp_stats_t* stats);
+
+/* Prove each of N[0..n-1] as _GMP_is_provable_prime does, using
+ * get_thread_count() threads each working on its own N.  The discriminant
+ * list and the factors saved from hard curve orders are shared by the whole
+ * batch.  done(ctx, i, result, cert) is called on this thread as each proof
+ * finishes, in that order, with cert freed after it returns.  A nonzero
+ * return stops the batch: no more proofs are started, and those running
+ * finish without being reported.  ecpp_get_stats then has the totals for
+ * the proofs run.  There is no checkpointing in a batch. */
+typedef int (*ecpp_batch_fn_t)(void *ctx, UV i, int result, char *cert);
+extern void ecpp_prove_batch(mpz_t* N, UV n, ecpp_batch_fn_t done, void* ctx);
+
 extern int ecpp_check_point(mpz_t x, mpz_t y, mpz_t m, mpz_t q, mpz_t a,
                             mpz_t N, mpz_t t, mpz_t t2);
 
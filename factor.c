@@ -406,43 +406,203 @@ void clear_factors(int nfactors, mpz_t* pfactors[], int* pexponents[])
 /*****************************************************************************/
 
 
-/* TODO: Optimize to factor down to the last semiprime. */
-static void _omega(mpz_t n, uint32_t* omega, uint32_t* bigomega)
+/* A factored integer.  Creating one costs a single call to factor(), after
+ * which any number of arithmetic functions can be computed from it. */
+
+void factored_init(factored_t *F, mpz_t n)
 {
-  mpz_t* factors;
-  int i, nfactors, result, *exponents;
+  mpz_init(F->n);
+  mpz_abs(F->n, n);
+  F->nfactors = factor(F->n, &F->factors, &F->exponents);
+}
 
-  mpz_abs(n,n);
-  nfactors = factor(n, &factors, &exponents);
-  if (bigomega != 0) {
-    for (i = 0, result = 0; i < nfactors; i++)
-      result += exponents[i];
-    *bigomega = result;
+/* Build from a user supplied list of primes (in any order, possibly with
+ * repeats).  Returns 0 if any entry is not a probable prime. */
+int factored_init_list(factored_t *F, int nf, mpz_t *factors, int *exponents)
+{
+  int i, nfactors = 0;
+  mpz_t *fac = 0;
+  int *exp = 0;
+
+  mpz_init_set_ui(F->n, 1);
+  F->nfactors = 0;
+  F->factors = 0;
+  F->exponents = 0;
+  for (i = 0; i < nf; i++) {
+    if (exponents[i] < 1) continue;
+    if (!_GMP_is_prob_prime(factors[i])) {
+      clear_factors(nfactors, &fac, &exp);
+      return 0;
+    }
+    nfactors = add_factor(nfactors, factors[i], exponents[i], &fac, &exp);
   }
-  if (omega != 0)
-    *omega = nfactors;
-  clear_factors(nfactors, &factors, &exponents);
+  for (i = 0; i < nfactors; i++) {
+    mpz_t t;
+    mpz_init(t);
+    mpz_pow_ui(t, fac[i], exp[i]);
+    mpz_mul(F->n, F->n, t);
+    mpz_clear(t);
+  }
+  F->nfactors = nfactors;
+  F->factors = fac;
+  F->exponents = exp;
+  return 1;
+}
+
+void factored_clear(factored_t *F)
+{
+  clear_factors(F->nfactors, &F->factors, &F->exponents);
+  F->nfactors = 0;
+  mpz_clear(F->n);
+}
+
+/* Factor every integer in lo .. lo+len-1 (lo > 0) together.  Primes up to
+ * a bound B are sieved over the window, accumulating factors and dividing
+ * them out of a per-element cofactor.  A remaining cofactor below B^2 must
+ * be prime, and otherwise one BPSW test usually finishes it.  Only
+ * cofactors that are composite go to factor(). */
+#define FACTOR_RANGE_MAXB  (1UL << 20)
+factored_t* factor_range(mpz_t lo, UV len)
+{
+  factored_t *F;
+  mpz_t *rem, f, B2;
+  UV i, B, start;
+  unsigned long p;
+  PRIME_ITERATOR(iter);
+
+  MPUassert(mpz_sgn(lo) > 0, "factor_range given non-positive lo");
+  New(0, F, len, factored_t);
+  New(0, rem, len, mpz_t);
+  for (i = 0; i < len; i++) {
+    mpz_init(F[i].n);
+    mpz_add_ui(F[i].n, lo, i);
+    mpz_init_set(rem[i], F[i].n);
+    F[i].nfactors = 0;
+    F[i].factors = 0;
+    F[i].exponents = 0;
+  }
+
+  /* Sieve to sqrt(hi), but no further than our maximum. */
+  mpz_init(f);
+  mpz_init(B2);
+  mpz_add_ui(f, lo, len-1);
+  mpz_sqrt(f, f);
+  B = (mpz_cmp_ui(f, FACTOR_RANGE_MAXB) >= 0) ? FACTOR_RANGE_MAXB : mpz_get_ui(f);
+  mpz_set_ui(B2, B);
+  mpz_mul_ui(B2, B2, B);
+
+  for (p = 2; p <= B; p = prime_iterator_next(&iter)) {
+    start = mpz_cdiv_ui(lo, p);   /* (p - lo%p) % p */
+    if (start >= len) continue;
+    mpz_set_ui(f, p);
+    for (i = start; i < len; i += p) {
+      int e = 0;
+      do {
+        mpz_divexact_ui(rem[i], rem[i], p);
+        e++;
+      } while (mpz_divisible_ui_p(rem[i], p));
+      F[i].nfactors = add_factor(F[i].nfactors, f, e, &F[i].factors, &F[i].exponents);
+    }
+  }
+  prime_iterator_destroy(&iter);
+
+  for (i = 0; i < len; i++) {
+    if (mpz_cmp_ui(rem[i], 1) > 0) {
+      if (mpz_cmp(rem[i], B2) < 0 || _GMP_is_prob_prime(rem[i])) {
+        F[i].nfactors = add_factor(F[i].nfactors, rem[i], 1, &F[i].factors, &F[i].exponents);
+      } else {
+        mpz_t *cf;
+        int j, ncf, *ce;
+        ncf = factor(rem[i], &cf, &ce);
+        for (j = 0; j < ncf; j++)
+          F[i].nfactors = add_factor(F[i].nfactors, cf[j], ce[j], &F[i].factors, &F[i].exponents);
+        clear_factors(ncf, &cf, &ce);
+      }
+    }
+    mpz_clear(rem[i]);
+  }
+  Safefree(rem);
+  mpz_clear(B2);
+  mpz_clear(f);
+  return F;
+}
+
+void factor_range_free(factored_t *F, UV len)
+{
+  UV i;
+  for (i = 0; i < len; i++)
+    factored_clear(F+i);
+  Safefree(F);
+}
+
+uint32_t omega_factored(factored_t *F)
+{
+  return F->nfactors;
+}
+uint32_t bigomega_factored(factored_t *F)
+{
+  uint32_t i, bo;
+  for (i = 0, bo = 0; i < (uint32_t)F->nfactors; i++)
+    bo += F->exponents[i];
+  return bo;
 }
 
 uint32_t omega(mpz_t n)
 {
   uint32_t o;
-  _omega(n, &o, 0);
+  factored_t F;
+  factored_init(&F, n);
+  o = omega_factored(&F);
+  factored_clear(&F);
   return o;
 }
 uint32_t bigomega(mpz_t n)
 {
   uint32_t bo;
-  _omega(n, 0, &bo);
+  factored_t F;
+  factored_init(&F, n);
+  bo = bigomega_factored(&F);
+  factored_clear(&F);
   return bo;
 }
 
+void sigma_factored(mpz_t res, factored_t *F, unsigned long k)
+{
+  mpz_t pk, pke, *terms;
+  int i, j, nfactors = F->nfactors;
+
+  if (nfactors == 0) { mpz_set_ui(res, 1); return; }
+
+  New(0, terms, nfactors, mpz_t);
+  mpz_init(pk);
+  mpz_init(pke);
+  for (i = 0; i < nfactors; i++) {
+    mpz_init(terms[i]);
+    if (k == 0) {
+      mpz_set_ui(terms[i], F->exponents[i]+1);
+      continue;
+    }
+    if (k == 1)  mpz_set(pk, F->factors[i]);
+    else         mpz_pow_ui(pk, F->factors[i], k);
+    mpz_add_ui(terms[i], pk, 1);
+    mpz_set(pke, pk);
+    for (j = 1; j < F->exponents[i]; j++) {
+      mpz_mul(pke, pke, pk);
+      mpz_add(terms[i], terms[i], pke);
+    }
+  }
+  mpz_clear(pke);
+  mpz_clear(pk);
+  mpz_product(terms, 0, nfactors-1);
+  mpz_set(res, terms[0]);
+  for (i = 0; i < nfactors; i++)
+    mpz_clear(terms[i]);
+  Safefree(terms);
+}
+
 void sigma(mpz_t res, mpz_t n, unsigned long k)
 {
-  mpz_t* factors;
-  mpz_t pk, pke, fmult;
-  int* exponents;
-  int i, j, nfactors;
+  factored_t F;
 
   if (mpz_cmp_ui(n, 1) <= 0) {
     mpz_set_ui(res, (k == 0 && mpz_cmp_ui(n,1) < 0) ? 2 : 1);
@@ -455,71 +615,44 @@ void sigma(mpz_t res, mpz_t n, unsigned long k)
     return;
   }
 
-  nfactors = factor(n, &factors, &exponents);
-  if (k == 0) {
-    for (i = 0; i < nfactors; i++) {
-      mpz_set_ui(factors[i], exponents[i]+1);
-    }
-  } else if (k == 1) {
-    mpz_init(pke);
-    mpz_init(fmult);
-    for (i = 0; i < nfactors; i++) {
-      mpz_set(pke, factors[i]);
-      mpz_add_ui(fmult, factors[i], 1);
-      for (j = 1; j < exponents[i]; j++) {
-        mpz_mul(pke, pke, factors[i]);
-        mpz_add(fmult, fmult, pke);
-      }
-      mpz_set(factors[i], fmult);
-    }
-    mpz_clear(fmult);
-    mpz_clear(pke);
-  } else {
-    mpz_init(pk);
-    mpz_init(pke);
-    mpz_init(fmult);
-    for (i = 0; i < nfactors; i++) {
-      mpz_pow_ui(pk, factors[i], k);
-      mpz_add_ui(fmult, pk, 1);
-      mpz_set(pke, pk);
-      for (j = 1; j < exponents[i]; j++) {
-        mpz_mul(pke, pke, pk);
-        mpz_add(fmult, fmult, pke);
-      }
-      mpz_set(factors[i], fmult);
-    }
-    mpz_clear(fmult);
-    mpz_clear(pke);
-    mpz_clear(pk);
-  }
-  mpz_product(factors, 0, nfactors-1);
-  mpz_set(res, factors[0]);
-  clear_factors(nfactors, &factors, &exponents);
+  factored_init(&F, n);
+  sigma_factored(res, &F, k);
+  factored_clear(&F);
 }
 
 
+int moebius_factored(factored_t *F)
+{
+  int i;
+  for (i = 0; i < F->nfactors; i++)
+    if (F->exponents[i] > 1)
+      return 0;
+  return (F->nfactors % 2) ? -1 : 1;
+}
+
 static const unsigned long smalldiv[] = {4, 9, 25, 49, 121, 169, 289};
 int moebius(mpz_t n)
 {
-  uint32_t i, o, bo;
+  uint32_t i;
+  int mu;
+  factored_t F;
 
-  if (mpz_sgn(n) < 0) {
-    mpz_neg(n,n);
-    o = moebius(n);
-    mpz_neg(n,n);
-    return o;
-  }
   if (mpz_sgn(n) == 0) return 0;
-  if (mpz_cmp_ui(n, 1) == 0) return 1;
+  if (mpz_cmpabs_ui(n, 1) == 0) return 1;
 
   for (i = 0; i < 7; i++)
     if (mpz_divisible_ui_p(n, smalldiv[i]))
       return 0;
 
-  _omega(n, &o, &bo);
-  return (o != bo) ?   0
-      :  (o % 2)   ?  -1
-                   :   1;
+  factored_init(&F, n);
+  mu = moebius_factored(&F);
+  factored_clear(&F);
+  return mu;
+}
+
+int liouville_factored(factored_t *F)
+{
+  return (bigomega_factored(F) & 1)  ?  -1  :  1;
 }
 
 int liouville(mpz_t n)
@@ -528,37 +661,67 @@ int liouville(mpz_t n)
   return (result & 1)  ?  -1  : 1;
 }
 
-void totient(mpz_t tot, mpz_t n_input)
+void totient_factored(mpz_t tot, factored_t *F)
 {
-  mpz_t t, n;
-  mpz_t* factors;
-  int* exponents;
-  int i, j, nfactors;
+  mpz_t t;
+  int i, j;
 
-  if (mpz_cmp_ui(n_input, 1) <= 0) {
-    mpz_set(tot, n_input);
+  mpz_set_ui(tot, 1);
+  mpz_init(t);
+  for (i = 0; i < F->nfactors; i++) {
+    if (mpz_cmp_ui(F->factors[i], 2) == 0) {
+      mpz_mul_2exp(tot, tot, F->exponents[i]-1);
+      continue;
+    }
+    mpz_sub_ui(t, F->factors[i], 1);
+    for (j = 1; j < F->exponents[i]; j++)
+      mpz_mul(t, t, F->factors[i]);
+    mpz_mul(tot, tot, t);
+  }
+  mpz_clear(t);
+}
+
+void totient(mpz_t tot, mpz_t n)
+{
+  factored_t F;
+
+  if (mpz_cmp_ui(n, 1) <= 0) {
+    mpz_set(tot, n);
     return;
   }
-  mpz_init_set(n, n_input);
-  mpz_set_ui(tot, 1);
-  /* Fast reduction of multiples of 2 */
-  i = mpz_scan1(n, 0);
-  if (i > 0) {
-    if (i > 1)  mpz_mul_2exp(tot, tot, i-1);
-    mpz_tdiv_q_2exp(n, n, i);
+  factored_init(&F, n);
+  totient_factored(tot, &F);
+  factored_clear(&F);
+}
+
+void jordan_totient_factored(mpz_t tot, factored_t *F, unsigned long k)
+{
+  mpz_t t, *terms;
+  int i, j, nfactors = F->nfactors;
+
+  if (k == 0 || nfactors == 0) {
+    mpz_set_ui(tot, (nfactors == 0) ? 1 : 0);
+    return;
   }
-  /* Now factor and calculate totient */
-  nfactors = factor(n, &factors, &exponents);
+  if (k == 1) {
+    totient_factored(tot, F);
+    return;
+  }
+  New(0, terms, nfactors, mpz_t);
   mpz_init(t);
   for (i = 0; i < nfactors; i++) {
-    mpz_sub_ui(t, factors[i], 1);
-    for (j = 1; j < exponents[i]; j++)
-      mpz_mul(t, t, factors[i]);
-    mpz_mul(tot, tot, t);
-  }
+    mpz_init(terms[i]);
+    mpz_pow_ui(t, F->factors[i], k);
+    mpz_sub_ui(terms[i], t, 1);
+    for (j = 1; j < F->exponents[i]; j++)
+      mpz_mul(terms[i], terms[i], t);
+  }
+  mpz_product(terms, 0, nfactors-1);
+  mpz_set(tot, terms[0]);
   mpz_clear(t);
-  clear_factors(nfactors, &factors, &exponents);
-  mpz_clear(n);
+  for (i = 0; i < nfactors; i++)
+    mpz_clear(terms[i]);
+  Safefree(terms);
 }
 
 void jordan_totient(mpz_t tot, mpz_t n, unsigned long k)
@@ -570,24 +733,34 @@ void jordan_totient(mpz_t tot, mpz_t n, unsigned long k)
   } else if (mpz_cmp_ui(n, 1) <= 0) {
     mpz_set_ui(tot, (mpz_cmp_ui(n, 1) == 0) ? 1 : 0);
   } else {
-    mpz_t t;
-    mpz_t* factors;
-    int* exponents;
-    int i, j, nfactors;
+    factored_t F;
+    factored_init(&F, n);
+    jordan_totient_factored(tot, &F, k);
+    factored_clear(&F);
+  }
+}
 
-    nfactors = factor(n, &factors, &exponents);
-    mpz_init(t);
-    for (i = 0; i < nfactors; i++) {
-      mpz_pow_ui(t, factors[i], k);
-      mpz_sub_ui(factors[i], t, 1);
-      for (j = 1; j < exponents[i]; j++)
-        mpz_mul(factors[i], factors[i], t);
+void carmichael_lambda_factored(mpz_t lambda, factored_t *F)
+{
+  mpz_t t;
+  int i, j, e;
+
+  mpz_init(t);
+  mpz_set_ui(lambda, 1);
+  for (i = 0; i < F->nfactors; i++) {
+    e = F->exponents[i];
+    if (mpz_cmp_ui(F->factors[i], 2) == 0) {
+      /* lambda(2) = 1, lambda(4) = 2, lambda(2^e) = 2^(e-2) */
+      mpz_set_ui(t, 1);
+      mpz_mul_2exp(t, t, (e <= 2) ? e-1 : e-2);
+    } else {
+      mpz_sub_ui(t, F->factors[i], 1);
+      for (j = 1; j < e; j++)
+        mpz_mul(t, t, F->factors[i]);
     }
-    mpz_product(factors, 0, nfactors-1);
-    mpz_set(tot, factors[0]);
-    mpz_clear(t);
-    clear_factors(nfactors, &factors, &exponents);
+    mpz_lcm(lambda, lambda, t);
   }
+  mpz_clear(t);
 }
 
 void carmichael_lambda(mpz_t lambda, mpz_t n)
@@ -597,23 +770,10 @@ void carmichael_lambda(mpz_t lambda, mpz_t n)
   } else if (mpz_scan1(n, 0) == mpz_sizeinbase(n, 2)-1) {
     mpz_tdiv_q_2exp(lambda, n, 2);
   } else {
-    mpz_t t;
-    mpz_t* factors;
-    int* exponents;
-    int i, j, nfactors;
-
-    nfactors = factor(n, &factors, &exponents);
-    mpz_init(t);
-    mpz_set_ui(lambda, 1);
-    if (exponents[0] > 2 && mpz_cmp_ui(factors[0], 2) == 0) exponents[0]--;
-    for (i = 0; i < nfactors; i++) {
-      mpz_sub_ui(t, factors[i], 1);
-      for (j = 1; j < exponents[i]; j++)
-        mpz_mul(t, t, factors[i]);
-      mpz_lcm(lambda, lambda, t);
-    }
-    mpz_clear(t);
-    clear_factors(nfactors, &factors, &exponents);
+    factored_t F;
+    factored_init(&F, n);
+    carmichael_lambda_factored(lambda, &F);
+    factored_clear(&F);
   }
 }
 
@@ -682,86 +842,77 @@ static void _znorder1(mpz_t order, mpz_t a, mpz_t p, int e, mpz_t t, mpz_t n)
   clear_factors(nfactors, &factors, &exponents);
 }
 
-void znorder(mpz_t res, mpz_t a, mpz_t n)
+/* Handles the cases not needing a factorization.  Returns 1 if res is set. */
+static int _znorder_trivial(mpz_t res, mpz_t a, mpz_t n, mpz_t t)
 {
-  mpz_t t, order;
-
-  /* TODO: Usually we don't want to modify their inputs */
-  mpz_abs(n,n);
-  if (mpz_cmp_ui(n, 1) <= 0) { mpz_set(res, n); return; }
+  if (mpz_cmp_ui(n, 1) <= 0) { mpz_set(res, n); return 1; }
   mpz_mod(a, a, n);
-  if (mpz_cmp_ui(a, 1) <= 0) { mpz_set(res, a); return; }
-
-  mpz_init(t);
+  if (mpz_cmp_ui(a, 1) <= 0) { mpz_set(res, a); return 1; }
   mpz_gcd(t, a, n);
-  if (mpz_cmp_ui(t, 1) != 0) {
-    mpz_set_ui(res, 0);
-    mpz_clear(t);
-    return;
-  }
-  mpz_init_set_ui(order, 1);
+  if (mpz_cmp_ui(t, 1) != 0) { mpz_set_ui(res, 0); return 1; }
+  return 0;
+}
 
-  { /* Factor n, then lcm all the znorder(p^e). */
-    mpz_t order1, t2, *factors;
-    int* exponents;
-    int i, nfactors;
+void znorder_factored(mpz_t res, mpz_t a, factored_t *F)
+{
+  mpz_t t, t2, order, order1;
+  int i;
 
-    mpz_init(order1);
-    mpz_init(t2);
-    nfactors = factor(n, &factors, &exponents);
-    for (i = 0; i < nfactors; i++) {
-      _znorder1(order1, a, factors[i], exponents[i], t, t2);
-      mpz_lcm(order, order, order1);
-    }
-    clear_factors(nfactors, &factors, &exponents);
-    mpz_clear(t2);
-    mpz_clear(order1);
+  mpz_init(t);
+  if (_znorder_trivial(res, a, F->n, t)) { mpz_clear(t); return; }
+
+  /* lcm all the znorder(p^e). */
+  mpz_init_set_ui(order, 1);
+  mpz_init(order1);
+  mpz_init(t2);
+  for (i = 0; i < F->nfactors; i++) {
+    _znorder1(order1, a, F->factors[i], F->exponents[i], t, t2);
+    mpz_lcm(order, order, order1);
   }
   mpz_set(res, order);
+  mpz_clear(t2);
+  mpz_clear(order1);
   mpz_clear(order);
   mpz_clear(t);
 }
 
-void znprimroot(mpz_t root, mpz_t n)
+void znorder(mpz_t res, mpz_t a, mpz_t n)
 {
-  mpz_t t, phi, a, on, r, *factors;
-  int i, nfactors, *exponents, oddprime, k;
-
-  mpz_set_ui(root, 0);
-  if (mpz_cmp_ui(n, 4) <= 0) {
-    if (mpz_sgn(n) > 0)
-      mpz_sub_ui(root, n, 1);
-    return;
-  }
-  if (mpz_divisible_ui_p(n, 4))
-    return;
-
-  mpz_init(r);
-  mpz_init_set(on, n);
-  if (mpz_even_p(on))
-    mpz_tdiv_q_2exp(on, on, 1);
-  if (!power_factor(on, r))
-    mpz_set(r, on);
-  if (!_GMP_is_prob_prime(r)) {
-    mpz_clear(on);
-    mpz_clear(r);
-    return;
-  }
+  factored_t F;
+  mpz_t t;
+  int done;
 
-  mpz_init(phi);
-  mpz_sub_ui(phi, r, 1);
-  mpz_divexact(on, on, r);
-  mpz_mul(phi, phi, on);
+  /* TODO: Usually we don't want to modify their inputs */
+  mpz_abs(n,n);
+  mpz_init(t);
+  done = _znorder_trivial(res, a, n, t);
+  mpz_clear(t);
+  if (done) return;
 
-  mpz_sub_ui(r,n,1);
-  oddprime = (mpz_cmp(r,phi) == 0);
+  factored_init(&F, n);
+  znorder_factored(res, a, &F);
+  factored_clear(&F);
+}
 
-  mpz_clear(on);
-  mpz_clear(r);
+/* Given n = r^e or 2*r^e with r an odd prime, find the least primitive root.
+ * Only the factorization of r-1 is needed for phi. */
+static void _znprimroot(mpz_t root, mpz_t n, mpz_t r, unsigned long e)
+{
+  mpz_t t, phi, a, *factors;
+  int i, nfactors, *exponents, oddprime, k;
 
   mpz_init(t);
   mpz_init(a);
+  mpz_init(phi);
+  mpz_sub_ui(phi, r, 1);
   nfactors = factor(phi, &factors, &exponents);
+  if (e > 1) {
+    mpz_pow_ui(t, r, e-1);
+    mpz_mul(phi, phi, t);
+    ADD_FACTORS(r, e-1);
+  }
+  mpz_sub_ui(t, n, 1);
+  oddprime = (mpz_cmp(t, phi) == 0);
 
   /* Replace each factor with phi/factor */
   for (i = 0; i < nfactors; i++)
@@ -784,6 +935,54 @@ void znprimroot(mpz_t root, mpz_t n)
   mpz_clear(phi);
 }
 
+void znprimroot_factored(mpz_t root, factored_t *F)
+{
+  int nf = F->nfactors, odd;
+
+  mpz_set_ui(root, 0);
+  if (mpz_cmp_ui(F->n, 4) <= 0) {
+    if (mpz_sgn(F->n) > 0)
+      mpz_sub_ui(root, F->n, 1);
+    return;
+  }
+  /* n must be p^e or 2*p^e for an odd prime p */
+  if      (nf == 1)  odd = 0;
+  else if (nf == 2 && F->exponents[0] == 1 && mpz_cmp_ui(F->factors[0],2) == 0)  odd = 1;
+  else               return;
+  if (mpz_cmp_ui(F->factors[odd], 2) == 0)
+    return;
+  _znprimroot(root, F->n, F->factors[odd], F->exponents[odd]);
+}
+
+void znprimroot(mpz_t root, mpz_t n)
+{
+  mpz_t on, r;
+  unsigned long e;
+
+  mpz_set_ui(root, 0);
+  if (mpz_cmp_ui(n, 4) <= 0) {
+    if (mpz_sgn(n) > 0)
+      mpz_sub_ui(root, n, 1);
+    return;
+  }
+  if (mpz_divisible_ui_p(n, 4))
+    return;
+
+  mpz_init(r);
+  mpz_init_set(on, n);
+  if (mpz_even_p(on))
+    mpz_tdiv_q_2exp(on, on, 1);
+  e = power_factor(on, r);
+  if (e == 0) {
+    mpz_set(r, on);
+    e = 1;
+  }
+  if (_GMP_is_prob_prime(r))
+    _znprimroot(root, n, r, e);
+  mpz_clear(on);
+  mpz_clear(r);
+}
+
 static const int32_t tau_table[] = {
   0,1,-24,252,-1472,4830,-6048,-16744,84480,-113643,-115920,534612,-370944,-577738,401856,1217160,987136,-6905934,2727432,10661420,-7109760,-4219488,-12830688,18643272,21288960,-25499225,13865712,-73279080,24647168,128406630,-29211840,-52843168,-196706304,134722224,165742416,-80873520,167282496,-182213314,-255874080,-145589976,408038400,308120442,101267712,-17125708,-786948864,-548895690,-447438528
 };
@@ -1311,8 +1510,8 @@ int _GMP_pminus1_factor(mpz_t n, mpz_t f, UV B1, UV B2)
     mpz_t b, bm, bmdiff;
     mpz_t precomp_bm[111];
     int   is_precomp[111] = {0};
-    UV* primes = 0;
-    UV sp = 1;
+    const uint32_t* primes = 0;
+    UV sp = 0, pcnt = 0;
 
     mpz_init(bmdiff);
     mpz_init_set(bm, a);
@@ -1331,17 +1530,17 @@ int _GMP_pminus1_factor(mpz_t n, mpz_t f, UV B1, UV B2)
     }
 
     mpz_powm_ui(a, a, q, n );
-    if (B2 < 10000000) {
-      /* grab all the primes at once.  Hack around non-perfect iterator. */
-      primes = sieve_to_n(B2+300, 0);
-      for (sp = B1>>4; primes[sp] <= q; sp++)  ;
-      /* q is primes <= B1, primes[sp] is the next prime */
-    }
+    /* Walk the shared prime table if it reaches B2. */
+    primes = prime_table(B2, &pcnt);
+    if (primes != 0)
+      prime_table(q, &sp);   /* primes[sp] is the next prime after q */
 
     j = 31;
     while (q <= B2) {
       UV lastq, qdiff;
 
+      if (primes != 0 && sp >= pcnt)  /* No more primes <= B2 */
+        break;
       lastq = q;
       q = primes ? primes[sp++] : prime_iterator_next(&iter);
       qdiff = (q - lastq) / 2 - 1;
@@ -1377,7 +1576,6 @@ int _GMP_pminus1_factor(mpz_t n, mpz_t f, UV B1, UV B2)
       if (is_precomp[j])
         mpz_clear(precomp_bm[j]);
     }
-    if (primes != 0) Safefree(primes);
     if ( (mpz_cmp_ui(f, 1) != 0) && (mpz_cmp(f, n) != 0) )
       goto end_success;
   }
@@ -1675,6 +1873,199 @@ mpz_t * divisor_list(int *num_divisors, mpz_t n)
   return divs;
 }
 
+/* Divisor iterator.
+ *
+ * Ordered mode keeps a min-heap of pending divisors.  Every divisor d > 1
+ * with largest prime p_k has a parent d/p_k, so the divisors form a tree
+ * whose children of d are d*p_j for j >= k.  Children are increasing in j,
+ * so each popped node only needs to push its first child and its next
+ * sibling.  The heap never holds more entries than have been returned, and
+ * nothing larger than hi is ever pushed.
+ *
+ * Unordered mode is an odometer over the exponents, carrying whenever the
+ * running product would exceed hi.
+ */
+
+static void _dheap_push(divisor_iterator *iter, mpz_t v, int k, int e)
+{
+  divisor_heap_t *H;
+  int i, parent;
+
+  if (iter->hashi && mpz_cmp(v, iter->hi) > 0) return;
+  if (iter->nheap >= iter->heapalloc) {
+    int newalloc = (iter->heapalloc == 0) ? 16 : 2*iter->heapalloc;
+    Renew(iter->heap, newalloc, divisor_heap_t);
+    for (i = iter->heapalloc; i < newalloc; i++)
+      mpz_init(iter->heap[i].v);
+    iter->heapalloc = newalloc;
+  }
+  H = iter->heap;
+  i = iter->nheap++;
+  mpz_set(H[i].v, v);  H[i].k = k;  H[i].e = e;
+  while (i > 0) {
+    parent = (i-1) >> 1;
+    if (mpz_cmp(H[parent].v, H[i].v) <= 0) break;
+    mpz_swap(H[parent].v, H[i].v);
+    k = H[parent].k;  H[parent].k = H[i].k;  H[i].k = k;
+    e = H[parent].e;  H[parent].e = H[i].e;  H[i].e = e;
+    i = parent;
+  }
+}
+
+/* Moves the smallest entry into H[nheap] (which remains initialized). */
+static void _dheap_pop(divisor_iterator *iter)
+{
+  divisor_heap_t *H = iter->heap;
+  int i, c, t, n = --iter->nheap;
+
+  mpz_swap(H[0].v, H[n].v);
+  t = H[0].k;  H[0].k = H[n].k;  H[n].k = t;
+  t = H[0].e;  H[0].e = H[n].e;  H[n].e = t;
+  for (i = 0; (c = 2*i+1) < n; i = c) {
+    if (c+1 < n && mpz_cmp(H[c+1].v, H[c].v) < 0) c++;
+    if (mpz_cmp(H[i].v, H[c].v) <= 0) break;
+    mpz_swap(H[i].v, H[c].v);
+    t = H[i].k;  H[i].k = H[c].k;  H[c].k = t;
+    t = H[i].e;  H[i].e = H[c].e;  H[c].e = t;
+  }
+}
+
+void divisor_iterator_init(divisor_iterator *iter, mpz_t n, mpz_t lo, mpz_t hi, int ordered)
+{
+  int i;
+
+  iter->ordered = ordered;
+  iter->state = 0;
+  iter->haslo = (lo != 0);
+  iter->hashi = (hi != 0);
+  mpz_init(iter->lo);
+  mpz_init(iter->hi);
+  mpz_init(iter->cur);
+  if (lo != 0) mpz_set(iter->lo, lo);
+  if (hi != 0) mpz_set(iter->hi, hi);
+  iter->pk = 0;
+  iter->e = 0;
+  iter->heap = 0;
+  iter->nheap = iter->heapalloc = 0;
+
+  iter->nfactors = factor(n, &iter->factors, &iter->exponents);
+  if (mpz_sgn(n) == 0) {       /* divisors(0) = {0, 1} */
+    clear_factors(iter->nfactors, &iter->factors, &iter->exponents);
+    iter->nfactors = 0;
+    iter->factors = 0;
+    iter->exponents = 0;
+    iter->state = 3;
+  }
+
+  if (!ordered) {
+    New(0, iter->pk, iter->nfactors+1, mpz_t);
+    Newz(0, iter->e, iter->nfactors+1, int);
+    for (i = 0; i < iter->nfactors; i++)
+      mpz_init_set_ui(iter->pk[i], 1);
+  }
+}
+
+void divisor_iterator_destroy(divisor_iterator *iter)
+{
+  int i;
+  for (i = 0; i < iter->heapalloc; i++)
+    mpz_clear(iter->heap[i].v);
+  Safefree(iter->heap);
+  if (iter->pk != 0)
+    for (i = 0; i < iter->nfactors; i++)
+      mpz_clear(iter->pk[i]);
+  Safefree(iter->pk);
+  Safefree(iter->e);
+  clear_factors(iter->nfactors, &iter->factors, &iter->exponents);
+  mpz_clear(iter->cur);
+  mpz_clear(iter->hi);
+  mpz_clear(iter->lo);
+  iter->heap = 0;  iter->heapalloc = iter->nheap = 0;
+  iter->pk = 0;  iter->e = 0;
+  iter->factors = 0;  iter->exponents = 0;
+  iter->nfactors = 0;
+  iter->state = 2;
+}
+
+/* Sets d to the next divisor and returns 1, or returns 0 when finished. */
+static int _divisor_iterator_step(divisor_iterator *iter, mpz_t d)
+{
+  int i, k, e, nf = iter->nfactors;
+
+  if (iter->state == 2) return 0;
+  if (iter->state == 3) {
+    mpz_set_ui(d, 0);
+    iter->state = 0;
+    return 1;
+  }
+
+  if (iter->ordered) {
+    divisor_heap_t *top;
+    if (iter->state == 0) {
+      mpz_set_ui(iter->cur, 1);
+      _dheap_push(iter, iter->cur, -1, 0);
+      iter->state = 1;
+    }
+    if (iter->nheap == 0) { iter->state = 2; return 0; }
+    _dheap_pop(iter);
+    top = iter->heap + iter->nheap;
+    mpz_set(d, top->v);
+    k = top->k;
+    e = top->e;
+    /* First child */
+    if (k >= 0 && e < iter->exponents[k]) {
+      mpz_mul(iter->cur, d, iter->factors[k]);
+      _dheap_push(iter, iter->cur, k, e+1);
+    } else if (k+1 < nf) {
+      mpz_mul(iter->cur, d, iter->factors[k+1]);
+      _dheap_push(iter, iter->cur, k+1, 1);
+    }
+    /* Next sibling */
+    if (k >= 0 && k+1 < nf) {
+      mpz_divexact(iter->cur, d, iter->factors[k]);
+      mpz_mul(iter->cur, iter->cur, iter->factors[k+1]);
+      _dheap_push(iter, iter->cur, k+1, 1);
+    }
+    return 1;
+  }
+
+  if (iter->state == 0) {
+    mpz_set_ui(iter->cur, 1);
+    iter->state = 1;
+    if (iter->hashi && mpz_cmp_ui(iter->hi, 1) < 0) { iter->state = 2; return 0; }
+    mpz_set(d, iter->cur);
+    return 1;
+  }
+  for (i = 0; i < nf; i++) {
+    if (iter->e[i] < iter->exponents[i]) {
+      mpz_mul(d, iter->cur, iter->factors[i]);
+      if (!iter->hashi || mpz_cmp(d, iter->hi) <= 0) {
+        mpz_set(iter->cur, d);
+        mpz_mul(iter->pk[i], iter->pk[i], iter->factors[i]);
+        iter->e[i]++;
+        return 1;
+      }
+    }
+    /* Reset this digit and carry into the next */
+    if (iter->e[i] > 0) {
+      mpz_divexact(iter->cur, iter->cur, iter->pk[i]);
+      mpz_set_ui(iter->pk[i], 1);
+      iter->e[i] = 0;
+    }
+  }
+  iter->state = 2;
+  return 0;
+}
+
+int divisor_iterator_next(divisor_iterator *iter, mpz_t d)
+{
+  while (_divisor_iterator_step(iter, d))
+    if ( (!iter->haslo || mpz_cmp(d, iter->lo) >= 0) &&
+         (!iter->hashi || mpz_cmp(d, iter->hi) <= 0) )
+      return 1;
+  return 0;
+}
+
 int is_smooth(mpz_t n, mpz_t k) {
   mpz_t *factors;
   mpz_t N;
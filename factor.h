@@ -9,6 +9,33 @@ extern void _init_factor(void);
 extern int factor(mpz_t n, mpz_t* factors[], int* exponents[]);
 extern void clear_factors(int nfactors, mpz_t* pfactors[], int* pexponents[]);
 
+/* An integer with its factorization, so arithmetic functions of the same
+ * n need only factor it once. */
+typedef struct {
+  mpz_t  n;
+  int    nfactors;
+  mpz_t *factors;
+  int   *exponents;
+} factored_t;
+
+extern void factored_init(factored_t *F, mpz_t n);
+extern int  factored_init_list(factored_t *F, int nfactors, mpz_t *factors, int *exponents);
+extern void factored_clear(factored_t *F);
+
+extern factored_t* factor_range(mpz_t lo, UV len);
+extern void factor_range_free(factored_t *F, UV len);
+
+extern uint32_t omega_factored(factored_t *F);
+extern uint32_t bigomega_factored(factored_t *F);
+extern void sigma_factored(mpz_t res, factored_t *F, unsigned long k);
+extern int  moebius_factored(factored_t *F);
+extern int  liouville_factored(factored_t *F);
+extern void totient_factored(mpz_t tot, factored_t *F);
+extern void jordan_totient_factored(mpz_t tot, factored_t *F, unsigned long k);
+extern void carmichael_lambda_factored(mpz_t lambda, factored_t *F);
+extern void znorder_factored(mpz_t res, mpz_t a, factored_t *F);
+extern void znprimroot_factored(mpz_t root, factored_t *F);
+
 extern uint32_t omega(mpz_t n);
 extern uint32_t bigomega(mpz_t n);
 extern void sigma(mpz_t res, mpz_t n, unsigned long k);
@@ -35,6 +62,36 @@ extern unsigned long   power_factor(mpz_t n, mpz_t f);
 
 extern mpz_t* divisor_list(int* ndivisors, mpz_t n);
 
+/* Divisor iterator.  Walks the divisors of n in [lo,hi] without building
+ * the full list.  Ordered mode uses a heap (increasing order), unordered
+ * mode uses an odometer over the exponents with O(omega) memory. */
+typedef struct {
+  mpz_t v;
+  int   k;            /* index of largest prime in v, -1 for 1 */
+  int   e;            /* exponent of that prime */
+} divisor_heap_t;
+
+typedef struct {
+  int      nfactors;
+  mpz_t   *factors;
+  int     *exponents;
+  int      ordered;
+  int      state;     /* 0 = start, 1 = running, 2 = done */
+  int      haslo, hashi;
+  mpz_t    lo, hi;
+  /* unordered */
+  mpz_t    cur;
+  mpz_t   *pk;        /* p[i]^e[i] */
+  int     *e;
+  /* ordered */
+  divisor_heap_t *heap;
+  int      nheap, heapalloc;
+} divisor_iterator;
+
+extern void divisor_iterator_init(divisor_iterator *iter, mpz_t n, mpz_t lo, mpz_t hi, int ordered);
+extern int  divisor_iterator_next(divisor_iterator *iter, mpz_t d);
+extern void divisor_iterator_destroy(divisor_iterator *iter);
+
 extern int is_smooth(mpz_t n, mpz_t k);
 extern int is_rough(mpz_t n, mpz_t k);
 extern int is_powerful(mpz_t n, uint32_t k);
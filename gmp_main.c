@@ -12,6 +12,9 @@
 #include "factor.h"
 #include "real.h"
 #include "random_prime.h"
+#include "lmo.h"
+#include "threadpool.h"
+#include "classpoly.h"
 
 #define FUNC_gcd_ui 1
 #define FUNC_mpz_logn 1
@@ -32,6 +35,12 @@ static mpz_t _bgcd3;
 #define NSMALLPRIMES 168
 static const unsigned short sprimes[NSMALLPRIMES] = {2,3,5,7,11,13,17,19,23,29,31,37,41,43,47,53,59,61,67,71,73,79,83,89,97,101,103,107,109,113,127,131,137,139,149,151,157,163,167,173,179,181,191,193,197,199,211,223,227,229,233,239,241,251,257,263,269,271,277,281,283,293,307,311,313,317,331,337,347,349,353,359,367,373,379,383,389,397,401,409,419,421,431,433,439,443,449,457,461,463,467,479,487,491,499,503,509,521,523,541,547,557,563,569,571,577,587,593,599,601,607,613,617,619,631,641,643,647,653,659,661,673,677,683,691,701,709,719,727,733,739,743,751,757,761,769,773,787,797,809,811,821,823,827,829,839,853,857,859,863,877,881,883,887,907,911,919,929,937,941,947,953,967,971,977,983,991,997};
 
+/* Loops over many primes walk the shared table when it reaches far enough,
+ * which is much cheaper than decoding them one at a time.  Index 0 holds 2,
+ * so pidx starts at 1 to match a fresh iterator. */
+#define NEXT_TABLE_PRIME \
+  ((ptab != 0) ? (UV)ptab[pidx++] : prime_iterator_next(&iter))
+
 #define TSTAVAL(arr, val)   (arr[(val) >> 6] & (1U << (((val)>>1) & 0x1F)))
 #define SETAVAL(arr, val)   arr[(val) >> 6] |= 1U << (((val)>>1) & 0x1F)
 
@@ -46,14 +55,20 @@ void _GMP_init(void)
   prime_iterator_global_startup();
   mpz_init(_bgcd);
   _GMP_pn_primorial(_bgcd, BGCD_PRIMES);   /* mpz_primorial_ui(_bgcd, 1000) */
-  mpz_init_set_ui(_bgcd2, 0);
-  mpz_init_set_ui(_bgcd3, 0);
+  /* Built here rather than on first use, as threads share them. */
+  mpz_init(_bgcd2);
+  _GMP_pn_primorial(_bgcd2, BGCD2_PRIMES);
+  mpz_divexact(_bgcd2, _bgcd2, _bgcd);
+  mpz_init(_bgcd3);
+  _GMP_pn_primorial(_bgcd3, BGCD3_PRIMES);
+  mpz_divexact(_bgcd3, _bgcd3, _bgcd);
   _init_factor();
 }
 
 void _GMP_destroy(void)
 {
   _GMP_memfree();
+  class_poly_db_close();
   prime_iterator_global_shutdown();
   clear_randstate();
   mpz_clear(_bgcd);
@@ -65,6 +80,7 @@ void _GMP_memfree(void)
 {
   free_float_constants();
   destroy_ecpp_gcds();
+  free_class_polys();
   free_borwein_zeta();
   free_bernoulli();
 }
@@ -136,18 +152,10 @@ int primality_pretest(mpz_t n)
 
     /* If we're reasonably large, do a gcd with more primes */
     if (log2n > 700) {
-      if (mpz_sgn(_bgcd3) == 0) {
-        _GMP_pn_primorial(_bgcd3, BGCD3_PRIMES);
-        mpz_divexact(_bgcd3, _bgcd3, _bgcd);
-      }
       mpz_gcd(t, n, _bgcd3);
       if (mpz_cmp_ui(t, 1))
         { mpz_clear(t); return 0; }
     } else if (log2n > 300) {
-      if (mpz_sgn(_bgcd2) == 0) {
-        _GMP_pn_primorial(_bgcd2, BGCD2_PRIMES);
-        mpz_divexact(_bgcd2, _bgcd2, _bgcd);
-      }
       mpz_gcd(t, n, _bgcd2);
       if (mpz_cmp_ui(t, 1))
         { mpz_clear(t); return 0; }
@@ -814,13 +822,14 @@ void factorialmod(mpz_t r, UV N, mpz_t m)
       if ((i & 15) == 0) mpz_mod(t, t, m);
     }
   } else {
-    UV j, sd = isqrt(D);
+    UV j, sd = isqrt(D), pidx = 1;
+    const uint32_t *ptab = prime_table(D, 0);
     PRIME_ITERATOR(iter);
 
     mpz_init(t2);
     mpz_set_ui(t,1);
     /* Group into powers of primes */
-    for (p = 2, i = 0; p <= D/sd; p = prime_iterator_next(&iter)) {
+    for (p = 2, i = 0; p <= D/sd; p = NEXT_TABLE_PRIME) {
       UV td = D/p,  e = td;
       do { td /= p; e += td; } while (td > 0);
       mpz_set_ui(t2, p);
@@ -836,7 +845,7 @@ void factorialmod(mpz_t r, UV N, mpz_t m)
       UV lo = D / (j+1)+1,  hi = D / j;
       MPUassert(p >= lo, "factorialmod prime loop p should be in range");
       /* while (p < lo) p = prime_iterator_next(&iter); */
-      for (mpz_set_ui(t2,1), i=0;  p <= hi;  p = prime_iterator_next(&iter)) {
+      for (mpz_set_ui(t2,1), i=0;  p <= hi;  p = NEXT_TABLE_PRIME) {
         mpz_mul_ui(t2, t2, p);
         if ((i++ & 15) == 0) mpz_mod(t2, t2, m);
       }
@@ -1175,10 +1184,34 @@ void exp_mangoldt(mpz_t res, mpz_t n)
     mpz_set_ui(res, 1);
 }
 
+/* Korselt's criterion given the factorization. */
+int is_carmichael_factored(factored_t *F)
+{
+  mpz_t nm1, t;
+  int i, res;
+
+  if (mpz_cmp_ui(F->n,1105) < 0 || mpz_even_p(F->n))
+    return mpz_cmp_ui(F->n,561)==0;
+
+  res = (F->nfactors > 2);                      /* must have 3+ factors */
+  for (i = 0; res && i < F->nfactors; i++)      /* must be square free  */
+    if (F->exponents[i] > 1)
+      res = 0;
+  mpz_init(nm1);
+  mpz_init(t);
+  mpz_sub_ui(nm1, F->n, 1);
+  for (i = 0; res && i < F->nfactors; i++)      /* p-1 | n-1 for all p */
+    if (mpz_sub_ui(t, F->factors[i], 1), !mpz_divisible_p(nm1, t))
+      res = 0;
+  mpz_clear(t);
+  mpz_clear(nm1);
+  return res;
+}
+
 int is_carmichael(mpz_t n)
 {
-  mpz_t nm1, base, t, *factors;
-  int i, res, nfactors, *exponents;
+  mpz_t nm1, base, t;
+  int i, res;
 
   /* small or even */
   if (mpz_cmp_ui(n,1105) < 0 || mpz_even_p(n))
@@ -1231,15 +1264,10 @@ int is_carmichael(mpz_t n)
 
   } else {                              /* Deterministic test (factor n) */
 
-    nfactors = factor(n, &factors, &exponents);
-    res = (nfactors > 2);                       /* must have 3+ factors */
-    for (i = 0; res && i < nfactors; i++)       /* must be square free  */
-      if (exponents[i] > 1)
-        res = 0;
-    for (i = 0; res && i < nfactors; i++)       /* p-1 | n-1 for all p */
-      if (mpz_sub_ui(t, factors[i], 1), !mpz_divisible_p(nm1, t))
-        res = 0;
-    clear_factors(nfactors, &factors, &exponents);
+    factored_t F;
+    factored_init(&F, n);
+    res = is_carmichael_factored(&F);
+    factored_clear(&F);
 
   }
   mpz_clear(base);  mpz_clear(t);  mpz_clear(nm1);
@@ -1312,8 +1340,8 @@ int is_practical(mpz_t n)
 
 int _totpred(mpz_t n, mpz_t maxd)
 {
-    int i, res, ndivisors;
-    mpz_t N, r, d, p, *D;
+    int res;
+    mpz_t N, r, d, p;
 
     if (mpz_odd_p(n)) return 0;
     if (mpz_cmp_ui(n,2) == 0) return 1;
@@ -1326,10 +1354,12 @@ int _totpred(mpz_t n, mpz_t maxd)
     if (mpz_cmp(N, maxd) < 0 && _GMP_is_prime(p)) {
       res = 1;
     } else {
+      divisor_iterator iter;
       mpz_init(d);  mpz_init(r);
-      D = divisor_list(&ndivisors, N);
-      for (i = 0; res == 0 && i < ndivisors && mpz_cmp(D[i],maxd) < 0; i++) {
-        mpz_set(d, D[i]);
+      /* Walk divisors d < maxd in order, stopping as soon as we succeed. */
+      mpz_sub_ui(r, maxd, 1);
+      divisor_iterator_init(&iter, N, 0, r, 1);
+      while (res == 0 && divisor_iterator_next(&iter, d)) {
         mpz_mul_2exp(p,d,1);  mpz_add_ui(p,p,1);
         if (!_GMP_is_prime(p))
           continue;
@@ -1344,10 +1374,8 @@ int _totpred(mpz_t n, mpz_t maxd)
           mpz_divexact(r, r, p);
         }
       }
+      divisor_iterator_destroy(&iter);
       mpz_clear(r);  mpz_clear(d);
-      for (i = 0; i < ndivisors; i++)
-        mpz_clear(D[i]);
-      Safefree(D);
     }
     mpz_clear(p);  mpz_clear(N);
     return res;
@@ -1436,10 +1464,169 @@ static void sievep_ui(uint32_t* comp, UV pos, UV p, UV len, int verbose) {
 #define sievep(comp, start, p, len, verbose) \
   sievep_ui(comp, (p) - mpz_fdiv_ui((start),(p)), p, len, verbose)
 
+/* Bucket sieve.  The range is processed in segments of BSIEVE_SEGLEN
+ * positions.  Primes smaller than a segment keep their next position in an
+ * array.  Larger primes hit a segment at most once, so each is filed in the
+ * bucket of the segment it next hits, and is only looked at again there.
+ * The buckets form a ring covering the farthest jump of the largest prime.
+ * start mod p is computed once per prime rather than once per window.
+ */
+typedef struct {
+  uint32_t *ent;           /* pairs of (prime, offset in segment) */
+  UV n, max;
+} sbucket_t;
+
+struct bucket_sieve_s {
+  UV         length, wlen, seg, nsegs;
+  UV         nsmall, maxsmall;
+  uint32_t  *sprime;
+  UV        *spos;
+  UV         nring;
+  sbucket_t *ring;
+};
+
+static void _bsieve_file(bucket_sieve_t *bs, UV p, UV pos)
+{
+  sbucket_t *b;
+  if (!(pos & 1)) pos += p;
+  if (p < BSIEVE_SEGLEN) {
+    if (bs->nsmall >= bs->maxsmall) {
+      bs->maxsmall += 4096;
+      Renew(bs->sprime, bs->maxsmall, uint32_t);
+      Renew(bs->spos, bs->maxsmall, UV);
+    }
+    bs->sprime[bs->nsmall] = p;
+    bs->spos[bs->nsmall++] = pos;
+    return;
+  }
+  if (pos >= bs->length) return;
+  b = bs->ring + (pos / BSIEVE_SEGLEN) % bs->nring;
+  if (b->n >= b->max) Renew(b->ent, b->max = 2*b->max + 1024, uint32_t);
+  b->ent[b->n++] = p;
+  b->ent[b->n++] = pos % BSIEVE_SEGLEN;
+}
+
+bucket_sieve_t* bucket_sieve_create(mpz_t start, UV length, UV maxprime)
+{
+  bucket_sieve_t *bs;
+  UV p, p1, p2, doublelim, pidx = 1;
+  const uint32_t *ptab;
+  mpz_t base;
+  PRIME_ITERATOR(iter);
+
+  MPUassert(mpz_odd_p(start), "bucket sieve given even start");
+  MPUassert(length > 0, "bucket sieve given zero length");
+  MPUassert(maxprime <= 4294967295U, "bucket sieve given too large maxprime");
+  if (length & 1) length++;
+
+  mpz_init(base);
+  mpz_sub_ui(base, start, 1);
+  if (mpz_cmp_ui(base, maxprime) <= 0) {
+    mpz_t t;
+    mpz_init(t);
+    mpz_add_ui(t, base, length+1);
+    mpz_sqrt(t, t);
+    if (maxprime > mpz_get_ui(t))
+      maxprime = mpz_get_ui(t);
+    mpz_clear(t);
+  }
+
+  Newz(0, bs, 1, bucket_sieve_t);
+  bs->length = length;
+  bs->wlen = (length+63)/64;
+  bs->nsegs = (length + BSIEVE_SEGLEN - 1) / BSIEVE_SEGLEN;
+  bs->nring = 2 + maxprime / (BSIEVE_SEGLEN/2);
+  Newz(0, bs->ring, bs->nring, sbucket_t);
+
+  ptab = prime_table(maxprime, 0);
+
+  /* Two primes per mpz remainder while the product fits a ulong. */
+  doublelim = (1UL << (sizeof(unsigned long) * 4)) - 1;
+  p1 = NEXT_TABLE_PRIME;
+  p2 = NEXT_TABLE_PRIME;
+  for ( ; p2 <= maxprime && p2 <= doublelim;
+        p1 = NEXT_TABLE_PRIME, p2 = NEXT_TABLE_PRIME ) {
+    UV ddiv = mpz_fdiv_ui(base, p1*p2);
+    _bsieve_file(bs, p1, p1 - (ddiv % p1));
+    _bsieve_file(bs, p2, p2 - (ddiv % p2));
+  }
+  for (p = p1; p <= maxprime; p = (p == p1) ? p2 : NEXT_TABLE_PRIME)
+    _bsieve_file(bs, p, p - mpz_fdiv_ui(base, p));
+  prime_iterator_destroy(&iter);
+  mpz_clear(base);
+  return bs;
+}
+
+UV bucket_sieve_next(bucket_sieve_t *bs, uint32_t* comp)
+{
+  UV i, segstart, segend, segw, pwlen, w0;
+  sbucket_t *b;
+
+  if (bs->seg >= bs->nsegs) return 0;
+  segstart = bs->seg * BSIEVE_SEGLEN;
+  segend = (bs->length - segstart > BSIEVE_SEGLEN) ? segstart + BSIEVE_SEGLEN
+                                                   : bs->length;
+  w0 = segstart / 64;
+  segw = (bs->wlen - w0 > BSIEVE_SEGLEN/64) ? BSIEVE_SEGLEN/64 : bs->wlen - w0;
+
+  /* Tile the tiniest primes, as partial_sieve does. */
+  pwlen = (segw < 3) ? segw : 3;
+  memset(comp, 0x00, pwlen*sizeof(uint32_t));
+  for (i = 0; i < bs->nsmall; i++) {
+    UV p = bs->sprime[i], pos = bs->spos[i];
+    sievep_ui(comp, pos - segstart, p, pwlen*64, 0);
+    /* Move to the first odd multiple at or past segend */
+    if (pos < segend)
+      bs->spos[i] = pos + ((segend - pos + 2*p - 1) / (2*p)) * (2*p);
+    if (i+1 >= bs->nsmall || pwlen * bs->sprime[i+1] >= segw) { i++; break; }
+    word_tile(comp, pwlen, pwlen * bs->sprime[i+1]);
+    pwlen *= bs->sprime[i+1];
+  }
+  word_tile(comp, pwlen, segw);
+
+  for ( ; i < bs->nsmall; i++) {
+    UV p = bs->sprime[i], pos = bs->spos[i];
+    for ( ; pos < segend; pos += 2*p)
+      SETAVAL(comp, pos - segstart);
+    bs->spos[i] = pos;
+  }
+
+  b = bs->ring + bs->seg % bs->nring;
+  for (i = 0; i < b->n; i += 2) {
+    UV p = b->ent[i], off = b->ent[i+1], pos;
+    if (off < segend - segstart)
+      SETAVAL(comp, off);
+    pos = segstart + off + 2*p;
+    if (pos < bs->length) {
+      sbucket_t *nb = bs->ring + (pos / BSIEVE_SEGLEN) % bs->nring;
+      if (nb->n >= nb->max) Renew(nb->ent, nb->max = 2*nb->max + 1024, uint32_t);
+      nb->ent[nb->n++] = p;
+      nb->ent[nb->n++] = pos % BSIEVE_SEGLEN;
+    }
+  }
+  b->n = 0;
+
+  bs->seg++;
+  return segend - segstart;
+}
+
+void bucket_sieve_destroy(bucket_sieve_t *bs)
+{
+  UV i;
+  for (i = 0; i < bs->nring; i++)
+    if (bs->ring[i].ent != 0)
+      Safefree(bs->ring[i].ent);
+  Safefree(bs->ring);
+  if (bs->sprime != 0) Safefree(bs->sprime);
+  if (bs->spos != 0)   Safefree(bs->spos);
+  Safefree(bs);
+}
+
 uint32_t* partial_sieve(mpz_t start, UV length, UV maxprime)
 {
   uint32_t* comp;
-  UV p, wlen, pwlen;
+  UV p, wlen, pwlen, pidx = 1;
+  const uint32_t *ptab;
   int _verbose = get_verbose_level();
   PRIME_ITERATOR(iter);
 
@@ -1448,6 +1635,20 @@ uint32_t* partial_sieve(mpz_t start, UV length, UV maxprime)
      gmp_printf("partial sieve start %Zd  length %lu mark %Zd to %Zd\n", start, length, start, t); */
   MPUassert(mpz_odd_p(start), "partial sieve given even start");
   MPUassert(length > 0, "partial sieve given zero length");
+
+  /* Long and deep: go through the segmented bucket sieve. */
+  if (length >= 4*BSIEVE_SEGLEN && maxprime >= BSIEVE_SEGLEN &&
+      maxprime <= 4294967295U && _verbose <= 3) {
+    bucket_sieve_t *bs = bucket_sieve_create(start, length, maxprime);
+    UV w = 0;
+    New(0, comp, bs->wlen, uint32_t);
+    while (bucket_sieve_next(bs, comp + w))
+      w += BSIEVE_SEGLEN/64;
+    bucket_sieve_destroy(bs);
+    mpz_sub_ui(start, start, 1);
+    return comp;
+  }
+
   mpz_sub_ui(start, start, 1);
   if (length & 1) length++;
 
@@ -1465,14 +1666,15 @@ uint32_t* partial_sieve(mpz_t start, UV length, UV maxprime)
   /* Allocate odds-only array in uint32_t units */
   wlen = (length+63)/64;
   New(0, comp, wlen, uint32_t);
-  p = prime_iterator_next(&iter);
+  ptab = prime_table(maxprime, 0);
+  p = NEXT_TABLE_PRIME;
 
   /* Mark 3, 5, ... by tiling as long as we can. */
   pwlen = (wlen < 3) ? wlen : 3;
   memset(comp, 0x00, pwlen*sizeof(uint32_t));
   while (p <= maxprime) {
     sievep(comp, start, p, pwlen*64, _verbose);
-    p = prime_iterator_next(&iter);
+    p = NEXT_TABLE_PRIME;
     if (pwlen*p >= wlen) break;
     word_tile(comp, pwlen, pwlen*p);
     pwlen *= p;
@@ -1492,16 +1694,16 @@ uint32_t* partial_sieve(mpz_t start, UV length, UV maxprime)
     UV ulim = (maxprime > ULONG_MAX) ? ULONG_MAX : maxprime;
     if (doublelim > maxprime) doublelim = maxprime;
     /* Do 2 primes at a time.  Fewer mpz remainders. */
-    for ( p1 = p, p2 = prime_iterator_next(&iter);
+    for ( p1 = p, p2 = NEXT_TABLE_PRIME;
           p2 <= doublelim;
-          p1 = prime_iterator_next(&iter), p2 = prime_iterator_next(&iter) ) {
+          p1 = NEXT_TABLE_PRIME, p2 = NEXT_TABLE_PRIME ) {
       UV p1p2 = p1 * p2;
       UV ddiv = mpz_fdiv_ui(start, p1p2);
       sievep_ui(comp, p1 - (ddiv % p1), p1, length, _verbose);
       sievep_ui(comp, p2 - (ddiv % p2), p2, length, _verbose);
     }
     if (p1 <= maxprime) sievep(comp, start, p1, length, _verbose);
-    for (p = p2; p <= ulim; p = prime_iterator_next(&iter))
+    for (p = p2; p <= ulim; p = NEXT_TABLE_PRIME)
       sievep(comp, start, p, length, _verbose);
     if (p < maxprime) {
       /* UV is 64-bit, GMP's ui functions are 32-bit.  Sigh. */
@@ -1511,7 +1713,7 @@ uint32_t* partial_sieve(mpz_t start, UV length, UV maxprime)
       mpz_init_set_ui(mp, (p >> 16) >> 16);
       mpz_mul_2exp(mp, mp, 32);
       mpz_add_ui(mp, mp, p & 0xFFFFFFFFUL);
-      for (lastp = p;  p <= maxprime;  lastp=p, p=prime_iterator_next(&iter)) {
+      for (lastp = p;  p <= maxprime;  lastp=p, p=NEXT_TABLE_PRIME) {
         mpz_add_ui(mp, mp, p-lastp);                 /* Calc mp = p */
         mpz_fdiv_r(rem, start, mp);                  /* Calc start % mp */
         if (mpz_cmp_ui(rem, ULONG_MAX) <= 0) {       /* pos = p - (start % p) */
@@ -1758,11 +1960,71 @@ void prime_count_upper(mpz_t pc, mpz_t n)
 }
 /*****************************************************************************/
 
-void prime_count_range(mpz_t count, mpz_t ilo, mpz_t ihi)
+/* Count the primes among the odd numbers in [lo, lo+width-1], lo odd.
+ * Survivors of the sieve to depth are primes if full, else BPSW tested.
+ * Safe to call from worker threads. */
+static UV _count_sieved_range(mpz_t lo, UV width, UV depth, int full)
 {
+  bucket_sieve_t *bs;
   uint32_t* comp;
-  UV i, cnt, hbits, depth, width;
+  UV i, seglen, cnt = 0;
+  mpz_t base, t;
+
+  mpz_init(base);  mpz_init(t);
+  New(0, comp, BSIEVE_SEGLEN/64, uint32_t);
+  bs = bucket_sieve_create(lo, width, depth);
+  mpz_sub_ui(base, lo, 1);
+  while ((seglen = bucket_sieve_next(bs, comp)) > 0) {
+    for (i = 1; i < seglen; i += 2) {
+      if (!TSTAVAL(comp, i) && (full || (mpz_add_ui(t, base, i), _GMP_BPSW(t))))
+        cnt++;
+    }
+    mpz_add_ui(base, base, BSIEVE_SEGLEN);
+  }
+  bucket_sieve_destroy(bs);
+  Safefree(comp);
+  mpz_clear(t);  mpz_clear(base);
+  return cnt;
+}
+
+/* Ranges are split into chunks of an even number of positions, so every
+ * chunk starts on an odd number, and farmed out to the thread pool. */
+#define PAR_MIN_CHUNK  (4*BSIEVE_SEGLEN)
+static UV _par_chunks(UV width, UV *chunklen)
+{
+  UV nthreads = get_thread_count(), nchunks;
+  if (nthreads <= 1 || width < 2*PAR_MIN_CHUNK) return 1;
+  nchunks = width / PAR_MIN_CHUNK;
+  if (nchunks > 8*nthreads) nchunks = 8*nthreads;
+  *chunklen = width / nchunks;
+  *chunklen += (*chunklen & 1);
+  return (width + *chunklen - 1) / *chunklen;
+}
+
+typedef struct {
+  mpz_t lo;
+  UV    width, chunklen, depth;
+  int   full;
+  UV   *counts;
+} pcount_ctx_t;
+
+static void _pcount_chunk(void *vctx, UV c)
+{
+  pcount_ctx_t *ctx = (pcount_ctx_t*) vctx;
+  UV start = c * ctx->chunklen, width = ctx->width - start;
+  mpz_t clo;
+  if (width > ctx->chunklen) width = ctx->chunklen;
+  mpz_init(clo);
+  mpz_add_ui(clo, ctx->lo, start);
+  ctx->counts[c] = _count_sieved_range(clo, width, ctx->depth, ctx->full);
+  mpz_clear(clo);
+}
+
+void prime_count_range(mpz_t count, mpz_t ilo, mpz_t ihi)
+{
+  UV cnt, hbits, depth, width;
   mpz_t lo, hi, shi, t;
+  int full;
 
   mpz_set_ui(count, 0);
 
@@ -1776,6 +2038,29 @@ void prime_count_range(mpz_t count, mpz_t ilo, mpz_t ihi)
      return;
   }
 
+  /* Wide ranges are faster as the difference of two LMO counts. */
+  if (mpz_sizeinbase(ihi,2) <= (size_t)lmo_max_bits()) {
+    int use_lmo;
+    mpz_init(t);
+    mpz_root(t, ihi, 3);
+    mpz_mul(t, t, t);
+    mpz_tdiv_q_2exp(t, t, 6);
+    mpz_init(lo);
+    mpz_sub(lo, ihi, ilo);
+    use_lmo = (mpz_cmp(lo, t) >= 0);
+    if (use_lmo) {
+      prime_count_lmo(count, ihi);
+      if (mpz_cmp_ui(ilo, 2) > 0) {
+        mpz_sub_ui(lo, ilo, 1);
+        prime_count_lmo(t, lo);
+        mpz_sub(count, count, t);
+      }
+    }
+    mpz_clear(lo);
+    mpz_clear(t);
+    if (use_lmo) return;
+  }
+
   mpz_init_set(lo, ilo);
   mpz_init_set(hi, ihi);
 
@@ -1816,20 +2101,38 @@ void prime_count_range(mpz_t count, mpz_t ilo, mpz_t ihi)
   if (mpz_even_p(lo)) mpz_add_ui(lo,lo,1);
   if (mpz_even_p(hi)) mpz_sub_ui(hi,hi,1);
 
-  mpz_init(shi);  /* segment hi */
+  /* Stream the range through the bucket sieve, in parallel chunks if we
+   * have threads.  If the sieve reaches sqrt(hi) the survivors are primes,
+   * otherwise they get a BPSW test. */
+  if (depth > 4294967295U) depth = 4294967295U;
+  mpz_sqrt(t, hi);
+  full = (mpz_cmp_ui(t, depth) <= 0);
+  mpz_init(shi);  /* window hi */
   while (mpz_cmp(lo,hi) <= 0) {
-    mpz_add_ui(shi, lo, 1000000000UL);
+    UV c, nchunks, chunklen;
+    mpz_add_ui(shi, lo, UVCONST(1) << (BITS_PER_WORD-2));
     if (mpz_cmp(shi, hi) > 0)
       mpz_set(shi, hi);
     mpz_sub(t, shi, lo);
     width = mpz_get_ui(t) + 1;
 
-    comp = partial_sieve(lo, width, depth);
-    for (i = 1, cnt = 0; i <= width; i += 2) {
-      if (!TSTAVAL(comp, i) && (mpz_add_ui(t, lo, i), _GMP_BPSW(t)))
-        cnt++;
+    nchunks = _par_chunks(width, &chunklen);
+    if (nchunks <= 1) {
+      cnt = _count_sieved_range(lo, width, depth, full);
+    } else {
+      pcount_ctx_t ctx;
+      mpz_init_set(ctx.lo, lo);
+      ctx.width = width;
+      ctx.chunklen = chunklen;
+      ctx.depth = depth;
+      ctx.full = full;
+      New(0, ctx.counts, nchunks, UV);
+      parallel_for(nchunks, _pcount_chunk, &ctx);
+      for (c = 0, cnt = 0; c < nchunks; c++)
+        cnt += ctx.counts[c];
+      Safefree(ctx.counts);
+      mpz_clear(ctx.lo);
     }
-    Safefree(comp);
 
     mpz_add_ui(lo, shi, 2);
     mpz_add_ui(count, count, cnt);
@@ -1846,6 +2149,117 @@ void prime_count(mpz_t count, mpz_t hi)
   mpz_clear(lo);
 }
 
+/* Find the k-th prime after n, or with forward = 0 the k-th prime counting
+ * down from n inclusive.  Windows are sieved fully if that is cheap,
+ * otherwise partially and the survivors are tested with BPSW. */
+static void _prime_walk(mpz_t res, mpz_t n, UV k, int forward)
+{
+  UV i, width, depth, hbits = mpz_sizeinbase(n,2);
+  uint32_t* comp;
+  mpz_t low, base, t;
+  int full;
+
+  width = (UV) (1.4 * (double)k * (double)hbits);
+  if (width < 65536) width = 65536;
+  if (width > 67108864) width = 67108864;
+  width = 64 * ((width+63)/64);
+
+  mpz_init(low);  mpz_init(base);  mpz_init(t);
+  if (forward) {
+    mpz_add_ui(low, n, mpz_even_p(n) ? 1 : 2);
+  } else {
+    mpz_set(low, n);
+    if (mpz_even_p(low)) mpz_sub_ui(low, low, 1);
+    if (mpz_cmp_ui(low, 4*width) < 0)        /* stay well above sqrt */
+      width = 64 * ((mpz_get_ui(low)/4 + 63)/64);
+    mpz_sub_ui(low, low, width-2);
+  }
+
+  while (1) {
+    mpz_add_ui(t, low, width);
+    mpz_sqrt(t, t);
+    depth = (hbits < 100) ? 50000000UL : hbits*UVCONST(500000);
+    full = (mpz_cmp_ui(t, depth) <= 0);
+    if (full) depth = mpz_get_ui(t);
+
+    mpz_set(base, low);
+    comp = partial_sieve(base, width, depth);    /* base is now low-1 */
+    for (i = 0; i < width/2; i++) {
+      UV j = forward ? 2*i+1 : width-1-2*i;
+      if (!TSTAVAL(comp, j) && (full || (mpz_add_ui(t,base,j),_GMP_BPSW(t)))) {
+        if (--k == 0) {
+          mpz_add_ui(res, base, j);
+          break;
+        }
+      }
+    }
+    Safefree(comp);
+    if (k == 0) break;
+    if (forward)  mpz_add_ui(low, low, width);
+    else          mpz_sub_ui(low, low, width);
+  }
+  mpz_clear(t);  mpz_clear(base);  mpz_clear(low);
+}
+
+/* x with R(x) close to n, by Newton's method using R'(x) ~ 1/log(x). */
+static void _inverse_riemannr(mpz_t x, mpz_t n)
+{
+  unsigned long i, bits = 64 + mpz_sizeinbase(n,2), prec = bits/3.32 + 2;
+  mpf_t fn, fx, r, t;
+
+  mpf_init2(fn, bits);  mpf_init2(fx, bits);  mpf_init2(r, bits);
+  mpf_init2(t, bits);
+
+  /* Start from n * (log n + log log n - 1) */
+  mpf_set_z(fn, n);
+  mpf_log(r, fn);
+  mpf_log(t, r);
+  mpf_add(t, t, r);
+  mpf_sub_ui(t, t, 1);
+  mpf_mul(fx, fn, t);
+
+  for (i = 0; i < 20; i++) {
+    riemannr(r, fx, prec);
+    mpf_sub(r, fn, r);
+    mpf_log(t, fx);
+    mpf_mul(r, r, t);
+    mpf_add(fx, fx, r);
+    if (mpf_cmp_d(r, 1.0) < 0 && mpf_cmp_d(r, -1.0) > 0) break;
+  }
+  mpz_set_f(x, fx);
+  mpf_clear(t);  mpf_clear(r);  mpf_clear(fx);  mpf_clear(fn);
+}
+
+void nth_prime(mpz_t p, mpz_t n)
+{
+  mpz_t c;
+
+  if (mpz_sgn(n) <= 0) { mpz_set_ui(p, 0); return; }
+
+  if (mpz_cmp_ui(n, 100000) < 0) {
+    UV un = mpz_get_ui(n), lim, cnt, *primes;
+    double dn = (double)un;
+    lim = (un < 6) ? 13 : (UV)(dn * (log(dn) + log(log(dn)))) + 1;
+    primes = sieve_to_n(lim, &cnt);
+    mpz_set_ui(p, primes[un-1]);
+    Safefree(primes);
+    return;
+  }
+
+  /* Count once up to an estimate, then sieve to the answer. */
+  mpz_init(c);
+  _inverse_riemannr(p, n);
+  prime_count(c, p);
+  if (mpz_cmp(c, n) < 0) {
+    mpz_sub(c, n, c);
+    _prime_walk(p, p, mpz_get_ui(c), 1);
+  } else {
+    mpz_sub(c, c, n);
+    _prime_walk(p, p, mpz_get_ui(c) + 1, 0);
+  }
+  mpz_clear(c);
+}
+
 
 typedef struct {
   uint32_t nmax;
@@ -1872,14 +2286,50 @@ typedef struct {
             t_ = n1;  n1 = n2;  n2 = t_; \
             t_ = m1;  m1 = m2;  m2 = t_; }
 
-UV* sieve_primes(mpz_t inlow, mpz_t high, UV k, UV *rn) {
-  mpz_t t, low;
-  int test_primality = 0, k_primality = 0, force_full = 0, width2, hbits;
+/* One chunk of a parallel sieve_primes.  Chunk c starts at lo+c*chunklen,
+ * results are offsets from lo-offset, collected in a list per chunk. */
+typedef struct {
+  mpz_t  lo;
+  UV     length, chunklen, k, offset;
+  int    test_primality;
+  vlist *lists;
+} psieve_ctx_t;
+
+static void _psieve_chunk(void *vctx, UV c)
+{
+  psieve_ctx_t *ctx = (psieve_ctx_t*) vctx;
+  UV i, start = c * ctx->chunklen, length = ctx->length - start;
   uint32_t* comp;
-  vlist retlist;
+  vlist list;
+  mpz_t clo, t;
 
-  if (mpz_cmp_ui(inlow, 2) < 0) mpz_set_ui(inlow, 2);
-  if (mpz_cmp(inlow, high) > 0) { *rn = 0; return 0; }
+  if (length > ctx->chunklen) length = ctx->chunklen;
+  INIT_VLIST(list);
+  mpz_init(t);
+  mpz_init(clo);
+  mpz_add_ui(clo, ctx->lo, start);
+  comp = partial_sieve(clo, length, ctx->k);
+  for (i = 1; i <= length; i += 2) {
+    if (!TSTAVAL(comp, i)) {
+      if (!ctx->test_primality || (mpz_add_ui(t,clo,i),_GMP_BPSW(t)))
+        PUSH_VLIST(list, start + i - ctx->offset);
+    }
+  }
+  Safefree(comp);
+  mpz_clear(clo);  mpz_clear(t);
+  ctx->lists[c] = list;
+}
+
+/* Choose the sieve depth for [low,high].  A k of 0, or one reaching
+ * sqrt(high), asks for primes: *k is set to a good depth and *test_primality
+ * says whether the survivors need BPSW, or *k_primality that the sieve is
+ * complete.  Otherwise k is kept and both flags are 0. */
+static void _sieve_primes_depth(mpz_t inlow, mpz_t high, UV *pk,
+                                int *ptest, int *pkprim)
+{
+  mpz_t t;
+  UV k = *pk;
+  int test_primality = 0, k_primality = 0, force_full = 0, width2, hbits;
 
   mpz_init(t);
   mpz_sub(t, high, inlow);
@@ -1913,7 +2363,23 @@ UV* sieve_primes(mpz_t inlow, mpz_t high, UV k, UV *rn) {
     k_primality = 1;           /* Our sieve is complete */
     test_primality = 0;        /* Don't run BPSW */
   }
+  mpz_clear(t);
+  *pk = k;
+  *ptest = test_primality;
+  *pkprim = k_primality;
+}
+
+UV* sieve_primes(mpz_t inlow, mpz_t high, UV k, UV *rn) {
+  mpz_t t, low;
+  int test_primality, k_primality;
+  uint32_t* comp;
+  vlist retlist;
 
+  if (mpz_cmp_ui(inlow, 2) < 0) mpz_set_ui(inlow, 2);
+  if (mpz_cmp(inlow, high) > 0) { *rn = 0; return 0; }
+
+  _sieve_primes_depth(inlow, high, &k, &test_primality, &k_primality);
+  mpz_init(t);
   INIT_VLIST(retlist);
 
   /* If we want small primes, do it quickly */
@@ -1953,8 +2419,35 @@ UV* sieve_primes(mpz_t inlow, mpz_t high, UV k, UV *rn) {
   if (mpz_even_p(high))          mpz_sub_ui(high, high, 1);
 
   if (mpz_cmp(low, high) <= 0) {
-    UV i, length, offset;
+    UV i, length, offset, nchunks, chunklen;
     mpz_sub(t, high, low); length = mpz_get_ui(t) + 1;
+    nchunks = _par_chunks(length, &chunklen);
+    if (nchunks > 1) {
+      psieve_ctx_t ctx;
+      UV c;
+      mpz_init_set(ctx.lo, low);
+      ctx.length = length;
+      ctx.chunklen = chunklen;
+      ctx.k = k;
+      ctx.offset = (mpz_cmp(low, inlow) == 0);  /* low is inlow or inlow+1 */
+      ctx.test_primality = test_primality;
+      New(0, ctx.lists, nchunks, vlist);
+      parallel_for(nchunks, _psieve_chunk, &ctx);
+      for (c = 0; c < nchunks; c++) {
+        vlist *l = ctx.lists + c;
+        if (retlist.nsize + l->nsize > retlist.nmax)
+          Renew(retlist.list, retlist.nmax = retlist.nsize + l->nsize, UV);
+        memcpy(retlist.list + retlist.nsize, l->list, l->nsize * sizeof(UV));
+        retlist.nsize += l->nsize;
+        Safefree(l->list);
+      }
+      Safefree(ctx.lists);
+      mpz_clear(ctx.lo);
+      mpz_clear(low);
+      mpz_clear(t);
+      *rn = retlist.nsize;
+      return retlist.list;
+    }
     /* Get bit array of odds marked with composites(k) marked with 1 */
     comp = partial_sieve(low, length, k);
     mpz_sub(t, low, inlow); offset = mpz_get_ui(t);
@@ -1973,6 +2466,113 @@ UV* sieve_primes(mpz_t inlow, mpz_t high, UV k, UV *rn) {
   return retlist.list;
 }
 
+/* One chunk of sieve_primes_bitmap: bits [c*chunkbits, ...) of the output,
+ * which are words [c*chunkbits/32, ...) as chunkbits is a multiple of 64. */
+typedef struct {
+  mpz_t     lo;
+  UV        nbits, chunkbits, k;
+  int       test_primality;
+  uint32_t *out;
+} pbitmap_ctx_t;
+
+static void _pbitmap_chunk(void *vctx, UV c)
+{
+  pbitmap_ctx_t *ctx = (pbitmap_ctx_t*) vctx;
+  UV i, w, nbits = ctx->nbits - c * ctx->chunkbits, nwords;
+  uint32_t *comp, *out;
+  mpz_t clo, t;
+
+  if (nbits > ctx->chunkbits) nbits = ctx->chunkbits;
+  nwords = (nbits + 31) / 32;
+  out = ctx->out + c * (ctx->chunkbits / 32);
+  mpz_init(t);
+  mpz_init(clo);
+  mpz_add_ui(clo, ctx->lo, 2 * c * ctx->chunkbits);
+  /* Odd value clo+2i is bit 2i+1 of comp, so bit i of its words. */
+  comp = partial_sieve(clo, 2*nbits - 1, ctx->k);
+  for (w = 0; w < nwords; w++) {
+    uint32_t bits = ~comp[w];
+    if (ctx->test_primality && bits != 0) {
+      for (i = 0; i < 32; i++) {
+        if (bits & (1U << i)) {
+          mpz_add_ui(t, clo, 1 + 2*(32*w + i));
+          if (!_GMP_BPSW(t))
+            bits &= ~(1U << i);
+        }
+      }
+    }
+    out[w] = bits;
+  }
+  i = nbits % 32;
+  if (i != 0)
+    out[nwords-1] &= (1U << i) - 1;
+  Safefree(comp);
+  mpz_clear(clo);  mpz_clear(t);
+}
+
+unsigned char* sieve_primes_bitmap(mpz_t inlow, mpz_t high, UV k, UV *nbits)
+{
+  pbitmap_ctx_t ctx;
+  UV nb, nwords, nchunks, chunklen, i;
+  int test_primality, k_primality;
+  unsigned char *bytes;
+  mpz_t t;
+
+  *nbits = 0;
+  if (mpz_sgn(inlow) < 0 || mpz_cmp(inlow, high) > 0) return 0;
+
+  mpz_init(t);
+  mpz_init_set(ctx.lo, inlow);
+  if (mpz_even_p(ctx.lo)) mpz_add_ui(ctx.lo, ctx.lo, 1);
+  if (mpz_cmp(ctx.lo, high) > 0) { mpz_clear(ctx.lo); mpz_clear(t); return 0; }
+  mpz_sub(t, high, ctx.lo);
+  nb = mpz_get_ui(t) / 2 + 1;
+
+  if (k != 1)
+    _sieve_primes_depth(ctx.lo, high, &k, &test_primality, &k_primality);
+  else
+    test_primality = 0;           /* No sieving at all */
+  ctx.nbits = nb;
+  ctx.k = k;
+  ctx.test_primality = test_primality;
+  nchunks = _par_chunks(2*nb, &chunklen);
+  ctx.chunkbits = (nchunks <= 1) ? nb : chunklen/2;
+  ctx.chunkbits = (ctx.chunkbits + 63) & ~(UV)63;
+  nchunks = (nb + ctx.chunkbits - 1) / ctx.chunkbits;
+
+  /* The words are laid out as bytes in place, least significant first, so
+   * bit i is in byte i/8.  One spare byte lets Perl adopt the buffer. */
+  nwords = (nb + 31) / 32;
+  New(0, bytes, 4*nwords + 1, unsigned char);
+  ctx.out = (uint32_t*) bytes;
+  parallel_for(nchunks, _pbitmap_chunk, &ctx);
+  for (i = 0; i < nwords; i++) {
+    uint32_t w = ctx.out[i];
+    bytes[4*i+0] = w;        bytes[4*i+1] = w >> 8;
+    bytes[4*i+2] = w >> 16;  bytes[4*i+3] = w >> 24;
+  }
+
+  /* The sieve removed its own primes and left 1 in. */
+  if (mpz_cmp_ui(ctx.lo, k) <= 0) {
+    UV ulo = mpz_get_ui(ctx.lo), uhi = k, pi, pcnt, *primes;
+    if (mpz_cmp_ui(high, uhi) < 0) uhi = mpz_get_ui(high);
+    primes = sieve_to_n(uhi, &pcnt);
+    for (pi = 1; pi < pcnt; pi++)
+      if (primes[pi] >= ulo) {
+        UV b = (primes[pi] - ulo) / 2;
+        bytes[b/8] |= 1U << (b%8);
+      }
+    Safefree(primes);
+  }
+  if (mpz_cmp_ui(ctx.lo, 1) == 0)
+    bytes[0] &= ~1U;
+
+  mpz_clear(ctx.lo);
+  mpz_clear(t);
+  *nbits = nb;
+  return bytes;
+}
+
 void next_twin_prime(mpz_t res, mpz_t n) {
   mpz_t low, t;
 
@@ -2059,6 +2659,7 @@ UV* sieve_twin_primes(mpz_t low, mpz_t high, UV twin, UV *rn) {
   mpz_sqrt(t, high);
   if (mpz_cmp_ui(t, k) < 0)
     k = mpz_get_ui(t);
+  if (k < 3) k = 3;   /* 3 is off the wheel, so must come from this list */
 
   /* Handle small primes that will get sieved out */
   if (mpz_cmp_ui(low, k) <= 0) {
@@ -2097,20 +2698,165 @@ UV* sieve_twin_primes(mpz_t low, mpz_t high, UV twin, UV *rn) {
 
 #define addmodded(r,a,b,n)  do { r = a + b; if (r >= n) r -= n; } while(0)
 
-UV* sieve_cluster(mpz_t low, mpz_t high, uint32_t* cl, UV nc, UV *rn) {
+/* The first CLUSTER_NPAIRS pairs of sieving primes past the primorial are
+ * applied with a table per pair product, indexed by the residue mod that
+ * product, with the residues mod each product kept in a uint16 array.  The
+ * scoring and compaction have no branches, but the table lookups are
+ * gathers, so this is scalar code.  The remaining primes are applied one
+ * at a time to the residues left, with a bit table per prime. */
+#define CLUSTER_NPAIRS 6
+
+/* Sieving primes go to 1000, or to this past 64 bits where each PRP test
+ * costs much more than filtering. */
+#ifndef CLUSTER_DEEP_LIMIT
+#define CLUSTER_DEEP_LIMIT 10000
+#endif
+
+/* Read-only state shared by the cluster sieve work units.  The range is
+ * split into chunks of ppr, each with the residue list applied. */
+typedef struct {
+  UV    *list;
+  UV     n, nmax, num_mr, num_lucas;
+} cluster_unit_t;
+
+typedef struct {
+  mpz_ptr   low, high;
+  uint32_t *cl;
+  UV        nc, nres, ppr, nchunks, cpb, nslices;
+  UV       *residues;
+  uint16_t *resmod[CLUSTER_NPAIRS];
+  uint32_t  pp[CLUSTER_NPAIRS], startpi, maxpi;
+  char     *crem[CLUSTER_NPAIRS];
+  const uint32_t *primes;       /* The deep filter primes, from 2 */
+  const uint32_t *premoff;      /* Offset of each prime's bits in prem */
+  const unsigned char *prem;
+  int       run_pretests, verbose, count_only;
+  cluster_unit_t *units;
+} cluster_ctx_t;
+
+/* Work unit u: chunks [b*cpb, (b+1)*cpb) and residue slice s. */
+static void _cluster_unit(void *vctx, UV u)
+{
+  const cluster_ctx_t *ctx = (const cluster_ctx_t*) vctx;
+  cluster_unit_t *out = ctx->units + u;
+  const uint32_t *cl = ctx->cl;
+  UV i, nc = ctx->nc, ppr = ctx->ppr, *cres;
+  UV chunk, chunkend, b = u / ctx->nslices, s = u % ctx->nslices;
+  UV rbeg = (s * ctx->nres) / ctx->nslices, rend = ((s+1) * ctx->nres) / ctx->nslices;
+  uint32_t j, rem[CLUSTER_NPAIRS], remadd[CLUSTER_NPAIRS], pi, c;
+  mpz_t low, t;
+
+  chunk = b * ctx->cpb;
+  chunkend = chunk + ctx->cpb;
+  if (chunkend > ctx->nchunks) chunkend = ctx->nchunks;
+
+  out->nmax = ctx->count_only ? 0 : 64;
+  if (!ctx->count_only)
+    New(0, out->list, out->nmax, UV);
+  New(0, cres, rend - rbeg, UV);
+  mpz_init(t);
+  mpz_init(low);
+  mpz_set_ui(low, ppr);
+  mpz_mul_ui(low, low, chunk);
+  mpz_add(low, low, ctx->low);
+
+  for (j = 0; j < CLUSTER_NPAIRS; j++) {
+    rem[j] = mpz_fdiv_ui(low, ctx->pp[j]);
+    remadd[j] = ppr % ctx->pp[j];
+  }
+
+  /* Loop over our chunks, each of size 'ppr' */
+  for ( ; chunk < chunkend; chunk++) {
+
+    uint32_t r, nr, remr, ncres;
+    unsigned long ui_low = (mpz_sizeinbase(low,2) > 8*sizeof(unsigned long)) ? 0 : mpz_get_ui(low);
+
+    /* Reduce the allowed residues for this chunk using more primes */
+
+    { /* Start making a list of this chunk's residues using the pairs */
+      for (r = rbeg, ncres = 0; r < rend; r++) {
+        char ok = 1;
+        for (j = 0; j < CLUSTER_NPAIRS; j++) {
+          addmodded(remr, rem[j], ctx->resmod[j][r], ctx->pp[j]);
+          ok &= ctx->crem[j][remr];
+        }
+        cres[ncres] = ctx->residues[r];
+        ncres += ok;
+      }
+      for (j = 0; j < CLUSTER_NPAIRS; j++)
+        addmodded(rem[j], rem[j], remadd[j], ctx->pp[j]);
+    }
+
+    /* Sieve through more primes one at a time, removing residues. */
+    for (pi = ctx->startpi+2*CLUSTER_NPAIRS; pi < ctx->maxpi && ncres > 0; pi++) {
+      uint32_t p = ctx->primes[pi];
+      uint32_t prem_rem = (ui_low) ? (ui_low % p) : mpz_fdiv_ui(low,p);
+      const unsigned char* prem = ctx->prem + ctx->premoff[pi];
+      /* Check divisibility of each remaining residue with this p */
+      if (ctx->startpi <= 9 || cres[ncres-1] <= 4294967295U - p) {  /* Sums fit 32 bits */
+        for (r = 0, nr = 0; r < ncres; r++) {
+          uint32_t v = (prem_rem+(uint32_t)cres[r]) % p;
+          cres[nr] = cres[r];
+          nr += (prem[v >> 3] >> (v & 7)) & 1;
+        }
+      } else {              /* Residues are 64-bit */
+        for (r = 0, nr = 0; r < ncres; r++) {
+          uint32_t v = (prem_rem+cres[r]) % p;
+          cres[nr] = cres[r];
+          nr += (prem[v >> 3] >> (v & 7)) & 1;
+        }
+      }
+      ncres = nr;
+    }
+    if (ctx->verbose > 2) printf("cluster sieve range has %u residues left\n", ncres);
+
+    /* Now check each of the remaining residues for inclusion */
+    for (r = 0; r < ncres; r++) {
+      i = cres[r];
+      mpz_add_ui(t, low, i);
+      if (mpz_cmp(t, ctx->high) > 0) break;
+      /* Pretest each element if the input is large enough */
+      if (ctx->run_pretests) {
+        for (c = 0; c < nc; c++)
+          if (mpz_add_ui(t, low, i+cl[c]), mpz_gcd(t,t,_bgcd2), mpz_cmp_ui(t,1)) break;
+        if (c != nc) continue;
+      }
+      /* PRP test.  Split BPSW in two for faster rejection. */
+      for (c = 0; c < nc; c++)
+        if (! (mpz_add_ui(t, low, i+cl[c]), out->num_mr++, miller_rabin_ui(t,2)) ) break;
+      if (c != nc) continue;
+      for (c = 0; c < nc; c++)
+        if (! (mpz_add_ui(t, low, i+cl[c]), out->num_lucas++, _GMP_is_lucas_pseudoprime(t,2)) ) break;
+      if (c != nc) continue;
+      if (ctx->count_only)  out->n++;
+      else                  ADDVAL32(out->list, out->n, out->nmax, chunk*ppr + i);
+    }
+    mpz_add_ui(low, low, ppr);
+  }
+  mpz_clear(low);
+  mpz_clear(t);
+  Safefree(cres);
+}
+
+/* With count_only, *rn is the count and no list is made past the small
+ * values, which the caller frees if returned. */
+static UV* _sieve_cluster(mpz_t low, mpz_t high, uint32_t* cl, UV nc, UV *rn,
+                          int count_only) {
   mpz_t t, savelow;
   vlist retlist;
   UV i, ppr, nres, allocres;
   uint32_t const targres = 4000000;
-  uint32_t const maxpi = 168;
-  UV *residues, *cres;
-  uint32_t pp_0, pp_1, pp_2, *resmod_0, *resmod_1, *resmod_2;
-  uint32_t rem_0, rem_1, rem_2, remadd_0, remadd_1, remadd_2;
+  UV maxpi;
+  UV *residues;
+  uint32_t pp[CLUSTER_NPAIRS];
+  uint16_t *resmod[CLUSTER_NPAIRS];
   uint32_t pi, startpi = 1;
-  uint32_t lastspr = sprimes[maxpi-1];
-  uint32_t c, smallnc;
-  UV ibase = 0, num_mr = 0, num_lucas = 0;
-  char crem_0[53*59], crem_1[61*67], crem_2[71*73], *VPrem;
+  uint32_t lastspr, *premoff;
+  uint32_t c;
+  const uint32_t *primes;
+  unsigned char *prem;
+  UV num_mr = 0, num_lucas = 0;
+  char *crem[CLUSTER_NPAIRS];
   int run_pretests = 0;
   int _verbose = get_verbose_level();
 
@@ -2125,12 +2871,15 @@ UV* sieve_cluster(mpz_t low, mpz_t high, uint32_t* cl, UV nc, UV *rn) {
   INIT_VLIST(retlist);
   mpz_init(t);
 
+  primes = prime_table((mpz_sizeinbase(high,2) > 64) ? CLUSTER_DEEP_LIMIT : 1000, &maxpi);
+  lastspr = primes[maxpi-1];
+
   /* Handle small values that would get sieved away */
   if (mpz_cmp_ui(low, lastspr) <= 0) {
     UV ui_low = mpz_get_ui(low);
     UV ui_high = (mpz_cmp_ui(high,lastspr) > 0) ? lastspr : mpz_get_ui(high);
     for (pi = 0; pi < maxpi; pi++) {
-      UV p = sprimes[pi];
+      UV p = primes[pi];
       if (p > ui_high) break;
       if (p < ui_low) continue;
       for (c = 1; c < nc; c++)
@@ -2206,157 +2955,350 @@ UV* sieve_cluster(mpz_t low, mpz_t high, uint32_t* cl, UV nc, UV *rn) {
 
   mpz_init_set(savelow, low);
   if (mpz_sizeinbase(low, 2) > 310) run_pretests = 1;
-  if (run_pretests && mpz_sgn(_bgcd2) == 0) {
-    _GMP_pn_primorial(_bgcd2, BGCD2_PRIMES);
-    mpz_divexact(_bgcd2, _bgcd2, _bgcd);
-  }
 
-  /* Pre-mod the residues with first two primes for fewer modulos every chunk */
+  /* Tables of composite-marking remainders for each pair of primes, and
+   * the residues mod each pair product. */
   {
-    uint32_t p1 = sprimes[startpi+0], p2 = sprimes[startpi+1];
-    uint32_t p3 = sprimes[startpi+2], p4 = sprimes[startpi+3];
-    uint32_t p5 = sprimes[startpi+4], p6 = sprimes[startpi+5];
-    pp_0 = p1*p2; pp_1 = p3*p4; pp_2 = p5*p6;
-    memset(crem_0, 1, pp_0);
-    memset(crem_1, 1, pp_1);
-    memset(crem_2, 1, pp_2);
-    /* Mark remainders that indicate a composite for this residue. */
-    for (i = 0; i < p1; i++) { crem_0[i*p1]=0; crem_0[i*p2]=0; }
-    for (     ; i < p2; i++) { crem_0[i*p1]=0;                }
-    for (i = 0; i < p3; i++) { crem_1[i*p3]=0; crem_1[i*p4]=0; }
-    for (     ; i < p4; i++) { crem_1[i*p3]=0;                }
-    for (i = 0; i < p5; i++) { crem_2[i*p5]=0; crem_2[i*p6]=0; }
-    for (     ; i < p6; i++) { crem_2[i*p5]=0;                }
-    for (c = 1; c < nc; c++) {
-      uint32_t c1=cl[c], c2=cl[c], c3=cl[c], c4=cl[c], c5=cl[c], c6=cl[c];
-      if (c1 >= p1) c1 %= p1;
-      if (c2 >= p2) c2 %= p2;
-      for (i = 1; i <= p1; i++) { crem_0[i*p1-c1]=0; crem_0[i*p2-c2]=0; }
-      for (     ; i <= p2; i++) { crem_0[i*p1-c1]=0;                   }
-      if (c3 >= p3) c3 %= p3;
-      if (c4 >= p4) c4 %= p4;
-      for (i = 1; i <= p3; i++) { crem_1[i*p3-c3]=0; crem_1[i*p4-c4]=0; }
-      for (     ; i <= p4; i++) { crem_1[i*p3-c3]=0;                   }
-      if (c5 >= p5) c5 %= p5;
-      if (c6 >= p6) c6 %= p6;
-      for (i = 1; i <= p5; i++) { crem_2[i*p5-c5]=0; crem_2[i*p6-c6]=0; }
-      for (     ; i <= p6; i++) { crem_2[i*p5-c5]=0;                   }
-    }
-    New(0, resmod_0, nres, uint32_t);
-    New(0, resmod_1, nres, uint32_t);
-    New(0, resmod_2, nres, uint32_t);
-    for (i = 0; i < nres; i++) {
-      resmod_0[i] = residues[i] % pp_0;
-      resmod_1[i] = residues[i] % pp_1;
-      resmod_2[i] = residues[i] % pp_2;
-    }
-  }
-
-  /* Precalculate acceptable residues for more primes */
-  MPUassert( lastspr <= 1024, "cluster sieve internal" );
-  New(0, VPrem, maxpi * 1024, char);
-  memset(VPrem, 1, maxpi * 1024);
-  for (pi = startpi+6; pi < maxpi; pi++)
-    VPrem[pi*1024] = 0;
-  for (pi = startpi+6, smallnc = 0; pi < maxpi; pi++) {
-    uint32_t p = sprimes[pi];
-    char* prem = VPrem + pi*1024;
-    while (smallnc < nc && cl[smallnc] < p)   smallnc++;
-    for (c = 1; c < smallnc; c++) prem[p-cl[c]] = 0;
-    for (     ; c <      nc; c++) prem[p-(cl[c]%p)] = 0;
-  }
-
-  New(0, cres, nres, UV);
-
-  rem_0 = mpz_fdiv_ui(low,pp_0);  remadd_0 = ppr % pp_0;
-  rem_1 = mpz_fdiv_ui(low,pp_1);  remadd_1 = ppr % pp_1;
-  rem_2 = mpz_fdiv_ui(low,pp_2);  remadd_2 = ppr % pp_2;
-
-  /* Loop over their range in chunks of size 'ppr' */
-  while (mpz_cmp(low, high) <= 0) {
-
-    uint32_t r, nr, remr, ncres;
-    unsigned long ui_low = (mpz_sizeinbase(low,2) > 8*sizeof(unsigned long)) ? 0 : mpz_get_ui(low);
-
-    /* Reduce the allowed residues for this chunk using more primes */
-
-    { /* Start making a list of this chunk's residues using three pairs */
-      for (r = 0, ncres = 0; r < nres; r++) {
-        addmodded(remr, rem_0, resmod_0[r], pp_0);
-        if (crem_0[remr]) {
-          addmodded(remr, rem_1, resmod_1[r], pp_1);
-          if (crem_1[remr]) {
-            addmodded(remr, rem_2, resmod_2[r], pp_2);
-            if (crem_2[remr]) {
-              cres[ncres++] = residues[r];
-            }
-          }
-        }
+    uint32_t j, csize = 0;
+    for (j = 0; j < CLUSTER_NPAIRS; j++) {
+      pp[j] = (uint32_t)sprimes[startpi+2*j] * sprimes[startpi+2*j+1];
+      csize += pp[j];
+    }
+    New(0, crem[0], csize, char);
+    memset(crem[0], 1, csize);
+    for (j = 1; j < CLUSTER_NPAIRS; j++)
+      crem[j] = crem[j-1] + pp[j-1];
+    for (j = 0; j < CLUSTER_NPAIRS; j++) {
+      uint32_t p1 = sprimes[startpi+2*j], p2 = sprimes[startpi+2*j+1];
+      uint32_t o1, o2;
+      for (c = 0; c < nc; c++) {
+        o1 = (p1 - cl[c] % p1) % p1;
+        o2 = (p2 - cl[c] % p2) % p2;
+        for (i = 0; i < p2; i++)  crem[j][i*p1 + o1] = 0;
+        for (i = 0; i < p1; i++)  crem[j][i*p2 + o2] = 0;
       }
-      addmodded(rem_0, rem_0, remadd_0, pp_0);
-      addmodded(rem_1, rem_1, remadd_1, pp_1);
-      addmodded(rem_2, rem_2, remadd_2, pp_2);
+      New(0, resmod[j], nres, uint16_t);
+      for (i = 0; i < nres; i++)
+        resmod[j][i] = residues[i] % pp[j];
     }
+  }
 
-    /* Sieve through more primes one at a time, removing residues. */
-    for (pi = startpi+6; pi < maxpi && ncres > 0; pi++) {
-      uint32_t p = sprimes[pi];
-      uint32_t rem = (ui_low) ? (ui_low % p) : mpz_fdiv_ui(low,p);
-      char* prem = VPrem + pi*1024;
-      /* Check divisibility of each remaining residue with this p */
-      if (startpi <= 9 || cres[ncres-1] < 4294967295U) {   /* Residues are 32-bit */
-        for (r = 0, nr = 0; r < ncres; r++) {
-          if (prem[ (rem+(uint32_t)cres[r]) % p ])
-            cres[nr++] = cres[r];
-        }
-      } else {              /* Residues are 64-bit */
-        for (r = 0, nr = 0; r < ncres; r++) {
-          if (prem[ (rem+cres[r]) % p ])
-            cres[nr++] = cres[r];
-        }
-      }
-      ncres = nr;
+  /* Bit tables of acceptable residues for the rest of the primes, bit v
+   * of a prime's table set unless v+cl[c] is divisible by p for some c. */
+  New(0, premoff, maxpi, uint32_t);
+  for (pi = startpi+2*CLUSTER_NPAIRS, i = 0; pi < maxpi; pi++) {
+    premoff[pi] = i;
+    i += (primes[pi] + 7) / 8;
+  }
+  New(0, prem, i + 1, unsigned char);
+  memset(prem, 0xFF, i + 1);
+  for (pi = startpi+2*CLUSTER_NPAIRS; pi < maxpi; pi++) {
+    uint32_t p = primes[pi];
+    unsigned char* pbits = prem + premoff[pi];
+    for (c = 0; c < nc; c++) {
+      uint32_t v = (p - cl[c] % p) % p;
+      pbits[v >> 3] &= ~(1U << (v & 7));
     }
-    if (_verbose > 2) printf("cluster sieve range has %u residues left\n", ncres);
+  }
 
-    /* Now check each of the remaining residues for inclusion */
-    for (r = 0; r < ncres; r++) {
-      i = cres[r];
-      mpz_add_ui(t, low, i);
-      if (mpz_cmp(t, high) > 0) break;
-      /* Pretest each element if the input is large enough */
-      if (run_pretests) {
-        for (c = 0; c < nc; c++)
-          if (mpz_add_ui(t, low, i+cl[c]), mpz_gcd(t,t,_bgcd2), mpz_cmp_ui(t,1)) break;
-        if (c != nc) continue;
+  /* Fill in the shared tables and split the work into units. */
+  {
+    cluster_ctx_t ctx;
+    UV u, nunits, nthreads = get_thread_count();
+
+    ctx.low = low;
+    ctx.high = high;
+    ctx.cl = cl;  ctx.nc = nc;
+    ctx.residues = residues;  ctx.nres = nres;  ctx.ppr = ppr;
+    memcpy(ctx.resmod, resmod, sizeof(resmod));
+    memcpy(ctx.crem, crem, sizeof(crem));
+    memcpy(ctx.pp, pp, sizeof(pp));
+    ctx.primes = primes;  ctx.premoff = premoff;  ctx.prem = prem;
+    ctx.startpi = startpi;  ctx.maxpi = maxpi;
+    ctx.run_pretests = run_pretests;
+    ctx.verbose = _verbose;
+    ctx.count_only = count_only;
+
+    mpz_sub(t, high, low);
+    mpz_fdiv_q_ui(t, t, ppr);
+    ctx.nchunks = mpz_get_ui(t) + 1;
+    /* Threads get blocks of chunks, or slices of the residues of each chunk
+     * when there are few chunks.  Units are in output order either way. */
+    ctx.cpb = ctx.nchunks;
+    ctx.nslices = 1;
+    if (nthreads > 1 && (ctx.nchunks > 1 || nres >= 1024)) {
+      UV want = 8 * nthreads;
+      if (ctx.nchunks >= want) {
+        ctx.cpb = (ctx.nchunks + want - 1) / want;
+      } else {
+        ctx.cpb = 1;
+        ctx.nslices = (want + ctx.nchunks - 1) / ctx.nchunks;
+        if (ctx.nslices > nres) ctx.nslices = nres;
       }
-      /* PRP test.  Split BPSW in two for faster rejection. */
-      for (c = 0; c < nc; c++)
-        if (! (mpz_add_ui(t, low, i+cl[c]), num_mr++, miller_rabin_ui(t,2)) ) break;
-      if (c != nc) continue;
-      for (c = 0; c < nc; c++)
-        if (! (mpz_add_ui(t, low, i+cl[c]), num_lucas++, _GMP_is_lucas_pseudoprime(t,2)) ) break;
-      if (c != nc) continue;
-      PUSH_VLIST(retlist, ibase + i);
     }
-    ibase += ppr;
-    mpz_add_ui(low, low, ppr);
+    nunits = ((ctx.nchunks + ctx.cpb - 1) / ctx.cpb) * ctx.nslices;
+
+    Newz(0, ctx.units, nunits, cluster_unit_t);
+    parallel_for(nunits, _cluster_unit, &ctx);
+    for (u = 0; u < nunits; u++) {
+      cluster_unit_t *cu = ctx.units + u;
+      num_mr += cu->num_mr;
+      num_lucas += cu->num_lucas;
+      if (count_only) { retlist.nsize += cu->n;  continue; }
+      if (retlist.nsize + cu->n > retlist.nmax)
+        Renew(retlist.list, retlist.nmax = retlist.nsize + cu->n, UV);
+      if (cu->n > 0)
+        memcpy(retlist.list + retlist.nsize, cu->list, cu->n * sizeof(UV));
+      retlist.nsize += cu->n;
+      Safefree(cu->list);
+    }
+    Safefree(ctx.units);
   }
 
   if (_verbose) printf("cluster sieve ran %"UVuf" MR and %"UVuf" Lucas tests (pretests %s)\n", num_mr, num_lucas, run_pretests ? "on" : "off");
   mpz_set(low, savelow);
-  Safefree(cres);
-  Safefree(VPrem);
-  Safefree(resmod_0);
-  Safefree(resmod_1);
-  Safefree(resmod_2);
+  Safefree(prem);
+  Safefree(premoff);
+  for (pi = 0; pi < CLUSTER_NPAIRS; pi++)
+    Safefree(resmod[pi]);
+  Safefree(crem[0]);
   Safefree(residues);
   mpz_clear(savelow);
   mpz_clear(t);
   *rn = retlist.nsize;
+  if (count_only) { Safefree(retlist.list);  return 0; }
   return retlist.list;
 }
 
+UV* sieve_cluster(mpz_t low, mpz_t high, uint32_t* cl, UV nc, UV *rn) {
+  return _sieve_cluster(low, high, cl, nc, rn, 0);
+}
+
+/* Pairs count fastest with the deep sieve of sieve_twin_primes, which we
+ * run over chunks of the range in parallel. */
+typedef struct {
+  mpz_t lo, hi;
+  UV    chunklen, twin;
+  UV   *counts;
+} tcount_ctx_t;
+
+static void _tcount_chunk(void *vctx, UV c)
+{
+  tcount_ctx_t *ctx = (tcount_ctx_t*) vctx;
+  mpz_t lo, hi;
+  UV n, *list;
+
+  mpz_init(lo);
+  mpz_init(hi);
+  mpz_add_ui(lo, ctx->lo, c * ctx->chunklen);
+  mpz_add_ui(hi, lo, ctx->chunklen - 1);
+  if (mpz_cmp(hi, ctx->hi) > 0)
+    mpz_set(hi, ctx->hi);
+  list = sieve_twin_primes(lo, hi, ctx->twin, &n);
+  if (list != 0) Safefree(list);
+  ctx->counts[c] = n;
+  mpz_clear(hi);
+  mpz_clear(lo);
+}
+
+static UV _count_pairs(mpz_t lo, mpz_t hi, UV twin)
+{
+  tcount_ctx_t ctx;
+  UV c, n, nchunks, chunklen, *list;
+
+  mpz_init(ctx.hi);
+  mpz_sub(ctx.hi, hi, lo);
+  nchunks = _par_chunks(mpz_get_ui(ctx.hi) + 1, &chunklen);
+  if (nchunks <= 1) {
+    mpz_clear(ctx.hi);
+    list = sieve_twin_primes(lo, hi, twin, &n);
+    if (list != 0) Safefree(list);
+    return n;
+  }
+  mpz_init_set(ctx.lo, lo);
+  mpz_set(ctx.hi, hi);
+  ctx.chunklen = chunklen;
+  ctx.twin = twin;
+  New(0, ctx.counts, nchunks, UV);
+  parallel_for(nchunks, _tcount_chunk, &ctx);
+  for (c = 0, n = 0; c < nchunks; c++)
+    n += ctx.counts[c];
+  Safefree(ctx.counts);
+  mpz_clear(ctx.hi);
+  mpz_clear(ctx.lo);
+  return n;
+}
+
+void cluster_count(mpz_t count, mpz_t low, mpz_t high, uint32_t* cl, UV nc)
+{
+  mpz_t lo, seghigh, t;
+  UV n, *list, maxseg = ((UV_MAX > ULONG_MAX) ? ULONG_MAX : UV_MAX);
+
+  mpz_set_ui(count, 0);
+  if (nc == 1) { prime_count_range(count, low, high); return; }
+
+  mpz_init_set(lo, low);
+  mpz_init(seghigh);
+  mpz_init(t);
+  while (mpz_cmp(lo, high) <= 0) {
+    mpz_add_ui(seghigh, lo, maxseg - 1);
+    if (mpz_cmp(seghigh, high) > 0)
+      mpz_set(seghigh, high);
+    mpz_set(t, seghigh);  /* Save in case it is modified */
+    if (nc == 2) {
+      n = _count_pairs(lo, seghigh, cl[1]);
+    } else {
+      list = _sieve_cluster(lo, seghigh, cl, nc, &n, 1);
+      if (list != 0) Safefree(list);
+    }
+    mpz_add_ui(count, count, n);
+    mpz_add_ui(lo, t, 1);
+  }
+  mpz_clear(t);
+  mpz_clear(seghigh);
+  mpz_clear(lo);
+}
+
+/* Hardy-Littlewood: the count is about C * integral of dt / log(t)^nc over
+ * the range, where C is the product over primes p of
+ * (1 - w(p)/p) / (1 - 1/p)^nc, and w(p) is the number of distinct cl[i] mod
+ * p.  Terms past p are 1 - O(nc^2/p^2), so the product is taken to 10^6
+ * and the tail estimated. */
+#define HL_PRIME_LIMIT  1000000
+#define HL_STEPS        2048
+
+static double _hl_log_constant(uint32_t* cl, UV nc)
+{
+  const uint32_t *primes;
+  UV i, j, pi, np, w;
+  double logc = 0;
+
+  primes = prime_table(HL_PRIME_LIMIT, &np);
+  for (pi = 0; pi < np; pi++) {
+    UV p = primes[pi];
+    if (p > cl[nc-1]) {
+      w = nc;
+    } else {
+      for (i = 0, w = 0; i < nc; i++) {
+        for (j = 0; j < i; j++)
+          if ((cl[j] % p) == (cl[i] % p)) break;
+        w += (j == i);
+      }
+    }
+    if (w >= p) return -HUGE_VAL;      /* Not admissible */
+    logc += log(1.0 - (double)w/p) - nc * log(1.0 - 1.0/p);
+  }
+  logc -= 0.5 * nc * (nc-1) / (HL_PRIME_LIMIT * log((double)HL_PRIME_LIMIT));
+  return logc;
+}
+
+void cluster_count_approx(mpz_t count, mpz_t low, mpz_t high, uint32_t* cl, UV nc)
+{
+  mpz_t lo, base;
+  mpf_t f, x;
+  double logc, logl, logh, fac, sum = 0, h;
+  UV i;
+
+  mpz_set_ui(count, 0);
+  if (mpz_cmp_ui(high, 2) < 0 || mpz_cmp(low, high) > 0) return;
+  logc = _hl_log_constant(cl, nc);
+  if (logc == -HUGE_VAL) {            /* At most the tiny exceptions */
+    cluster_count(count, low, high, cl, nc);
+    return;
+  }
+
+  mpz_init(lo);
+  mpz_init(base);
+  if (mpz_cmp_ui(low, 2) < 0) mpz_set_ui(lo, 2);
+  else                        mpz_set(lo, low);
+  logl = mpz_logn(lo);
+  logh = mpz_logn(high);
+
+  if (logh - logl < 0.69) {
+    /* hi < 2*lo: integrate over t = lo + s*(hi-lo), as (hi-lo) * mean. */
+    double r;
+    mpz_sub(base, high, lo);
+    if (mpz_sgn(base) == 0) mpz_set_ui(base, 1);
+    r = exp(mpz_logn(base) - logl);
+    h = 1.0 / HL_STEPS;
+    for (i = 0; i <= HL_STEPS; i++) {
+      double u = logl + log1p(r * i * h);
+      double wt = (i == 0 || i == HL_STEPS) ? 1 : (i & 1) ? 4 : 2;
+      sum += wt * exp(-(double)nc * log(u));
+    }
+    fac = sum * h / 3;
+  } else {
+    /* Over u = log t, as hi * integral of e^(u-logh) / u^nc.  Below about
+     * logh-50 the integrand is negligible. */
+    if (logl < logh - 50) logl = logh - 50;
+    mpz_set(base, high);
+    h = (logh - logl) / HL_STEPS;
+    for (i = 0; i <= HL_STEPS; i++) {
+      double u = logl + i * h;
+      double wt = (i == 0 || i == HL_STEPS) ? 1 : (i & 1) ? 4 : 2;
+      sum += wt * exp((u - logh) - (double)nc * log(u));
+    }
+    fac = sum * h / 3;
+  }
+  fac *= exp(logc);
+
+  mpf_init2(f, 64 + mpz_sizeinbase(base, 2));
+  mpf_init2(x, 64);
+  mpf_set_z(f, base);
+  mpf_set_d(x, fac);
+  mpf_mul(f, f, x);
+  mpf_set_d(x, 0.5);
+  mpf_add(f, f, x);
+  mpz_set_f(count, f);
+  mpf_clear(x);  mpf_clear(f);
+  mpz_clear(base);  mpz_clear(lo);
+}
+
+/* Walk [low,high] in windows, handing each prime (nc = 0, sieved to depth
+ * k as in sieve_primes) or cluster start (nc >= 1, as in sieve_cluster)
+ * to fn in increasing order.  Windows start small so the first results
+ * come quickly, and then adapt so each holds a bounded number of results.
+ * Stops early when fn returns nonzero. */
+#define STREAM_MIN_WINDOW   (UVCONST(1) << 16)
+#define STREAM_MAX_RESULTS  (UVCONST(1) << 18)
+void sieve_stream(mpz_t low, mpz_t high, UV k, uint32_t* cl, UV nc,
+                  sieve_stream_fn fn, void *ctx)
+{
+  mpz_t lo, hi, seglo, seghi, t;
+  UV i, n, *list, window = STREAM_MIN_WINDOW;
+  UV maxwindow = ((UV_MAX > ULONG_MAX) ? ULONG_MAX : UV_MAX) >> 1;
+  int stop = 0;
+
+  mpz_init_set(lo, low);
+  mpz_init_set(hi, high);
+  if (mpz_cmp_ui(lo, 2) < 0) mpz_set_ui(lo, 2);
+  mpz_init(seglo);  mpz_init(seghi);  mpz_init(t);
+
+  while (!stop && mpz_cmp(lo, hi) <= 0) {
+    mpz_add_ui(seghi, lo, window - 1);
+    if (mpz_cmp(seghi, hi) > 0)
+      mpz_set(seghi, hi);
+    mpz_set(seglo, lo);
+    mpz_add_ui(lo, seghi, 1);    /* Before the sieve modifies seghi */
+    list = (nc == 0) ? sieve_primes(seglo, seghi, k, &n)
+                     : sieve_cluster(seglo, seghi, cl, nc, &n);
+    if (list != 0) {
+      for (i = 0; i < n && !stop; i++) {
+        mpz_add_ui(t, seglo, list[i]);
+        stop = fn(ctx, t);
+      }
+      Safefree(list);
+    }
+    /* Aim for between 1/4 and all of the result limit per window. */
+    if (n > STREAM_MAX_RESULTS && window > STREAM_MIN_WINDOW)
+      window >>= 1;
+    else if (n < STREAM_MAX_RESULTS/4 && window <= maxwindow)
+      window <<= 1;
+  }
+  mpz_clear(t);  mpz_clear(seghi);  mpz_clear(seglo);
+  mpz_clear(hi);  mpz_clear(lo);
+}
+
 static uint32_t* _todigits32(uint32_t *ndigits, uint32_t n, uint32_t base) {
   uint32_t bits[32];
   uint32_t *digits, i, d;
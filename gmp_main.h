@@ -3,6 +3,7 @@
 
 #include <gmp.h>
 #include "ptypes.h"
+#include "factor.h"
 
 extern void _GMP_init(void);
 extern void _GMP_destroy(void);
@@ -33,6 +34,7 @@ extern void faulhaber_sum(mpz_t sum, mpz_t zn, unsigned long p);
 extern void powerful_count(mpz_t r, mpz_t n, unsigned long k);
 
 extern int  is_carmichael(mpz_t n);
+extern int  is_carmichael_factored(factored_t *F);
 extern int  is_fundamental(mpz_t n);
 extern int  is_practical(mpz_t n);
 extern int  is_totient(mpz_t n);
@@ -42,14 +44,41 @@ extern void exp_mangoldt(mpz_t res, mpz_t n);
 
 extern uint32_t* partial_sieve(mpz_t start, UV length, UV maxprime);
 
+/* Segmented sieve of the odd numbers in [start, start+length), start odd,
+ * by primes up to maxprime (< 2^32).  Each call to bucket_sieve_next fills
+ * comp with the next BSIEVE_SEGLEN positions in partial_sieve's format,
+ * relative to (start-1) + k*BSIEVE_SEGLEN, and returns the number of
+ * positions filled, or 0 when the range is done. */
+#define BSIEVE_SEGLEN  (UVCONST(1) << 21)
+typedef struct bucket_sieve_s bucket_sieve_t;
+extern bucket_sieve_t* bucket_sieve_create(mpz_t start, UV length, UV maxprime);
+extern UV   bucket_sieve_next(bucket_sieve_t *bs, uint32_t* comp);
+extern void bucket_sieve_destroy(bucket_sieve_t *bs);
+
 extern void prime_count_lower(mpz_t pc, mpz_t n);
 extern void prime_count_upper(mpz_t pc, mpz_t n);
 extern UV* sieve_primes(mpz_t low, mpz_t high, UV k, UV *rn);
 extern UV* sieve_twin_primes(mpz_t low, mpz_t high, UV twin, UV *rn);
 extern UV* sieve_cluster(mpz_t low, mpz_t high, uint32_t* cl, UV nc, UV *rn);
+/* Number of n in [low,high] with every n+cl[i] prime, by sieving, and the
+ * Hardy-Littlewood estimate of it.  cl[0] = 0, as for sieve_cluster. */
+extern void cluster_count(mpz_t count, mpz_t low, mpz_t high, uint32_t* cl, UV nc);
+extern void cluster_count_approx(mpz_t count, mpz_t low, mpz_t high, uint32_t* cl, UV nc);
+/* sieve_primes as a bitmap over the odd numbers from low (rounded up to odd)
+ * to high: bit i, in byte i/8 at bit i%8, is set if low+2i is prime, or with
+ * 1 < k < sqrt(high) has no prime factor <= k.  k = 1 does no sieving.  The
+ * buffer has a spare byte at the end, *nbits is set to the number of bits. */
+extern unsigned char* sieve_primes_bitmap(mpz_t low, mpz_t high, UV k, UV *nbits);
+/* Streaming version of the above.  Calls fn for each value in order,
+ * stopping when it returns nonzero.  nc = 0 selects sieve_primes with
+ * depth k, otherwise sieve_cluster with cl[0..nc-1]. */
+typedef int (*sieve_stream_fn)(void *ctx, mpz_t v);
+extern void sieve_stream(mpz_t low, mpz_t high, UV k, uint32_t* cl, UV nc,
+                         sieve_stream_fn fn, void *ctx);
 
 extern void prime_count(mpz_t count, mpz_t hi);
 extern void prime_count_range(mpz_t count, mpz_t lo, mpz_t hi);
+extern void nth_prime(mpz_t p, mpz_t n);
 
 extern void prime_power_count(mpz_t r, mpz_t n);
 extern void prime_power_count_range(mpz_t r, mpz_t lo, mpz_t hi);
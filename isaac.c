@@ -8,6 +8,7 @@
 #include <string.h>
 #include "ptypes.h"
 #include "isaac.h"
+#include "threadpool.h"
 
 /* Ensure big-endian and little-endian get the same results */
 #if __LITTLE_ENDIAN__ || (defined(BYTEORDER) && (BYTEORDER == 0x1234 || BYTEORDER == 0x12345678))
@@ -142,8 +143,15 @@ void isaac_init(uint32_t bytes, const unsigned char* data)
 
 int isaac_seeded(void) { return good_seed; }
 
+/* The generator state is shared, so callers on worker threads take turns.
+ * With a single thread there is nobody to wait for. */
+#define ISAAC_LOCK    int _locked = (get_thread_count() > 1); \
+                      if (_locked) parallel_lock()
+#define ISAAC_UNLOCK  if (_locked) parallel_unlock()
+
 void isaac_rand_bytes(uint32_t bytes, unsigned char* data)
 {
+  ISAAC_LOCK;
   if ( 4*(256-randcnt) >= bytes) {
     /* We have enough data, just copy it and leave */
     COPYRSL(data, randrsl, randcnt, bytes);
@@ -162,12 +170,17 @@ void isaac_rand_bytes(uint32_t bytes, unsigned char* data)
       bytes -= n_copy_bytes;
     }
   }
+  ISAAC_UNLOCK;
 }
 
 uint32_t isaac_rand32(void)
 {
+  uint32_t r;
+  ISAAC_LOCK;
   if (randcnt > 255) isaac();
-  return randrsl[randcnt++];
+  r = randrsl[randcnt++];
+  ISAAC_UNLOCK;
+  return r;
 }
 
 /* Return rand 32-bit integer between 0 to n-1 inclusive */
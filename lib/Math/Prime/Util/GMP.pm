@@ -17,6 +17,10 @@ our @EXPORT_OK = qw(
                      is_bpsw_prime
                      is_provable_prime
                      is_provable_prime_with_cert
+                     verify_prime_certificate
+                     prime_certificate_to_binary
+                     prime_certificate_to_text
+                     forprovable
                      is_trial_prime
                      is_aks_prime
                      is_nminus1_prime
@@ -47,7 +51,11 @@ our @EXPORT_OK = qw(
                      sieve_primes
                      sieve_twin_primes
                      sieve_prime_cluster
+                     twin_prime_count twin_prime_count_approx
+                     cluster_count cluster_count_approx
                      sieve_range
+                     sieve_primes_bitmap sieve_range_bitmap
+                     forprimes forclusters forprimegaps
                      next_prime
                      prev_prime
                      surround_primes
@@ -63,11 +71,14 @@ our @EXPORT_OK = qw(
                      ecm_factor
                      qs_factor
                      factor
-                     divisors
+                     divisors fordivisors lastfor
                      sigma
+                     totient_range sigma_range carmichael_lambda_range
+                     liouville_range prime_omega_range prime_bigomega_range
+                     is_semiprime_range
                      chinese chinese2
                      moebius
-                     prime_count prime_count_lower prime_count_upper
+                     prime_count prime_count_lower prime_count_upper nth_prime
                      primorial
                      pn_primorial
                      factorial subfactorial multifactorial factorial_sum
@@ -118,8 +129,6 @@ our @EXPORT_OK = qw(
                      irand irand64 drand urandomb urandomm urandomr random_bytes
                      permtonum numtoperm
                    );
-                   # Should add:
-                   # nth_prime
 our %EXPORT_TAGS = (all => [ @EXPORT_OK ]);
 
 sub _init_random {
@@ -177,6 +186,15 @@ sub is_provable_prime {
   return _is_provable_prime($n);
 }
 
+sub _cert_with_header {
+  my ($n, $result, $text) = @_;
+  return ($result, '') if $result != 2;
+  $text = "Type Small\nN $n\n" if !defined $text || $text eq '';
+  $text =~ s/\n$//;
+  $text = "[MPU - Primality Certificate]\nVersion 1.0\n\nProof for:\nN $n\n\n$text";
+  return ($result, $text);
+}
+
 sub is_provable_prime_with_cert {
   my ($n) = @_;
   my @composite = (0, '');
@@ -184,11 +202,12 @@ sub is_provable_prime_with_cert {
 
   my ($result, $text) = _is_provable_prime($n, 1);
   return @composite if $result == 0;
-  return ($result, '') if $result != 2;
-  $text = "Type Small\nN $n\n" if !defined $text || $text eq '';
-  $text =~ s/\n$//;
-  $text = "[MPU - Primality Certificate]\nVersion 1.0\n\nProof for:\nN $n\n\n$text";
-  return ($result, $text);
+  return _cert_with_header($n, $result, $text);
+}
+
+sub forprovable (&@) {
+  my ($block, @n) = @_;
+  _forprovable(sub { $block->(_cert_with_header($_, @_)) }, @n);
 }
 
 sub primes {
@@ -299,6 +318,19 @@ and follows Pari, L<Math::Primality>, and some other math packages.
 The modern definition of pseudoprime is a I<composite> that passes the
 test, rather than any number.
 
+Arithmetic functions that depend only on the factorization of C<n>
+(L</totient>, L</jordan_totient>, L</carmichael_lambda>, L</sigma>,
+L</moebius>, L</liouville>, L</prime_omega>, L</prime_bigomega>,
+L</is_semiprime>, L</is_carmichael>, L</znorder>, and L</znprimroot>)
+will also accept the factorization in place of C<n>, given as an array
+reference of primes (e.g. the output of L</factor>) or of C<[p,e]>
+pairs.  Each prime is checked with BPSW.  When computing several of these
+functions for the same large input, factoring once and passing the
+result avoids repeating the factorization:
+
+  my @f = factor($n);
+  my($phi, $lambda, $sigma) = (totient(\@f), carmichael_lambda(\@f), sigma(\@f));
+
 
 =head1 FUNCTIONS
 
@@ -432,6 +464,61 @@ verification.  Proof types used include:
   BLS5
   Small
 
+=head2 verify_prime_certificate
+
+  my $ok = verify_prime_certificate($cert);
+  my($ok, @steps) = verify_prime_certificate($cert);
+
+Takes a primality certificate as a string, either in the MPU format
+produced by L</is_provable_prime_with_cert> (as text or in the binary
+form from L</prime_certificate_to_binary>) or a Primo certificate
+(format 3 or 4), and returns 1 if it proves its number prime, or 0 if it
+does not or cannot be parsed.
+
+The certificate is parsed once and its steps are then checked
+independently, largest first, using the threads selected with
+C<_GMP_set_threads> (see L</prime_count>).  Last, the chain of factors is
+followed from N down to numbers small enough to prove directly.
+
+In list context the steps are returned after the result, in certificate
+order, each as an array reference holding the step type, its N, 1 or 0
+for whether its conditions hold, the seconds taken, and the condition
+that failed (or undef).  Primo steps are checked as the MPU steps they
+correspond to.  With verbose output each step is printed with its time.
+
+=head2 prime_certificate_to_binary
+
+  my $bin = prime_certificate_to_binary($cert);
+  my $text = prime_certificate_to_text($bin);
+
+Converts an MPU certificate to a compact binary form and back.  Numbers
+are stored as bytes rather than decimal digits, so the binary form is
+around 40% of the size of the text, and it can be given directly
+to L</verify_prime_certificate>, which reads it without any decimal
+conversions.  The conversion is lossless apart from comments and layout:
+the text from C<prime_certificate_to_text> is laid out as
+L</is_provable_prime_with_cert> gives it.  A certificate already in the
+requested form is returned unchanged, and one that cannot be parsed
+(including a Primo certificate) causes a croak.
+
+=head2 forprovable
+
+  forprovable { print "$_ $_[0]\n"; save_cert($_, $_[1]) if $_[0] == 2 } @n;
+
+Proves each of a list of numbers as L</is_provable_prime_with_cert> does,
+running the block once for each with C<$_> set to the number and C<@_>
+set to the result and certificate.  With more than one thread selected
+(see C<_GMP_set_threads>) the numbers are proven at the same time, one per
+thread, and the block is called as each finishes, so not necessarily in
+list order.  This is much faster than proving them one at a time when
+each is too small to make good use of the threads itself.
+
+The proofs share their ECPP setup, and factors found by one while working
+hard on a curve order are tried by the others.  No checkpoint file is
+used, and afterwards C<_GMP_ecpp_stats> gives the totals over the batch.
+Calling L</lastfor> in the block, or dying in it, stops the batch once the
+proofs already running have finished, and a die is then rethrown.
+
 =head2 is_pseudoprime
 
 Takes a positive number C<n> and one or more non-zero positive bases as input.
@@ -855,8 +942,59 @@ This implementation uses a "factor all strategy" (FAS) with backtracking.
 A limited set of about 500 precalculated discriminants are used, which works
 well for inputs up to 300 digits, and for many inputs up to one thousand
 digits.  Having a larger set will help with large numbers (a set of 2650
-is available on github in the C<xt/> directory).  A future implementation
-may include code to generate class polynomials as needed.
+is available on github in the C<xt/> directory).  For inputs over about 450
+digits, several thousand more discriminants (up to 50000, with class number
+up to 32) are also tried, with their Hilbert class polynomials computed as
+needed and cached.
+
+Larger sets of discriminants can also be used without building them in.
+C<xt/make-class-poly-db.pl> converts files in the format of
+C<class_poly_data.h> into a compact indexed file, which is mapped into
+memory at the first proof and decoded one polynomial at a time as they are
+chosen.  Give its path in the environment variable C<MPU_CLASS_POLY_DB>, or
+call C<Math::Prime::Util::GMP::_GMP_set_class_poly_db($path)> (C<undef>
+goes back to the environment).  Its discriminants are tried after the
+built-in ones of the same degree.  A missing or invalid file is ignored.
+The database cannot be changed from inside a L</forprovable> block.
+
+A long proof can be checkpointed.  Give a file in the environment variable
+C<MPU_ECPP_CHECKPOINT>, or call
+C<Math::Prime::Util::GMP::_GMP_set_ecpp_checkpoint($path)> (C<undef> goes
+back to the environment).  As the proof runs, the factors saved for later
+stages, each step of the chain chosen on the way down, and each step proven
+on the way back up are appended to it.  If the proof is interrupted, running
+it again for the same number checks the saved steps, reuses those that are
+proven, and tries the saved choices first.  The file is written in the MPU
+certificate format, and when the proof finishes it is a certificate for the
+number (with the search state in comment lines).  A file for a different
+number is replaced.
+
+How the chain is chosen can be tuned with
+C<Math::Prime::Util::GMP::_GMP_set_ecpp_policy($eas, $degree_bits, $seconds)>.
+With C<$eas> above 1, while the number has 100 or more digits, that many
+candidate orders are collected before any is tried, and they are tried in
+order of the bits removed less C<$degree_bits> (default 2) for each degree
+of the class polynomial, rather than in the order found.  This usually
+gives a shorter chain at the cost of more factoring.  With C<$seconds>
+above 0, on the first pass each step below the top stops trying more
+discriminants once it has spent that long factoring, and backs up to try
+another order for the step above; later passes are not limited.  The
+default is C<(0, 2, 0)>.  After a proof,
+C<Math::Prime::Util::GMP::_GMP_ecpp_stats()> returns a list of key/value
+pairs describing it: the numbers of levels, discriminants, orders factored,
+candidates, downs, backtracks, reorders, budget stops, curve failures,
+steps (and those finished by BLS75) and bits removed, the final factoring
+stage, and the seconds spent factoring, finding curves, and in total.
+
+Where the search finds N-1 at some level is all but factored (or N+1, when
+no certificate is wanted), a BLS75 proof is tried for that number, which
+ends the chain there.  Called from L</is_provable_prime>, the first step
+starts from what the BLS75 attempt left of N-1 and N+1 rather than
+factoring them again.
+
+With more than one thread selected (see L</prime_count>), the candidate
+curve orders for several discriminants are factored at once, and the
+curves for all steps of the chain are found in parallel at the end.
 
 This is a test specifically for this proof method.  The return values are:
 
@@ -889,10 +1027,16 @@ Values above 64-bit are extra-strong BPSW probable primes.
 Returns the number of primes up to C<n> (single argument)
 or between C<lo> and C<hi> (two arguments).  The values are inclusive.
 
-The method is simple sieving followed by primality testing.  This is
-appropriate for small ranges and is useful for very large arguments.
-The L<Math::Prime::Util> module has much more sophisticated methods
-for 64-bit arguments.
+Inputs less than C<2^80> (C<2^64> if the compiler has no 128-bit integer
+type) use the Lagarias-Miller-Odlyzko method with segmented sieving, so
+C<prime_count(10**12)> takes a fraction of a second.  Ranges that are
+narrow relative to C<hi^(2/3)>, and larger arguments, use simple sieving
+followed by primality testing.
+
+If the module was built with pthreads, the LMO sieve and the sieving and
+testing of wide ranges can be split over several threads by calling C<Math::Prime::Util::GMP::_GMP_set_threads(n)>.
+The default is 1, and C<0> selects the number of online processors.
+C<_GMP_get_threads()> returns the current setting.
 
 
 =head2 prime_count_lower
@@ -904,6 +1048,19 @@ Returns lower or upper bounds for the prime count of the input C<n>.
 Bounds use Dusart 2010, Büthe 2014, Büthe 2015, and Axler 2017.
 
 
+=head2 nth_prime
+
+  say nth_prime(10**10);    # 252097800623
+
+Returns the C<n>-th prime, with C<nth_prime(1) = 2>.  Returns undef for
+C<n = 0>.
+
+An estimate is made by inverting Riemann's R function, the primes up to it
+are counted with L</prime_count>, and the remaining distance is walked with
+a segmented sieve.  The time is dominated by the prime count, so this is
+practical for results below about C<10^16>.
+
+
 =head2 sieve_primes
 
   my @primes = sieve_primes(2**100, 2**100 + 10000);
@@ -925,6 +1082,10 @@ that want to apply their own primality or other tests, and wish to have a
 list of values in the range with no small factors.  This is quite common
 for applications involving prime gaps.
 
+Ranges wider than about C<2^24> are split into chunks that are sieved and
+tested in parallel when more than one thread has been selected with
+C<_GMP_set_threads> (see L</prime_count>).  The output is the same.
+
 Also see L</sieve_range>.
 
 
@@ -946,6 +1107,29 @@ values themselves.  This can substantially reduce overhead for
 multi-thousand digit numbers.
 
 
+=head2 sieve_primes_bitmap
+
+=head2 sieve_range_bitmap
+
+  my $bits = sieve_primes_bitmap(2**100, 2**100 + 10**8);
+  my $cand = sieve_range_bitmap(2**1000, 10**6, 40000);
+  my $n = 0;  $n += vec($bits, $_, 1) for 0 .. 8*length($bits)-1;
+
+These take the same arguments as L</sieve_primes> and L</sieve_range>, but
+return the result as a packed bit string over the odd numbers instead of a
+list.  Bit C<i>, as read by C<vec($bits, i, 1)>, stands for C<lo + 2i>,
+where C<lo> is the start of the range rounded up to odd.  It is set if that
+value is prime, or for a partial sieve if it has no prime factor up to the
+depth.  Even values, including 2, are not represented.  The string has
+about C<w/16> bytes for a range of width C<w>, with zero bits after the
+last odd value.
+
+This is the sieve's own layout, handed over without building a Perl value
+per entry.  For dense ranges it is many times smaller and faster than the
+lists, and can be written straight to a file with C<syswrite>, or counted
+with C<unpack("%32b*", $bits)>.  Threads are used as for L</sieve_primes>.
+
+
 =head2 sieve_twin_primes
 
   my @primes = sieve_twin_primes(2**1000, 2**1000 + 500000);
@@ -986,6 +1170,37 @@ than filtering results from primes or twin primes.
 Shorter clusters are not quite this efficient, and the overhead for
 returning large arrays should not be ignored.
 
+With more than one thread selected (see L</prime_count>), blocks of the
+range, or slices of the admissible residues when the range is short, are
+searched in parallel.
+
+
+=head2 forprimes
+
+  forprimes { print "$_\n" } 1000;
+  forprimes { print "$_\n" } 2**64, 2**64 + 10**6;
+
+Given a block and one or two non-negative integers, calls the block once
+for each prime in the inclusive range, with C<$_> set to the prime.  With
+one argument the range starts at 2.
+
+The range is sieved in windows that start small and adapt so each holds a
+bounded number of primes, so the first values arrive quickly and memory
+does not grow with the width of the range.  Calling L</lastfor> inside
+the block ends the loop early.
+
+=head2 forclusters
+
+  # The first 1000 prime quadruplets past 10^20
+  my $n = 0;
+  forclusters { print "$_\n"; lastfor if ++$n >= 1000 } "100000000000000000000", "200000000000000000000", 2,6,8;
+
+The streaming form of L</sieve_prime_cluster>.  Given a block, C<low>,
+C<high>, and the cluster offsets, calls the block with C<$_> set to the
+start of each cluster in the range, in increasing order.  No offsets
+gives primes, and the single offset C<2> gives twin primes.  Memory use is
+bounded as for L</forprimes>, and L</lastfor> ends the loop early.
+
 
 =head2 next_prime
 
@@ -1030,6 +1245,35 @@ finding the nearest prime to a value.
 Note that with a non-zero second argument, the values returned have not
 undergone a full BPSW test; just sieving and a SPSP-2 test.
 
+=head2 forprimegaps
+
+  # Gaps of merit 10 or more around m * 1511#/30030
+  my $K = divint(primorial(1511), 30030);
+  forprimegaps {
+    my($gap, $merit) = @_;
+    print "$gap $merit $_\n";
+  } $K, 1, 1000000, 10;
+
+Given a block, a positive integer C<K>, native integers C<mlo> and C<mhi>,
+and a minimum merit C<M>, looks at the prime gap around each centre
+C<m*K> for C<mlo E<lt>= m E<lt>= mhi>.  The block is called for each gap
+with merit (size divided by the log of its lower prime) at least C<M>,
+with C<$_> set to the lower prime and the gap size and merit as its
+arguments.  Gaps are reported in increasing order, and a gap containing
+more than one centre is reported once.  A centre that is itself prime
+is the lower end of its gap.  An optional sixth argument sets the sieve
+depth.
+
+This is made for record gap searches.  The sieve state is shared by runs
+of centres, so stepping to the next centre needs no bignum remainders,
+and primes too large to hit every interval are only touched at the
+centres they hit.  That allows sieving much deeper than
+L</surround_primes> does.  The search around each centre stops at the
+first probable prime showing the gap is too small, candidates get only a
+SPSP-2 test, and the primes at the ends of a reported gap are checked with
+BPSW.  With more than one thread selected (see L</prime_count>) runs of
+centres are searched in parallel.  L</lastfor> ends the search early.
+
 
 =head2 next_twin_prime
 
@@ -1778,6 +2022,7 @@ C<moebius(0) = 0> for convenience.
 If called with two arguments, they define a range C<low> to C<high>, and the
 function returns an array with the value of the Möbius function for every n
 from low to high inclusive.
+The range is factored together by sieving (see L</totient_range>).
 
 =head2 invmod
 
@@ -1997,6 +2242,40 @@ The result is identical to C<scalar(factor_exp($n))>.
 This corresponds to Pari's C<omega> function
 and Mathematica's C<PrimeNu[n]> function.
 
+=head2 totient_range
+
+  my @phi = totient_range("1000000000000000000000", "1000000000000000001000");
+
+Given non-negative integers C<low> and C<high>, returns a list of
+L</totient> for every n from low to high inclusive.
+
+The range is processed in blocks.  Each block is sieved by all primes up
+to a bound (at most C<2^20>), building up the factorization of every value
+at once.  The cofactor left over is prime if it is below the bound squared,
+and otherwise is almost always settled by a single BPSW test.  Only
+composite cofactors need a call to L</factor>.  For wide ranges of large
+numbers this is much faster than factoring each value separately.
+
+The functions
+C<carmichael_lambda_range>,
+C<liouville_range>,
+C<prime_omega_range>,
+C<prime_bigomega_range>, and
+C<is_semiprime_range>
+work the same way, returning the results of L</carmichael_lambda>,
+L</liouville>, L</prime_omega>, L</prime_bigomega>, and L</is_semiprime>
+respectively.
+
+=head2 sigma_range
+
+  my @s = sigma_range($lo, $hi);      # sigma(n) for each n in lo..hi
+  my @d = sigma_range($lo, $hi, 0);   # number of divisors
+
+Given non-negative integers C<low> and C<high>, and an optional
+non-negative integer C<k> (default 1), returns a list of C<sigma(n,k)> for
+every n from low to high inclusive.  This uses the same range factoring
+as L</totient_range>.
+
 =head2 is_divisible
 
 Given integers C<n> and C<d>, returns 1 if C<n> is exactly divisible by C<d>,
@@ -2283,6 +2562,32 @@ is the same result as evaluating the returned array in scalar context
 The result then corresponds to Pari's C<numdiv> and Mathematica's
 C<DivisorSigma[0,n]> functions.
 
+An optional second argument C<k> restricts the result to divisors
+less than or equal to C<k>.  In scalar context this is then the count of
+those divisors.  The divisors are generated in order from the
+factorization, so the full list is never built when C<k> is small.
+
+=head2 fordivisors
+
+  fordivisors { print "$_\n" } 360;
+  fordivisors { print "$_\n" } "1000000000000000000000", 10**9, 10**10;
+
+Given a block and a non-negative integer C<n>, calls the block once for
+each divisor of C<n> in increasing order, with C<$_> set to the divisor.
+Optional third and fourth arguments give lower and upper limits, and only
+divisors in that inclusive range are visited.
+
+Divisors are generated on demand rather than materialized as a list, so
+memory use stays small even for numbers with millions of divisors.
+Calling L</lastfor> inside the block ends the loop early.
+
+=head2 lastfor
+
+  fordivisors { lastfor if $_ > 1000; print "$_\n" } $n;
+
+Inside the block of a C<for...> function such as L</fordivisors>, stops
+the iteration after the current call returns.
+
 
 =head2 trial_factor
 
@@ -0,0 +1,559 @@
+/*
+ * Prime counting with the Lagarias-Miller-Odlyzko method, using the
+ * segmented special leaf sieve as described by Deleglise and Rivat.
+ *
+ *   pi(x) = phi(x,a) + a - 1 - P2(x,a)       a = pi(y), x^(1/3) <= y < x^(1/2)
+ *   phi(x,a) = S1 + S2
+ *
+ * S1 (the ordinary leaves) uses a table of mu(n) and lpf(n) for n <= y.  The
+ * special leaves S2 and the P2 term are both computed from one sieve of
+ * [1, x/y), walked in segments.  Runs of consecutive segments ("chunks") are
+ * sieved independently, each keeping counts relative to its own start, and
+ * are then merged in order.  That lets the chunks be spread over threads.
+ *
+ * Everything but the final result is done in native integers, using a
+ * 128-bit type when the compiler has one.  That limits x to 2^80, which is
+ * well past what anyone will want to wait for.
+ */
+
+#include <string.h>
+#include <math.h>
+#include <gmp.h>
+#include "ptypes.h"
+
+#include "lmo.h"
+#include "prime_iterator.h"
+#include "threadpool.h"
+
+#if defined(__SIZEOF_INT128__) && BITS_PER_WORD == 64
+  #define HAVE_UINT128 1
+  __extension__ typedef unsigned __int128 xuint;
+  __extension__ typedef          __int128 xint;
+  #define LMO_MAX_BITS 80
+#else
+  #define HAVE_UINT128 0
+  typedef UV xuint;
+  typedef IV xint;
+  #define LMO_MAX_BITS BITS_PER_WORD
+#endif
+
+#if defined(__GNUC__) && (__GNUC__ > 3 || (__GNUC__ == 3 && __GNUC_MINOR__ >= 4))
+  #if BITS_PER_WORD == 64
+    #define popcnt(w)  __builtin_popcountll(w)
+  #else
+    #define popcnt(w)  __builtin_popcountl(w)
+  #endif
+#else
+static INLINE int popcnt(UV w) {
+  int c = 0;
+  while (w) { w &= w-1; c++; }
+  return c;
+}
+#endif
+
+#define WBITS       BITS_PER_WORD
+#define CNT_WORDS   16                    /* words per counter block */
+#define CNT_BITS    (CNT_WORDS * WBITS)
+#define P2_BLOCK    65536                 /* numbers per P2 prime sieve */
+
+/* phi(n, 6) from n mod 2*3*5*7*11*13 */
+#define TINY_C      6
+#define TINY_PROD   30030
+#define TINY_TOT    5760
+#define PAT_PERIOD  (TINY_PROD/2)         /* odd-only presieve period */
+
+int lmo_max_bits(void)
+{
+  return LMO_MAX_BITS;
+}
+
+typedef struct {
+  UV    low, high;       /* numbers in [low, high) */
+  UV    nb;              /* special leaves use p_{b+1} for b < nb */
+  UV   *phicnt;          /* [b]: unsieved by p_1..p_b, over this chunk */
+  IV   *musum;           /* [b]: sum of -mu(m) over this chunk's leaves */
+  xint  s2;              /* leaves, counted from the chunk start */
+  UV    surv;            /* unsieved by p_1..p_k2, over this chunk */
+  UV    np2;             /* P2 primes p with x/p in this chunk */
+  xuint p2;              /* their counts, from the chunk start */
+  UV    sqrtcnt;         /* count to sqrt(x) if it is in this chunk */
+} lmo_chunk_t;
+
+typedef struct {
+  xuint           x;
+  int             x_is_uv;
+  UV              y, zmax, sqrtx;
+  UV              a, k2;       /* pi(y), pi(sqrt(zmax)) */
+  const uint32_t *primes;      /* primes[1..a] */
+  const int32_t  *mulpf;       /* mu(n)*lpf(n) for n <= y, 0 if not sqfree */
+  const uint16_t *phitab;      /* phi(r,6) for r < TINY_PROD */
+  UV             *pattern;     /* odd-only presieve by 3,5,7,11,13 */
+  UV              segwords;
+  UV              s1block;
+  xint           *s1part;
+  lmo_chunk_t    *chunks;
+} lmo_ctx_t;
+
+static INLINE UV xdiv(const lmo_ctx_t *ctx, UV d)
+{
+  return ctx->x_is_uv ? (UV)ctx->x / d : (UV)(ctx->x / d);
+}
+
+/* floor(x/(p*q)) clamped to max, with no overflow of p*q. */
+static INLINE UV xdiv2_max(const lmo_ctx_t *ctx, UV p, UV q, UV max)
+{
+  xuint r = (ctx->x / p) / q;
+  return (r > max) ? max : (UV)r;
+}
+
+static UV xisqrt(xuint n)
+{
+  UV r = (UV) sqrt((double)n);
+  while (r > 0 && (xuint)r*r > n)  r--;
+  while ((xuint)(r+1)*(r+1) <= n)  r++;
+  return r;
+}
+
+static UV xicbrt(xuint n)
+{
+  UV r = (UV) pow((double)n, 1.0/3.0);
+  while (r > 0 && (xuint)r*r*r > n)  r--;
+  while ((xuint)(r+1)*(r+1)*(r+1) <= n)  r++;
+  return r;
+}
+
+/* Number of primes in primes[1..a] that are <= v. */
+static UV _pi_table(const uint32_t *primes, UV a, UV v)
+{
+  UV lo = 1, hi = a+1;
+  while (lo < hi) {
+    UV mid = lo + (hi-lo)/2;
+    if (primes[mid] <= v)  lo = mid+1;
+    else                   hi = mid;
+  }
+  return lo-1;
+}
+
+static INLINE xuint _phi_tiny(const lmo_ctx_t *ctx, xuint v)
+{
+  return (v / TINY_PROD) * TINY_TOT + ctx->phitab[(UV)(v % TINY_PROD)];
+}
+
+/******************************************************************************/
+/*                              ordinary leaves                               */
+/******************************************************************************/
+
+static void _s1_block(void *vctx, UV blk)
+{
+  lmo_ctx_t *ctx = (lmo_ctx_t*) vctx;
+  UV n, nlo = blk * ctx->s1block + 1, nhi = nlo + ctx->s1block - 1;
+  xint sum = 0;
+
+  if (nhi > ctx->y) nhi = ctx->y;
+  for (n = nlo; n <= nhi; n++) {
+    int32_t e = ctx->mulpf[n];
+    if (n == 1)
+      sum += _phi_tiny(ctx, ctx->x);
+    else if (e > 13)
+      sum += _phi_tiny(ctx, ctx->x / n);
+    else if (e < -13)
+      sum -= _phi_tiny(ctx, ctx->x / n);
+  }
+  ctx->s1part[blk] = sum;
+}
+
+/******************************************************************************/
+/*                         special leaves and P2                              */
+/******************************************************************************/
+
+/* Counting unsieved numbers in a segment.  Bit i of the sieve is the number
+ * low+2i+1.  Queries must be made with non-decreasing z. */
+typedef struct { UV blk; UV sum; } sweep_t;
+
+static UV _count_to(const UV *sieve, const uint32_t *cnt, UV low, UV z,
+                    sweep_t *sw)
+{
+  UV idx, blk, w, wend, n;
+  if (z <= low) return 0;
+  idx = (z - low - 1) >> 1;
+  blk = idx / CNT_BITS;
+  while (sw->blk < blk)
+    sw->sum += cnt[sw->blk++];
+  n = sw->sum;
+  wend = idx / WBITS;
+  for (w = blk * CNT_WORDS; w < wend; w++)
+    n += popcnt(sieve[w]);
+  n += popcnt(sieve[wend] & (UV_MAX >> (WBITS-1 - idx % WBITS)));
+  return n;
+}
+
+/* Fill the segment with numbers coprime to 2*3*5*7*11*13. */
+static UV _presieve(const lmo_ctx_t *ctx, UV *sieve, uint32_t *cnt,
+                    UV low, UV high)
+{
+  UV w, off, nbits, alive = 0, segwords = ctx->segwords;
+  const UV *pat = ctx->pattern;
+
+  off = (low/2) % PAT_PERIOD;
+  for (w = 0; w < segwords; w++) {
+    UV wi = off / WBITS, sh = off % WBITS;
+    UV v = pat[wi] >> sh;
+    if (sh) v |= pat[wi+1] << (WBITS - sh);
+    sieve[w] = v;
+    off += WBITS;
+    if (off >= PAT_PERIOD) off -= PAT_PERIOD;
+  }
+  nbits = (high - low) / 2;
+  if (nbits < segwords * WBITS) {
+    w = nbits / WBITS;
+    if (nbits % WBITS)
+      sieve[w++] &= UV_MAX >> (WBITS - nbits % WBITS);
+    for (; w < segwords; w++)
+      sieve[w] = 0;
+  }
+  for (w = 0; w < segwords; w += CNT_WORDS) {
+    UV i, c = 0;
+    for (i = 0; i < CNT_WORDS; i++)
+      c += popcnt(sieve[w+i]);
+    cnt[w / CNT_WORDS] = c;
+    alive += c;
+  }
+  return alive;
+}
+
+/* Walk the primes in (plo, phi] in decreasing order, adding their P2 counts
+ * to the chunk.  All primes up to sqrt(phi) are in the table. */
+static void _p2_primes(const lmo_ctx_t *ctx, lmo_chunk_t *ch,
+                       const UV *sieve, const uint32_t *cnt,
+                       UV low, UV plo, UV phi, UV survbase)
+{
+  unsigned char *comp;
+  sweep_t sw = {0, 0};
+  UV bhi, blo, i, j;
+
+  New(0, comp, P2_BLOCK, unsigned char);
+  for (bhi = phi; bhi > plo; bhi = blo) {
+    blo = (bhi - plo > P2_BLOCK) ? bhi - P2_BLOCK : plo;
+    /* comp[i] represents blo+1+i */
+    memset(comp, 0, bhi - blo);
+    for (j = 1; j <= ctx->a; j++) {
+      UV p = ctx->primes[j], m;
+      if (p*p > bhi) break;
+      m = ((blo / p) + 1) * p;
+      if (m < p*p) m = p*p;
+      for (; m <= bhi; m += p)
+        comp[m - blo - 1] = 1;
+    }
+    for (i = bhi - blo; i-- > 0; ) {
+      if (!comp[i]) {
+        UV p = blo + 1 + i;
+        ch->p2 += survbase + _count_to(sieve, cnt, low, xdiv(ctx, p), &sw);
+        ch->np2++;
+      }
+    }
+  }
+  Safefree(comp);
+}
+
+static void _lmo_chunk(void *vctx, UV ci)
+{
+  lmo_ctx_t *ctx = (lmo_ctx_t*) vctx;
+  lmo_chunk_t *ch = ctx->chunks + ci;
+  const uint32_t *primes = ctx->primes;
+  UV segwords = ctx->segwords, seglen = 2 * segwords * WBITS;
+  UV y = ctx->y, k2 = ctx->k2;
+  UV j, b, low, high, bendmax, *sieve, *next;
+  uint32_t *cnt;
+
+  bendmax = (ch->nb > k2) ? ch->nb : k2;
+  New(0, next, bendmax+1, UV);
+  for (j = TINY_C+1; j <= bendmax; j++) {
+    UV p = primes[j], m = ((ch->low + p - 1) / p) * p;
+    if (!(m & 1)) m += p;
+    next[j] = m;
+  }
+  New(0, sieve, segwords, UV);
+  New(0, cnt, segwords / CNT_WORDS, uint32_t);
+  ch->sqrtcnt = UV_MAX;
+
+  for (low = ch->low; low < ch->high; low += seglen) {
+    UV nbs, bend, alive;
+    high = (ch->high - low > seglen) ? low + seglen : ch->high;
+
+    if (low == 0) {
+      nbs = ctx->a;
+    } else {
+      xuint q = ctx->x / low;
+      nbs = _pi_table(primes, ctx->a, xisqrt(q));
+    }
+    if (nbs > ch->nb) nbs = ch->nb;
+    bend = (nbs > k2) ? nbs : k2;
+
+    alive = _presieve(ctx, sieve, cnt, low, high);
+
+    for (b = TINY_C; ; b++) {
+
+      if (b < nbs) {
+        /* Special leaves -mu(m)*phi(x/(m*p), b) with p = p_{b+1},
+         * lpf(m) > p, and m <= y < m*p. */
+        UV p = primes[b+1], base = ch->phicnt[b], mlo, mhi, t;
+        sweep_t sw = {0, 0};
+        xint s2 = 0;
+        IV msum = 0;
+        mlo = y / p;
+        if (mlo < p) mlo = p;
+        t = xdiv2_max(ctx, p, high, y);
+        if (t > mlo) mlo = t;
+        mhi = (low == 0) ? y : xdiv2_max(ctx, p, low, y);
+        if (mhi > mlo) {
+          if (p*p > y) {     /* every m is a prime */
+            UV i, ilo = _pi_table(primes, ctx->a, mlo) + 1,
+                  ihi = _pi_table(primes, ctx->a, mhi);
+            for (i = ihi; i >= ilo; i--) {
+              UV z = xdiv(ctx, p * primes[i]);
+              s2 += base + _count_to(sieve, cnt, low, z, &sw);
+              msum++;
+            }
+          } else {
+            UV m;
+            for (m = mhi; m > mlo; m--) {
+              int32_t e = ctx->mulpf[m];
+              if (e > (int32_t)p) {
+                UV z = xdiv(ctx, p * m);
+                s2 -= base + _count_to(sieve, cnt, low, z, &sw);
+                msum--;
+              } else if (e < -(int32_t)p) {
+                UV z = xdiv(ctx, p * m);
+                s2 += base + _count_to(sieve, cnt, low, z, &sw);
+                msum++;
+              }
+            }
+          }
+        }
+        ch->s2 += s2;
+        ch->musum[b] += msum;
+        ch->phicnt[b] += alive;
+      }
+
+      if (b == k2) {
+        /* Only primes > p_k2 remain, which lets us count pi(v) here. */
+        UV plo, phi;
+        plo = xdiv2_max(ctx, 1, high, UV_MAX);
+        if (plo < y) plo = y;
+        phi = (low == 0) ? ctx->sqrtx : xdiv2_max(ctx, 1, low, ctx->sqrtx);
+        if (phi > plo)
+          _p2_primes(ctx, ch, sieve, cnt, low, plo, phi, ch->surv);
+        if (ctx->sqrtx >= low && ctx->sqrtx < high) {
+          sweep_t sw = {0, 0};
+          ch->sqrtcnt = ch->surv + _count_to(sieve, cnt, low, ctx->sqrtx, &sw);
+        }
+        ch->surv += alive;
+      }
+
+      if (b >= bend) break;
+
+      { /* Remove multiples of p_{b+1} */
+        UV p = primes[b+1], twop = 2*p, m = next[b+1];
+        for (; m < high; m += twop) {
+          UV i = (m - low) >> 1, w = i / WBITS, s = i % WBITS;
+          UV was = (sieve[w] >> s) & 1;
+          sieve[w] &= ~(UVCONST(1) << s);
+          cnt[i / CNT_BITS] -= was;
+          alive -= was;
+        }
+        next[b+1] = m;
+      }
+    }
+  }
+  Safefree(cnt);
+  Safefree(sieve);
+  Safefree(next);
+}
+
+/******************************************************************************/
+
+static void _xint_to_mpz(mpz_t r, xint v)
+{
+  int neg = (v < 0);
+  xuint u = neg ? -(xuint)v : (xuint)v;
+#if HAVE_UINT128
+  mpz_set_ui(r, (unsigned long)(UV)(u >> 64));
+  mpz_mul_2exp(r, r, 64);
+  mpz_add_ui(r, r, (unsigned long)(UV)u);
+#else
+  mpz_set_ui(r, u);
+#endif
+  if (neg) mpz_neg(r, r);
+}
+
+static xuint _mpz_to_xuint(mpz_t n)
+{
+#if HAVE_UINT128
+  xuint r;
+  mpz_t t;
+  mpz_init(t);
+  mpz_tdiv_q_2exp(t, n, 64);
+  r = (xuint)mpz_get_ui(t) << 64;
+  mpz_tdiv_r_2exp(t, n, 64);
+  r |= mpz_get_ui(t);
+  mpz_clear(t);
+  return r;
+#else
+  return mpz_get_ui(n);
+#endif
+}
+
+void prime_count_lmo(mpz_t count, mpz_t n)
+{
+  lmo_ctx_t ctx;
+  uint32_t *primes;
+  int32_t  *mulpf;
+  uint16_t *phitab;
+  UV       *pattern, *pl, *phig;
+  UV i, j, a, y, x13, nthreads, seglen, chunklen, nchunks, nround, s1blocks;
+  UV survg, pisqrt, patwords;
+  xint s1, s2, p2sum, p2, pix;
+  double logx, alpha;
+
+  if (mpz_cmp_ui(n, 100000) < 0) {
+    UV cnt, un = mpz_get_ui(n);
+    if (un < 2) { mpz_set_ui(count, 0); return; }
+    pl = sieve_to_n(un, &cnt);
+    Safefree(pl);
+    mpz_set_ui(count, cnt);
+    return;
+  }
+  if (mpz_sizeinbase(n, 2) > LMO_MAX_BITS)
+    croak("prime_count_lmo: input too large");
+
+  memset(&ctx, 0, sizeof(ctx));
+  ctx.x = _mpz_to_xuint(n);
+  ctx.x_is_uv = (mpz_sizeinbase(n, 2) <= BITS_PER_WORD);
+  ctx.sqrtx = xisqrt(ctx.x);
+  nthreads = get_thread_count();
+
+  /* Choose y = alpha * x^(1/3).  A larger y shrinks the sieve but the
+   * number of special leaves grows as y^2, so alpha stays small. */
+  x13 = xicbrt(ctx.x);
+  logx = log((double)ctx.x);
+  alpha = logx / 16.0;
+  if (alpha < 1.0) alpha = 1.0;
+  y = (UV)(alpha * x13);
+  if (y > UVCONST(1) << 26) y = UVCONST(1) << 26;
+  if (y < x13) y = x13;
+  if (y >= ctx.sqrtx) y = ctx.sqrtx - 1;
+  ctx.y = y;
+  ctx.zmax = xdiv(&ctx, y);
+
+  /* primes[1..a], primes up to y */
+  pl = sieve_to_n(y, &a);
+  New(0, primes, a+2, uint32_t);
+  primes[0] = 0;
+  for (i = 0; i < a; i++)  primes[i+1] = pl[i];
+  primes[a+1] = 0;
+  Safefree(pl);
+  ctx.a = a;
+  ctx.primes = primes;
+  ctx.k2 = _pi_table(primes, a, xisqrt(ctx.zmax));
+  MPUassert(a > TINY_C && ctx.k2 >= TINY_C, "lmo: y is too small");
+
+  /* mu(n) * lpf(n).  Going through primes in decreasing order leaves the
+   * smallest one in place. */
+  New(0, mulpf, y+1, int32_t);
+  for (i = 0; i <= y; i++)  mulpf[i] = 1;
+  for (j = a; j >= 1; j--) {
+    UV p = primes[j], m;
+    for (m = p; m <= y; m += p)
+      if (mulpf[m] != 0)
+        mulpf[m] = (mulpf[m] > 0) ? -(int32_t)p : (int32_t)p;
+    if (p <= y / p)
+      for (m = p*p; m <= y; m += p*p)
+        mulpf[m] = 0;
+  }
+  ctx.mulpf = mulpf;
+
+  New(0, phitab, TINY_PROD, uint16_t);
+  phitab[0] = 0;
+  for (i = 1; i < TINY_PROD; i++)
+    phitab[i] = phitab[i-1] + ((i%2) && (i%3) && (i%5) && (i%7) && (i%11) && (i%13));
+  ctx.phitab = phitab;
+
+  patwords = (PAT_PERIOD + 2*WBITS) / WBITS + 1;
+  Newz(0, pattern, patwords, UV);
+  for (i = 0; i < patwords * WBITS; i++) {
+    UV v = 2*(i % PAT_PERIOD) + 1;
+    if ((v%3) && (v%5) && (v%7) && (v%11) && (v%13))
+      pattern[i / WBITS] |= UVCONST(1) << (i % WBITS);
+  }
+  ctx.pattern = pattern;
+
+  /* S1 */
+  ctx.s1block = 65536;
+  s1blocks = (y + ctx.s1block - 1) / ctx.s1block;
+  New(0, ctx.s1part, s1blocks, xint);
+  parallel_for(s1blocks, _s1_block, &ctx);
+  for (i = 0, s1 = 0; i < s1blocks; i++)
+    s1 += ctx.s1part[i];
+  Safefree(ctx.s1part);
+
+  /* Segment about sqrt(zmax) numbers, between 64k and 1M. */
+  ctx.segwords = CNT_WORDS;
+  while (ctx.segwords * 2*WBITS < 1048576 &&
+         (xuint)ctx.segwords * 2*WBITS * ctx.segwords * 2*WBITS < ctx.zmax)
+    ctx.segwords *= 2;
+  if (ctx.segwords * 2*WBITS < 65536)  ctx.segwords = 65536 / (2*WBITS);
+  seglen = ctx.segwords * 2*WBITS;
+
+  /* Enough chunks to balance the threads, but few enough that merging
+   * and the per-chunk counts stay cheap. */
+  nchunks = (ctx.zmax + seglen) / seglen;       /* segments covering [0,zmax] */
+  chunklen = (nthreads <= 1) ? nchunks : (nchunks + 16*nthreads - 1) / (16*nthreads);
+  if (chunklen < 1) chunklen = 1;
+  if (chunklen > 64) chunklen = 64;
+  chunklen *= seglen;
+  nchunks = (ctx.zmax + chunklen) / chunklen;
+  nround = (nthreads <= 1) ? 1 : 2*nthreads;
+
+  Newz(0, phig, a+1, UV);
+  New(0, ctx.chunks, nround, lmo_chunk_t);
+  s2 = 0;  p2sum = 0;  survg = 0;  pisqrt = 0;
+
+  for (i = 0; i < nchunks; i += nround) {
+    UV c, nc = (nchunks - i < nround) ? nchunks - i : nround;
+    for (c = 0; c < nc; c++) {
+      lmo_chunk_t *ch = ctx.chunks + c;
+      memset(ch, 0, sizeof(*ch));
+      ch->low = (i+c) * chunklen;
+      ch->high = (ctx.zmax+1 - ch->low > chunklen) ? ch->low + chunklen : ctx.zmax+1;
+      ch->nb = (ch->low == 0) ? a : _pi_table(primes, a, xisqrt(ctx.x / ch->low));
+      Newz(0, ch->phicnt, ch->nb, UV);
+      Newz(0, ch->musum, ch->nb, IV);
+    }
+    parallel_for(nc, _lmo_chunk, &ctx);
+    for (c = 0; c < nc; c++) {
+      lmo_chunk_t *ch = ctx.chunks + c;
+      s2 += ch->s2;
+      for (j = TINY_C; j < ch->nb; j++) {
+        s2 += (xint)ch->musum[j] * (xint)phig[j];
+        phig[j] += ch->phicnt[j];
+      }
+      p2sum += ch->p2 + (xuint)ch->np2 * (survg + ctx.k2 - 1);
+      if (ch->sqrtcnt != UV_MAX)
+        pisqrt = survg + ch->sqrtcnt + ctx.k2 - 1;
+      survg += ch->surv;
+      Safefree(ch->phicnt);
+      Safefree(ch->musum);
+    }
+  }
+  Safefree(ctx.chunks);
+  Safefree(phig);
+  Safefree(pattern);
+  Safefree(phitab);
+  Safefree(mulpf);
+  Safefree(primes);
+
+  /* P2 = sum over a < k <= pi(sqrt x) of pi(x/p_k) - (k-1) */
+  p2 = p2sum - ((xint)pisqrt*(pisqrt-1)/2 - (xint)a*(a-1)/2);
+  pix = s1 + s2 + (xint)a - 1 - p2;
+  _xint_to_mpz(count, pix);
+}
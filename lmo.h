@@ -0,0 +1,14 @@
+#ifndef MPU_LMO_H
+#define MPU_LMO_H
+
+#include <gmp.h>
+#include "ptypes.h"
+
+/* Largest input (in bits) the LMO code can handle.  This is 80 with a
+ * 128-bit integer type, otherwise the native word size. */
+extern int  lmo_max_bits(void);
+
+/* count = pi(n) for 0 <= n < 2^lmo_max_bits(). */
+extern void prime_count_lmo(mpz_t count, mpz_t n);
+
+#endif
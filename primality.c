@@ -1335,6 +1335,7 @@ int _GMP_is_prime(mpz_t n)
 
 int _GMP_is_provable_prime(mpz_t n, char** prooftext)
 {
+  bls_partial_t part;
   int prob_prime = primality_pretest(n);
   if (prob_prime != 1)  return prob_prime;
 
@@ -1368,18 +1369,23 @@ int _GMP_is_provable_prime(mpz_t n, char** prooftext)
    *   ECPP     _GMP_ecpp               fastest in general
    */
 
+  /* ECPP picks up the factoring where these leave off. */
+  bls_partial_init(&part);
   if (prooftext) {
     /* Give n-1 a small go */
-    prob_prime = BLS_primality_nm1(n, is_proth_form(n) ? 3 : 1, prooftext);
-    if (prob_prime != 1)  return prob_prime;
+    prob_prime = BLS_primality_nm1_partial(n, is_proth_form(n) ? 3 : 1, prooftext, &part);
+    /* Proofs of some factors, which we won't be using */
+    if (prob_prime == 1 && *prooftext != 0)
+      { Safefree(*prooftext);  *prooftext = 0; }
   } else {
     /* See if there's an easy n-1 / n+1 hybrid proof */
-    prob_prime = BLS_primality(n, is_proth_form(n) ? 3 : 1, prooftext);
-    if (prob_prime != 1)  return prob_prime;
+    prob_prime = BLS_primality_partial(n, is_proth_form(n) ? 3 : 1, prooftext, &part);
   }
 
   /* ECPP */
-  prob_prime = _GMP_ecpp(n, prooftext);
+  if (prob_prime == 1)
+    prob_prime = _GMP_ecpp_partial(n, prooftext, &part);
+  bls_partial_clear(&part);
 
   /* While extremely unusual, it is not impossible for our ECPP implementation
    * to give up.  If this happens, we won't return 2 with a proof, but let's
@@ -7,6 +7,11 @@
 #define FUNC_isqrt 1
 #include "utility.h"
 #include "prime_iterator.h"
+#include "threadpool.h"
+
+#ifdef USE_PTHREADS
+ #include <pthread.h>
+#endif
 
 
 /* Add this to a number and you'll ensure you're on a wheel location */
@@ -300,8 +305,103 @@ static const UV primary_limit = (30 * PRIMARY_SIZE)-1;
 static const uint32_t* small_primes = 0;
 static UV num_small_primes = 0;
 
+/* The shared prime table.  Each growth builds a whole new table and
+ * publishes it with a single pointer store, so a reader sees either the old
+ * or the new one, both complete.  Old tables stay alive until shutdown
+ * because a reader may still be using them.  With doubling they add up to
+ * less than the current one. */
+typedef struct prime_table_s {
+  UV        limit;          /* Holds every prime <= limit */
+  UV        count;          /* ... and there are this many */
+  uint32_t *primes;         /* count+2 entries, the last two past limit */
+  struct prime_table_s *prev;
+} prime_table_t;
+
+static prime_table_t * volatile _ptable = 0;
+
+#if defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7))
+  #define PTABLE_LOAD()     __atomic_load_n(&_ptable, __ATOMIC_ACQUIRE)
+  #define PTABLE_STORE(t)   __atomic_store_n(&_ptable, t, __ATOMIC_RELEASE)
+  #define PTABLE_LOCKFREE   1
+#else
+  #define PTABLE_LOAD()     (_ptable)
+  #define PTABLE_STORE(t)   (_ptable = (t))
+  #define PTABLE_LOCKFREE   0
+#endif
+
+/* Each thread keeps the last segment an iterator gave up, both the buffer
+ * and what was sieved into it.  The next iterator on that thread reuses the
+ * buffer instead of allocating, and skips the sieve entirely if it starts
+ * at the same place, as repeated stage 2 runs over one range do.  Nothing is
+ * shared between threads, so there is no locking and no allocator traffic
+ * once a thread has its buffer. */
+typedef struct {
+  unsigned char *mem;
+  UV             lod;      /* mem holds the segment starting at byte lod */
+} segment_cache_t;
+
+#ifdef USE_PTHREADS
+static pthread_key_t _segkey;
+static int _segkey_ok = 0;
+
+static void _segcache_free(void *vc)
+{
+  segment_cache_t *c = (segment_cache_t*) vc;
+  if (c->mem != 0)  Safefree(c->mem);
+  Safefree(c);
+}
+
+static segment_cache_t* _segcache(void)
+{
+  segment_cache_t *c;
+  if (!_segkey_ok) return 0;
+  c = (segment_cache_t*) pthread_getspecific(_segkey);
+  if (c == 0) {
+    Newz(0, c, 1, segment_cache_t);
+    if (pthread_setspecific(_segkey, c) != 0) { Safefree(c); c = 0; }
+  }
+  return c;
+}
+#else
+static segment_cache_t _segcache_one = {0, 0};
+#define _segcache()  (&_segcache_one)
+#endif
+
+/* A SEGMENT_SIZE buffer holding the sieve of bytes lod .. lod+SEGMENT_SIZE-1. */
+static unsigned char* _segment_get(UV lod)
+{
+  segment_cache_t *c = _segcache();
+  unsigned char *mem = 0;
+  if (c != 0 && c->mem != 0) {
+    mem = c->mem;
+    c->mem = 0;
+    if (c->lod == lod) return mem;
+  }
+  if (mem == 0)
+    New(0, mem, SEGMENT_SIZE, unsigned char);
+  if (!sieve_segment(mem, lod, lod + SEGMENT_SIZE - 1, primary_sieve, primary_limit))
+    croak("Could not segment sieve");
+  return mem;
+}
+
+/* Hand a segment back to this thread's cache, or free it if that is full. */
+static void _segment_put(const unsigned char *mem, UV lod)
+{
+  segment_cache_t *c = _segcache();
+  if (c != 0 && c->mem == 0) {
+    c->mem = (unsigned char*) mem;
+    c->lod = lod;
+  } else {
+    Safefree(mem);
+  }
+}
+
 void prime_iterator_global_startup(void)
 {
+#ifdef USE_PTHREADS
+  if (!_segkey_ok)
+    _segkey_ok = (pthread_key_create(&_segkey, _segcache_free) == 0);
+#endif
   primary_sieve = sieve_erat30(primary_limit);
 #ifdef NSMALL_PRIMES
   {
@@ -318,6 +418,25 @@ void prime_iterator_global_startup(void)
 
 void prime_iterator_global_shutdown(void)
 {
+  prime_table_t *tab, *prev;
+  for (tab = (prime_table_t*) _ptable; tab != 0; tab = prev) {
+    prev = tab->prev;
+    Safefree(tab->primes);
+    Safefree(tab);
+  }
+  _ptable = 0;
+#ifdef USE_PTHREADS
+  if (_segkey_ok) {
+    segment_cache_t *c = (segment_cache_t*) pthread_getspecific(_segkey);
+    if (c != 0) _segcache_free(c);
+    pthread_setspecific(_segkey, 0);
+    pthread_key_delete(_segkey);
+    _segkey_ok = 0;
+  }
+#else
+  if (_segcache_one.mem != 0)  Safefree(_segcache_one.mem);
+  _segcache_one.mem = 0;
+#endif
   if (primary_sieve != 0)  Safefree(primary_sieve);
   if (small_primes != 0)   Safefree(small_primes);
   primary_sieve = 0;
@@ -342,7 +461,8 @@ prime_iterator prime_iterator_default(void)
 
 void prime_iterator_destroy(prime_iterator *iter)
 {
-  if (iter->segment_mem != 0)  Safefree(iter->segment_mem);
+  if (iter->segment_mem != 0)
+    _segment_put(iter->segment_mem, iter->segment_start/30);
   iter->segment_mem = 0;
   iter->segment_start = 0;
   iter->segment_bytes = 0;
@@ -384,14 +504,10 @@ void prime_iterator_setprime(prime_iterator *iter, UV n) {
   if (n <= primary_limit) { /* Is it inside the primary cache range? */
     iter->p = n;
   } else { /* Sieve this range */
-    UV lod, hid;
-    lod = n/30;
-    hid = lod + SEGMENT_SIZE;
-    New(0, iter->segment_mem, SEGMENT_SIZE, unsigned char );
+    UV lod = n/30;
+    iter->segment_mem = _segment_get(lod);
     iter->segment_start = lod * 30;
     iter->segment_bytes = SEGMENT_SIZE;
-    if (!sieve_segment((unsigned char*)iter->segment_mem, lod, hid, primary_sieve, primary_limit))
-      croak("Could not segment sieve");
     iter->p = n;
   }
 }
@@ -441,20 +557,18 @@ UV prime_iterator_next(prime_iterator *iter)
     }
     /* Not found in this segment */
     lod = (seg_end+1)/30;
+    hid = lod + SEGMENT_SIZE - 1;
+    if (!sieve_segment((unsigned char*)sieve, lod, hid, primary_sieve, primary_limit))
+      croak("Could not segment sieve from %"UVuf" to %"UVuf, 30*lod, 30*hid+29);
   } else {
     lod = PRIMARY_SIZE;
-    New(0, sieve, SEGMENT_SIZE, unsigned char );
+    sieve = _segment_get(lod);
   }
 
-  hid = lod + SEGMENT_SIZE - 1;
   iter->segment_start = lod * 30;
   iter->segment_bytes = SEGMENT_SIZE;
-  seg_beg = iter->segment_start;
-  seg_end = iter->segment_start + 30*iter->segment_bytes - 1;
-
-  if (!sieve_segment((unsigned char*)sieve, lod, hid, primary_sieve, primary_limit))
-    croak("Could not segment sieve from %"UVuf" to %"UVuf, seg_beg, seg_end);
   iter->segment_mem = sieve;
+  seg_beg = iter->segment_start;
 
   n = next_prime_in_segment(sieve, seg_beg, iter->segment_bytes, seg_beg);
   if (n > 0) {
@@ -515,10 +629,105 @@ int prime_iterator_isprime(prime_iterator *iter, UV n)
   }
 }
 
+/* An upper bound for pi(n), with a little room. */
+static UV _pi_upper(UV n)
+{
+  return (n < 67)     ? 18
+       : (n < 355991) ? 15+(n/(log(n)-1.09))
+       : (n/log(n)) * (1.0+1.0/log(n)+2.51/(log(n)*log(n)));
+}
+
+/* Append the primes marked in sieve (bytes lod .. hid) to list. */
+static UV _sieve_to_list(uint32_t* list, UV n, const unsigned char* sieve,
+                         UV lod, UV hid)
+{
+  UV d, p;
+  for (d = lod, p = 30*lod;  d <= hid;  d++, p += 30) {
+    UV c = sieve[d-lod];
+    if (c == 0xFF) continue;
+    if (!(c &   1)) list[n++] = p+ 1;
+    if (!(c &   2)) list[n++] = p+ 7;
+    if (!(c &   4)) list[n++] = p+11;
+    if (!(c &   8)) list[n++] = p+13;
+    if (!(c &  16)) list[n++] = p+17;
+    if (!(c &  32)) list[n++] = p+19;
+    if (!(c &  64)) list[n++] = p+23;
+    if (!(c & 128)) list[n++] = p+29;
+  }
+  return n;
+}
+
+/* A table with all primes to limit (30k-1), extending old if given. */
+static prime_table_t* _ptable_build(prime_table_t *old, UV limit)
+{
+  static const uint32_t first[10] = {2,3,5,7,11,13,17,19,23,29};
+  prime_table_t *tab;
+  unsigned char *seg;
+  UV n, lod, hid, endd = limit/30;
+
+  New(0, tab, 1, prime_table_t);
+  New(0, tab->primes, _pi_upper(limit) + 12, uint32_t);
+  if (old == 0) {
+    memcpy(tab->primes, first, sizeof(first));
+    n = 10;
+    lod = 1;
+  } else {
+    memcpy(tab->primes, old->primes, old->count * sizeof(uint32_t));
+    n = old->count;
+    lod = (old->limit+1)/30;
+  }
+  New(0, seg, SEGMENT_SIZE, unsigned char);
+  for ( ; lod <= endd; lod = hid+1) {
+    hid = (endd - lod >= SEGMENT_SIZE) ? lod + SEGMENT_SIZE - 1 : endd;
+    sieve_segment(seg, lod, hid, primary_sieve, primary_limit);
+    n = _sieve_to_list(tab->primes, n, seg, lod, hid);
+  }
+  Safefree(seg);
+  tab->primes[n] = tab->primes[n+1] = 0xFFFFFFFFU;
+  tab->limit = limit;
+  tab->count = n;
+  tab->prev = old;
+  return tab;
+}
+
+const uint32_t* prime_table(UV n, UV *count)
+{
+  prime_table_t *tab;
+
+  if (n > PRIME_TABLE_LIMIT) return 0;
+
+  tab = PTABLE_LOCKFREE ? PTABLE_LOAD() : 0;
+  if (tab == 0 || tab->limit < n) {
+    parallel_lock();
+    tab = _ptable;
+    if (tab == 0 || tab->limit < n) {
+      /* Grow by doubling, so repeated small steps stay cheap. */
+      UV limit = (tab == 0) ? primary_limit : 2*tab->limit+1;
+      if (limit < n) limit = n;
+      if (limit > PRIME_TABLE_LIMIT) limit = PRIME_TABLE_LIMIT;
+      tab = _ptable_build(tab, 30*(limit/30)+29);
+      PTABLE_STORE(tab);
+    }
+    parallel_unlock();
+  }
+
+  if (count != 0) {
+    UV lo = (n == tab->limit) ? tab->count : 0,  hi = tab->count;
+    while (lo < hi) {
+      UV mid = lo + (hi-lo)/2;
+      if (tab->primes[mid] <= n) lo = mid+1;
+      else                       hi = mid;
+    }
+    *count = lo;
+  }
+  return tab->primes;
+}
+
 UV* sieve_to_n(UV n, UV* count)
 {
   UV pi_max, max_buf, i, p, pi;
   const unsigned char* sieve;
+  const uint32_t* table;
   UV* primes;
 
 #ifdef NSMALL_PRIMES
@@ -531,9 +740,15 @@ UV* sieve_to_n(UV n, UV* count)
   }
 #endif
 
-  pi_max = (n < 67)     ? 18
-           : (n < 355991) ? 15+(n/(log(n)-1.09))
-           : (n/log(n)) * (1.0+1.0/log(n)+2.51/(log(n)*log(n)));
+  table = prime_table(n, &pi);
+  if (table != 0) {
+    New(0, primes, pi + 1, UV);
+    for (i = 0; i < pi; i++)  primes[i] = table[i];
+    if (count != 0) *count = pi;
+    return primes;
+  }
+
+  pi_max = _pi_upper(n);
   New(0, primes, pi_max + 10, UV);
 
   pi = 0;
@@ -12,6 +12,15 @@ typedef struct {
 
 #define PRIME_ITERATOR(i)  prime_iterator i = {2, 0, 0, 0}
 
+/* Thread safety: global startup and shutdown must run with no iterator in
+ * use.  Between them the shared sieves are read-only, so any number of
+ * threads may each run their own iterators.  One iterator must not be used
+ * from two threads at once.
+ *
+ * Past the primary sieve an iterator works from a segment buffer.  Each
+ * thread caches the last buffer given up, so iterators that are created and
+ * destroyed in a loop, or repositioned with setprime, do not allocate. */
+
 extern void prime_iterator_global_startup(void);
 extern void prime_iterator_global_shutdown(void);
 
@@ -23,4 +32,21 @@ extern int prime_iterator_isprime(prime_iterator *iter, UV n);
 
 extern UV* sieve_to_n(UV n, UV* count);
 
+/* A shared, read-only table of the primes as 32-bit values, for loops that
+ * walk many primes.  Returns an array whose first *count entries are the
+ * primes <= n, followed by at least two entries greater than n.  The table
+ * grows on demand and may be called from any thread.  The array is never
+ * changed or freed before global shutdown, so it can be kept.
+ *
+ * Returns 0 if n is over PRIME_TABLE_LIMIT, which may be set at build time.
+ * The whole table to the limit takes about 0.2*limit bytes. */
+#ifndef PRIME_TABLE_LIMIT
+ #if BITS_PER_WORD == 64
+  #define PRIME_TABLE_LIMIT 268435455U
+ #else
+  #define PRIME_TABLE_LIMIT 16777215U
+ #endif
+#endif
+extern const uint32_t* prime_table(UV n, UV *count);
+
 #endif
@@ -0,0 +1,306 @@
+/*
+ * Batch prime gap search around the centres m*K, as used for record gap
+ * hunts with K = P#/d.
+ *
+ * For every sieving prime p we keep the start of the current centre's
+ * interval mod p, and K mod p.  Stepping to the next centre is then one
+ * modular add per prime rather than a bignum remainder, so the sieve state
+ * is shared by a whole run of centres.  Each interval is [c-W, c+W] with W
+ * a little over the merit target.
+ *
+ * The gap around c is found by first locating the next prime above c.
+ * That fixes how far below c the previous prime must be for the gap to
+ * qualify, and the downward scan gives up at the first probable prime
+ * closer than that.  Most centres therefore cost about two prime searches
+ * in a sieved interval, almost all of them single Miller-Rabin tests, and
+ * no bignum work at all for the sieve.
+ *
+ * Runs of centres are independent, and are spread over threads in rounds.
+ * Results are delivered in order between rounds.
+ */
+
+#include <string.h>
+#include <math.h>
+#include <gmp.h>
+#include "ptypes.h"
+
+#include "primegaps.h"
+#include "gmp_main.h"
+#include "primality.h"
+#include "prime_iterator.h"
+#include "threadpool.h"
+#define FUNC_mpz_logn 1
+#include "utility.h"
+
+/* Centres per work unit.  Units are made longer when there are many
+ * large primes, so their setup stays small next to the testing. */
+#define GAP_UNIT_CENTRES 256
+
+typedef struct {
+  UV m, dp, dn;
+} gap_result_t;
+
+typedef struct {
+  gap_result_t *res;
+  UV            n, nmax;
+} gap_unit_t;
+
+typedef struct {
+  mpz_ptr   K;
+  double    logK, minmerit;
+  UV        W, np, nsmall, ucentres, mlo, mbeg, mend;
+  const uint32_t *primes;
+  uint32_t *Kmod, *rbase;
+  gap_unit_t *units;
+} gap_ctx_t;
+
+/* Candidates are screened with a base 2 strong test.  Only the primes that
+ * end a reported gap get the Lucas half of BPSW.  A base 2 pseudoprime could
+ * hide a gap, but at the sizes searched that will not happen in practice. */
+#define GAP_SPRP(t)   miller_rabin_ui(t,2)
+#define GAP_LUCAS(t)  _GMP_is_lucas_pseudoprime(t,2)
+
+#define NO_HIT 0xFFFFFFFFU
+
+/* Smallest x >= 0 with l <= (a*x mod m) <= r, for 0 <= l <= r < m and
+ * 0 <= a < m, or UV_MAX if there is none.  m*m must fit in a UV. */
+static UV _modsearch(UV a, UV m, UV l, UV r)
+{
+  UV x, y;
+  if (l == 0) return 0;
+  if (a == 0) return UV_MAX;
+  x = (l + a - 1) / a;
+  if (a * x <= r) return x;
+  y = _modsearch(m % a, a, (a - r % a) % a, (a - l % a) % a);
+  if (y == UV_MAX) return UV_MAX;
+  return (m * y + l + a - 1) / a;
+}
+
+/* Offset from x of the first centre at or after x whose interval p hits,
+ * given u = (start of centre x's interval + 2W) mod p. */
+static UV _next_hit(UV u, UV k, UV p, UV W2)
+{
+  if (u <= W2) return 0;
+  return _modsearch(k, p, p - u, p - u + W2);
+}
+
+/* Centres m = mbeg + u*ucentres ... in this round. */
+static void _gap_unit(void *vctx, UV u)
+{
+  const gap_ctx_t *ctx = (const gap_ctx_t*) vctx;
+  gap_unit_t *out = ctx->units + u;
+  UV W = ctx->W, W2 = 2*ctx->W, np = ctx->np, nsmall = ctx->nsmall;
+  UV j, d, m, m0, x, ncentres;
+  uint32_t *r, *A, *link, *head;
+  char *comp;
+  mpz_t base, t;
+
+  m0 = ctx->mbeg + u * ctx->ucentres;
+  ncentres = ctx->mend - m0 + 1;
+  if (ncentres > ctx->ucentres || ncentres == 0) ncentres = ctx->ucentres;
+  out->n = 0;
+  out->nmax = 16;
+  New(0, out->res, out->nmax, gap_result_t);
+  New(0, comp, W2+1, char);
+  New(0, r, np+1, uint32_t);
+  mpz_init(base);  mpz_init(t);
+
+  /* Interval start mod p for our first centre, from that of the first centre
+   * of the search.  Small primes are stepped every centre.  Large primes hit
+   * rarely, so each sits in the list of the next centre it hits. */
+  for (j = 0; j < np; j++) {
+    UV p = ctx->primes[j];
+    r[j] = (ctx->rbase[j] + ((m0 - ctx->mlo) % p) * ctx->Kmod[j]) % p;
+  }
+  A = r + nsmall;
+  New(0, link, np - nsmall + 1, uint32_t);
+  New(0, head, ncentres, uint32_t);
+  for (x = 0; x < ncentres; x++)
+    head[x] = NO_HIT;
+  for (j = nsmall; j < np; j++) {
+    UV p = ctx->primes[j], a = (A[j-nsmall] + W2) % p;
+    A[j-nsmall] = a;
+    x = _next_hit(a, ctx->Kmod[j], p, W2);
+    if (x < ncentres) {
+      link[j-nsmall] = head[x];
+      head[x] = j - nsmall;
+    }
+  }
+
+  mpz_mul_ui(base, ctx->K, m0);
+  mpz_sub_ui(base, base, W);
+
+  for (x = 0; x < ncentres; x++) {
+    UV dn, dp, need;
+    uint32_t jl, jnext;
+    double logc;
+
+    m = m0 + x;
+    logc = ctx->logK + log((double)m);
+
+    /* Sieve [c-W, c+W] and step the small prime remainders. */
+    memset(comp, 0, W2+1);
+    for (j = 0; j < nsmall; j++) {
+      uint32_t p = ctx->primes[j], rj = r[j];
+      UV i = rj ? p - rj : 0;
+      for ( ; i <= W2; i += p)
+        comp[i] = 1;
+      rj += ctx->Kmod[j];
+      r[j] = (rj >= p) ? rj - p : rj;
+    }
+    /* Large primes hitting this interval, each moved to its next centre. */
+    for (jl = head[x]; jl != NO_HIT; jl = jnext) {
+      UV p = ctx->primes[nsmall+jl], k = ctx->Kmod[nsmall+jl];
+      UV ux = (A[jl] + (x % p) * k) % p, nx;
+      jnext = link[jl];
+      comp[W2 - ux] = 1;
+      ux += k;  if (ux >= p) ux -= p;
+      nx = _next_hit(ux, k, p, W2);
+      if (nx < ncentres - x - 1) {
+        nx += x + 1;
+        link[jl] = head[nx];
+        head[nx] = jl;
+      }
+    }
+
+    /* Distance to the next prime above c. */
+    for (d = 1; d <= W; d++)
+      if (!comp[W+d] && (mpz_add_ui(t, base, W+d), GAP_SPRP(t)) && GAP_LUCAS(t))
+        break;
+    if (d > W) {
+      mpz_add_ui(t, base, 2*W);
+      _GMP_next_prime(t);
+      mpz_sub(t, t, base);
+      d = mpz_get_ui(t) - W;
+    }
+    dn = d;
+
+    /* The previous prime (c itself counts) has to be at least dp away. */
+    need = (UV)(ctx->minmerit * logc);
+    dp = (need > dn) ? need - dn : 0;
+    for (d = 0; d <= W; d++)
+      if (!comp[W-d] && (mpz_add_ui(t, base, W-d), GAP_SPRP(t)) &&
+          (d < dp || GAP_LUCAS(t)))
+        break;
+    if (d > W) {
+      mpz_set(t, base);
+      _GMP_prev_prime(t);
+      mpz_sub(t, base, t);
+      d = W + mpz_get_ui(t);
+    }
+    if (d >= dp) {
+      gap_result_t *g;
+      if (out->n >= out->nmax)
+        Renew(out->res, out->nmax *= 2, gap_result_t);
+      g = out->res + out->n++;
+      g->m = m;  g->dp = d;  g->dn = dn;
+    }
+
+    mpz_add(base, base, ctx->K);
+  }
+
+  mpz_clear(t);  mpz_clear(base);
+  Safefree(head);
+  Safefree(link);
+  Safefree(r);
+  Safefree(comp);
+}
+
+int prime_gap_search(mpz_t K, UV mlo, UV mhi, double minmerit,
+                     UV depth, prime_gap_fn fn, void *fnctx)
+{
+  gap_ctx_t ctx;
+  UV j, nunits, nprimes;
+  uint32_t *ownprimes = 0;
+  double logc;
+  mpz_t c, last, p1;
+  int stop = 0;
+
+  if (mlo > mhi) return 1;
+  mpz_init(c);
+  mpz_mul_ui(c, K, mlo);
+  if (mpz_cmp_ui(c, 3) < 0) { mpz_clear(c); return 0; }
+
+  ctx.K = K;
+  ctx.logK = mpz_logn(K);
+  ctx.minmerit = minmerit;
+  logc = ctx.logK + log((double)mhi);
+  ctx.W = (UV) (((minmerit > 3.0) ? minmerit : 3.0) * logc) + 1;
+
+  /* Interval ends must stay above the sieving primes. */
+  if (mpz_cmp_ui(c, 2*ctx.W + 3) < 0)
+    ctx.W = (mpz_get_ui(c) - 3) / 2;
+  /* Sieving removes a share of the tests falling like 1/log(depth), while
+   * the tests get dearer with size.  Balance at about bits^3 / 200. */
+  if (depth == 0) {
+    double bits = logc * 1.442695;
+    depth = (bits*bits*bits/200 > 1e8) ? 100000000 : (UV)(bits*bits*bits/200);
+    if (depth < 1000) depth = 1000;
+  }
+#if BITS_PER_WORD == 64
+  if (depth > 4294967295U) depth = 4294967295U;
+#else
+  if (depth > 65535) depth = 65535;     /* p^2 must fit */
+#endif
+  mpz_sub_ui(c, c, ctx.W);
+  if (mpz_cmp_ui(c, depth) <= 0)
+    depth = mpz_get_ui(c) - 1;
+
+  ctx.primes = prime_table(depth, &nprimes);
+  if (ctx.primes == 0) {                  /* Deeper than the shared table */
+    UV *primes = sieve_to_n(depth, &nprimes);
+    New(0, ownprimes, nprimes+1, uint32_t);
+    for (j = 0; j < nprimes; j++)
+      ownprimes[j] = primes[j];
+    Safefree(primes);
+    ctx.primes = ownprimes;
+  }
+  ctx.np = nprimes;
+  ctx.nsmall = 0;
+  ctx.mlo = mlo;
+  New(0, ctx.Kmod, ctx.np+1, uint32_t);
+  New(0, ctx.rbase, ctx.np+1, uint32_t);
+  for (j = 0; j < ctx.np; j++) {
+    ctx.Kmod[j] = mpz_fdiv_ui(K, ctx.primes[j]);
+    ctx.rbase[j] = mpz_fdiv_ui(c, ctx.primes[j]);
+    if (ctx.primes[j] <= 32*(2*ctx.W+1))
+      ctx.nsmall = j+1;
+  }
+  ctx.ucentres = (ctx.np - ctx.nsmall) / 32;
+  if (ctx.ucentres < GAP_UNIT_CENTRES) ctx.ucentres = GAP_UNIT_CENTRES;
+
+  mpz_init_set_ui(last, 0);
+  mpz_init(p1);
+  nunits = 4 * get_thread_count();
+  New(0, ctx.units, nunits, gap_unit_t);
+
+  for (ctx.mbeg = mlo; !stop; ctx.mbeg += nunits * ctx.ucentres) {
+    UV u, span = (mhi - ctx.mbeg) / ctx.ucentres + 1;
+    UV n = (span < nunits) ? span : nunits;
+    ctx.mend = mhi;
+    parallel_for(n, _gap_unit, &ctx);
+    for (u = 0; u < n; u++) {
+      gap_unit_t *unit = ctx.units + u;
+      for (j = 0; j < unit->n && !stop; j++) {
+        gap_result_t *g = unit->res + j;
+        double merit;
+        mpz_mul_ui(p1, K, g->m);
+        mpz_sub_ui(p1, p1, g->dp);
+        if (mpz_cmp(p1, last) == 0) continue;   /* Already reported */
+        mpz_set(last, p1);
+        merit = (double)(g->dp + g->dn) / mpz_logn(p1);
+        if (merit >= minmerit)
+          stop = fn(fnctx, p1, g->dp + g->dn, merit);
+      }
+      Safefree(unit->res);
+    }
+    if (mhi - ctx.mbeg < nunits * ctx.ucentres) break;
+  }
+
+  Safefree(ctx.units);
+  Safefree(ctx.rbase);
+  Safefree(ctx.Kmod);
+  if (ownprimes != 0) Safefree(ownprimes);
+  mpz_clear(p1);  mpz_clear(last);  mpz_clear(c);
+  return 1;
+}
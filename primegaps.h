@@ -0,0 +1,18 @@
+#ifndef MPU_PRIMEGAPS_H
+#define MPU_PRIMEGAPS_H
+
+#include <gmp.h>
+#include "ptypes.h"
+
+/* Search for prime gaps of merit at least minmerit that contain one of the
+ * centres m*K, mlo <= m <= mhi.  Each gap found is handed to fn with its
+ * lower prime, size, and merit (gap / log(p1)), in increasing order.  A gap
+ * spanning several centres is reported once.  Stops early if fn returns
+ * nonzero.  depth is the sieve limit, 0 to choose one.
+ *
+ * Returns 0 without searching if the first centre is less than 3. */
+typedef int (*prime_gap_fn)(void *ctx, mpz_t p1, UV gap, double merit);
+extern int prime_gap_search(mpz_t K, UV mlo, UV mhi, double minmerit,
+                            UV depth, prime_gap_fn fn, void *ctx);
+
+#endif
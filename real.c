@@ -10,6 +10,7 @@
 #include "factor.h"
 #define FUNC_mpz_logn 1
 #include "utility.h"
+#include "threadpool.h"
 
 static unsigned long precbits(mpf_t x, unsigned long prec, unsigned long add) {
   unsigned long bits1 = mpf_get_prec(x), bits2 = DIGS2BITS(prec);
@@ -619,20 +620,31 @@ static void _const_log2(mpf_t logn, unsigned long prec)
   mpz_clear(t1); mpz_clear(t2); mpz_clear(term1); mpz_clear(term2); mpz_clear(pows);
 }
 
-/* Cache constants.  We should thread lock these. */
+/* Cache constants.  Worker threads computing class polys use pi, so the
+ * cache is locked.  The computation itself is not (euler uses log, which
+ * uses log2), so the more precise of two racing results is kept. */
 static mpf_t _fconst_euler, _fconst_pi, _fconst_log2;
 static unsigned long _prec_euler = 0, _prec_pi = 0, _prec_log2 = 0;
 
 #define CONST_FUNC(name) \
   void const_##name(mpf_t c, unsigned long prec) { \
+    mpf_t t; \
+    parallel_lock(); \
     if (prec > _prec_##name) { \
+      parallel_unlock(); \
       prec += 10; \
-      if (_prec_##name == 0) mpf_init2(_fconst_##name, 7+DIGS2BITS(prec)); \
-      else                   mpf_set_prec(_fconst_##name, 7+DIGS2BITS(prec)); \
-      _const_##name(_fconst_##name, prec); \
-      _prec_##name = prec; \
+      mpf_init2(t, 7+DIGS2BITS(prec)); \
+      _const_##name(t, prec); \
+      parallel_lock(); \
+      if (prec > _prec_##name) { \
+        if (_prec_##name == 0) mpf_init(_fconst_##name); \
+        mpf_swap(_fconst_##name, t); \
+        _prec_##name = prec; \
+      } \
+      mpf_clear(t); \
     } \
     mpf_set(c, _fconst_##name); \
+    parallel_unlock(); \
   }
 
 CONST_FUNC(euler);
@@ -1007,20 +1019,21 @@ static void _bernfrac_zeta(mpz_t num, mpz_t den, unsigned long n, mpz_t t)
 
   /* Calculate denominator */
   {
-    int i, ndivisors;
-    mpz_t *D;
+    divisor_iterator iter;
+    mpz_t d;
 
+    mpz_init(d);
     mpz_set_ui(t, n >> 1);
-    D = divisor_list(&ndivisors, t);
     mpz_set_ui(den, 6);
-    for (i = 1; i < ndivisors; i++) {
-      mpz_mul_2exp(t,D[i],1);  mpz_add_ui(t,t,1);
+    mpz_set_ui(d, 2);
+    divisor_iterator_init(&iter, t, d, 0, 0);   /* order does not matter */
+    while (divisor_iterator_next(&iter, d)) {
+      mpz_mul_2exp(t,d,1);  mpz_add_ui(t,t,1);
       if (_GMP_is_prime(t))
         mpz_mul(den, den, t);
     }
-    for (i = 0; i < ndivisors; i++)
-      mpz_clear(D[i]);
-    Safefree(D);
+    divisor_iterator_destroy(&iter);
+    mpz_clear(d);
   }
 
   /* Estimate number of bits, from Pari, also see Stein 2006 */
@@ -1206,6 +1219,10 @@ char* zetareal(mpf_t z, unsigned long prec)
   gmp_sprintf(out, "%.*Ff", (int)(prec), z);
   return out;
 }
+void riemannr(mpf_t r, mpf_t n, unsigned long prec)
+{
+  _riemann_r(r, n, prec);
+}
 char* riemannrreal(mpf_t r, unsigned long prec)
 {
   if (mpf_cmp_ui(r,0) <= 0) return 0;
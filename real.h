@@ -8,6 +8,7 @@ extern void bernfrac(mpz_t num, mpz_t den, mpz_t n);
 extern void harmfrac(mpz_t num, mpz_t den, mpz_t n);
 extern void li(mpf_t li, mpf_t x, unsigned long prec);
 extern void ei(mpf_t li, mpf_t x, unsigned long prec);
+extern void riemannr(mpf_t r, mpf_t x, unsigned long prec);
 
 extern void const_euler(mpf_t gamma, unsigned long prec);
 extern void const_pi(mpf_t pi, unsigned long prec);
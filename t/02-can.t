@@ -11,6 +11,10 @@ my @functions = qw(
                      is_bpsw_prime
                      is_provable_prime
                      is_provable_prime_with_cert
+                     verify_prime_certificate
+                     prime_certificate_to_binary
+                     prime_certificate_to_text
+                     forprovable
                      is_aks_prime
                      is_nminus1_prime
                      is_nplus1_prime
@@ -40,7 +44,11 @@ my @functions = qw(
                      sieve_primes
                      sieve_twin_primes
                      sieve_prime_cluster
+                     twin_prime_count twin_prime_count_approx
+                     cluster_count cluster_count_approx
                      sieve_range
+                     sieve_primes_bitmap sieve_range_bitmap
+                     forprimes forclusters forprimegaps
                      next_prime
                      prev_prime
                      surround_primes
@@ -54,11 +62,14 @@ my @functions = qw(
                      ecm_factor
                      qs_factor
                      factor
-                     divisors
+                     divisors fordivisors lastfor
                      sigma
+                     totient_range sigma_range carmichael_lambda_range
+                     liouville_range prime_omega_range prime_bigomega_range
+                     is_semiprime_range
                      chinese
                      moebius
-                     prime_count prime_count_lower prime_count_upper
+                     prime_count prime_count_lower prime_count_upper nth_prime
                      primorial
                      pn_primorial
                      factorial subfactorial multifactorial factorial_sum
@@ -3,9 +3,9 @@ use strict;
 use warnings;
 
 use Test::More;
-use Math::Prime::Util::GMP qw/primes sieve_twin_primes sieve_primes sieve_range/;
+use Math::Prime::Util::GMP qw/primes sieve_twin_primes sieve_primes sieve_range sieve_primes_bitmap sieve_range_bitmap forprimes lastfor/;
 
-plan tests => 12 + 12 + 1 + 19 + 1 + 1 + 13*1 + 7 + 2;
+plan tests => 12 + 12 + 1 + 19 + 1 + 1 + 13*1 + 7 + 2 + 2 + 4 + 3 + 4;
 
 ok(!eval { primes(undef); },   "primes(undef)");
 ok(!eval { primes("a"); },     "primes(a)");
@@ -123,6 +123,35 @@ is( scalar @{primes(474973,538390)}, 44454 - 39617, "count primes within a range
 
 is_deeply( [sieve_primes(1e6,1e6+100,100)], [qw/1000001 1000003 1000009 1000033 1000037 1000039 1000049 1000079 1000081 1000099/], "use sieve_primes to partial sieve a range" );
 is_deeply( [sieve_range('6295609118348014841031009747805006052065816763110427',3204+1,3e6)], [qw/0 32 42 54 62 72 134 152 204 224 236 240 254 300 314 342 432 512 530 620 650 666 702 704 720 732 786 806 834 846 926 936 980 986 1014 1022 1034 1050 1080 1112 1122 1142 1170 1194 1206 1230 1274 1292 1296 1334 1374 1376 1422 1470 1476 1506 1530 1544 1574 1586 1632 1674 1686 1752 1772 1836 1842 1890 1902 1932 1946 1976 1986 1994 2030 2042 2060 2064 2100 2102 2136 2172 2244 2246 2276 2312 2346 2360 2370 2396 2424 2462 2490 2504 2532 2552 2610 2640 2700 2702 2760 2772 2790 2832 2886 2930 2942 2982 2996 3026 3042 3060 3092 3164 3204/], "use sieve_range to sieve a large range" );
+is( scalar(my @l = sieve_primes("100000000000000000001","100000000000020000000",50000000)), 637365, "sieve_primes deep partial sieve of 10^20 + 2*10^7" );
+{
+  Math::Prime::Util::GMP::_GMP_set_threads(3);
+  is( scalar(my @l = sieve_primes("100000000000000000000","100000000000020000000",50000000)), 637365, "sieve_primes deep partial sieve of 10^20 + 2*10^7 using 3 threads" );
+  Math::Prime::Util::GMP::_GMP_set_threads(1);
+}
+{
+  my @p;
+  forprimes { push @p, $_ } 1000;
+  is_deeply( \@p, primes(1000), "forprimes to 1000" );
+  @p = ();
+  forprimes { push @p, $_ } "18446744073709551557", "18446744073709552000";
+  is_deeply( \@p, [qw/18446744073709551557 18446744073709551629 18446744073709551653 18446744073709551667 18446744073709551697 18446744073709551709 18446744073709551757 18446744073709551923 18446744073709551947/], "forprimes across 2^64" );
+  my $n = 0;
+  forprimes { $n++; lastfor if $n == 5000 } 1e9, 2e9;
+  is( $n, 5000, "forprimes stops with lastfor" );
+  my @outer;
+  forprimes { push @outer, $_; lastfor; forprimes { } 10; } 100;
+  is_deeply( \@outer, [2], "lastfor is kept across a nested forprimes" );
+}
+{
+  my $bits = sieve_primes_bitmap(0, 100);
+  is_deeply( [map { 1+2*$_ } grep { vec($bits,$_,1) } 0..8*length($bits)-1], [grep { $_ > 2 } @{primes(100)}], "sieve_primes_bitmap to 100" );
+  $bits = sieve_range_bitmap('6295609118348014841031009747805006052065816763110427',3204+1,3e6);
+  is_deeply( [map { 2*$_ } grep { vec($bits,$_,1) } 0..8*length($bits)-1], [sieve_range('6295609118348014841031009747805006052065816763110427',3204+1,3e6)], "sieve_range_bitmap matches sieve_range" );
+  Math::Prime::Util::GMP::_GMP_set_threads(3);
+  is( unpack("%32b*", sieve_primes_bitmap("100000000000000000000","100000000000020000000",50000000)), 637365, "sieve_primes_bitmap deep partial sieve of 10^20 + 2*10^7 using 3 threads" );
+  Math::Prime::Util::GMP::_GMP_set_threads(1);
+}
 is_deeply( [sieve_range(0,4,2)], [2,3], "sieve_range starting at zero" );
 is_deeply( [sieve_range(1,4,2)], [1,2], "sieve_range starting at one" );
 is_deeply( [sieve_range(2,4,2)], [0,1,3], "sieve_range starting at two" );
@@ -131,3 +160,13 @@ is_deeply( [sieve_range(6,12,1)], [0..11], "sieve_range depth 1" );
 
 is_deeply( [sieve_twin_primes("1000000000000000000000000000000","1000000000000000000000000020000")], [qw/1000000000000000000000000001681 1000000000000000000000000004831 1000000000000000000000000018739 1000000000000000000000000019171/], "Sieve twin primes 10^30 10^30+20000");
 is_deeply( [sieve_twin_primes("1000000000000000000000000004832","1000000000000000000000000018738")], [], "Sieve twin primes 10^30+4832 10^20+18738 should be empty");
+
+# Prime iterators past the primary sieve (below 982560), each placed with
+# setprime and placed again for a second walk, run from several threads.
+for my $r ([900000,3000000,7], [1,1000000,3], ["1000000000000","1000003000000",16], ["4294000000","4296000000",8]) {
+  my($lo, $hi, $nchunks) = @$r;
+  Math::Prime::Util::GMP::_GMP_set_threads(4);
+  my @p = Math::Prime::Util::GMP::_GMP_prime_iterator_walk($lo, $hi, $nchunks);
+  Math::Prime::Util::GMP::_GMP_set_threads(1);
+  is_deeply( \@p, [sieve_primes($lo, $hi)], "prime iterators in $nchunks pieces from $lo to $hi match sieve_primes" );
+}
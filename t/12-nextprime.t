@@ -4,10 +4,11 @@ use warnings;
 
 use Test::More;
 use Math::Prime::Util::GMP qw/next_prime prev_prime surround_primes
-                              next_twin_prime powint addint/;
+                              next_twin_prime powint addint
+                              forprimegaps lastfor primorial divint/;
 my $extra = defined $ENV{EXTENDED_TESTING} && $ENV{EXTENDED_TESTING};
 
-plan tests => 2 + 3*2 + 6 + 1 + 2 + 1 + 3 + 7 + 3*$extra + 2;
+plan tests => 2 + 3*2 + 6 + 1 + 2 + 1 + 3 + 7 + 3*$extra + 2 + 4;
 
 my @small_primes = qw/
 2 3 5 7 11 13 17 19 23 29 31 37 41 43 47 53 59 61 67 71 73 79 83 89 97
@@ -131,3 +132,28 @@ if ($extra) {
   if (!$extra) { $#a113275 = 30; $#a036062 = 30; }
   is_deeply([map { next_twin_prime($_) } @a113275], \@a036062, "next_twin_prime on record gaps");
 }
+
+{
+  my @g;
+  forprimegaps { push @g, "$_ $_[0]" } 1, 3, 100000, 6;
+  is_deeply( \@g, ["31397 72"], "forprimegaps finds the merit 6.95 gap at 31397" );
+
+  my $K = divint(primorial(151), 30);
+  my @exp = ("15021302332788745155259349081932800090045677557490436271981 1482",
+             "488192325815634217545928845162816002926484520618439178865709 1138",
+             "1554704791443635123569342629980044809319727627200260154233679 1224",
+             "1644832605440367594500898724471641609860001692545202771869649 1640",
+             "2516068140742114813505940971223744015082650990879648075691853 1146",
+             "2906622001394622187542684047353996817423838607374399418785139 1198");
+  @g = ();
+  forprimegaps { push @g, "$_ $_[0]" } $K, 1, 400, 8;
+  is_deeply( \@g, \@exp, "forprimegaps merit 8 around m*151#/30 for m <= 400" );
+  Math::Prime::Util::GMP::_GMP_set_threads(3);
+  @g = ();
+  forprimegaps { push @g, "$_ $_[0]" } $K, 1, 400, 8;
+  is_deeply( \@g, \@exp, "forprimegaps with 3 threads" );
+  Math::Prime::Util::GMP::_GMP_set_threads(1);
+  @g = ();
+  forprimegaps { push @g, "$_ $_[0]"; lastfor if @g == 2 } $K, 1, 400, 8;
+  is_deeply( \@g, [@exp[0,1]], "forprimegaps stops with lastfor" );
+}
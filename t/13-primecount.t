@@ -3,7 +3,7 @@ use strict;
 use warnings;
 
 use Test::More;
-use Math::Prime::Util::GMP qw/prime_count prime_count_lower prime_count_upper/;
+use Math::Prime::Util::GMP qw/prime_count prime_count_lower prime_count_upper nth_prime/;
 
 my %pivals = (
                    1 => 0,
@@ -76,6 +76,16 @@ my @tests = (
   ["1969978340430920872903807060280344576", "1969978340430920872903807060280346393", 17],
 );
 
+my %nthprimes = (
+          1 => 2,
+          2 => 3,
+         10 => 29,
+       1000 => 7919,
+     100000 => 1299709,
+    1000000 => 15485863,
+ 1000000000 => "22801763489",
+);
+
 my %pi2n = (
     1 => '1',
     2 => '2',
@@ -166,7 +176,7 @@ my %pi2n = (
 );
 
 
-plan tests => 4 + scalar (keys %pivals) + scalar @tests + 2*scalar(keys %pi2n) + 2 + 2;
+plan tests => 4 + scalar (keys %pivals) + scalar @tests + 2*scalar(keys %pi2n) + 3 + 6 + 2 + scalar(keys %nthprimes) + 2;
 
 
 # TODO: error cases
@@ -193,6 +203,25 @@ while (my($n, $pin) = each (%pi2n)) {
 # Larger to exercise the sieve code
 is( prime_count(0,100010), 9593, "prime_count(0,100010) = 9593");
 is( prime_count(1000000,1100010), 7217, "prime_count(1e6+0,1e6+100010) = 7217");
+is( prime_count("999999980000000","1000000000000000"), 579415, "prime_count(10^15-2*10^7,10^15) = 579415");
+
+# Large enough for the LMO method
+foreach my $n (24, 30, 36) {
+  is( prime_count(2**$n), $pi2n{$n}, "prime_count(2^$n) = $pi2n{$n}" );
+}
+is( prime_count("10000000000"), 455052511, "prime_count(10^10) = 455052511");
+is( prime_count("1000000000","10000000000"), 404204977, "prime_count(10^9,10^10) = 404204977");
+{
+  Math::Prime::Util::GMP::_GMP_set_threads(3);
+  is( prime_count("100000000000"), 4118054813, "prime_count(10^11) = 4118054813 using 3 threads");
+  is( prime_count("999999980000000","1000000000000000"), 579415, "prime_count(10^15-2*10^7,10^15) = 579415 using 3 threads");
+  Math::Prime::Util::GMP::_GMP_set_threads(1);
+}
+
+is( nth_prime(0), undef, "nth_prime(0) = undef" );
+while (my($n, $p) = each (%nthprimes)) {
+  is( nth_prime($n), $p, "nth_prime($n) = $p" );
+}
 
 # Github #33
 is( prime_count(619,619), 1, "prime_count(619,619) = 1");
@@ -0,0 +1,43 @@
+#!/usr/bin/env perl
+use strict;
+use warnings;
+
+use Test::More;
+use Math::Prime::Util::GMP;
+
+# Every Hilbert polynomial in the class poly table, in order of D.  Stop at
+# the end of the table, where any computed polys start again at small D.
+my @table;
+for (my $i = 1; ; $i++) {
+  my($D, $type, @T) = Math::Prime::Util::GMP::_GMP_class_poly($i);
+  last if !defined $D || (@table && -$D <= $table[-1][0]);
+  push @table, [-$D, $type, \@T];
+}
+my @hilbert = grep { $_->[1] == 1 } @table;
+
+# The discriminants -d with class number 1 (including non-fundamental)
+my @h1 = (3,4,7,8,11,12,16,19,27,28,43,67,163);
+my %hknown = (15 => 2, 20 => 2, 23 => 3, 47 => 5, 71 => 7, 199 => 9, 5 => 0, 9 => 0);
+
+plan tests => 3 + 2 + 1;
+
+ok(scalar(@hilbert) > 50, "class poly table has Hilbert polys (".scalar(@hilbert).")");
+is_deeply([Math::Prime::Util::GMP::_GMP_hilbert_class_poly(23)],
+          [qw/12771880859375 -5151296875 3491750 1/],
+          "hilbert_class_poly(-23)");
+{
+  my @bad = grep {
+    my($d, $type, $T) = @$_;
+    my @H = Math::Prime::Util::GMP::_GMP_hilbert_class_poly($d);
+    join(" ",@H) ne join(" ",@$T);
+  } @hilbert;
+  is_deeply([map { $_->[0] } @bad], [], "hilbert_class_poly matches the table for all Hilbert entries");
+}
+
+my @h = Math::Prime::Util::GMP::_GMP_class_numbers(200);
+is_deeply([grep { $h[$_] == 1 } 0..200], \@h1, "class number 1 discriminants to 200");
+is_deeply({map { $_ => $h[$_] } keys %hknown}, \%hknown, "selected class numbers");
+
+@h = Math::Prime::Util::GMP::_GMP_class_numbers($hilbert[-1][0]);
+is_deeply([map { $_->[0] } grep { $h[$_->[0]] != @{$_->[2]}-1 } @hilbert], [],
+          "table degrees match class numbers");
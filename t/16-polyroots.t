@@ -0,0 +1,74 @@
+#!/usr/bin/env perl
+use strict;
+use warnings;
+
+use Test::More;
+use Math::Prime::Util::GMP qw/addmod submod mulmod modint mulint powint
+                              next_prime prev_prime kronecker/;
+
+plan tests => 7;
+
+# Coefficients (constant first) of the product of the given monic factors.
+sub polymul {
+  my($p, @f) = @_;
+  my @c = (1);
+  for my $f (@f) {
+    my @n = (0) x (@c + @$f - 1);
+    for my $i (0 .. $#c) {
+      for my $j (0 .. $#$f) {
+        $n[$i+$j] = addmod($n[$i+$j], mulmod($c[$i], $f->[$j], $p), $p);
+      }
+    }
+    @c = @n;
+  }
+  @c;
+}
+sub linears { my $p = shift;  map { [submod(0,$_,$p), 1] } @_; }
+sub roots {
+  my($p, @c) = @_;
+  sort { length($a) <=> length($b) || $a cmp $b }
+       Math::Prime::Util::GMP::_GMP_polyz_roots_modp($p, @c);
+}
+sub sorted { sort { length($a) <=> length($b) || $a cmp $b } @_; }
+# x^2 - k for k a non-residue, which has no roots
+sub noroots {
+  my($p, $n) = @_;
+  my @f;
+  for (my $k = 2; @f < $n; $k++) {
+    push @f, [submod(0,$k,$p), 0, 1] if kronecker($k, $p) == -1;
+  }
+  @f;
+}
+
+my $p64 = prev_prime(powint(2,64));     # 2^64-59
+my $p200 = next_prime(powint(2,200));
+
+{
+  my @r = map { modint(mulint($_, "1234567890123457"), $p64) } 1..60;
+  is_deeply([roots($p64, polymul($p64, linears($p64, @r)))], [sorted(@r)],
+            "degree 60 with 60 roots mod 2^64-59");
+}
+{
+  my @r = map { modint(mulint($_, "98765432109876543"), $p64) } 1..120;
+  my @c = polymul($p64, linears($p64, @r), noroots($p64, 20));
+  is_deeply([roots($p64, @c)], [sorted(@r)],
+            "degree 160 with 120 roots mod 2^64-59");
+}
+{
+  my @r = map { modint(powint($_, 61), $p200) } 2..34;
+  my @c = polymul($p200, linears($p200, @r), noroots($p200, 4));
+  is_deeply([roots($p200, @c)], [sorted(@r)],
+            "degree 41 with 33 roots mod a 201-bit prime");
+}
+{
+  my $p = 10007;
+  my @c = (map { ($_*7919+13) % $p } 0..29), 1;
+  my @exp = grep { my $x = $_;  my $v = 0;
+                   $v = addmod(mulmod($v,$x,$p), $c[$_], $p) for reverse 0..$#c;
+                   $v == 0 } 0 .. $p-1;
+  is_deeply([roots($p, @c)], \@exp, "degree 30 mod 10007 matches a search of all x");
+}
+is_deeply([roots($p64, polymul($p64, noroots($p64, 8)))], [], "degree 16 with no roots");
+is_deeply([roots($p64, polymul($p64, linears($p64, 5)))], [5], "degree 1");
+is_deeply([roots($p64, polymul($p64, linears($p64, 5, "18446744073709551000")))],
+          [5, "18446744073709551000"], "degree 2");
@@ -7,7 +7,11 @@ use Math::Prime::Util::GMP qw/is_provable_prime is_provable_prime_with_cert
                               is_trial_prime
                               is_llr_prime is_proth_prime
                               is_aks_prime is_miller_prime is_ecpp_prime
-                              is_nminus1_prime is_nplus1_prime is_bls75_prime/;
+                              is_nminus1_prime is_nplus1_prime is_bls75_prime
+                              verify_prime_certificate forprovable lastfor
+                              prime_certificate_to_binary prime_certificate_to_text
+                              next_prime is_prime todigits rootint
+                              absint negint addint subint mulint divint modint/;
 
 my @llrs = (
   [202, 0],
@@ -81,10 +85,19 @@ plan tests => 0 + 6
                 + 34
                 + 2
                 + 7   # _with_cert
+                + 7   # verify_prime_certificate
+                + 4   # binary certificates
+                + 5   # ECPP checkpoint
+                + 4   # ECPP policy and stats
+                + 2   # ECPP with BLS75 steps
+                + 4   # forprovable
                 + 4   # Trial, Miller, N-1
                 + scalar(@np1s)   # BLS75 N+1
                 + scalar(@bls75s) # BLS75 hybrid
                 + scalar(@ecpps)  # ecpp
+                + scalar(@ecpps)  # ecpp with threads
+                + 2   # ecpp with a bad class poly database
+                + 3   # ecpp with a class poly database
                 + scalar(@llrs)   # llr
                 + scalar(@prs)    # proth
                 + scalar(@akss)   # AKS
@@ -245,7 +258,7 @@ EOPROOF
 $proof =~ s/\n$//;
 my($isp, $cert) = is_provable_prime_with_cert("3138550867693340381917894711603833208051177722232017256453");
 is($isp, 2, "is_provable_prime_with_cert(3138550867693340381917894711603833208051177722232017256453) is prime");
-if ($cert =~ /\bType BLS5\b/) {
+if ($cert =~ /\nType BLS5\nN  3138550867693340381917894711603833208051177722232017256453\n/) {
   is($cert, $proof, "is_provable_prime_with_cert(3138550867693340381917894711603833208051177722232017256453)");
 } else {
   like($cert, qr/\nType BLS15\nN  3138550867693340381917894711603833208051177722232017256453\nQ  120713494911282322381457488907839738771199143162769894479\nLP 1\nLQ 6\n\n/, "is_provable_prime_with_cert(3138550867693340381917894711603833208051177722232017256453)");
@@ -280,6 +293,220 @@ for my $d (@ecpps) {
   my($n,$exp) = @$d;
   is(is_ecpp_prime($n), $exp, "is_ecpp_prime($n) = $exp");
 }
+# With threads, factoring and curve finding take the parallel paths
+Math::Prime::Util::GMP::_GMP_set_threads(2);
+for my $d (@ecpps) {
+  my($n,$exp) = @$d;
+  is(is_ecpp_prime($n), $exp, "is_ecpp_prime($n) = $exp using 2 threads");
+}
+Math::Prime::Util::GMP::_GMP_set_threads(1);
+# A missing or invalid class poly database is ignored
+{
+  my($n,$exp) = @{$ecpps[-1]};
+  Math::Prime::Util::GMP::_GMP_set_class_poly_db("t/no-such-file.db");
+  is(is_ecpp_prime($n), $exp, "is_ecpp_prime($n) = $exp with a missing database");
+  Math::Prime::Util::GMP::_GMP_set_class_poly_db($0);
+  is(is_ecpp_prime($n), $exp, "is_ecpp_prime($n) = $exp with an invalid database");
+  Math::Prime::Util::GMP::_GMP_set_class_poly_db(undef);
+}
+# A database made by xt/make-class-poly-db.pl from computed Hilbert polys
+{
+  my $file = "t/16-class-poly-db.$$";
+  my @d = (979, 1043, 1187);    # Fundamental, not in the built-in table
+  open(my $fh, '>', "$file.h") or die "$file.h: $!";
+  for my $d (@d) {
+    my @T = Math::Prime::Util::GMP::_GMP_hilbert_class_poly($d);
+    pop @T;
+    # Hilbert polys store the cube root of the constant term
+    $T[0] = ($T[0] =~ /^-/) ? negint(rootint(absint($T[0]),3)) : rootint($T[0],3);
+    my $s = '';
+    for my $c (@T) {
+      my @b = ($c eq '0') ? () : todigits(absint($c), 256);
+      my @len = (scalar(@b) < 127) ? (scalar(@b))
+              : (127, (127) x int((@b-127)/127), (@b-127) % 127);
+      $len[0] |= 128 if $c =~ /^-/;
+      $s .= join '', map { sprintf "\\x%02x", $_ } @len, @b;
+    }
+    print $fh "  { $d, 1, ", scalar(@T), ", \"$s\" },\n";
+  }
+  close $fh;
+  system("$^X xt/make-class-poly-db.pl $file.h > $file 2>/dev/null");
+
+  my $count = sub { my $i = 0; $i++ while Math::Prime::Util::GMP::_GMP_class_poly($i+1); $i };
+  my $n0 = $count->();
+  Math::Prime::Util::GMP::_GMP_set_class_poly_db($file);
+  my $n1 = $count->();
+  is($n1, $n0 + @d, "class poly database adds ".scalar(@d)." discriminants");
+  my @bad = grep {
+    my($D, $type, @T) = Math::Prime::Util::GMP::_GMP_class_poly($_);
+    join(" ",@T) ne join(" ",Math::Prime::Util::GMP::_GMP_hilbert_class_poly(-$D));
+  } $n0+1 .. $n1;
+  is_deeply(\@bad, [], "class poly database entries decode to their Hilbert polys");
+
+  # Build N = (t^2 + d v^2)/4 so -979 gives an order m = N+1-t with a large
+  # prime factor, and point the checkpoint at that choice so it goes first.
+  my($d, $v, $n, $m, $q) = (979, "100000000000000000000000");
+  for (my $t = "1000000000000000000000000020106"; ; $t = addint($t, 2)) {
+    $n = divint(addint(mulint($t,$t), mulint($d, mulint($v,$v))), 4);
+    next unless is_prime($n);
+    $m = subint(addint($n, 1), $t);
+    my($k) = grep { !modint($m,$_) && is_prime(divint($m,$_)) } 1..1000;
+    if (defined $k) { $q = divint($m, $k); last; }
+  }
+  my $ckpt = "t/16-ecpp-checkpoint.$$";
+  open($fh, '>', $ckpt) or die "$ckpt: $!";
+  print $fh "[MPU - Primality Certificate]\nVersion 1.0\n\nProof for:\nN $n\n\n# Down -$d $n $m $q\n";
+  close $fh;
+  Math::Prime::Util::GMP::_GMP_set_ecpp_checkpoint($ckpt);
+  is_ecpp_prime($n);
+  Math::Prime::Util::GMP::_GMP_set_ecpp_checkpoint(undef);
+  my $saved = do { local(@ARGV,$/) = ($ckpt); <> };
+  ok(scalar(verify_prime_certificate($saved)) == 1 && $saved =~ /^M\s+$m$/m,
+     "ECPP using database discriminant -$d gives a certificate");
+  Math::Prime::Util::GMP::_GMP_set_class_poly_db(undef);
+  unlink $file, "$file.h", $ckpt;
+}
+###### verify_prime_certificate
+{
+  my $n = "340282366920938463463374607431768211507";
+  my $cert = (is_provable_prime_with_cert($n))[1];
+  is(verify_prime_certificate($cert), 1, "verify_prime_certificate of is_provable_prime_with_cert($n)");
+  my @steps = verify_prime_certificate($cert);
+  ok(shift(@steps) == 1 && @steps > 0 && $steps[0]->[1] eq $n
+     && !grep({ !$_->[2] || defined $_->[4] } @steps),
+     "verify_prime_certificate in list context gives the steps");
+  my $bad = $cert;
+  $bad =~ s/^(Q\s+\d+)(\d)$/$1.($2 == 1 ? 3 : 1)/me;
+  is(verify_prime_certificate($bad), 0, "verify_prime_certificate with a changed Q fails");
+  is(verify_prime_certificate($proof), 1, "verify_prime_certificate of a BLS5 certificate");
+  $bad = $proof;
+  $bad =~ s/^Q\[6\]  19$/Q[6]  23/m;
+  is(verify_prime_certificate($bad), 0, "verify_prime_certificate with a wrong factor fails");
+  my $primo = <<'EOPRIMO';
+[PRIMO - Primality Certificate]
+Format=4
+TestCount=3
+
+[Candidate]
+N=$100000000000000000000000000000033
+
+[1]
+S=4254285270807444
+W=-$544F8664A2424188
+A=$0
+B=-$8
+T=$453383E1
+
+[2]
+S=28
+Q=2
+
+[3]
+S=12363039705
+W=-$C11CE0AAF
+A=-$25ECAE3CB689639494
+B=-$1F9A9132981D284626
+T=$93EBECEF
+EOPRIMO
+  is(verify_prime_certificate($primo), 1, "verify_prime_certificate of a Primo certificate");
+  is(verify_prime_certificate("Type Small\nN 5\n"), 0, "verify_prime_certificate of text without a header");
+}
+
+###### binary certificates
+{
+  my $n = "340282366920938463463374607431768211507";
+  my $cert = (is_provable_prime_with_cert($n))[1];
+  my $bin = prime_certificate_to_binary($cert);
+  ok(length($bin) < length($cert) && prime_certificate_to_text($bin) eq $cert,
+     "ECPP certificate converts to binary and back");
+  is(verify_prime_certificate($bin), 1, "verify_prime_certificate of a binary certificate");
+  $bin = prime_certificate_to_binary($proof);
+  ok(prime_certificate_to_text($bin) eq $proof && verify_prime_certificate($bin) == 1,
+     "BLS5 certificate converts to binary and back, and verifies");
+  is(verify_prime_certificate(substr($bin, 0, -2)), 0, "verify_prime_certificate of a truncated binary certificate");
+}
+
+###### ECPP checkpoint
+{
+  my $n = "340282366920938463463374607431768211507";
+  my $file = "t/16-ecpp-checkpoint.$$";
+  Math::Prime::Util::GMP::_GMP_set_ecpp_checkpoint($file);
+  my $cert = (is_provable_prime_with_cert($n))[1];
+  my %first = Math::Prime::Util::GMP::_GMP_ecpp_stats();
+  my $saved = do { local(@ARGV,$/) = ($file); <> };
+  is(verify_prime_certificate($saved), 1, "ECPP checkpoint for $n is a certificate when done");
+  # Cut it off part way through the last step, as if interrupted.
+  my $part = substr($saved, 0, rindex($saved, "\nType ") + 20);
+  { open(my $fh, '>', $file) or die "$file: $!";  print $fh $part;  close $fh; }
+  is(verify_prime_certificate((is_provable_prime_with_cert($n))[1]), 1,
+     "ECPP resumed from an interrupted checkpoint gives a certificate");
+  my %resumed = Math::Prime::Util::GMP::_GMP_ecpp_stats();
+  ok($resumed{factored} < $first{factored},
+     "resuming used the saved choices ($resumed{factored} orders factored, was $first{factored})");
+  $saved = do { local(@ARGV,$/) = ($file); <> };
+  is(verify_prime_certificate($saved), 1, "the resumed checkpoint is a certificate when done");
+  Math::Prime::Util::GMP::_GMP_set_ecpp_checkpoint("t/no-such-dir.$$/ckpt");
+  ok(!eval { is_ecpp_prime($n); 1 } && $@ =~ /cannot write checkpoint/,
+     "ECPP croaks if the checkpoint cannot be written");
+  Math::Prime::Util::GMP::_GMP_set_ecpp_checkpoint(undef);
+  unlink $file;
+}
+
+###### ECPP policy and stats
+{
+  my $n = "100000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000013";
+  Math::Prime::Util::GMP::_GMP_set_ecpp_policy(4);
+  is(verify_prime_certificate((is_provable_prime_with_cert($n))[1]), 1,
+     "ECPP with candidates tried best first gives a certificate");
+  my %stats = Math::Prime::Util::GMP::_GMP_ecpp_stats();
+  ok($stats{steps} > 0 && $stats{levels} >= $stats{steps} && $stats{discriminants} >= $stats{steps}
+     && $stats{candidates} >= 4,
+     "ECPP stats: $stats{steps} steps, $stats{discriminants} discriminants, $stats{candidates} candidates");
+  Math::Prime::Util::GMP::_GMP_set_ecpp_policy(0, 2, 0.001);
+  is(verify_prime_certificate((is_provable_prime_with_cert($n))[1]), 1,
+     "ECPP with a tiny time budget per step gives a certificate");
+  %stats = Math::Prime::Util::GMP::_GMP_ecpp_stats();
+  ok($stats{budget_stops} > 0, "ECPP stopped $stats{budget_stops} times on the time budget");
+  Math::Prime::Util::GMP::_GMP_set_ecpp_policy(0);
+}
+
+###### ECPP with BLS75 steps
+{
+  # Part way down, an N-1 is smooth enough for a BLS75 proof
+  my $n = "47045144809785057037053064188899";
+  is(verify_prime_certificate((is_provable_prime_with_cert($n))[1]), 1,
+     "ECPP finishing with BLS75 gives a certificate for $n");
+  my %stats = Math::Prime::Util::GMP::_GMP_ecpp_stats();
+  ok($stats{bls_steps} > 0, "ECPP used BLS75 for one of its steps");
+}
+
+###### forprovable
+{
+  my @n = (7, "100000000000000000000000000000000000000001", -5,
+           map { next_prime("1" . "0" x $_) } 10, 25, 40, 60);
+  my %exp = map { $_ => 2 } @n;
+  $exp{$_} = 0 for @n[1,2];
+  for my $threads (1, 2) {
+    my $nt = Math::Prime::Util::GMP::_GMP_get_threads();
+    Math::Prime::Util::GMP::_GMP_set_threads($threads);
+    my(%got, @bad);
+    forprovable {
+      $got{$_} = $_[0];
+      push @bad, $_ if $_[0] == 2 && verify_prime_certificate($_[1]) != 1;
+    } @n;
+    Math::Prime::Util::GMP::_GMP_set_threads($nt);
+    is_deeply([\%got, \@bad], [\%exp, []],
+              "forprovable with $threads threads: results and certificates");
+  }
+  my $calls = 0;
+  forprovable { $calls++; lastfor } @n;
+  is($calls, 1, "forprovable stops after lastfor");
+  ok(!eval { forprovable { Math::Prime::Util::GMP::_GMP_set_class_poly_db(undef) } @n; 1 }
+     && $@ =~ /while proofs are running/,
+     "the class poly database cannot be changed from forprovable");
+  Math::Prime::Util::GMP::_GMP_set_class_poly_db(undef);
+}
+
 ###### llr
 for my $d (@llrs) {
   my($n,$exp) = @$d;
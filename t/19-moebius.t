@@ -6,7 +6,11 @@ use Test::More;
 use Math::Prime::Util::GMP qw/moebius liouville totient jordan_totient
                               exp_mangoldt carmichael_lambda
                               znorder znprimroot is_primitive_root
-                              chinese chinese2 ramanujan_tau/;
+                              chinese chinese2 ramanujan_tau
+                              sigma is_carmichael prime_omega
+                              totient_range sigma_range liouville_range
+                              prime_omega_range is_semiprime_range
+                              prime_bigomega is_semiprime/;
 my $extra = defined $ENV{EXTENDED_TESTING} && $ENV{EXTENDED_TESTING};
 
 my @moeb_vals = (qw/ 1 -1 -1 0 -1 1 -1 0 0 1 -1 0 -1 1 1 0 -1 0 -1 0 /);
@@ -206,7 +210,9 @@ plan tests => 1
             + 3 # is_primitive_root
             + scalar(keys %rtau)
             + 3     # chinese, chinese2
-            + 10;
+            + 10
+            + 10    # factored input
+            + 6;    # ranges
 
 
 ###### moebius
@@ -281,6 +287,39 @@ is(znorder(17,"100000000000000000000000065"),"11018158296270848614660","znorder(
 #is(znprimroot("1000000000000000000000000000066"),3,"znprimroot(1000000000000000000000000000066)");
 is(znprimroot("9218092345892375982375972365235234234238"),7,"znprimroot(9218092345892375982375972365235234234238)");
 
+###### factored input
+{
+  my @f = (3, 19, 107, 30517, "48797511013708444606991");
+  is(totient(\@f), totient("9082348072348972344232348972353"), "totient with factored input");
+  is(jordan_totient(7,\@f),"5095518312757196744226274674573606050126361160581316878353842679128612307851086686674388236784494856239490781063311007858142493527563560083079291494558455443094226241877357726178655478871147887413922557679205648656960", "jordan_totient with factored input");
+  is(carmichael_lambda([reverse @f]),"118383835264498988202339093780", "carmichael_lambda with unsorted factored input");
+  is_deeply([moebius(\@f), liouville(\@f), prime_omega([[2,3],[3,2]])], [-1,-1,2], "moebius, liouville, prime_omega with factored input");
+  is(znorder(17,[3,5,11,9791,"61899765709386789971"]),"11018158296270848614660","znorder with factored input");
+  is(sigma([[2,3],[3,2]]), 195, "sigma([[2,3],[3,2]]) = sigma(72)");
+  is_deeply([map { is_carmichael($_) } [3,11,17], [11,13,17], [7,13,19]], [1,0,1], "is_carmichael with factored input");
+  ok(!eval { totient([4,3]); 1 }, "composite in factored input is rejected");
+  my(@holes, @pair);
+  $holes[2] = 3;
+  $pair[1] = 2;
+  ok(!eval { totient(\@holes); 1 } && !eval { totient([\@pair]); 1 },
+     "factored input with holes is rejected");
+  ok(!eval { totient([[2,"4294967296"]]); 1 } && !eval { znorder("x",[3,5]); 1 },
+     "factored input with a huge exponent or a bad a is rejected");
+}
+
+###### ranges
+{
+  my @n = map { "1000000000000000000".sprintf("%02d",$_) } 0..40;
+  is_deeply( [totient_range(0,40)], [map { totient($_) } 0..40], "totient_range(0,40)" );
+  is_deeply( [totient_range($n[0],$n[-1])], [map { totient($_) } @n], "totient_range(10^20, 10^20+40)" );
+  is_deeply( [sigma_range($n[0],$n[-1],2)], [map { sigma($_,2) } @n], "sigma_range(10^20, 10^20+40, 2)" );
+  is_deeply( [moebius($n[0],$n[-1])], [map { moebius($_) } @n], "moebius(10^20, 10^20+40)" );
+  is_deeply( [liouville_range($n[0],$n[-1])], [map { liouville($_) } @n], "liouville_range(10^20, 10^20+40)" );
+  is_deeply( [is_semiprime_range($n[0],$n[-1]), prime_omega_range($n[0],$n[-1])],
+             [(map { is_semiprime($_) } @n), (map { prime_omega($_) } @n)],
+             "is_semiprime_range and prime_omega_range(10^20, 10^20+40)" );
+}
+
 ###### Ramanujan Tau
 while (my($n, $tau) = each (%rtau)) {
   is( ramanujan_tau($n), $tau, "Ramanujan Tau($n) = $tau" );
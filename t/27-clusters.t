@@ -3,7 +3,7 @@ use strict;
 use warnings;
 
 use Test::More;
-use Math::Prime::Util::GMP qw/sieve_prime_cluster is_prime sieve_primes sieve_twin_primes/;
+use Math::Prime::Util::GMP qw/sieve_prime_cluster is_prime sieve_primes sieve_twin_primes forclusters lastfor twin_prime_count twin_prime_count_approx cluster_count cluster_count_approx addint/;
 use Math::BigInt try => "GMP,Pari";
 my $extra = defined $ENV{EXTENDED_TESTING} && $ENV{EXTENDED_TESTING};
 
@@ -51,7 +51,7 @@ my @high_check = (
 #[4,6,10,16,18,24,28,30,34,40,46,48,54,58,60,66);   # A257375
 #[6,12,16,18,22,28,30,36,40,42,46,48);   # A214947
 
-plan tests => scalar(@tests) + 2 + 2 * scalar(@patterns) + scalar(@high_check);
+plan tests => scalar(@tests) + 2 + 2 * scalar(@patterns) + scalar(@high_check) + 3 + 2 + 5;
 
 for my $t (@tests) {
   my($what, $tuple, $range, $expect) = @$t;
@@ -102,6 +102,41 @@ for my $test (@high_check) {
   is_deeply(\@res, [$n], "Window around $name high cluster finds the cluster");
 }
 
+{
+  my @s;
+  forclusters { push @s, $_ } 0, 1000000, 2, 6, 8;
+  is_deeply( \@s, [sieve_prime_cluster(0, 1000000, 2, 6, 8)], "forclusters quadruplets to 10^6" );
+  @s = ();
+  forclusters { push @s, $_ } 0, 200, 2;
+  is_deeply( \@s, $tests[0][3], "forclusters twin primes to 200" );
+  @s = ();
+  forclusters { push @s, $_; lastfor if @s >= 10 } "100000000000000000000", "200000000000000000000", 2, 6, 8;
+  is_deeply( \@s, [sieve_prime_cluster("100000000000000000000", $s[-1], 2, 6, 8)], "forclusters with lastfor stops after 10 quadruplets past 10^20" );
+}
+
+{
+  my @s1 = sieve_prime_cluster("100000000000000000000","100000000002000000000",2,6,8,12);
+  Math::Prime::Util::GMP::_GMP_set_threads(3);
+  my @s3 = sieve_prime_cluster("100000000000000000000","100000000002000000000",2,6,8,12);
+  Math::Prime::Util::GMP::_GMP_set_threads(1);
+  is_deeply( \@s3, \@s1, "sieve_prime_cluster quintuplets past 10^20 with 3 threads" );
+  # Past 64 bits the residues are filtered by the primes to 10000
+  my %p = map { $_ => 1 } sieve_primes("100000000000000000000","100000000000003000006");
+  my @exp = grep { $p{addint($_,2)} && $p{addint($_,6)} } sieve_primes("100000000000000000000","100000000000003000000");
+  is_deeply( [sieve_prime_cluster("100000000000000000000","100000000000003000000",2,6)], \@exp,
+             "sieve_prime_cluster triplets past 10^20 match the primes" );
+}
+
+{
+  is( twin_prime_count(0, 1000), 35, "twin_prime_count(0,1000)" );
+  is( twin_prime_count("100000000000000000000","100000000000001000000"), scalar(my @l = sieve_twin_primes("100000000000000000000","100000000000001000000")), "twin_prime_count past 10^20 matches sieve_twin_primes" );
+  is( cluster_count(0, 10000000, 2, 6), 8543, "cluster_count prime triplets (0,2,6) to 10^7" );
+  my $est = twin_prime_count_approx(0, "1000000000000000000");
+  ok( abs($est - 808675888577436)/808675888577436 < 0.001, "twin_prime_count_approx(10^18) within 0.1%" );
+  $est = cluster_count_approx(0, 10000000, 2, 6);
+  ok( abs($est - 8543)/8543 < 0.02, "cluster_count_approx prime triplets to 10^7 within 2%" );
+}
+
 sub ktuple {
   my($beg, $end, $prset, @pat) = @_;
   my @p;
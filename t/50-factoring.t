@@ -4,6 +4,7 @@ use warnings;
 
 use Test::More;
 use Math::Prime::Util::GMP qw/factor is_prime sigma divisors is_semiprime
+                              fordivisors lastfor
                               prime_bigomega prime_omega/;
 my $extra = defined $ENV{EXTENDED_TESTING} && $ENV{EXTENDED_TESTING};
 
@@ -30,12 +31,13 @@ plan tests => 0 + 57
                 + 24
                 + 2
                 + 2
-                + 9   # individual tets for factoring methods
+                + 10  # individual tets for factoring methods
                 + 1*$extra # SQUFOF fail case
                 + 7*7  # factor extra tests
                 + 8    # factor in scalar context
                 + scalar(keys %sigmas)
                 + 3    # divisors
+                + 6    # divisors with limits, fordivisors
                 + 2    # is_semiprime
                 + 2*scalar(@omega)
                 + 0;
@@ -166,6 +168,8 @@ is_deeply( [Math::Prime::Util::GMP::pbrent_factor('2114957314229414940')], [2,2,
 
 # Test stage 2 of pminus1
 is_deeply( [ sort {$a<=>$b} Math::Prime::Util::GMP::pminus1_factor('23113042053749572861737011', 100, 100000) ], ['694059980329', '33301217054459'], "p-1 factors 23113042053749572861737011 in stage 2");
+# Stage 2 walking the prime table must start right after B1 (p-1 = 2*31000241)
+is_deeply( [ sort {$a<=>$b} Math::Prime::Util::GMP::pminus1_factor('62000483000000000000000000003534027531', 31000000, 40000000) ], ['62000483', '1000000000000000000000000000057'], "p-1 stage 2 with B1 above 3e7 finds the prime just past B1");
 
 # A SQUFOF side case, trying to cover code
 if ($extra) {
@@ -214,6 +218,20 @@ while (my($n, $s4) = each (%sigmas)) {
 is_deeply( [divisors(1)], [1], "divisors(1) in list context" );
 is_deeply( [divisors(9283540924)], [qw/1 2 4 7 14 28 331555033 663110066 1326220132 2320885231 4641770462 9283540924/], "divisors(9283540924)" );
 is( scalar(divisors(9283540924)), 12, "scalar divisors(9283540924) = 12" );
+is_deeply( [divisors(5040, 20)], [1..10,12,14,15,16,18,20], "divisors(5040,20)" );
+is( scalar(divisors("1000000000000000000000", 1000)), 29, "scalar divisors(10^21,1000) = 29" );
+ok( !eval { divisors(5040, "x"); 1 }, "divisors with an invalid limit croaks" );
+{
+  my @d;
+  fordivisors { push @d, $_ } 360;
+  is_deeply( \@d, [divisors(360)], "fordivisors(360) matches divisors(360)" );
+  @d = ();
+  fordivisors { push @d, $_ } "1000000000000000000000", "1000000000000000000", "2000000000000000000";
+  is_deeply( \@d, [qw/1000000000000000000 1250000000000000000 1562500000000000000 1600000000000000000 1953125000000000000 2000000000000000000/], "fordivisors(10^21, 10^18, 2*10^18)" );
+  @d = ();
+  fordivisors { push @d, $_; lastfor if $_ >= 10; } "479001600";
+  is_deeply( \@d, [1..10], "fordivisors with lastfor" );
+}
 
 {
   my @non = map { is_semiprime($_) }
@@ -0,0 +1,217 @@
+/*
+ * Minimal worker pool for splitting independent work over threads.
+ *
+ * parallel_for() starts up to N-1 helper threads, the calling thread works
+ * as well, and indices are handed out from a shared counter.  Threads are
+ * created per call, which keeps us free of any state that would need
+ * cleanup when the module is unloaded.  All the current users do work in
+ * chunks of many milliseconds, so creation cost is noise.
+ */
+
+#include <stdlib.h>
+
+#include "ptypes.h"
+#include "threadpool.h"
+
+#ifdef USE_PTHREADS
+ #include <pthread.h>
+ #include <unistd.h>
+#endif
+
+#define MAX_THREADS 256
+
+static int _nthreads = 1;
+
+int get_thread_count(void)
+{
+  return _nthreads;
+}
+
+void set_thread_count(int nthreads)
+{
+#ifdef USE_PTHREADS
+  if (nthreads <= 0) {
+    long ncpu = -1;
+#ifdef _SC_NPROCESSORS_ONLN
+    ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    nthreads = (ncpu > 0) ? (int)ncpu : 1;
+  }
+  if (nthreads > MAX_THREADS) nthreads = MAX_THREADS;
+  _nthreads = nthreads;
+#else
+  (void) nthreads;
+  _nthreads = 1;
+#endif
+}
+
+#ifdef USE_PTHREADS
+
+static pthread_mutex_t _global_lock = PTHREAD_MUTEX_INITIALIZER;
+void parallel_lock(void)   { pthread_mutex_lock(&_global_lock); }
+void parallel_unlock(void) { pthread_mutex_unlock(&_global_lock); }
+
+typedef struct {
+  pthread_mutex_t lock;
+  UV              next;
+  UV              n;
+  parallel_fn_t   fn;
+  void           *ctx;
+} pfor_state_t;
+
+static void* _pfor_worker(void *vstate)
+{
+  pfor_state_t *st = (pfor_state_t*) vstate;
+  while (1) {
+    UV i;
+    pthread_mutex_lock(&st->lock);
+    i = st->next;
+    if (i < st->n) st->next++;
+    pthread_mutex_unlock(&st->lock);
+    if (i >= st->n) break;
+    st->fn(st->ctx, i);
+  }
+  return 0;
+}
+
+void parallel_for(UV n, parallel_fn_t fn, void *ctx)
+{
+  pthread_t tids[MAX_THREADS];
+  pfor_state_t st;
+  int t, nt = _nthreads;
+
+  if ((UV)nt > n) nt = (int)n;
+  if (nt <= 1) {
+    UV i;
+    for (i = 0; i < n; i++)
+      fn(ctx, i);
+    return;
+  }
+
+  pthread_mutex_init(&st.lock, 0);
+  st.next = 0;
+  st.n = n;
+  st.fn = fn;
+  st.ctx = ctx;
+  /* Start helpers.  If we can't get as many as asked, run with fewer. */
+  for (t = 0; t < nt-1; t++)
+    if (pthread_create(&tids[t], 0, _pfor_worker, &st) != 0)
+      break;
+  nt = t;
+  _pfor_worker(&st);
+  for (t = 0; t < nt; t++)
+    pthread_join(tids[t], 0);
+  pthread_mutex_destroy(&st.lock);
+}
+
+static void _serial_queue(UV n, parallel_fn_t fn, parallel_done_t done, void *ctx)
+{
+  UV i;
+  for (i = 0; i < n; i++) {
+    fn(ctx, i);
+    if (done(ctx, i)) break;
+  }
+}
+
+typedef struct {
+  pthread_mutex_t lock;
+  pthread_cond_t  cond;
+  UV              next;
+  UV              n;
+  UV              nfinished;
+  UV             *finished;   /* indices in the order they finished */
+  parallel_fn_t   fn;
+  void           *ctx;
+} pqueue_state_t;
+
+static void* _pqueue_worker(void *vstate)
+{
+  pqueue_state_t *st = (pqueue_state_t*) vstate;
+  while (1) {
+    UV i;
+    pthread_mutex_lock(&st->lock);
+    i = st->next;
+    if (i < st->n) st->next++;
+    pthread_mutex_unlock(&st->lock);
+    if (i >= st->n) break;
+    st->fn(st->ctx, i);
+    pthread_mutex_lock(&st->lock);
+    st->finished[st->nfinished++] = i;
+    pthread_cond_signal(&st->cond);
+    pthread_mutex_unlock(&st->lock);
+  }
+  return 0;
+}
+
+void parallel_queue(UV n, parallel_fn_t fn, parallel_done_t done, void *ctx)
+{
+  pthread_t tids[MAX_THREADS];
+  pqueue_state_t st;
+  UV ndone = 0;
+  int t, nt = _nthreads, stopped = 0;
+
+  if ((UV)nt > n) nt = (int)n;
+  if (nt <= 1) {
+    _serial_queue(n, fn, done, ctx);
+    return;
+  }
+
+  pthread_mutex_init(&st.lock, 0);
+  pthread_cond_init(&st.cond, 0);
+  st.next = 0;
+  st.n = n;
+  st.nfinished = 0;
+  New(0, st.finished, n, UV);
+  st.fn = fn;
+  st.ctx = ctx;
+  for (t = 0; t < nt; t++)
+    if (pthread_create(&tids[t], 0, _pqueue_worker, &st) != 0)
+      break;
+  nt = t;
+  if (nt == 0) {   /* No threads at all, so do it ourselves */
+    _serial_queue(n, fn, done, ctx);
+  } else {
+    pthread_mutex_lock(&st.lock);
+    while (ndone < st.n) {   /* Once stopped, n is what was started */
+      UV i;
+      while (ndone == st.nfinished)
+        pthread_cond_wait(&st.cond, &st.lock);
+      i = st.finished[ndone++];
+      pthread_mutex_unlock(&st.lock);
+      if (!stopped && done(ctx, i))
+        stopped = 1;
+      pthread_mutex_lock(&st.lock);
+      if (stopped)
+        st.n = st.next;
+    }
+    pthread_mutex_unlock(&st.lock);
+    for (t = 0; t < nt; t++)
+      pthread_join(tids[t], 0);
+  }
+  Safefree(st.finished);
+  pthread_cond_destroy(&st.cond);
+  pthread_mutex_destroy(&st.lock);
+}
+
+#else
+
+void parallel_lock(void)   { }
+void parallel_unlock(void) { }
+
+void parallel_queue(UV n, parallel_fn_t fn, parallel_done_t done, void *ctx)
+{
+  UV i;
+  for (i = 0; i < n; i++) {
+    fn(ctx, i);
+    if (done(ctx, i)) break;
+  }
+}
+
+void parallel_for(UV n, parallel_fn_t fn, void *ctx)
+{
+  UV i;
+  for (i = 0; i < n; i++)
+    fn(ctx, i);
+}
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef MPU_THREADPOOL_H
+#define MPU_THREADPOOL_H
+
+#include "ptypes.h"
+
+/* Number of worker threads used by the parallel routines.  The default is
+ * 1 (no threads).  Setting 0 selects the number of online processors.
+ * Without pthreads support this is always 1. */
+extern int  get_thread_count(void);
+extern void set_thread_count(int nthreads);
+
+/* Call fn(ctx, i) for every i in 0 .. n-1, spreading the calls over up to
+ * get_thread_count() threads.  Indices are handed out in increasing order,
+ * and this returns once every call has finished.
+ *
+ * fn runs outside the Perl interpreter, so it must not croak, call back
+ * into Perl, or touch any unprotected static state. */
+typedef void (*parallel_fn_t)(void *ctx, UV i);
+extern void parallel_for(UV n, parallel_fn_t fn, void *ctx);
+
+/* As parallel_for, but the calling thread does none of the work.  Instead
+ * it calls done(ctx, i) for each i as soon as fn(ctx, i) has finished, in
+ * the order they finish, so done may call back into Perl (though it must
+ * not croak).  If done returns nonzero no more calls of fn are started, and
+ * those already running finish without done being called for them. */
+typedef int (*parallel_done_t)(void *ctx, UV i);
+extern void parallel_queue(UV n, parallel_fn_t fn, parallel_done_t done, void *ctx);
+
+/* A single global lock for the rare bits of shared state workers update. */
+extern void parallel_lock(void);
+extern void parallel_unlock(void);
+
+#endif
@@ -4,9 +4,16 @@
 
 #include <stdio.h>
 #include <stddef.h>
+#include <string.h>
 #include <stdlib.h>
 #include <gmp.h>
 #include <math.h>
+#include <time.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+  #include <sys/time.h>
+  #define MPU_HAVE_GETTIMEOFDAY
+#endif
 
 #include "ptypes.h"
 
@@ -16,11 +23,24 @@
 #include "factor.h"
 #include "primality.h"
 #include "isaac.h"
+#include "classpoly.h"
+#include "threadpool.h"
 
 static int _verbose = 0;
 int get_verbose_level(void) { return _verbose; }
 void set_verbose_level(int level) { _verbose = level; }
 
+double wall_seconds(void)
+{
+#ifdef MPU_HAVE_GETTIMEOFDAY
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  return (double)tv.tv_sec + (double)tv.tv_usec / 1e6;
+#else
+  return (double)clock() / (double)CLOCKS_PER_SEC;
+#endif
+}
+
 static gmp_randstate_t _randstate;
 gmp_randstate_t* get_randstate(void) { return &_randstate; }
 
@@ -1274,7 +1294,61 @@ void polyz_mulmod(mpz_t* pr, mpz_t* px, mpz_t *py, long *dr, long dx, long dy, m
   while (*dr > 0 && mpz_sgn(pr[*dr]) == 0)  dr[0]--;
 }
 #endif
-#if 1
+#if __GNU_MP_VERSION >= 6
+/* Kronecker substitution with each coefficient in a whole number of limbs,
+ * so packing and unpacking are linear copies rather than shifts of the
+ * whole product.  Coefficients must be in [0,mod). */
+static void _polyz_pack(mpz_t p, mpz_t* px, long dx, size_t L)
+{
+  long i;
+  mp_limb_t *lp = mpz_limbs_write(p, (dx+1)*L);
+  memset(lp, 0, (dx+1)*L*sizeof(mp_limb_t));
+  for (i = 0; i <= dx; i++)
+    memcpy(lp + i*L, mpz_limbs_read(px[i]), mpz_size(px[i])*sizeof(mp_limb_t));
+  mpz_limbs_finish(p, (dx+1)*L);
+}
+/* The coefficients of x^0 .. x^(n-1) of px*py */
+static void _polyz_mullo(mpz_t* pr, mpz_t* px, mpz_t *py, long dx, long dy, long n, mpz_t mod)
+{
+  long i;
+  size_t L, size;
+  const mp_limb_t *lp;
+  mpz_t p, p2, t, ro;
+
+  if (dx > n-1) dx = n-1;
+  if (dy > n-1) dy = n-1;
+  /* Each product coefficient is less than (min(dx,dy)+1) * mod^2 */
+  mpz_init(t);
+  mpz_mul(t, mod, mod);
+  mpz_mul_ui(t, t, ((dx < dy) ? dx : dy) + 1);
+  L = mpz_size(t);
+  mpz_clear(t);
+
+  mpz_init(p);
+  _polyz_pack(p, px, dx, L);
+  if (px == py && dx == dy) {
+    mpz_mul(p, p, p);
+  } else {
+    mpz_init(p2);
+    _polyz_pack(p2, py, dy, L);
+    mpz_mul(p, p, p2);
+    mpz_clear(p2);
+  }
+
+  lp = mpz_limbs_read(p);
+  size = mpz_size(p);
+  for (i = 0; i < n; i++) {
+    size_t start = i*L,  len = (start >= size) ? 0 : (size-start < L) ? size-start : L;
+    mpz_mod(pr[i], mpz_roinit_n(ro, lp + start, len), mod);
+  }
+  mpz_clear(p);
+}
+void polyz_mulmod(mpz_t* pr, mpz_t* px, mpz_t *py, long *dr, long dx, long dy, mpz_t mod)
+{
+  *dr = dx+dy;
+  _polyz_mullo(pr, px, py, dx, dy, dx+dy+1, mod);
+}
+#else
 void polyz_mulmod(mpz_t* pr, mpz_t* px, mpz_t *py, long *dr, long dx, long dy, mpz_t mod)
 {
   UV i, bits, r;
@@ -1316,6 +1390,12 @@ void polyz_mulmod(mpz_t* pr, mpz_t* px, mpz_t *py, long *dr, long dx, long dy, m
 
   mpz_clear(p); mpz_clear(t);
 }
+/* pr needs room for the whole product */
+static void _polyz_mullo(mpz_t* pr, mpz_t* px, mpz_t *py, long dx, long dy, long n, mpz_t mod)
+{
+  long dr;
+  polyz_mulmod(pr, px, py, &dr, dx, dy, mod);
+}
 #endif
 #if 0
 void polyz_mulmod(mpz_t* pr, mpz_t* px, mpz_t *py, long *dr, long dx, long dy, mpz_t mod)
@@ -1432,8 +1512,9 @@ void polyz_div(mpz_t *pq, mpz_t *pr, mpz_t *pn, mpz_t *pd,
   while (*dq > 0 && mpz_sgn(pq[*dq]) == 0)  dq[0]--;
 }
 
-/* Raise poly pn to the power, modulo poly pmod and coefficient NMOD. */
-void polyz_pow_polymod(mpz_t* pres,  mpz_t* pn,  mpz_t* pmod,
+/* Square and multiply with schoolbook division.  For moduli whose leading
+ * coefficient is not invertible mod NMOD. */
+static void polyz_pow_polymod_slow(mpz_t* pres,  mpz_t* pn,  mpz_t* pmod,
                               long *dres,   long   dn,  long   dmod,
                               mpz_t power, mpz_t NMOD)
 {
@@ -1483,6 +1564,282 @@ void polyz_pow_polymod(mpz_t* pres,  mpz_t* pn,  mpz_t* pmod,
   Safefree(pX);
 }
 
+/* Reduction modulo a fixed monic poly g using a precomputed inverse of its
+ * reversal (Newton iteration), so a remainder costs two products instead
+ * of deg^2 coefficient operations.  The products use polyz_mulmod, whose
+ * Kronecker substitution gets GMP's subquadratic multiplication.  See
+ * von zur Gathen and Gerhard, "Modern Computer Algebra", section 9.1. */
+typedef struct {
+  mpz_t *g;       /* monic, degree dg */
+  mpz_t *ginv;    /* 1/rev(g) mod x^k, k = dg-1 */
+  mpz_t *t1, *t2; /* scratch, 2*dg+1 each */
+  long dg, k;
+} polyz_modulus_t;
+
+static void _polyz_modulus_free(polyz_modulus_t* M)
+{
+  long i;
+  for (i = 0; i <= 2*M->dg; i++) {
+    mpz_clear(M->t1[i]);
+    mpz_clear(M->t2[i]);
+  }
+  for (i = 0; i <= M->dg; i++) {
+    mpz_clear(M->g[i]);
+    mpz_clear(M->ginv[i]);
+  }
+  Safefree(M->t1);  Safefree(M->t2);
+  Safefree(M->g);   Safefree(M->ginv);
+}
+
+/* Returns 0 if the leading coefficient of g is not invertible mod NMOD. */
+static int _polyz_modulus_init(polyz_modulus_t* M, mpz_t* pg, long dg, mpz_t NMOD)
+{
+  long i, prec;
+
+  M->dg = dg;
+  M->k = (dg > 1) ? dg-1 : 1;
+  New(0, M->g, dg+1, mpz_t);
+  New(0, M->ginv, dg+1, mpz_t);
+  New(0, M->t1, 2*dg+1, mpz_t);
+  New(0, M->t2, 2*dg+1, mpz_t);
+  for (i = 0; i <= dg; i++) {
+    mpz_init(M->g[i]);
+    mpz_init(M->ginv[i]);
+  }
+  for (i = 0; i <= 2*dg; i++) {
+    mpz_init(M->t1[i]);
+    mpz_init(M->t2[i]);
+  }
+
+  if (!mpz_invert(M->t1[0], pg[dg], NMOD)) {
+    _polyz_modulus_free(M);
+    return 0;
+  }
+  for (i = 0; i < dg; i++)
+    mpz_mulmod(M->g[i], pg[i], M->t1[0], NMOD, M->t2[0]);
+  mpz_set_ui(M->g[dg], 1);
+
+  /* f <- f(2 - rev(g) f), doubling the precision each time */
+  mpz_set_ui(M->ginv[0], 1);
+  for (prec = 1; prec < M->k; ) {
+    long p2 = (2*prec < M->k) ? 2*prec : M->k;
+    for (i = 0; i < p2; i++)
+      mpz_set(M->t1[i], M->g[dg-i]);
+    _polyz_mullo(M->t2, M->t1, M->ginv, p2-1, prec-1, p2, NMOD);
+    for (i = 0; i < p2; i++) {
+      if (mpz_sgn(M->t2[i])) mpz_sub(M->t1[i], NMOD, M->t2[i]);
+      else                   mpz_set_ui(M->t1[i], 0);
+    }
+    mpz_add_ui(M->t1[0], M->t1[0], 2);
+    mpz_mod(M->t1[0], M->t1[0], NMOD);
+    _polyz_mullo(M->t2, M->ginv, M->t1, prec-1, p2-1, p2, NMOD);
+    for (i = 0; i < p2; i++)
+      mpz_set(M->ginv[i], M->t2[i]);
+    prec = p2;
+  }
+  return 1;
+}
+
+/* r = a mod g, for deg a <= 2*deg g - 2.  pr may be pa. */
+static void _polyz_rem(mpz_t* pr, long* dr, mpz_t* pa, long da, polyz_modulus_t* M, mpz_t NMOD)
+{
+  long i, m, dg = M->dg;
+
+  while (da > 0 && mpz_sgn(pa[da]) == 0)  da--;
+  if (da < dg) {
+    if (pr != pa)
+      for (i = 0; i <= da; i++)
+        mpz_set(pr[i], pa[i]);
+    *dr = da;
+    return;
+  }
+  /* rev(q) = rev(a) / rev(g) mod x^(m+1) */
+  m = da - dg;
+  for (i = 0; i <= m; i++)
+    mpz_set(M->t1[i], pa[da-i]);
+  _polyz_mullo(M->t2, M->t1, M->ginv, m, m, m+1, NMOD);
+  for (i = 0; i <= m; i++)
+    mpz_set(M->t1[i], M->t2[m-i]);
+  /* r = a - q*g, of which only the terms below x^dg are needed */
+  _polyz_mullo(M->t2, M->t1, M->g, m, dg-1, dg, NMOD);
+  for (i = 0; i < dg; i++) {
+    mpz_sub(pr[i], pa[i], M->t2[i]);
+    if (mpz_sgn(pr[i]) < 0) mpz_add(pr[i], pr[i], NMOD);
+  }
+  *dr = dg-1;
+  while (*dr > 0 && mpz_sgn(pr[*dr]) == 0)  dr[0]--;
+}
+
+/* r = r * (b x + a) mod g, in place with O(deg) work.  r has room for dg+1. */
+static void _polyz_mul_linear(mpz_t* pr, long* dr, mpz_t a, mpz_t b, polyz_modulus_t* M, mpz_t NMOD)
+{
+  long i, dg = M->dg;
+  mpz_t t;
+
+  mpz_init(t);
+  mpz_set_ui(pr[*dr+1], 0);
+  for (i = *dr+1; i >= 0; i--) {
+    mpz_mul(pr[i], pr[i], a);
+    if (i > 0) mpz_addmul(pr[i], pr[i-1], b);
+    mpz_mod(pr[i], pr[i], NMOD);
+  }
+  *dr += 1;
+  if (*dr == dg) {
+    mpz_set(t, pr[dg]);
+    for (i = 0; i < dg; i++) {
+      mpz_submul(pr[i], t, M->g[i]);
+      mpz_mod(pr[i], pr[i], NMOD);
+    }
+    *dr = dg-1;
+  }
+  while (*dr > 0 && mpz_sgn(pr[*dr]) == 0)  dr[0]--;
+  mpz_clear(t);
+}
+
+/* Raise poly pn to the power, modulo poly pmod and coefficient NMOD.
+ *
+ * Left to right, reducing with the precomputed inverse.  A linear pn (the
+ * usual X+a from root finding) is multiplied in directly in linear time,
+ * anything else uses a sliding window of odd powers. */
+void polyz_pow_polymod(mpz_t* pres,  mpz_t* pn,  mpz_t* pmod,
+                              long *dres,   long   dn,  long   dmod,
+                              mpz_t power, mpz_t NMOD)
+{
+  polyz_modulus_t M;
+  mpz_t *pX, *pProd, **pw;
+  long i, j, dX, dProd, bit, w, npw, *dpw, maxd;
+  int started = 0;
+
+  while (dmod > 0 && mpz_sgn(pmod[dmod]) == 0)  dmod--;
+  if (dmod == 0 || !_polyz_modulus_init(&M, pmod, dmod, NMOD)) {
+    polyz_pow_polymod_slow(pres, pn, pmod, dres, dn, dmod, power, NMOD);
+    return;
+  }
+
+  while (dn > 0 && mpz_sgn(pn[dn]) == 0)  dn--;
+  maxd = (dn > 2*dmod) ? dn : 2*dmod;
+  New(0, pX, maxd+1, mpz_t);
+  New(0, pProd, 2*dmod+1, mpz_t);
+  for (i = 0; i <= maxd; i++)
+    mpz_init(pX[i]);
+  for (i = 0; i <= 2*dmod; i++)
+    mpz_init(pProd[i]);
+
+  /* X = n mod g */
+  if (dn > 2*dmod-2) {
+    mpz_t *pQ;
+    long dQ;
+    New(0, pQ, dn+1, mpz_t);
+    for (i = 0; i <= dn; i++)
+      mpz_init(pQ[i]);
+    polyz_div(pQ, pX, pn, M.g, &dQ, &dX, dn, dmod, NMOD);
+    for (i = 0; i <= dn; i++)
+      mpz_clear(pQ[i]);
+    Safefree(pQ);
+  } else {
+    for (i = 0; i <= dn; i++)
+      mpz_mod(pX[i], pn[i], NMOD);
+    _polyz_rem(pX, &dX, pX, dn, &M, NMOD);
+  }
+
+  *dres = 0;
+  mpz_set_ui(pres[0], 1);
+  bit = mpz_sizeinbase(power, 2) - 1;
+  if (mpz_sgn(power) == 0) bit = -1;
+
+  if (dX == 1 && dmod > 1) {
+    for ( ; bit >= 0; bit--) {
+      if (started) {
+        polyz_mulmod(pProd, pres, pres, &dProd, *dres, *dres, NMOD);
+        _polyz_rem(pres, dres, pProd, dProd, &M, NMOD);
+      }
+      if (mpz_tstbit(power, bit)) {
+        _polyz_mul_linear(pres, dres, pX[0], pX[1], &M, NMOD);
+        started = 1;
+      }
+    }
+  } else {
+    w = (bit < 24) ? 1 : (bit < 80) ? 3 : (bit < 800) ? 4 : 5;
+    npw = 1L << (w-1);
+    /* pw[j] = X^(2j+1) mod g */
+    New(0, pw, npw, mpz_t*);
+    New(0, dpw, npw, long);
+    for (j = 0; j < npw; j++) {
+      New(0, pw[j], 2*dmod+1, mpz_t);
+      for (i = 0; i <= 2*dmod; i++)
+        mpz_init(pw[j][i]);
+    }
+    polyz_set(pw[0], &dpw[0], pX, dX);
+    if (npw > 1) {
+      polyz_mulmod(pProd, pX, pX, &dProd, dX, dX, NMOD);
+      _polyz_rem(pX, &dX, pProd, dProd, &M, NMOD);
+    }
+    for (j = 1; j < npw; j++) {
+      polyz_mulmod(pProd, pw[j-1], pX, &dProd, dpw[j-1], dX, NMOD);
+      _polyz_rem(pw[j], &dpw[j], pProd, dProd, &M, NMOD);
+    }
+
+    while (bit >= 0) {
+      long low, val;
+      if (!mpz_tstbit(power, bit)) {
+        if (started) {
+          polyz_mulmod(pProd, pres, pres, &dProd, *dres, *dres, NMOD);
+          _polyz_rem(pres, dres, pProd, dProd, &M, NMOD);
+        }
+        bit--;
+        continue;
+      }
+      /* Longest window of at most w bits ending in a 1 */
+      low = (bit-w+1 > 0) ? bit-w+1 : 0;
+      while (!mpz_tstbit(power, low))  low++;
+      for (val = 0, i = bit; i >= low; i--) {
+        val = 2*val + mpz_tstbit(power, i);
+        if (started) {
+          polyz_mulmod(pProd, pres, pres, &dProd, *dres, *dres, NMOD);
+          _polyz_rem(pres, dres, pProd, dProd, &M, NMOD);
+        }
+      }
+      if (started) {
+        polyz_mulmod(pProd, pres, pw[val>>1], &dProd, *dres, dpw[val>>1], NMOD);
+        _polyz_rem(pres, dres, pProd, dProd, &M, NMOD);
+      } else {
+        polyz_set(pres, dres, pw[val>>1], dpw[val>>1]);
+        started = 1;
+      }
+      bit = low-1;
+    }
+
+    for (j = 0; j < npw; j++) {
+      for (i = 0; i <= 2*dmod; i++)
+        mpz_clear(pw[j][i]);
+      Safefree(pw[j]);
+    }
+    Safefree(pw);
+    Safefree(dpw);
+  }
+
+  for (i = 0; i <= maxd; i++)
+    mpz_clear(pX[i]);
+  for (i = 0; i <= 2*dmod; i++)
+    mpz_clear(pProd[i]);
+  Safefree(pX);
+  Safefree(pProd);
+  _polyz_modulus_free(&M);
+}
+
+/* Divide by the leading coefficient, if it is invertible */
+static void _polyz_make_monic(mpz_t* pn, long dn, mpz_t t, mpz_t NMOD)
+{
+  long i;
+  if (mpz_cmp_ui(pn[dn], 1) == 0 || !mpz_invert(t, pn[dn], NMOD))
+    return;
+  for (i = 0; i < dn; i++) {
+    mpz_mul(pn[i], pn[i], t);
+    mpz_mod(pn[i], pn[i], NMOD);
+  }
+  mpz_set_ui(pn[dn], 1);
+}
+
 void polyz_gcd(mpz_t* pres, mpz_t* pa, mpz_t* pb, long* dres, long da, long db, mpz_t MODN)
 {
   long i;
@@ -1500,7 +1857,6 @@ void polyz_gcd(mpz_t* pres, mpz_t* pa, mpz_t* pb, long* dres, long da, long db,
     mtmp = pa; pa = pb; pb = mtmp;
     ltmp = da; da = db; db = ltmp;
   }
-  /* TODO: Should set c=pa[da], then after Euclid loop, res = c^-1 * res */
 
   /* Allocate temporary polys */
   maxd = da;
@@ -1526,9 +1882,15 @@ void polyz_gcd(mpz_t* pres, mpz_t* pa, mpz_t* pb, long* dres, long da, long db,
   while (dr1 > 0 && mpz_sgn(pr1[dr1]) == 0)   dr1--;
 
   while (dr1 > 0 || mpz_sgn(pr1[dr1]) != 0) {
+    /* A monic divisor avoids pseudo-division */
+    _polyz_make_monic(pr1, dr1, pq[0], MODN);
     polyz_div(pq, pr,  pres, pr1,  &dq, &dr,  *dres, dr1, MODN);
-    if (dr < 0 || dq < 0 || dr > maxd || dq > maxd)
-      croak("division error: dq %ld dr %ld maxd %ld\n", dq, dr, maxd);
+    if (dr < 0 || dq < 0 || dr > maxd || dq > maxd) {
+      /* Not reached for a prime modulus.  Report failure rather than
+       * croaking, as this may be running on a worker thread. */
+      *dres = -1;
+      break;
+    }
     /* pr0 = pr1.  pr1 = pr */
     *dres = dr1;
     for (i = 0; i <= dr1; i++)
@@ -1538,7 +1900,10 @@ void polyz_gcd(mpz_t* pres, mpz_t* pa, mpz_t* pb, long* dres, long da, long db,
       mpz_set(pr1[i], pr[i]);
   }
   /* return pr0 */
-  while (*dres > 0 && mpz_sgn(pres[*dres]) == 0)   dres[0]--;
+  if (*dres >= 0) {
+    while (*dres > 0 && mpz_sgn(pres[*dres]) == 0)   dres[0]--;
+    _polyz_make_monic(pres, *dres, pq[0], MODN);
+  }
 
   for (i = 0; i <= maxd; i++) {
     mpz_clear(pr1[i]);
@@ -1662,7 +2027,7 @@ static void polyz_roots(mpz_t* roots, long *nroots,
     mpz_sub_ui(pt[0], pt[0], 1);
     polyz_gcd(ph, pt, pg, &dh, dt, dg, NMOD);
 
-    if (dh >= 1 && dh < dg)
+    if (dh < 0 || (dh >= 1 && dh < dg))
       break;
   }
 
@@ -1758,78 +2123,243 @@ const char* poly_class_type_name(int type)
   }
 }
 
-int* poly_class_nums(void)
+/* Index numbers run through the built-in table, then the external database
+ * (if there is one, see classpoly.c), then the discriminants whose Hilbert
+ * polys we compute as needed: fundamental, with |D| <= CLASS_GEN_MAXD and
+ * degree <= CLASS_GEN_MAXH.  Computed polys are cached. */
+#define CLASS_GEN_MAXD 50000
+#define CLASS_GEN_MAXH 32
+
+static UV _ngen = 0;
+static uint32_t* _gen_D = 0;
+static unsigned short* _gen_degree = 0;
+static mpz_t** _gen_T = 0;
+
+static int _in_class_table(UV D)
+{
+  UV lo = 0, hi = NUM_CLASS_POLYS;
+  while (lo < hi) {
+    UV mid = lo + (hi-lo)/2;
+    if (_class_poly_data[mid].D < D)  lo = mid+1;
+    else                              hi = mid;
+  }
+  return (lo < NUM_CLASS_POLYS && _class_poly_data[lo].D == D);
+}
+
+static void _gen_class_list(void)
+{
+  unsigned short *h;
+  UV d;
+
+  if (_gen_D != 0) return;
+  h = class_numbers(CLASS_GEN_MAXD);
+  for (d = 3; d <= CLASS_GEN_MAXD; d++)
+    if (h[d] > 1 && h[d] <= CLASS_GEN_MAXH && !_in_class_table(d) && !class_poly_db_find(d) && is_fundamental_disc(d))
+      _ngen++;
+  New(0, _gen_D, _ngen, uint32_t);
+  New(0, _gen_degree, _ngen, unsigned short);
+  Newz(0, _gen_T, _ngen, mpz_t*);
+  for (_ngen = 0, d = 3; d <= CLASS_GEN_MAXD; d++)
+    if (h[d] > 1 && h[d] <= CLASS_GEN_MAXH && !_in_class_table(d) && !class_poly_db_find(d) && is_fundamental_disc(d)) {
+      _gen_D[_ngen] = d;
+      _gen_degree[_ngen] = h[d];
+      _ngen++;
+    }
+  Safefree(h);
+}
+
+void free_class_polys(void)
+{
+  UV i, j;
+  if (_gen_D == 0) return;
+  for (i = 0; i < _ngen; i++) {
+    if (_gen_T[i] == 0) continue;
+    for (j = 0; j <= _gen_degree[i]; j++)
+      mpz_clear(_gen_T[i][j]);
+    Safefree(_gen_T[i]);
+  }
+  Safefree(_gen_T);
+  Safefree(_gen_degree);
+  Safefree(_gen_D);
+  _gen_D = 0;
+  _ngen = 0;
+}
+
+int* poly_class_nums(int extra)
 {
   int* dlist;
-  UV i;
+  UV i, ngen, ndb, nlist;
   int degree_offset[256] = {0};
 
   for (i = 1; i < NUM_CLASS_POLYS; i++)
     if (_class_poly_data[i].D < _class_poly_data[i-1].D)
       croak("Problem with data file, out of order at D=%d\n", (int)_class_poly_data[i].D);
 
-  Newz(0, dlist, NUM_CLASS_POLYS + 1, int);
+  ndb = class_poly_db_count();
+  if (extra) _gen_class_list();
+  ngen = (extra) ? _ngen : 0;
+
+  Newz(0, dlist, NUM_CLASS_POLYS + ndb + ngen + 1, int);
   /* init degree_offset to total number of this degree */
   for (i = 0; i < NUM_CLASS_POLYS; i++)
     degree_offset[_class_poly_data[i].degree]++;
+  for (i = 0; i < ndb; i++) {
+    UV D, degree = class_poly_db_entry(i, &D, 0, 0, 0);
+    if (!_in_class_table(D))
+      degree_offset[degree]++;
+  }
+  for (i = 0; i < ngen; i++)
+    degree_offset[_gen_degree[i]]++;
   /* set degree_offset to sum of this and all previous degrees. */
   for (i = 1; i < 256; i++)
     degree_offset[i] += degree_offset[i-1];
-  /* Fill in dlist, sorted */
+  nlist = degree_offset[255];
+  /* Fill in dlist, sorted: the table, database, and computed polys in turn
+   * for each degree. */
   for (i = 0; i < NUM_CLASS_POLYS; i++) {
     int position = degree_offset[_class_poly_data[i].degree-1]++;
     dlist[position] = i+1;
   }
+  for (i = 0; i < ndb; i++) {
+    UV D, degree = class_poly_db_entry(i, &D, 0, 0, 0);
+    if (!_in_class_table(D)) {
+      int position = degree_offset[degree-1]++;
+      dlist[position] = NUM_CLASS_POLYS+1+i;
+    }
+  }
+  for (i = 0; i < ngen; i++) {
+    int position = degree_offset[_gen_degree[i]-1]++;
+    dlist[position] = NUM_CLASS_POLYS+ndb+1+i;
+  }
   /* Null terminate */
-  dlist[NUM_CLASS_POLYS] = 0;
+  dlist[nlist] = 0;
   return dlist;
 }
 
-UV poly_class_poly_num(int i, int *D, mpz_t**T, int* type)
+/* A computed Hilbert poly.  Workers may ask for these, so the cache is
+ * locked, but the poly is computed outside the lock and then published
+ * unless another thread got there first. */
+static UV _gen_class_poly(UV gi, mpz_t**T)
 {
-  UV degree, j;
-  int ctype;
-  mpz_t t;
-  const char* s;
-
-  if (i < 1 || i > (int)NUM_CLASS_POLYS) { /* Invalid number */
-     if (D != 0) *D = 0;
-     if (T != 0) *T = 0;
-     return 0;
+  UV j, h, degree = _gen_degree[gi];
+  mpz_t *H = 0;
+  int have;
+
+  parallel_lock();
+  have = (_gen_T[gi] != 0);
+  parallel_unlock();
+  if (!have) {
+    h = hilbert_class_poly(&H, _gen_D[gi]);
+    if (h != degree) {
+      for (j = 0; H != 0 && j <= h; j++)
+        mpz_clear(H[j]);
+      if (H != 0) Safefree(H);
+      *T = 0;
+      return 0;
+    }
+    parallel_lock();
+    if (_gen_T[gi] == 0)
+      { _gen_T[gi] = H;  H = 0; }
+    parallel_unlock();
+    if (H != 0) {      /* Lost the race, use theirs */
+      for (j = 0; j <= degree; j++)
+        mpz_clear(H[j]);
+      Safefree(H);
+    }
   }
-  i--; /* i now is the index into our table */
-
-  degree = _class_poly_data[i].degree;
-  ctype  = _class_poly_data[i].type;
-  s = _class_poly_data[i].coefs;
+  New(0, *T, degree+1, mpz_t);
+  parallel_lock();
+  for (j = 0; j <= degree; j++)
+    mpz_init_set( (*T)[j], _gen_T[gi][j] );
+  parallel_unlock();
+  return degree;
+}
 
-  if (D != 0)  *D = -_class_poly_data[i].D;
-  if (type != 0)  *type = ctype;
-  if (T == 0) return degree;
+/* Decode the coefficients of a class poly.  If end is not null, the encoded
+ * string must not run past it.  Returns 0 if it does. */
+static int _decode_class_poly(mpz_t* T, const unsigned char* s, const unsigned char* end, UV degree, int ctype)
+{
+  UV j;
+  mpz_t t;
 
-  New(0, *T, degree+1, mpz_t);
   mpz_init(t);
   for (j = 0; j < degree; j++) {
-    unsigned char signcount = (*s++) & 0xFF;
-    unsigned char sign = signcount >> 7;
-    unsigned long count = signcount & 0x7F;
+    unsigned char signcount, sign;
+    unsigned long count;
+    if (end != 0 && s >= end) break;
+    signcount = *s++;
+    sign = signcount >> 7;
+    count = signcount & 0x7F;
     if (count == 127) {
       do {
-        signcount = (*s++) & 0xFF;
+        if (end != 0 && s >= end) break;
+        signcount = *s++;
         count += signcount;
       } while (signcount == 127);
     }
+    if (end != 0 && count > (unsigned long)(end - s)) break;
     mpz_set_ui(t, 0);
     while (count-- > 0) {
       mpz_mul_2exp(t, t, 8);
-      mpz_add_ui(t, t, (unsigned long) (*s++) & 0xFF);
+      mpz_add_ui(t, t, (unsigned long) *s++);
     }
     /* Cube the last coefficient of Hilbert polys */
     if (j == 0 && ctype == 1) mpz_pow_ui(t, t, 3);
     if (sign) mpz_neg(t, t);
-    mpz_init_set( (*T)[j], t );
+    mpz_init_set( T[j], t );
   }
   mpz_clear(t);
-  mpz_init_set_ui( (*T)[degree], 1 );
+  if (j < degree) {             /* Ran off the end */
+    while (j-- > 0)
+      mpz_clear(T[j]);
+    return 0;
+  }
+  mpz_init_set_ui( T[degree], 1 );
+  return 1;
+}
+
+UV poly_class_poly_num(int i, int *D, mpz_t**T, int* type)
+{
+  UV degree, ndb = class_poly_db_count();
+  int ctype;
+
+  if (i > (int)(NUM_CLASS_POLYS+ndb) && i <= (int)(NUM_CLASS_POLYS+ndb+_ngen)) {
+    UV gi = i - NUM_CLASS_POLYS - ndb - 1;
+    if (D != 0)  *D = -(int)_gen_D[gi];
+    if (type != 0)  *type = 1;
+    if (T == 0) return _gen_degree[gi];
+    return _gen_class_poly(gi, T);
+  }
+  if (i > (int)NUM_CLASS_POLYS && i <= (int)(NUM_CLASS_POLYS+ndb)) {
+    const unsigned char* s;
+    UV dbD, length;
+    degree = class_poly_db_entry(i - NUM_CLASS_POLYS - 1, &dbD, &ctype, &s, &length);
+    if (D != 0)  *D = -(int)dbD;
+    if (type != 0)  *type = ctype;
+    if (T == 0) return degree;
+    New(0, *T, degree+1, mpz_t);
+    if (!_decode_class_poly(*T, s, s+length, degree, ctype)) {
+      Safefree(*T);
+      *T = 0;
+      return 0;
+    }
+    return degree;
+  }
+  if (i < 1 || i > (int)NUM_CLASS_POLYS) { /* Invalid number */
+     if (D != 0) *D = 0;
+     if (T != 0) *T = 0;
+     return 0;
+  }
+  i--; /* i now is the index into our table */
+
+  degree = _class_poly_data[i].degree;
+  ctype  = _class_poly_data[i].type;
+
+  if (D != 0)  *D = -_class_poly_data[i].D;
+  if (type != 0)  *type = ctype;
+  if (T == 0) return degree;
+
+  New(0, *T, degree+1, mpz_t);
+  _decode_class_poly(*T, (const unsigned char*)_class_poly_data[i].coefs, 0, degree, ctype);
   return degree;
 }
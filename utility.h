@@ -8,6 +8,9 @@
 extern int get_verbose_level(void);
 extern void set_verbose_level(int level);
 
+/* Seconds from some fixed point, for timing (wall clock where we can). */
+extern double wall_seconds(void);
+
 extern gmp_randstate_t* get_randstate(void);
 extern void init_randstate(unsigned long seed);
 extern void clear_randstate(void);
@@ -65,6 +68,7 @@ extern void polyz_div(mpz_t *pq, mpz_t *pr, mpz_t *pn, mpz_t *pd,
 extern void polyz_pow_polymod(mpz_t* pres,  mpz_t* pn,  mpz_t* pmod,
                               long *dres,   long   dn,  long   dmod,
                               mpz_t power, mpz_t NMOD);
+/* Sets *dres to -1 if the division fails (e.g. MODN is not prime). */
 extern void polyz_gcd(mpz_t* pres, mpz_t* pa, mpz_t* pb, long* dres, long da, long db, mpz_t MODN);
 
 extern void polyz_root_deg1(mpz_t root, mpz_t* pn, mpz_t NMOD);
@@ -88,14 +92,16 @@ extern const char* poly_class_type_name(int type);
 /* return a 0 terminated list of all D's sorted by degree */
 extern IV* poly_class_degrees(int insert_1s);
 
-/* List of class polynomial indices in order */
-extern int* poly_class_nums(void);
+/* List of class polynomial indices in order.  If extra is set this also
+ * has the discriminants whose Hilbert polys are computed on demand. */
+extern int* poly_class_nums(int extra);
 /* Given a class poly index, return the degree and fill in (if not null):
  *   D     the discriminant number
  *   T     the polynomial coefficients
  *   type  the poly type:  1 Hilber, 2 Weber
  */
 extern UV poly_class_poly_num(int i, int *D, mpz_t**T, int* type);
+extern void free_class_polys(void);
 
 #define BITS2DIGS(bits) ceil(bits/3.3219281)
 #define DIGS2BITS(digs) ceil(digs*3.3219281)
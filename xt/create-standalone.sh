@@ -6,11 +6,11 @@ then
 fi
 
 cp -p ptypes.h standalone/
-cp -p ecpp.[ch] bls75.[ch] aks.[ch] ecm.[ch] prime_iterator.[ch] standalone/
+cp -p ecpp.[ch] classpoly.[ch] cert.[ch] bls75.[ch] aks.[ch] ecm.[ch] prime_iterator.[ch] standalone/
 cp -p gmp_main.[ch] real.[ch] standalone/
 cp -p factor.[ch] squfof126.[ch] pbrent63.[ch] tinyqs.[ch] standalone/
-cp -p utility.[ch] isaac.[ch] random_prime.[ch] standalone/
-cp -p primality.[ch] standalone/
+cp -p utility.[ch] isaac.[ch] random_prime.[ch] rootmod.[ch] lmo.[ch] standalone/
+cp -p primality.[ch] threadpool.[ch] lucas_seq.[ch] standalone/
 cp -p xt/expr.[ch] xt/expr-impl.h standalone/
 cp -p xt/proof-text-format.txt standalone/
 cp -p examples/verify-cert.pl standalone/
@@ -40,13 +40,14 @@ EOSIMPQSH
 cat << 'EOM' > standalone/Makefile
 TARGET = ecpp-dj
 CC = gcc
-DEFINES = -DSTANDALONE -DSTANDALONE_ECPP
+DEFINES = -DSTANDALONE -DSTANDALONE_ECPP -DUSE_PTHREADS
 CFLAGS = -O3 -g -Wall $(DEFINES)
-LIBS = -lgmp -lm
+LIBS = -lgmp -lm -lpthread
 
-OBJ = ecpp.o bls75.o aks.o primality.o ecm.o prime_iterator.o gmp_main.o \
+OBJ = ecpp.o classpoly.o cert.o bls75.o aks.o primality.o ecm.o prime_iterator.o gmp_main.o \
       factor.o squfof126.o pbrent63.o tinyqs.o \
-      real.o isaac.o random_prime.o utility.o expr.o
+      real.o isaac.o random_prime.o utility.o threadpool.o expr.o \
+      lucas_seq.o rootmod.o lmo.o
 HEADERS = ptypes.h class_poly_data.h
 
 .PHONY: default all clean
@@ -176,16 +177,14 @@ Some areas to concentrate on:
     discriminants than we do, so factoring isn't a big issue for them.  They
     have very different polynomials and root finding algorithms however.
 
- 3. Parallelism.  Currently the entire code is single threaded.  There are
+ 3. Parallelism.  Only parts of the code use threads so far.  There are
     many opportunities here.
-    - Something I think would be useful and not too much work is parallelizing
-    the dlist loop in ecpp_down, so all the discriminants can be searched at
-    once.  A more complicated solution would be a work queue including pruning
-    so we could recurse down many trees at once.
+    - With '-t <n>' the m values for a run of discriminants in the dlist
+    loop of ecpp_down are factored at once, and the curve finding for the
+    entire chain is done in parallel after the down-run.  A more complicated
+    solution would be a work queue including pruning so we could recurse down
+    many trees at once.
     - If we have to run ECM, then clearly we can run multiple curves at once.
-    - Finally, once we've hit STEP 2 of ecpp_down, we could do curve finding
-    for the entire chain in parallel.  This would be especially useful for
-    titanic numbers where this is a large portion of the total time.
 
  4. ecpp_down.  There are a lot of little things here that can have big
     impacts on performance.  For instance the decisions on when to keep
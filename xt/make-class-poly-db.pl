@@ -0,0 +1,48 @@
+#!/usr/bin/env perl
+use warnings;
+use strict;
+
+# Build an external class polynomial database for ECPP from one or more
+# files in the format of class_poly_data.h (e.g. the larger sets on github).
+# Where a discriminant appears more than once, the last file wins.
+#
+#   perl xt/make-class-poly-db.pl class_poly_data_big.h > classpoly.db
+#   MPU_CLASS_POLY_DB=classpoly.db perl -MMath::Prime::Util::GMP=:all ...
+#
+# See classpoly.c for the layout.
+
+die "Usage: $0 <class_poly_data.h> ... > out.db\n" unless @ARGV;
+
+my %polys;
+for my $file (@ARGV) {
+  open(my $fh, '<', $file) or die "Cannot open $file: $!\n";
+  my $text = do { local $/; <$fh> };
+  close $fh;
+  my $n = 0;
+  while ($text =~ /\{\s*(\d+)\s*,\s*(\d+)\s*,\s*(\d+)\s*,\s*((?:"[^"]*"\s*)+)\}/g) {
+    my($D, $type, $degree, $strings) = ($1, $2, $3, $4);
+    die "$file: bad type $type for D=$D\n" unless $type >= 1 && $type <= 3;
+    die "$file: bad degree $degree for D=$D\n" unless $degree >= 1 && $degree <= 255;
+    my $coefs = '';
+    $coefs .= $1 while $strings =~ /"([^"]*)"/g;
+    $coefs =~ s/\\x([0-9a-fA-F]{1,2})|\\([0-7]{1,3})|\\(.)/
+               defined $1 ? chr(hex $1) : defined $2 ? chr(oct $2)
+                          : $3 eq 'n' ? "\n" : $3 eq 't' ? "\t" : $3/ge;
+    $polys{$D} = [$type, $degree, $coefs];
+    $n++;
+  }
+  warn "$file: $n polys\n";
+}
+
+my @D = sort { $a <=> $b } keys %polys;
+my $offset = 16 + 16 * scalar(@D);
+my($index, $data) = ('', '');
+for my $D (@D) {
+  my($type, $degree, $coefs) = @{$polys{$D}};
+  $index .= pack("V C C v V V", $D, $type, 0, $degree, $offset, length($coefs));
+  $data .= $coefs;
+  $offset += length($coefs);
+}
+binmode STDOUT;
+print "MPUCPDB1", pack("V V", scalar(@D), 0), $index, $data;
+warn "wrote ", scalar(@D), " polys, $offset bytes\n";